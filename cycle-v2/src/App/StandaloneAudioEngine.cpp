@@ -21,10 +21,17 @@ std::unique_ptr<PropertiesFile> createDeviceProperties() {
     return std::make_unique<PropertiesFile>(options);
 }
 
+int renderWorkerCount() {
+    // a few lanes cover a full chord; past that the workers only add wake-up latency
+    constexpr int maximumRenderWorkers = 3;
+    return jmin(maximumRenderWorkers, RealtimeWorkerPool::defaultWorkerCount());
+}
+
 }
 
 StandaloneAudioEngine::StandaloneAudioEngine() :
-        deviceProperties(createDeviceProperties()) {
+        deviceProperties(createDeviceProperties())
+    ,   renderer(renderWorkerCount()) {
     startTimerHz(30);
 }
 
@@ -89,10 +96,15 @@ bool StandaloneAudioEngine::publishGraph(
     spec.maximumFrameCount = (size_t) jmax(1, currentBlockSize.load(std::memory_order_acquire));
     spec.sampleRate = currentSampleRate.load(std::memory_order_acquire);
     spec.channelLayout = ChannelLayout::LinkedStereo;
+    // the newest graph is the active one or about to be, and carries what's unchanged forward
+    const PreparedGraph* previous = graphOwners.empty() ? nullptr : graphOwners.back().get();
     auto graph = RealtimeGraphRenderer::prepareGraph(
             std::move(plan),
             revision,
-            spec);
+            spec,
+            polyphony,
+            renderer.renderLaneCount(),
+            previous);
     PreparedGraph* graphPointer = graph.get();
     graphOwners.push_back(std::move(graph));
 
@@ -231,7 +243,9 @@ void StandaloneAudioEngine::timerCallback() {
     PreparedGraph* retired = retiredGraph.exchange(nullptr, std::memory_order_acq_rel);
     reclaimGraph(retired);
     for (const auto& graph : graphOwners) {
-        graph->executor.serviceNonRealtimePreparation();
+        for (const auto& executor : graph->executors) {
+            executor->serviceNonRealtimePreparation();
+        }
     }
 }
 
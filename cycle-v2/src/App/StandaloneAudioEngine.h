@@ -67,6 +67,8 @@ public:
 private:
     using PreparedGraph = RealtimeGraphRenderer::PreparedGraph;
 
+    static constexpr size_t polyphony = 16;
+
     void timerCallback() override;
     void adoptPendingGraph();
     void reclaimGraph(PreparedGraph* graph);
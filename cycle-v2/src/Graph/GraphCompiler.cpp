@@ -7,11 +7,93 @@
 #include "../Nodes/Unison/UnisonNode.h"
 
 #include <algorithm>
+#include <numeric>
+#include <queue>
 
 namespace CycleV2 {
 
 namespace {
 
+using IdIndex = std::unordered_map<String, int, GraphDependencyIndex::StringHash>;
+
+struct PortKey {
+    String nodeId;
+    String portId;
+
+    bool operator==(const PortKey& other) const {
+        return nodeId == other.nodeId && portId == other.portId;
+    }
+};
+
+struct PortKeyHash {
+    size_t operator()(const PortKey& key) const {
+        const size_t nodeHash = static_cast<size_t>(key.nodeId.hashCode64());
+        const size_t portHash = static_cast<size_t>(key.portId.hashCode64());
+        return nodeHash ^ (portHash + 0x9e3779b9 + (nodeHash << 6) + (nodeHash >> 2));
+    }
+};
+
+using PortIndex = std::unordered_map<PortKey, int, PortKeyHash>;
+
+/*
+ * Lookups the passes below share, built once per compile so that none of them
+ * scans the node or edge lists for every step, port or edge it visits. Edge
+ * positions refer to the resolved signal edges, and the per-node lists keep
+ * their plan order.
+ */
+struct CompileIndex {
+    IdIndex nodeIndexById;
+    std::vector<ChannelLayout> signalEdgeLayouts;
+    PortIndex firstEdgeByOutput;
+    std::vector<std::vector<int>> outgoingEdges;
+    std::vector<std::vector<int>> incomingEdges;
+
+    int nodeIndex(const String& nodeId) const {
+        const auto found = nodeIndexById.find(nodeId);
+        return found != nodeIndexById.end() ? found->second : -1;
+    }
+};
+
+IdIndex indexNodes(const std::vector<Node>& nodes) {
+    IdIndex index;
+    index.reserve(nodes.size());
+    for (int i = 0; i < static_cast<int>(nodes.size()); ++i) {
+        index.emplace(nodes[static_cast<size_t>(i)].id, i);
+    }
+    return index;
+}
+
+void indexSignalEdges(
+        CompileIndex& index,
+        const NodeGraph& graph,
+        const std::vector<Edge>& signalEdges,
+        const std::vector<size_t>& graphEdgeIndices,
+        const GraphDomainResolution& domainResolution) {
+    index.signalEdgeLayouts.resize(signalEdges.size());
+    index.outgoingEdges.assign(graph.getNodes().size(), {});
+    index.incomingEdges.assign(graph.getNodes().size(), {});
+    index.firstEdgeByOutput.reserve(signalEdges.size());
+
+    for (int edgeIndex = 0; edgeIndex < static_cast<int>(signalEdges.size()); ++edgeIndex) {
+        const Edge& edge = signalEdges[static_cast<size_t>(edgeIndex)];
+        const size_t graphEdgeIndex = graphEdgeIndices[static_cast<size_t>(edgeIndex)];
+        index.signalEdgeLayouts[static_cast<size_t>(edgeIndex)] =
+                graphEdgeIndex < domainResolution.channelLayouts.size()
+                ? domainResolution.channelLayouts[graphEdgeIndex]
+                : ChannelLayout::Mono;
+        index.firstEdgeByOutput.emplace(PortKey { edge.sourceNodeId, edge.sourcePortId }, edgeIndex);
+
+        const int sourceIndex = index.nodeIndex(edge.sourceNodeId);
+        const int destinationIndex = index.nodeIndex(edge.destNodeId);
+        if (sourceIndex >= 0) {
+            index.outgoingEdges[static_cast<size_t>(sourceIndex)].push_back(edgeIndex);
+        }
+        if (destinationIndex >= 0) {
+            index.incomingEdges[static_cast<size_t>(destinationIndex)].push_back(edgeIndex);
+        }
+    }
+}
+
 int indexOfNode(const std::vector<Node>& nodes, const String& nodeId) {
     for (int i = 0; i < static_cast<int>(nodes.size()); ++i) {
         if (nodes[static_cast<size_t>(i)].id == nodeId) {
@@ -56,44 +138,31 @@ int inputPortIndex(const Node& node, const String& portId) {
 
 PortDomain outputPortDomain(
         const std::vector<Edge>& resolvedEdges,
+        const CompileIndex& index,
         const Node& node,
         const Port& port) {
     if (node.kind == NodeKind::Envelope && port.domain == PortDomain::ControlSignal) {
         return PortDomain::ControlSignal;
     }
-    for (const auto& edge : resolvedEdges) {
-        if (edge.sourceNodeId == node.id && edge.sourcePortId == port.id) {
-            return edge.domain;
-        }
-    }
-
-    return port.domain;
+    const auto found = index.firstEdgeByOutput.find({ node.id, port.id });
+    return found != index.firstEdgeByOutput.end()
+            ? resolvedEdges[static_cast<size_t>(found->second)].domain
+            : port.domain;
 }
 
 ChannelLayout outputPortChannelLayout(
-        const NodeGraph& graph,
-        const std::vector<Edge>& resolvedEdges,
-        const GraphDomainResolver& domainResolver,
-        const GraphDomainResolution& domainResolution,
+        const CompileIndex& index,
         const Node& node,
         const Port& port) {
-    for (const auto& edge : resolvedEdges) {
-        if (edge.sourceNodeId == node.id && edge.sourcePortId == port.id) {
-            return domainResolver.resolvedChannelLayoutForEdge(
-                    graph,
-                    edge,
-                    domainResolution);
-        }
-    }
-
-    return port.channelLayout;
+    const auto found = index.firstEdgeByOutput.find({ node.id, port.id });
+    return found != index.firstEdgeByOutput.end()
+            ? index.signalEdgeLayouts[static_cast<size_t>(found->second)]
+            : port.channelLayout;
 }
 
 std::vector<GraphStepOutput> buildStepOutputs(
-        const NodeGraph& graph,
         const std::vector<Edge>& resolvedEdges,
-        const GraphDomainResolver& domainResolver,
-        const GraphDomainResolution& domainResolution,
+        const CompileIndex& index,
         const Node& node) {
     std::vector<GraphStepOutput> outputs;
     outputs.reserve(node.outputs.size());
@@ -101,14 +170,8 @@ std::vector<GraphStepOutput> buildStepOutputs(
     for (const auto& port : node.outputs) {
         outputs.push_back({
                 port.id,
-                outputPortDomain(resolvedEdges, node, port),
-                outputPortChannelLayout(
-                        graph,
-                        resolvedEdges,
-                        domainResolver,
-                        domainResolution,
-                        node,
-                        port),
+                outputPortDomain(resolvedEdges, index, node, port),
+                outputPortChannelLayout(index, node, port),
                 -1
         });
     }
@@ -155,57 +218,52 @@ ExecutionCoordinate coordinateForTrait(NodeExecutionTrait trait) {
 
 std::vector<String> buildNodeOrder(
         const NodeGraph& graph,
+        const CompileIndex& index,
         std::vector<GraphCompileIssue>& issues) {
     const auto& nodes = graph.getNodes();
-    const auto& edges = graph.getEdges();
 
     std::vector<int> indegrees(nodes.size(), 0);
-    std::vector<bool> emitted(nodes.size(), false);
+    std::vector<std::vector<int>> destinations(nodes.size());
     std::vector<String> order;
     order.reserve(nodes.size());
 
-    for (const auto& edge : edges) {
-        const int sourceIndex = indexOfNode(nodes, edge.sourceNodeId);
-        const int destIndex = indexOfNode(nodes, edge.destNodeId);
+    for (const auto& edge : graph.getEdges()) {
+        const int sourceIndex = index.nodeIndex(edge.sourceNodeId);
+        const int destIndex = index.nodeIndex(edge.destNodeId);
 
         if (sourceIndex >= 0 && destIndex >= 0 && sourceIndex != destIndex) {
             ++indegrees[static_cast<size_t>(destIndex)];
+            destinations[static_cast<size_t>(sourceIndex)].push_back(destIndex);
         }
     }
 
-    while (order.size() < nodes.size()) {
-        int readyIndex = -1;
-
-        for (int i = 0; i < static_cast<int>(nodes.size()); ++i) {
-            if (!emitted[static_cast<size_t>(i)] && indegrees[static_cast<size_t>(i)] == 0) {
-                readyIndex = i;
-                break;
-            }
-        }
-
-        if (readyIndex < 0) {
-            issues.push_back({
-                    GraphCompileCode::CycleDetected,
-                    "Graph contains a cycle in processing dependencies"
-            });
-            break;
+    // the lowest-indexed ready node goes next, so the order depends only on the graph
+    std::priority_queue<int, std::vector<int>, std::greater<>> ready;
+    for (int i = 0; i < static_cast<int>(nodes.size()); ++i) {
+        if (indegrees[static_cast<size_t>(i)] == 0) {
+            ready.push(i);
         }
+    }
 
-        emitted[static_cast<size_t>(readyIndex)] = true;
+    while (!ready.empty()) {
+        const int readyIndex = ready.top();
+        ready.pop();
         order.push_back(nodes[static_cast<size_t>(readyIndex)].id);
 
-        for (const auto& edge : edges) {
-            if (edge.sourceNodeId != nodes[static_cast<size_t>(readyIndex)].id) {
-                continue;
-            }
-
-            const int destIndex = indexOfNode(nodes, edge.destNodeId);
-            if (destIndex >= 0 && destIndex != readyIndex) {
-                --indegrees[static_cast<size_t>(destIndex)];
+        for (const int destIndex : destinations[static_cast<size_t>(readyIndex)]) {
+            if (--indegrees[static_cast<size_t>(destIndex)] == 0) {
+                ready.push(destIndex);
             }
         }
     }
 
+    if (order.size() < nodes.size()) {
+        issues.push_back({
+                GraphCompileCode::CycleDetected,
+                "Graph contains a cycle in processing dependencies"
+        });
+    }
+
     return order;
 }
 
@@ -213,14 +271,13 @@ std::vector<GraphExecutionStep> buildExecutionSteps(
         const NodeGraph& graph,
         const std::vector<String>& nodeOrder,
         const std::vector<Edge>& resolvedEdges,
-        const GraphDomainResolver& domainResolver,
-        const GraphDomainResolution& domainResolution,
+        const CompileIndex& index,
         const NodeModuleRegistry& moduleRegistry) {
     std::vector<GraphExecutionStep> steps;
     steps.reserve(nodeOrder.size());
 
     for (const auto& nodeId : nodeOrder) {
-        const int nodeIndex = indexOfNode(graph.getNodes(), nodeId);
+        const int nodeIndex = index.nodeIndex(nodeId);
 
         if (nodeIndex < 0) {
             continue;
@@ -232,9 +289,7 @@ std::vector<GraphExecutionStep> buildExecutionSteps(
             continue;
         }
         if (node.kind == NodeKind::ModulationTriple
-                && std::none_of(resolvedEdges.begin(), resolvedEdges.end(), [&](const Edge& edge) {
-                    return edge.sourceNodeId == node.id;
-                })
+                && index.outgoingEdges[static_cast<size_t>(nodeIndex)].empty()
                 && std::none_of(node.outputs.begin(), node.outputs.end(), [&](const Port& port) {
                     return graph.findSignalProbeForSource(node.id, port.id) != nullptr;
                 })) {
@@ -242,11 +297,8 @@ std::vector<GraphExecutionStep> buildExecutionSteps(
         }
         std::vector<GraphStepInput> inputs;
 
-        for (const auto& edge : resolvedEdges) {
-            if (edge.destNodeId != node.id) {
-                continue;
-            }
-
+        for (const int edgeIndex : index.incomingEdges[static_cast<size_t>(nodeIndex)]) {
+            const Edge& edge = resolvedEdges[static_cast<size_t>(edgeIndex)];
             inputs.push_back({
                     edge.sourceNodeId,
                     edge.sourcePortId,
@@ -256,10 +308,7 @@ std::vector<GraphExecutionStep> buildExecutionSteps(
                     -1,
                     -1,
                     edge.domain,
-                    domainResolver.resolvedChannelLayoutForEdge(
-                            graph,
-                            edge,
-                            domainResolution)
+                    index.signalEdgeLayouts[static_cast<size_t>(edgeIndex)]
             });
         }
 
@@ -291,40 +340,39 @@ std::vector<GraphExecutionStep> buildExecutionSteps(
                 node.model,
                 {},
                 std::move(inputs),
-                buildStepOutputs(
-                        graph,
-                        resolvedEdges,
-                        domainResolver,
-                        domainResolution,
-                        node)
+                buildStepOutputs(resolvedEdges, index, node)
         });
     }
 
     return steps;
 }
 
-int bufferIndexFor(
-        const std::vector<GraphBufferPlan>& buffers,
-        const String& nodeId,
-        const String& portId) {
+PortIndex indexBuffers(const std::vector<GraphBufferPlan>& buffers) {
+    PortIndex index;
+    index.reserve(buffers.size());
     for (int i = 0; i < (int) buffers.size(); ++i) {
-        if (buffers[(size_t) i].sourceNodeId == nodeId
-                && buffers[(size_t) i].sourcePortId == portId) {
-            return i;
-        }
+        index.emplace(PortKey { buffers[(size_t) i].sourceNodeId, buffers[(size_t) i].sourcePortId }, i);
     }
+    return index;
+}
 
-    return -1;
+int bufferIndexFor(const PortIndex& buffers, const String& nodeId, const String& portId) {
+    const auto found = buffers.find({ nodeId, portId });
+    return found != buffers.end() ? found->second : -1;
 }
 
-int stepIndexFor(const GraphExecutionPlan& plan, const String& nodeId) {
-    for (int i = 0; i < (int) plan.steps.size(); ++i) {
-        if (plan.steps[(size_t) i].nodeId == nodeId) {
-            return i;
-        }
-    }
+int stepIndexFor(const IdIndex& steps, const String& nodeId) {
+    const auto found = steps.find(nodeId);
+    return found != steps.end() ? found->second : -1;
+}
 
-    return -1;
+IdIndex indexSteps(const std::vector<GraphExecutionStep>& steps) {
+    IdIndex index;
+    index.reserve(steps.size());
+    for (int i = 0; i < (int) steps.size(); ++i) {
+        index.emplace(steps[(size_t) i].nodeId, i);
+    }
+    return index;
 }
 
 int outputIndexFor(const GraphExecutionStep& step, const String& portId) {
@@ -338,6 +386,16 @@ int outputIndexFor(const GraphExecutionStep& step, const String& portId) {
 }
 
 void compileRouting(GraphExecutionPlan& plan) {
+    const PortIndex buffers = indexBuffers(plan.buffers);
+    const IdIndex steps = indexSteps(plan.steps);
+    std::vector<std::vector<size_t>> attachmentsByStep(plan.steps.size());
+    for (size_t attachmentIndex = 0; attachmentIndex < plan.attachments.size(); ++attachmentIndex) {
+        const int stepIndex = stepIndexFor(steps, plan.attachments[attachmentIndex].destNodeId);
+        if (stepIndex >= 0) {
+            attachmentsByStep[(size_t) stepIndex].push_back(attachmentIndex);
+        }
+    }
+
     for (int stepIndex = 0; stepIndex < (int) plan.steps.size(); ++stepIndex) {
         auto& step = plan.steps[(size_t) stepIndex];
         plan.maximumOutputCount = std::max(plan.maximumOutputCount, step.outputs.size());
@@ -349,10 +407,10 @@ void compileRouting(GraphExecutionPlan& plan) {
                         (size_t) input.destPortIndex + 1);
             }
             input.sourceBufferIndex = bufferIndexFor(
-                    plan.buffers,
+                    buffers,
                     input.sourceNodeId,
                     input.sourcePortId);
-            input.sourceStepIndex = stepIndexFor(plan, input.sourceNodeId);
+            input.sourceStepIndex = stepIndexFor(steps, input.sourceNodeId);
             if (input.sourceStepIndex >= 0) {
                 input.sourceOutputIndex = outputIndexFor(
                         plan.steps[(size_t) input.sourceStepIndex],
@@ -364,7 +422,7 @@ void compileRouting(GraphExecutionPlan& plan) {
         }
 
         for (auto& output : step.outputs) {
-            output.bufferIndex = bufferIndexFor(plan.buffers, step.nodeId, output.portId);
+            output.bufferIndex = bufferIndexFor(buffers, step.nodeId, output.portId);
             if (output.bufferIndex >= 0) {
                 auto& buffer = plan.buffers[(size_t) output.bufferIndex];
                 buffer.firstProducerStep = stepIndex;
@@ -372,13 +430,10 @@ void compileRouting(GraphExecutionPlan& plan) {
             }
         }
 
-        for (const auto& attachment : plan.attachments) {
-            if (attachment.destNodeId != step.nodeId) {
-                continue;
-            }
-
+        for (const size_t attachmentIndex : attachmentsByStep[(size_t) stepIndex]) {
+            const auto& attachment = plan.attachments[attachmentIndex];
             const int sourceBufferIndex = bufferIndexFor(
-                    plan.buffers,
+                    buffers,
                     attachment.sourceNodeId,
                     attachment.sourcePortId);
             step.attachments.push_back({
@@ -398,6 +453,61 @@ void compileRouting(GraphExecutionPlan& plan) {
     }
 }
 
+/*
+ * Colors the buffer lifetimes onto as few payload slots as the interval graph
+ * allows. A buffer is live from its producing step through its last consumer,
+ * inclusive, so a step never writes an output into the slot it is reading.
+ * Default modulation buffers are rendered before the first step, and buffers
+ * without a producer step are never written, so both start live. The output
+ * sink's inputs stay live to the end because the realtime result is a view
+ * into that slot. Diagnostics and probes copy each output as its step runs
+ * and need nothing held here.
+ */
+void compileBufferSlots(GraphExecutionPlan& plan) {
+    const int endOfPlan = (int) plan.steps.size();
+    std::vector<int> firstLive(plan.buffers.size());
+    std::vector<int> lastLive(plan.buffers.size());
+    for (size_t bufferIndex = 0; bufferIndex < plan.buffers.size(); ++bufferIndex) {
+        const auto& buffer = plan.buffers[bufferIndex];
+        firstLive[bufferIndex] = buffer.firstProducerStep;
+        lastLive[bufferIndex] = buffer.firstProducerStep < 0
+                && buffer.defaultModulationSlot == DefaultModulationSlot::None
+                ? endOfPlan
+                : std::max(buffer.lastConsumerStep, firstLive[bufferIndex]);
+    }
+    for (const auto& step : plan.steps) {
+        if (!step.outputSink) {
+            continue;
+        }
+        for (const auto& input : step.inputs) {
+            if (input.sourceBufferIndex >= 0) {
+                lastLive[(size_t) input.sourceBufferIndex] = endOfPlan;
+            }
+        }
+    }
+
+    std::vector<size_t> byStart(plan.buffers.size());
+    std::iota(byStart.begin(), byStart.end(), (size_t) 0);
+    std::stable_sort(byStart.begin(), byStart.end(), [&](size_t left, size_t right) {
+        return firstLive[left] < firstLive[right];
+    });
+
+    // Taking buffers in start order, any slot free before the start will do.
+    std::vector<int> slotLiveUntil;
+    for (const size_t bufferIndex : byStart) {
+        auto freeSlot = std::find_if(slotLiveUntil.begin(), slotLiveUntil.end(), [&](int liveUntil) {
+            return liveUntil < firstLive[bufferIndex];
+        });
+        if (freeSlot == slotLiveUntil.end()) {
+            freeSlot = slotLiveUntil.insert(slotLiveUntil.end(), lastLive[bufferIndex]);
+        } else {
+            *freeSlot = lastLive[bufferIndex];
+        }
+        plan.buffers[bufferIndex].slot = (int) std::distance(slotLiveUntil.begin(), freeSlot);
+    }
+    plan.bufferSlotCount = slotLiveUntil.size();
+}
+
 int dependencyNodeIndex(const GraphDependencyIndex& index, const String& nodeId) {
     const auto found = index.nodeIndexById.find(nodeId);
     return found != index.nodeIndexById.end() ? found->second : -1;
@@ -444,8 +554,7 @@ void compileDependencyIndex(GraphExecutionPlan& plan) {
 std::vector<GraphBufferPlan> buildBufferPlan(
         const NodeGraph& graph,
         const std::vector<Edge>& resolvedEdges,
-        const GraphDomainResolver& domainResolver,
-        const GraphDomainResolution& domainResolution) {
+        const CompileIndex& index) {
     std::vector<GraphBufferPlan> buffers;
 
     for (const auto& node : graph.getNodes()) {
@@ -454,13 +563,11 @@ std::vector<GraphBufferPlan> buildBufferPlan(
                 continue;
             }
             if (node.kind == NodeKind::ModulationTriple
-                    && std::none_of(resolvedEdges.begin(), resolvedEdges.end(), [&](const Edge& edge) {
-                        return edge.sourceNodeId == node.id && edge.sourcePortId == port.id;
-                    })
+                    && index.firstEdgeByOutput.count({ node.id, port.id }) == 0
                     && graph.findSignalProbeForSource(node.id, port.id) == nullptr) {
                 continue;
             }
-            const PortDomain domain = outputPortDomain(resolvedEdges, node, port);
+            const PortDomain domain = outputPortDomain(resolvedEdges, index, node, port);
             if (domain == PortDomain::DomainContext) {
                 continue;
             }
@@ -470,13 +577,7 @@ std::vector<GraphBufferPlan> buildBufferPlan(
                     node.id,
                     port.id,
                     domain,
-                    outputPortChannelLayout(
-                            graph,
-                            resolvedEdges,
-                            domainResolver,
-                            domainResolution,
-                            node,
-                            port)
+                    outputPortChannelLayout(index, node, port)
             });
         }
     }
@@ -607,7 +708,8 @@ bool mergeVoiceContexts(std::vector<String>& destination, const std::vector<Stri
 
 VoiceContextAssignments assignVoiceContexts(
         const NodeGraph& graph,
-        const GraphExecutionPlan& plan) {
+        const GraphExecutionPlan& plan,
+        const CompileIndex& index) {
     VoiceContextAssignments assignments(graph.getNodes().size());
     for (size_t nodeIndex = 0; nodeIndex < graph.getNodes().size(); ++nodeIndex) {
         const Node& node = graph.getNodes()[nodeIndex];
@@ -616,42 +718,56 @@ VoiceContextAssignments assignVoiceContexts(
         }
     }
 
+    // node indices for the edges contexts travel along, looked up once rather than per pass
+    struct Link {
+        size_t source;
+        size_t destination;
+        bool envelopeSource;
+    };
+    std::vector<Link> signalLinks;
+    std::vector<Link> scratchLinks;
+    signalLinks.reserve(plan.signalEdges.size());
+    for (const auto& edge : plan.signalEdges) {
+        const int sourceIndex = index.nodeIndex(edge.sourceNodeId);
+        const int destinationIndex = index.nodeIndex(edge.destNodeId);
+        if (sourceIndex >= 0 && destinationIndex >= 0) {
+            signalLinks.push_back({
+                    (size_t) sourceIndex,
+                    (size_t) destinationIndex,
+                    graph.getNodes()[(size_t) sourceIndex].kind == NodeKind::Envelope
+            });
+        }
+    }
+    for (const auto& attachment : plan.attachments) {
+        if (attachment.attachmentType != AttachmentType::ScratchEnvelope) {
+            continue;
+        }
+        const int sourceIndex = index.nodeIndex(attachment.sourceNodeId);
+        const int destinationIndex = index.nodeIndex(attachment.destNodeId);
+        if (sourceIndex >= 0 && destinationIndex >= 0) {
+            scratchLinks.push_back({ (size_t) sourceIndex, (size_t) destinationIndex, false });
+        }
+    }
+
     bool changed = true;
     while (changed) {
         changed = false;
-        for (const auto& edge : plan.signalEdges) {
-            const int sourceIndex = indexOfNode(graph.getNodes(), edge.sourceNodeId);
-            const int destinationIndex = indexOfNode(graph.getNodes(), edge.destNodeId);
-            if (sourceIndex < 0 || destinationIndex < 0) {
-                continue;
-            }
+        for (const auto& link : signalLinks) {
             changed = mergeVoiceContexts(
-                    assignments[(size_t) destinationIndex],
-                    assignments[(size_t) sourceIndex]) || changed;
+                    assignments[link.destination],
+                    assignments[link.source]) || changed;
 
-            const Node& source = graph.getNodes()[(size_t) sourceIndex];
-            if (source.kind == NodeKind::Envelope) {
+            if (link.envelopeSource) {
                 changed = mergeVoiceContexts(
-                        assignments[(size_t) sourceIndex],
-                        assignments[(size_t) destinationIndex]) || changed;
+                        assignments[link.source],
+                        assignments[link.destination]) || changed;
             }
         }
 
-        for (const auto& attachment : plan.attachments) {
-            if (attachment.attachmentType != AttachmentType::ScratchEnvelope) {
-                continue;
-            }
-            const int sourceIndex = indexOfNode(
-                    graph.getNodes(),
-                    attachment.sourceNodeId);
-            const int destinationIndex = indexOfNode(
-                    graph.getNodes(),
-                    attachment.destNodeId);
-            if (sourceIndex >= 0 && destinationIndex >= 0) {
-                changed = mergeVoiceContexts(
-                        assignments[(size_t) sourceIndex],
-                        assignments[(size_t) destinationIndex]) || changed;
-            }
+        for (const auto& link : scratchLinks) {
+            changed = mergeVoiceContexts(
+                    assignments[link.source],
+                    assignments[link.destination]) || changed;
         }
     }
 
@@ -659,11 +775,9 @@ VoiceContextAssignments assignVoiceContexts(
 }
 
 const CompiledVoiceContext* voiceContextForNode(
-        const NodeGraph& graph,
         const GraphExecutionPlan& plan,
         const VoiceContextAssignments& assignments,
-        const Node& node) {
-    const int nodeIndex = indexOfNode(graph.getNodes(), node.id);
+        int nodeIndex) {
     if (nodeIndex < 0 || assignments[(size_t) nodeIndex].size() != 1) {
         return nullptr;
     }
@@ -682,18 +796,20 @@ const CompiledVoiceContext* voiceContextForNode(
 
 void compileDefaultModulationInputs(
         const NodeGraph& graph,
-        GraphExecutionPlan& plan) {
-    const VoiceContextAssignments assignments = assignVoiceContexts(graph, plan);
+        GraphExecutionPlan& plan,
+        const CompileIndex& index) {
+    const VoiceContextAssignments assignments = assignVoiceContexts(graph, plan, index);
+    PortIndex buffers = indexBuffers(plan.buffers);
     for (auto& step : plan.steps) {
-        const Node* node = findNode(graph, step.nodeId);
-        if (node == nullptr) {
+        const int nodeIndex = index.nodeIndex(step.nodeId);
+        if (nodeIndex < 0) {
             continue;
         }
+        const Node* node = &graph.getNodes()[(size_t) nodeIndex];
         const CompiledVoiceContext* context = voiceContextForNode(
-                graph,
                 plan,
                 assignments,
-                *node);
+                nodeIndex);
         if (context == nullptr) {
             continue;
         }
@@ -702,25 +818,19 @@ void compileDefaultModulationInputs(
             if (port.defaultModulationSlot == DefaultModulationSlot::None) {
                 continue;
             }
+            // the step's inputs are still just its signal edges, plus defaults for earlier ports
             const bool explicitInput = std::any_of(
-                    plan.signalEdges.begin(),
-                    plan.signalEdges.end(),
-                    [&](const Edge& edge) {
-                        return edge.destNodeId == node->id && edge.destPortId == port.id;
+                    step.inputs.begin(),
+                    step.inputs.end(),
+                    [&](const GraphStepInput& input) {
+                        return input.destPortId == port.id;
                     });
             if (explicitInput) {
                 continue;
             }
             const String sourcePort = "default."
                     + String((int) port.defaultModulationSlot);
-            const bool bufferExists = std::any_of(
-                    plan.buffers.begin(),
-                    plan.buffers.end(),
-                    [&](const GraphBufferPlan& buffer) {
-                        return buffer.sourceNodeId == context->nodeId
-                                && buffer.sourcePortId == sourcePort;
-                    });
-            if (!bufferExists) {
+            if (buffers.emplace(PortKey { context->nodeId, sourcePort }, (int) plan.buffers.size()).second) {
                 plan.buffers.push_back({
                         context->nodeId + "." + sourcePort,
                         context->nodeId,
@@ -792,8 +902,35 @@ int effectiveLaneCount(
     return unison != nullptr && !unison->isEnabled() ? 1 : found->lanes.order;
 }
 
+/*
+ * The plan's signal edges between steps, by step index, in edge order, for
+ * the region passes to walk instead of the whole edge list.
+ */
+struct StepLinks {
+    IdIndex stepIndexById;
+    std::vector<std::vector<int>> consumers;
+    std::vector<std::vector<int>> producers;
+};
+
+StepLinks linkSteps(const GraphExecutionPlan& plan) {
+    StepLinks links;
+    links.stepIndexById = indexSteps(plan.steps);
+    links.consumers.resize(plan.steps.size());
+    links.producers.resize(plan.steps.size());
+    for (const auto& edge : plan.signalEdges) {
+        const int sourceIndex = stepIndexFor(links.stepIndexById, edge.sourceNodeId);
+        const int destinationIndex = stepIndexFor(links.stepIndexById, edge.destNodeId);
+        if (sourceIndex >= 0 && destinationIndex >= 0) {
+            links.consumers[(size_t) sourceIndex].push_back(destinationIndex);
+            links.producers[(size_t) destinationIndex].push_back(sourceIndex);
+        }
+    }
+    return links;
+}
+
 bool appendDownstreamRegionOperations(
         const GraphExecutionPlan& plan,
+        const StepLinks& links,
         const std::vector<bool>& assigned,
         OscillatorRegionPlan& region,
         std::vector<GraphCompileIssue>& issues) {
@@ -803,13 +940,8 @@ bool appendDownstreamRegionOperations(
         if (source.executionTrait == NodeExecutionTrait::OscillatorMaterializer) {
             continue;
         }
-        for (const auto& edge : plan.signalEdges) {
-            if (edge.sourceNodeId != source.nodeId) {
-                continue;
-            }
-            const int destinationIndex = stepIndexFor(plan, edge.destNodeId);
-            if (destinationIndex < 0
-                    || !regionOperation(plan.steps[(size_t) destinationIndex].executionTrait)
+        for (const int destinationIndex : links.consumers[(size_t) sourceStepIndex]) {
+            if (!regionOperation(plan.steps[(size_t) destinationIndex].executionTrait)
                     || containsStep(region.stepIndices, destinationIndex)) {
                 continue;
             }
@@ -819,7 +951,7 @@ bool appendDownstreamRegionOperations(
                     destination.inputs.end(),
                     [&](const GraphStepInput& input) {
                         const int inputStepIndex = stepIndexFor(
-                                plan,
+                                links.stepIndexById,
                                 input.sourceNodeId);
                         return inputStepIndex >= 0
                                 && !containsStep(
@@ -834,7 +966,7 @@ bool appendDownstreamRegionOperations(
             if (assigned[(size_t) destinationIndex]) {
                 issues.push_back({
                         GraphCompileCode::AmbiguousVoiceContext,
-                        "Oscillator operation '" + edge.destNodeId
+                        "Oscillator operation '" + destination.nodeId
                                 + "' is reached by multiple Voice Contexts"
                 });
                 return false;
@@ -845,20 +977,20 @@ bool appendDownstreamRegionOperations(
     return true;
 }
 
+// the closure is the same whatever order the producers are found in
 void appendUpstreamRegionOperations(
         const GraphExecutionPlan& plan,
+        const StepLinks& links,
         const String& contextNodeId,
         OscillatorRegionPlan& region) {
-    bool expanded = true;
-    while (expanded) {
-        expanded = false;
-        for (const auto& edge : plan.signalEdges) {
-            const int destinationIndex = stepIndexFor(plan, edge.destNodeId);
-            const int sourceIndex = stepIndexFor(plan, edge.sourceNodeId);
-            if (destinationIndex < 0
-                    || sourceIndex < 0
-                    || !containsStep(region.stepIndices, destinationIndex)
-                    || containsStep(region.stepIndices, sourceIndex)
+    std::vector<bool> inRegion(plan.steps.size());
+    for (const int stepIndex : region.stepIndices) {
+        inRegion[(size_t) stepIndex] = true;
+    }
+
+    for (size_t cursor = 0; cursor < region.stepIndices.size(); ++cursor) {
+        for (const int sourceIndex : links.producers[(size_t) region.stepIndices[cursor]]) {
+            if (inRegion[(size_t) sourceIndex]
                     || !regionOperation(plan.steps[(size_t) sourceIndex].executionTrait)
                     || plan.steps[(size_t) sourceIndex].executionTrait
                             == NodeExecutionTrait::OscillatorMaterializer) {
@@ -868,8 +1000,8 @@ void appendUpstreamRegionOperations(
             if (sourceContext.isNotEmpty() && sourceContext != contextNodeId) {
                 continue;
             }
+            inRegion[(size_t) sourceIndex] = true;
             region.stepIndices.push_back(sourceIndex);
-            expanded = true;
         }
     }
 }
@@ -889,18 +1021,17 @@ bool hasSpectralExecution(
 }
 
 int terminalRegionStep(
-        const GraphExecutionPlan& plan,
+        const StepLinks& links,
         const OscillatorRegionPlan& region,
         int fallbackStep) {
     int terminalStep = -1;
     for (const int stepIndex : region.stepIndices) {
-        const auto& step = plan.steps[(size_t) stepIndex];
+        const auto& consumers = links.consumers[(size_t) stepIndex];
         const bool hasRegionConsumer = std::any_of(
-                plan.signalEdges.begin(),
-                plan.signalEdges.end(),
-                [&](const Edge& edge) {
-                    return edge.sourceNodeId == step.nodeId
-                            && containsStep(region.stepIndices, stepIndexFor(plan, edge.destNodeId));
+                consumers.begin(),
+                consumers.end(),
+                [&](int consumer) {
+                    return containsStep(region.stepIndices, consumer);
                 });
         if (hasRegionConsumer) {
             continue;
@@ -915,6 +1046,7 @@ int terminalRegionStep(
 
 void assignOscillatorRegion(
         GraphExecutionPlan& plan,
+        const StepLinks& links,
         int rootIndex,
         std::vector<bool>& assigned,
         OscillatorRegionPlan& region) {
@@ -926,7 +1058,7 @@ void assignOscillatorRegion(
     region.outputLatencySamples = 0;
     region.tailPolicy = OscillatorTailPolicy::EnvelopeOwned;
     region.outputTailSamples = 0;
-    region.materializationStepIndex = terminalRegionStep(plan, region, rootIndex);
+    region.materializationStepIndex = terminalRegionStep(links, region, rootIndex);
     const int regionIndex = (int) plan.oscillatorRegions.size();
 
     for (const int stepIndex : region.stepIndices) {
@@ -953,6 +1085,7 @@ void assignOscillatorRegion(
 void compileOscillatorRegions(
         GraphExecutionPlan& plan,
         std::vector<GraphCompileIssue>& issues) {
+    const StepLinks links = linkSteps(plan);
     std::vector<bool> assigned(plan.steps.size());
     for (int rootIndex = 0; rootIndex < (int) plan.steps.size(); ++rootIndex) {
         auto& root = plan.steps[(size_t) rootIndex];
@@ -969,11 +1102,11 @@ void compileOscillatorRegions(
         region.laneCount = effectiveLaneCount(plan.voiceContexts, contextNodeId);
         region.stepIndices.push_back(rootIndex);
 
-        if (!appendDownstreamRegionOperations(plan, assigned, region, issues)) {
+        if (!appendDownstreamRegionOperations(plan, links, assigned, region, issues)) {
             return;
         }
-        appendUpstreamRegionOperations(plan, contextNodeId, region);
-        assignOscillatorRegion(plan, rootIndex, assigned, region);
+        appendUpstreamRegionOperations(plan, links, contextNodeId, region);
+        assignOscillatorRegion(plan, links, rootIndex, assigned, region);
         if (region.strategy == OscillatorExecutionStrategy::SharedSpectralFrame) {
             const auto& materializer = plan.steps[
                     (size_t) region.materializationStepIndex];
@@ -999,33 +1132,51 @@ void compileOscillatorRegions(
     }
 }
 
+/*
+ * What a node's configuration and dependencies are built from besides its own
+ * parameters: the edges in and out of it, summed so the order they were added
+ * in doesn't matter.
+ */
 }
 
 bool GraphCompileResult::succeeded() const {
     return validationIssues.empty() && compileIssues.empty();
 }
 
+/*
+ * Validation, domains, ordering, buffers, voice contexts and oscillator
+ * regions are planned for the whole graph every time: domains and contexts
+ * propagate along edges, so an edit can reach any of them. Each pass looks
+ * nodes, ports and edges up through CompileIndex, so the whole compile stays
+ * close to linear in the graph.
+ */
 GraphCompileResult GraphCompiler::compile(const NodeGraph& graph) const {
     GraphCompileResult result;
-    result.validationIssues = validator.validate(graph);
+    const GraphDomainResolution domainResolution = domainResolver.resolve(graph);
+    result.validationIssues = validator.validate(graph, domainResolution);
 
     if (!result.validationIssues.empty()) {
         return result;
     }
 
-    result.plan.nodeOrder = buildNodeOrder(graph, result.compileIssues);
+    CompileIndex index;
+    index.nodeIndexById = indexNodes(graph.getNodes());
+    result.plan.nodeOrder = buildNodeOrder(graph, index, result.compileIssues);
 
     if (result.compileIssues.empty()) {
-        const GraphDomainResolution domainResolution = domainResolver.resolve(graph);
+        std::vector<size_t> graphEdgeIndices;
         result.plan.signalEdges = domainResolver.resolveSignalEdges(
                 graph,
                 result.plan.nodeOrder,
-                domainResolution);
-        result.plan.buffers = buildBufferPlan(
+                domainResolution,
+                graphEdgeIndices);
+        indexSignalEdges(
+                index,
                 graph,
                 result.plan.signalEdges,
-                domainResolver,
+                graphEdgeIndices,
                 domainResolution);
+        result.plan.buffers = buildBufferPlan(graph, result.plan.signalEdges, index);
 
         for (const auto& edge : graph.getEdges()) {
             if (edge.isProcessingAttachment()) {
@@ -1044,16 +1195,17 @@ GraphCompileResult GraphCompiler::compile(const NodeGraph& graph) const {
                 graph,
                 result.plan.nodeOrder,
                 result.plan.signalEdges,
-                domainResolver,
-                domainResolution,
+                index,
                 moduleRegistry);
-        compileDefaultModulationInputs(graph, result.plan);
+        compileDefaultModulationInputs(graph, result.plan, index);
         compileOscillatorRegions(result.plan, result.compileIssues);
         if (!result.compileIssues.empty()) {
             result.plan = {};
             return result;
         }
         compileRouting(result.plan);
+        compileBufferSlots(result.plan);
+
         compileDependencyIndex(result.plan);
         refreshSignalProbes(graph, result.plan);
         publishConfigurations(graph, result.plan.steps);
@@ -1106,16 +1258,8 @@ void GraphCompiler::publishConfigurations(
                 spec,
                 &graph,
                 step.nodeId);
-        auto found = std::find_if(configurations.begin(), configurations.end(), [&](const auto& entry) {
-            return entry.nodeId == step.nodeId;
-        });
-
-        if (found == configurations.end()) {
-            configurations.push_back({ step.nodeId, {} });
-            found = configurations.end() - 1;
-        }
 
-        step.configuration = found->publisher.publish(key, [&]() {
+        step.configuration = configurations[step.nodeId].publish(key, [&]() {
             return configurationFactory.create(
                     step.audioRole,
                     step.parameters,
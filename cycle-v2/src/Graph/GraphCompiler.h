@@ -87,6 +87,8 @@ struct GraphBufferPlan {
     int lastConsumerStep { -1 };
     DefaultModulationSlot defaultModulationSlot { DefaultModulationSlot::None };
     std::shared_ptr<const INodeDspConfiguration> defaultModulation;
+    // Physical payload slot; buffers whose lifetimes don't overlap share one.
+    int slot { -1 };
 };
 
 struct GraphDependencyIndex {
@@ -170,6 +172,7 @@ struct GraphExecutionPlan {
     std::vector<String> nodeOrder;
     std::vector<GraphExecutionStep> steps;
     std::vector<GraphBufferPlan> buffers;
+    size_t bufferSlotCount {};
     std::vector<Edge> signalEdges;
     std::vector<Edge> attachments;
     std::vector<Edge> configurationAttachments;
@@ -193,11 +196,6 @@ public:
     void refreshSignalProbes(const NodeGraph& graph, GraphExecutionPlan& plan) const;
 
 private:
-    struct ConfigurationEntry {
-        String nodeId;
-        NodeConfigurationPublisher publisher;
-    };
-
     void publishConfigurations(
             const NodeGraph& graph,
             std::vector<GraphExecutionStep>& steps) const;
@@ -206,7 +204,8 @@ private:
     GraphValidator validator;
     NodeModuleRegistry moduleRegistry;
     NodeDspConfigurationFactory configurationFactory;
-    mutable std::vector<ConfigurationEntry> configurations;
+    mutable std::unordered_map<String, NodeConfigurationPublisher, GraphDependencyIndex::StringHash>
+            configurations;
 };
 
 }
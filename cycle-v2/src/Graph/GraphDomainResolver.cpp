@@ -449,18 +449,42 @@ std::vector<Edge> GraphDomainResolver::resolveSignalEdges(
         const NodeGraph& graph,
         const std::vector<String>& nodeOrder,
         const GraphDomainResolution& resolution) const {
-    std::vector<Edge> resolvedEdges;
+    std::vector<size_t> graphEdgeIndices;
+    return resolveSignalEdges(graph, nodeOrder, resolution, graphEdgeIndices);
+}
 
-    for (const auto& nodeId : nodeOrder) {
-        for (size_t edgeIndex = 0; edgeIndex < graph.getEdges().size(); ++edgeIndex) {
-            const Edge& edge = graph.getEdges()[edgeIndex];
-            if (edge.isAttachment() || edge.sourceNodeId != nodeId) {
-                continue;
-            }
+std::vector<Edge> GraphDomainResolver::resolveSignalEdges(
+        const NodeGraph& graph,
+        const std::vector<String>& nodeOrder,
+        const GraphDomainResolution& resolution,
+        std::vector<size_t>& graphEdgeIndices) const {
+    const auto& edges = graph.getEdges();
+    std::unordered_map<String, size_t, StringHash> orderIndexById;
+    orderIndexById.reserve(nodeOrder.size());
+    for (size_t orderIndex = 0; orderIndex < nodeOrder.size(); ++orderIndex) {
+        orderIndexById.emplace(nodeOrder[orderIndex], orderIndex);
+    }
 
-            Edge resolved = edge;
+    // grouped by source in node order, each group keeping the graph's edge order
+    std::vector<std::vector<size_t>> edgesBySource(nodeOrder.size());
+    for (size_t edgeIndex = 0; edgeIndex < edges.size(); ++edgeIndex) {
+        if (edges[edgeIndex].isAttachment()) {
+            continue;
+        }
+        const auto source = orderIndexById.find(edges[edgeIndex].sourceNodeId);
+        if (source != orderIndexById.end()) {
+            edgesBySource[source->second].push_back(edgeIndex);
+        }
+    }
+
+    std::vector<Edge> resolvedEdges;
+    graphEdgeIndices.clear();
+    for (const auto& sourceEdges : edgesBySource) {
+        for (const size_t edgeIndex : sourceEdges) {
+            Edge resolved = edges[edgeIndex];
             resolved.domain = resolution.domains[edgeIndex];
             resolvedEdges.push_back(std::move(resolved));
+            graphEdgeIndices.push_back(edgeIndex);
         }
     }
 
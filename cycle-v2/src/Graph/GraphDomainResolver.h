@@ -32,6 +32,12 @@ public:
             const NodeGraph& graph,
             const std::vector<String>& nodeOrder,
             const GraphDomainResolution& resolution) const;
+    // also fills the graph edge index each resolved edge came from
+    std::vector<Edge> resolveSignalEdges(
+            const NodeGraph& graph,
+            const std::vector<String>& nodeOrder,
+            const GraphDomainResolution& resolution,
+            std::vector<size_t>& graphEdgeIndices) const;
 
     static bool isConcreteOperationDomain(PortDomain domain);
     static bool isConcreteSignalDomain(PortDomain domain);
@@ -90,9 +90,14 @@ private:
 };
 
 std::vector<GraphValidationIssue> GraphValidator::validate(const NodeGraph& graph) const {
+    return validate(graph, domainResolver.resolve(graph));
+}
+
+std::vector<GraphValidationIssue> GraphValidator::validate(
+        const NodeGraph& graph,
+        const GraphDomainResolution& resolution) const {
     std::vector<GraphValidationIssue> issues;
     EdgeIssueReporter reporter(issues);
-    const GraphDomainResolution resolution = domainResolver.resolve(graph);
 
     for (size_t edgeIndex = 0; edgeIndex < graph.getEdges().size(); ++edgeIndex) {
         validateEdge(
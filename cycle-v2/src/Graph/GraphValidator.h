@@ -33,6 +33,10 @@ struct GraphValidationIssue {
 class GraphValidator {
 public:
     std::vector<GraphValidationIssue> validate(const NodeGraph& graph) const;
+    // for callers that have already resolved the graph's domains
+    std::vector<GraphValidationIssue> validate(
+            const NodeGraph& graph,
+            const GraphDomainResolution& resolution) const;
     bool isValid(const NodeGraph& graph) const;
     bool edgeHasValidationIssue(const NodeGraph& graph, const Edge& edge) const;
     GraphValidationIssue validationIssueForEdge(const NodeGraph& graph, const Edge& edge) const;
@@ -290,6 +290,8 @@ void ReverbSignalProcessor::beginChannelTraversalGrid(
     pendingWet = {};
     for (size_t channel = 0; channel < convolvers.size(); ++channel) {
         convolvers[channel].beginTraversal();
+        // traversals render ahead of playback, so late tail blocks are waited for
+        convolvers[channel].traversal().setWaitsForLateJobs(true);
         prepareConvolver(channel, convolvers[channel].traversal(), rows);
         convolvers[channel].markTraversalPrepared(rows);
     }
@@ -348,6 +350,7 @@ void ReverbSignalProcessor::prepareTraversalConvolver(size_t rowCount) {
                 || !convolvers[channel].traversalNeedsPreparation(rowCount)) {
             continue;
         }
+        convolvers[channel].traversal().setWaitsForLateJobs(true);
         prepareConvolver(channel, convolvers[channel].traversal(), rowCount);
         convolvers[channel].markTraversalPrepared(rowCount);
     }
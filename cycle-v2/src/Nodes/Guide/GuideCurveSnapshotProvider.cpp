@@ -101,6 +101,12 @@ void GuideCurveSnapshotProvider::sampleDownAddNoise(
             context);
 }
 
+bool GuideCurveSnapshotProvider::addsNoise() const {
+    return std::any_of(guides.begin(), guides.end(), [](const GuideSnapshot& guide) {
+        return guide.parameters.noiseLevel > 0.f;
+    });
+}
+
 Buffer<Float32> GuideCurveSnapshotProvider::getTable(int guideIndex) {
     GuideSnapshot* guide = guideAt(guideIndex);
     return guide != nullptr
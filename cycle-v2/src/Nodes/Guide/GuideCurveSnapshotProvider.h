@@ -27,6 +27,8 @@ public:
     int getTableDensity(int guideIndex) override;
 
     int size() const { return (int) guides.size(); }
+    // whether the noise seed changes any table value, i.e. some guide has noise
+    bool addsNoise() const;
     static uint32_t visualizationSeed(PortDomain domain);
 
 private:
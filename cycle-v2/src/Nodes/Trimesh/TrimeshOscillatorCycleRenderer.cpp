@@ -22,13 +22,20 @@ bool TrimeshOscillatorCycleRenderer::prepare(
     preparedLaneCount = laneCount;
     auto* mesh = const_cast<Mesh*>(configuration->mesh.get());
     const auto preparation = Rasterization::VoiceRasterizerPreparation::forMesh(*mesh);
-    for (int laneIndex = 0; laneIndex < preparedLaneCount; ++laneIndex) {
-        auto& lane = lanes[(size_t) laneIndex];
+    auto prepareLane = [&](LaneRasterizer& lane) {
         lane.rasterizer.setGuideCurveProvider(configuration->guideCurveProvider.get());
         lane.rasterizer.setCalcDepthDimensions(false);
         lane.rasterizer.setScalingMode(Rasterization::PointScalingMode::Bipolar);
         lane.rasterizer.prepare(preparation, { &lane.state });
+    };
+    for (int laneIndex = 0; laneIndex < preparedLaneCount; ++laneIndex) {
+        prepareLane(lanes[(size_t) laneIndex]);
     }
+    prepareLane(shared);
+
+    // lanes differ in noise seed, which only guide noise reads
+    noiseFreeLanes = configuration->guideCurveProvider == nullptr
+            || !configuration->guideCurveProvider->addsNoise();
     reset();
     return true;
 }
@@ -39,7 +46,12 @@ void TrimeshOscillatorCycleRenderer::reset() {
         lane.state.reset();
         lane.rasterizer.orphanOldVerts();
         lane.primed = false;
+        lane.cycles = 0;
     }
+    shared.state.reset();
+    shared.rasterizer.orphanOldVerts();
+    shared.primed = false;
+    shared.cycles = 0;
 }
 
 void TrimeshOscillatorCycleRenderer::renderCycle(
@@ -57,6 +69,13 @@ void TrimeshOscillatorCycleRenderer::renderCycle(
     }
 
     auto& lane = lanes[(size_t) request.laneIndex];
+    ++lane.cycles;
+    if (sharesSlices()) {
+        renderSharedCycle(lane, request, left);
+        left.copyTo(right);
+        return;
+    }
+
     CycleDsp::ChainedRasterizationRequest rasterRequest {
             const_cast<Mesh*>(configuration->mesh.get()),
             &lane.state,
@@ -70,7 +89,49 @@ void TrimeshOscillatorCycleRenderer::renderCycle(
         lane.primed = true;
     }
     CycleDsp::OscillatorLaneRasterizer::render(lane.rasterizer, rasterRequest, left);
+    ++renderCount;
     left.copyTo(right);
 }
 
+/*
+ * The shared cycle moves on when a lane asks for a cycle past the last one
+ * rendered, so the lane with the highest pitch drives it and the rest sample
+ * whichever cycle is current. Detune is small next to a cycle, so that is
+ * never more than one cycle away from their own.
+ */
+void TrimeshOscillatorCycleRenderer::renderSharedCycle(
+        LaneRasterizer& lane,
+        const ChainedCycleRenderRequest& request,
+        Buffer<float> output) {
+    if (request.angleDelta <= 0.0) {
+        output.zero();
+        return;
+    }
+
+    CycleDsp::ChainedRasterizationRequest rasterRequest {
+            const_cast<Mesh*>(configuration->mesh.get()),
+            &shared.state,
+            configuration->morph,
+            0.f,
+            request.angleDelta,
+            0
+    };
+    if (!shared.primed) {
+        CycleDsp::OscillatorLaneRasterizer::prime(shared.rasterizer, rasterRequest);
+        shared.primed = true;
+    }
+    if (lane.cycles > shared.cycles) {
+        CycleDsp::OscillatorLaneRasterizer::rasterize(shared.rasterizer, rasterRequest);
+        shared.cycles = lane.cycles;
+        ++renderCount;
+    }
+
+    CycleDsp::OscillatorLaneRasterizer::sampleRotated(
+            shared.rasterizer,
+            lane.state,
+            request.voice.phaseCycles,
+            request.angleDelta,
+            output);
+}
+
 }
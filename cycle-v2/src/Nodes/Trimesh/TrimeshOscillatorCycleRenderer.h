@@ -20,15 +20,37 @@ public:
             Buffer<float> left,
             Buffer<float> right) override;
 
+    /*
+     * Lanes all slice the mesh at the configuration's morph, so unless guide
+     * noise is seeded per lane they render one cycle between them and each
+     * samples it at its own phase and rate. Off renders every lane separately,
+     * which is what the shared cycle is checked against.
+     */
+    void setSliceSharing(bool shouldShare) { sliceSharing = shouldShare; }
+    bool sharesSlices() const { return sliceSharing && noiseFreeLanes && preparedLaneCount > 1; }
+    size_t sliceRenderCount() const { return renderCount; }
+
 private:
     struct LaneRasterizer {
         Rasterization::VoiceCycleState state;
         Rasterization::VoiceRasterizer rasterizer;
         bool primed {};
+        size_t cycles {};
     };
 
+    void renderSharedCycle(
+            LaneRasterizer& lane,
+            const ChainedCycleRenderRequest& request,
+            Buffer<float> output);
+
     int preparedLaneCount {};
+    bool sliceSharing { true };
+    bool noiseFreeLanes {};
+    size_t renderCount {};
     std::array<LaneRasterizer, CycleDsp::maximumUnisonOrder> lanes;
+
+    // the cycle lanes share, rendered at zero phase, and how many lane cycles it has reached
+    LaneRasterizer shared;
     std::shared_ptr<const TrimeshConfiguration> configuration;
 };
 
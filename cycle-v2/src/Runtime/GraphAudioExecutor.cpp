@@ -11,6 +11,23 @@ namespace CycleV2 {
 
 namespace {
 
+// Buffers with disjoint lifetimes share a payload slot; see compileBufferSlots.
+size_t slotIndexFor(const GraphExecutionPlan& plan, int bufferIndex) {
+    return (size_t) plan.buffers[(size_t) bufferIndex].slot;
+}
+
+// Empties a slot in place so it keeps its binding to the work arena.
+void clearSlot(SignalPayload& payload) {
+    payload.block.samples.clear();
+    payload.secondaryBlock.samples.clear();
+    for (auto* grid : { &payload.traversalGrid, &payload.secondaryTraversalGrid }) {
+        grid->values.clear();
+        grid->metadata = {};
+        grid->columns = 0;
+        grid->rows = 0;
+    }
+}
+
 const CompiledVoiceContext* voiceContextForRegion(
         const GraphExecutionPlan& plan,
         const OscillatorRegionPlan& region) {
@@ -37,6 +54,51 @@ int maximumCycleSamplesFor(
     return (int) std::ceil(sampleRate / lowestFrequency) + 1;
 }
 
+bool sameRegionPlan(
+        const GraphExecutionPlan& previousPlan,
+        const OscillatorRegionPlan& previous,
+        const GraphExecutionPlan& plan,
+        const OscillatorRegionPlan& region) {
+    if (previous.id != region.id
+            || previous.voiceContextNodeId != region.voiceContextNodeId
+            || previous.strategy != region.strategy
+            || previous.reconstruction != region.reconstruction
+            || previous.laneCount != region.laneCount
+            || previous.outputLatencySamples != region.outputLatencySamples
+            || previous.tailPolicy != region.tailPolicy
+            || previous.outputTailSamples != region.outputTailSamples
+            || previous.stepIndices.size() != region.stepIndices.size()
+            || region.materializationStepIndex < 0
+            || (size_t) region.materializationStepIndex >= plan.steps.size()
+            || previous.materializationStepIndex < 0
+            || (size_t) previous.materializationStepIndex >= previousPlan.steps.size()
+            || previousPlan.steps[(size_t) previous.materializationStepIndex].nodeId
+                    != plan.steps[(size_t) region.materializationStepIndex].nodeId) {
+        return false;
+    }
+    for (size_t index = 0; index < region.stepIndices.size(); ++index) {
+        if (previousPlan.steps[(size_t) previous.stepIndices[index]].nodeId
+                != plan.steps[(size_t) region.stepIndices[index]].nodeId) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// configurations are compared by identity, so a recompiled one counts as changed
+bool sameVoiceContext(const CompiledVoiceContext& previous, const CompiledVoiceContext& context) {
+    return previous.nodeId == context.nodeId
+            && previous.startDomain == context.startDomain
+            && previous.octave == context.octave
+            && previous.pitchSemitones == context.pitchSemitones
+            && previous.portamento == context.portamento
+            && previous.oversampling == context.oversampling
+            && previous.defaultModulation == context.defaultModulation
+            && previous.pitchEnvelope == context.pitchEnvelope
+            && previous.pitchEnvelopeUnitValues == context.pitchEnvelopeUnitValues
+            && previous.unison == context.unison;
+}
+
 template<class PreparedVoiceType>
 bool oscillatorPreparationMatches(
         const GraphExecutionPlan& plan,
@@ -218,12 +280,12 @@ GraphAudioResult GraphAudioExecutor::processInternal(
         prepareExecution(plan, executionSpec, voice.voiceIndex);
     }
 
-    const auto preparedVoice = preparedVoices.find(voice.voiceIndex);
+    PreparedVoice* preparedVoice = preparedVoiceFor(voice.voiceIndex);
     if (frameCount > workArena.frameCapacity
-            || bufferSlots.size() != plan.buffers.size()
-            || preparedVoice == preparedVoices.end()
-            || preparedVoice->second.plan != &plan
-            || preparedVoice->second.processors.size() != plan.steps.size()) {
+            || bufferSlots.size() != plan.bufferSlotCount
+            || preparedVoice == nullptr
+            || preparedVoice->plan != &plan
+            || preparedVoice->processors.size() != plan.steps.size()) {
         jassertfalse;
         return {};
     }
@@ -268,7 +330,7 @@ GraphAudioResult GraphAudioExecutor::processInternal(
             continue;
         }
         const int sourceIndex = (int) buffer.defaultModulationSlot - 1;
-        SignalPayload& payload = bufferSlots[bufferIndex];
+        SignalPayload& payload = bufferSlots[slotIndexFor(plan, (int) bufferIndex)];
         payload.domain = PortDomain::ControlSignal;
         payload.channelLayout = ChannelLayout::Mono;
         payload.block.samples.resize(frameCount);
@@ -296,15 +358,19 @@ GraphAudioResult GraphAudioExecutor::processInternal(
                 if (bufferIndex < 0 || outputIndex >= cachedOutputs.size()) {
                     continue;
                 }
-                bufferSlots[(size_t) bufferIndex] = cachedOutputs[outputIndex].second;
+                bufferSlots[slotIndexFor(plan, bufferIndex)] = cachedOutputs[outputIndex].second;
             }
             continue;
         }
-        NodeAudioProcessor* processor = stepIndex < preparedVoice->second.processors.size()
-                ? preparedVoice->second.processors[stepIndex]
-                : nullptr;
+        NodeAudioProcessor* processor = preparedVoice->processors[stepIndex];
 
         if (processor == nullptr) {
+            // the slot may hold another buffer's samples from earlier in the block
+            for (const auto& output : step.outputs) {
+                if (output.bufferIndex >= 0) {
+                    clearSlot(bufferSlots[slotIndexFor(plan, output.bufferIndex)]);
+                }
+            }
             continue;
         }
 
@@ -333,7 +399,7 @@ GraphAudioResult GraphAudioExecutor::processInternal(
                     output.channelLayout
             });
             if (output.bufferIndex >= 0) {
-                context.outputViews[outputIndex] = &bufferSlots[(size_t) output.bufferIndex];
+                context.outputViews[outputIndex] = &bufferSlots[slotIndexFor(plan, output.bufferIndex)];
             }
         }
 
@@ -344,14 +410,14 @@ GraphAudioResult GraphAudioExecutor::processInternal(
 
             const auto inputIndex = (size_t) input.destPortIndex;
             if (input.sourceBufferIndex >= 0
-                    && (size_t) input.sourceBufferIndex < bufferSlots.size()) {
-                context.inputViews[inputIndex] = &bufferSlots[(size_t) input.sourceBufferIndex];
+                    && (size_t) input.sourceBufferIndex < plan.buffers.size()) {
+                context.inputViews[inputIndex] = &bufferSlots[slotIndexFor(plan, input.sourceBufferIndex)];
             }
         }
 
         for (const auto& attachment : step.attachments) {
             if (attachment.sourceBufferIndex < 0
-                    || (size_t) attachment.sourceBufferIndex >= bufferSlots.size()) {
+                    || (size_t) attachment.sourceBufferIndex >= plan.buffers.size()) {
                 continue;
             }
 
@@ -360,7 +426,7 @@ GraphAudioResult GraphAudioExecutor::processInternal(
                     attachment.sourcePortId,
                     attachment.destPortId,
                     attachment.domain,
-                    &bufferSlots[(size_t) attachment.sourceBufferIndex]
+                    &bufferSlots[slotIndexFor(plan, attachment.sourceBufferIndex)]
             });
         }
 
@@ -382,7 +448,7 @@ GraphAudioResult GraphAudioExecutor::processInternal(
         }
 
         auto* oscillatorRegion = oscillatorRegionForStep(
-                preparedVoice->second,
+                *preparedVoice,
                 stepIndex);
         if (oscillatorRegion != nullptr
                 && (!captureDiagnostics
@@ -414,14 +480,20 @@ GraphAudioResult GraphAudioExecutor::processInternal(
                     : "out";
 
             if (i < step.outputs.size() && step.outputs[i].bufferIndex >= 0) {
-                bufferSlots[(size_t) step.outputs[i].bufferIndex] = std::move(context.outputs[i]);
+                SignalPayload& slot = bufferSlots[slotIndexFor(plan, step.outputs[i].bufferIndex)];
+                slot = std::move(context.outputs[i]);
                 if (captureDiagnostics) {
-                    nodeOutputs.push_back({ portId, bufferSlots[(size_t) step.outputs[i].bufferIndex] });
+                    nodeOutputs.push_back({ portId, slot });
                 }
             } else if (captureDiagnostics) {
                 nodeOutputs.push_back({ portId, std::move(context.outputs[i]) });
             }
         }
+        for (size_t i = context.outputs.size(); i < step.outputs.size(); ++i) {
+            if (step.outputs[i].bufferIndex >= 0) {
+                clearSlot(bufferSlots[slotIndexFor(plan, step.outputs[i].bufferIndex)]);
+            }
+        }
 
         if (!captureDiagnostics) {
             if (outputNode) {
@@ -487,8 +559,6 @@ GraphAudioResult GraphAudioExecutor::processInternal(
         }
     }
 
-    removeUnreferencedProcessors();
-
     return result;
 }
 
@@ -503,7 +573,7 @@ void GraphAudioExecutor::prepareExecution(
             && workArena.inputCapacity == plan.maximumInputCount
             && workArena.outputCapacity == plan.maximumOutputCount
             && workArena.gridValueCapacity == gridValueCapacity
-            && bufferSlots.size() == plan.buffers.size();
+            && bufferSlots.size() == plan.bufferSlotCount;
     if (!workspaceMatches) {
         workArena.prepare(
                 spec.maximumFrameCount,
@@ -511,12 +581,12 @@ void GraphAudioExecutor::prepareExecution(
                 plan.maximumOutputCount,
                 gridValueCapacity);
         bufferSlots.clear();
-        if (!workArena.preparePayloadStorage(plan.buffers.size())) {
+        if (!workArena.preparePayloadStorage(plan.bufferSlotCount)) {
             workArena.frameCapacity = 0;
             jassertfalse;
             return;
         }
-        bufferSlots.resize(plan.buffers.size());
+        bufferSlots.resize(plan.bufferSlotCount);
         for (auto& slot : bufferSlots) {
             workArena.bind(slot);
         }
@@ -529,7 +599,14 @@ void GraphAudioExecutor::prepareExecution(
     processContext.outputPorts.prepare(plan.maximumOutputCount);
     processContext.outputViews.prepare(plan.maximumOutputCount);
     processContext.outputs.prepare(plan.maximumOutputCount);
-    PreparedVoice& preparedVoice = preparedVoices[voiceIndex];
+    jassert(voiceIndex >= 0);
+    if (voiceIndex < 0) {
+        return;
+    }
+    if ((size_t) voiceIndex >= preparedVoices.size()) {
+        preparedVoices.resize((size_t) voiceIndex + 1);
+    }
+    PreparedVoice& preparedVoice = preparedVoices[(size_t) voiceIndex];
     const bool rebuildOscillatorRegions = !oscillatorPreparationMatches(
             plan,
             preparedVoice,
@@ -540,43 +617,45 @@ void GraphAudioExecutor::prepareExecution(
     preparedVoice.sampleRate = spec.sampleRate;
     preparedVoice.processors.clear();
     preparedVoice.processors.reserve(plan.steps.size());
+    preparedVoice.tailProcessors.clear();
+    bool referencesChanged = preparedVoice.cachedProcessors.size() != plan.steps.size();
+    preparedVoice.cachedProcessors.resize(plan.steps.size(), nullptr);
 
-    for (const auto& step : plan.steps) {
-        CachedProcessor& cached = processorFor(
-                step.nodeId,
-                voiceIndex,
-                step.audioRole,
-                factory);
+    for (size_t stepIndex = 0; stepIndex < plan.steps.size(); ++stepIndex) {
+        const auto& step = plan.steps[stepIndex];
+        // an unchanged plan resolves every step from the previous preparation without hashing
+        CachedProcessor* reused = preparedVoice.cachedProcessors[stepIndex];
+        if (reused == nullptr || reused->nodeId != step.nodeId) {
+            reused = &processorFor(step.nodeId, voiceIndex, step.audioRole, factory);
+            preparedVoice.cachedProcessors[stepIndex] = reused;
+            referencesChanged = true;
+        } else {
+            adoptRole(*reused, step.audioRole, factory);
+        }
+        CachedProcessor& cached = *reused;
         NodeAudioProcessor* processor = cached.processor.get();
         preparedVoice.processors.push_back(processor);
         if (processor == nullptr) {
             continue;
         }
-
-        AudioExecutionSpec stepSpec = spec;
-        if (!step.outputs.empty()) {
-            stepSpec.domain = step.outputs.front().domain;
-            stepSpec.channelLayout = step.outputs.front().channelLayout;
+        if (cached.role == AudioModuleRole::Envelope) {
+            preparedVoice.tailProcessors.push_back(processor);
         }
-        const PreparationSignature signature {
-                step.configuration.revision,
-                step.configuration.key,
-                spec.maximumFrameCount,
-                spec.sampleRate,
-                stepSpec.domain,
-                stepSpec.channelLayout,
-                stepSpec.bpm,
-                stepSpec.beatsPerMeasure
-        };
+
+        const PreparationSignature signature = preparationSignatureFor(step, spec);
         if (cached.prepared && cached.preparation == signature) {
             continue;
         }
 
+        AudioExecutionSpec stepSpec = spec;
+        stepSpec.domain = signature.domain;
+        stepSpec.channelLayout = signature.channelLayout;
         processor->adoptConfiguration(step.configuration);
         processor->prepareExecution(stepSpec);
         cached.preparation = signature;
         cached.prepared = true;
         ++cached.preparationCount;
+        ++ownPreparationCount;
     }
 
     if (rebuildOscillatorRegions) {
@@ -612,8 +691,125 @@ void GraphAudioExecutor::prepareExecution(
             preparedVoice.oscillatorRegionByStep[
                     (size_t) region.materializationStepIndex] = preparedRegion.get();
             preparedVoice.oscillatorRegions.push_back(std::move(preparedRegion));
+            ++ownPreparationCount;
         }
     }
+
+    if (referencesChanged) {
+        removeUnreferencedProcessors();
+    }
+}
+
+size_t GraphAudioExecutor::adoptPreparedState(
+        const GraphAudioExecutor& previous,
+        const GraphExecutionPlan& plan,
+        const AudioExecutionSpec& spec,
+        int voiceIndex) const {
+    jassert(&previous != this);
+    size_t adoptedCount = 0;
+    for (const auto& step : plan.steps) {
+        const ProcessorKey key { step.nodeId, voiceIndex };
+        const auto found = previous.processors.find(key);
+        if (found == previous.processors.end() || processors.count(key) != 0) {
+            continue;
+        }
+        const CachedProcessor& cached = found->second;
+        if (cached.processor == nullptr
+                || !cached.prepared
+                || cached.role != step.audioRole
+                || !(cached.preparation == preparationSignatureFor(step, spec))) {
+            continue;
+        }
+        processors.emplace(key, cached);
+        ++adoptedCount;
+    }
+
+    if (const PreparedVoice* previousVoice = previous.preparedVoiceFor(voiceIndex)) {
+        adoptOscillatorRegions(*previousVoice, plan, spec, voiceIndex);
+    }
+    return adoptedCount;
+}
+
+/*
+ * Regions are adopted all or none, matching how prepareExecution rebuilds
+ * them, and only when each is the same region of the same steps at the same
+ * configuration revisions, driven by an identical voice context.
+ */
+bool GraphAudioExecutor::adoptOscillatorRegions(
+        const PreparedVoice& previous,
+        const GraphExecutionPlan& plan,
+        const AudioExecutionSpec& spec,
+        int voiceIndex) const {
+    const GraphExecutionPlan* previousPlan = previous.plan;
+    if (previousPlan == nullptr
+            || previous.oscillatorRegions.empty()
+            || previous.maximumFrameCount != spec.maximumFrameCount
+            || previous.sampleRate != spec.sampleRate
+            || previousPlan->oscillatorRegions.size() != plan.oscillatorRegions.size()) {
+        return false;
+    }
+
+    for (const auto& prepared : previous.oscillatorRegions) {
+        const auto regionIndex = (size_t) prepared->planRegionIndex;
+        if (prepared->planRegionIndex < 0 || regionIndex >= plan.oscillatorRegions.size()) {
+            return false;
+        }
+        const auto& region = plan.oscillatorRegions[regionIndex];
+        const auto& previousRegion = previousPlan->oscillatorRegions[regionIndex];
+        if (!sameRegionPlan(*previousPlan, previousRegion, plan, region)
+                || prepared->configurationRevisions.size() != region.stepIndices.size()) {
+            return false;
+        }
+        for (size_t operationIndex = 0; operationIndex < region.stepIndices.size(); ++operationIndex) {
+            if (prepared->configurationRevisions[operationIndex]
+                    != plan.steps[(size_t) region.stepIndices[operationIndex]].configuration.revision) {
+                return false;
+            }
+        }
+        const auto* context = voiceContextForRegion(plan, region);
+        const auto* previousContext = voiceContextForRegion(*previousPlan, previousRegion);
+        if (context == nullptr
+                || previousContext == nullptr
+                || !sameVoiceContext(*previousContext, *context)) {
+            return false;
+        }
+    }
+
+    if ((size_t) voiceIndex >= preparedVoices.size()) {
+        preparedVoices.resize((size_t) voiceIndex + 1);
+    }
+    PreparedVoice& voice = preparedVoices[(size_t) voiceIndex];
+    voice.voiceIndex = voiceIndex;
+    voice.plan = &plan;
+    voice.maximumFrameCount = spec.maximumFrameCount;
+    voice.sampleRate = spec.sampleRate;
+    voice.oscillatorRegions = previous.oscillatorRegions;
+    voice.oscillatorRegionByStep.assign(plan.steps.size(), nullptr);
+    for (const auto& prepared : voice.oscillatorRegions) {
+        const auto& region = plan.oscillatorRegions[(size_t) prepared->planRegionIndex];
+        voice.oscillatorRegionByStep[(size_t) region.materializationStepIndex] = prepared.get();
+    }
+    return true;
+}
+
+GraphAudioExecutor::PreparationSignature GraphAudioExecutor::preparationSignatureFor(
+        const GraphExecutionStep& step,
+        const AudioExecutionSpec& spec) {
+    PreparationSignature signature {
+            step.configuration.revision,
+            step.configuration.key,
+            spec.maximumFrameCount,
+            spec.sampleRate,
+            spec.domain,
+            spec.channelLayout,
+            spec.bpm,
+            spec.beatsPerMeasure
+    };
+    if (!step.outputs.empty()) {
+        signature.domain = step.outputs.front().domain;
+        signature.channelLayout = step.outputs.front().channelLayout;
+    }
+    return signature;
 }
 
 GraphAudioExecutor::PreparedVoice::OscillatorRegion*
@@ -683,6 +879,10 @@ size_t GraphAudioExecutor::preparationCount(const String& nodeId, int voiceIndex
     return found == processors.end() ? 0 : found->second.preparationCount;
 }
 
+size_t GraphAudioExecutor::preparedProcessorCount() const {
+    return ownPreparationCount;
+}
+
 size_t GraphAudioExecutor::serviceNonRealtimePreparation() const {
     size_t preparedCount = 0;
     for (const auto& [key, entry] : processors) {
@@ -696,26 +896,36 @@ size_t GraphAudioExecutor::serviceNonRealtimePreparation() const {
 }
 
 bool GraphAudioExecutor::hasActiveVoiceTail(int voiceIndex) const {
-    return std::any_of(
-            processors.begin(),
-            processors.end(),
-            [&](const auto& entry) {
-                return entry.first.voiceIndex == voiceIndex
-                        && entry.second.role == AudioModuleRole::Envelope
-                        && entry.second.processor != nullptr
-                        && entry.second.processor->isVoiceActive();
-            });
+    const PreparedVoice* voice = preparedVoiceFor(voiceIndex);
+    return voice != nullptr
+            && std::any_of(
+                    voice->tailProcessors.begin(),
+                    voice->tailProcessors.end(),
+                    [](const NodeAudioProcessor* processor) {
+                        return processor->isVoiceActive();
+                    });
 }
 
 bool GraphAudioExecutor::hasVoiceTailProcessor(int voiceIndex) const {
-    return std::any_of(
-            processors.begin(),
-            processors.end(),
-            [&](const auto& entry) {
-                return entry.first.voiceIndex == voiceIndex
-                        && entry.second.role == AudioModuleRole::Envelope
-                        && entry.second.processor != nullptr;
-            });
+    const PreparedVoice* voice = preparedVoiceFor(voiceIndex);
+    return voice != nullptr && !voice->tailProcessors.empty();
+}
+
+GraphAudioExecutor::PreparedVoice* GraphAudioExecutor::preparedVoiceFor(int voiceIndex) const {
+    return voiceIndex >= 0 && (size_t) voiceIndex < preparedVoices.size()
+            ? &preparedVoices[(size_t) voiceIndex]
+            : nullptr;
+}
+
+void GraphAudioExecutor::adoptRole(
+        CachedProcessor& cached,
+        AudioModuleRole role,
+        const NodeAudioProcessorFactory& factory) {
+    if (cached.role != role) {
+        cached.role = role;
+        cached.processor = factory.create(role);
+        cached.prepared = false;
+    }
 }
 
 GraphAudioExecutor::CachedProcessor& GraphAudioExecutor::processorFor(
@@ -726,37 +936,30 @@ GraphAudioExecutor::CachedProcessor& GraphAudioExecutor::processorFor(
     const ProcessorKey key { nodeId, voiceIndex };
     const auto found = processors.find(key);
     if (found != processors.end()) {
-        CachedProcessor& cached = found->second;
-        if (cached.role != role) {
-            cached.role = role;
-            cached.processor = factory.create(role);
-            cached.prepared = false;
-        }
-
-        return cached;
+        adoptRole(found->second, role, factory);
+        return found->second;
     }
 
-    auto [inserted, succeeded] = processors.emplace(key, CachedProcessor {
-            role,
-            factory.create(role)
-    });
+    CachedProcessor created { role, factory.create(role) };
+    created.nodeId = nodeId;
+    auto [inserted, succeeded] = processors.emplace(key, std::move(created));
     jassert(succeeded);
     return inserted->second;
 }
 
 void GraphAudioExecutor::removeUnreferencedProcessors() const {
+    for (auto& entry : processors) {
+        entry.second.referenced = false;
+    }
+    for (const auto& voice : preparedVoices) {
+        for (CachedProcessor* cached : voice.cachedProcessors) {
+            if (cached != nullptr) {
+                cached->referenced = true;
+            }
+        }
+    }
     for (auto entry = processors.begin(); entry != processors.end();) {
-        const bool referenced = std::any_of(
-                preparedVoices.begin(),
-                preparedVoices.end(),
-                [&](const auto& voice) {
-                    const auto& voiceProcessors = voice.second.processors;
-                    return std::find(
-                            voiceProcessors.begin(),
-                            voiceProcessors.end(),
-                            entry->second.processor.get()) != voiceProcessors.end();
-                });
-        if (!referenced) {
+        if (!entry->second.referenced) {
             entry = processors.erase(entry);
         } else {
             ++entry;
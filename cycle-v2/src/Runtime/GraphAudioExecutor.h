@@ -49,7 +49,25 @@ public:
             const GraphExecutionPlan& plan,
             const AudioExecutionSpec& spec,
             int voiceIndex = 0) const;
+    /*
+     * Takes over what another executor prepared for this voice wherever the
+     * plan would prepare it the same way: processors whose preparation
+     * signature and role are unchanged, and the voice's oscillator regions
+     * when none of them changed. Call it before prepareExecution, which then
+     * only prepares what an edit touched.
+     *
+     * Adopted processors are shared with the other executor along with their
+     * voice state, so only one of the two may render at a time. Returns the
+     * number of processors adopted.
+     */
+    size_t adoptPreparedState(
+            const GraphAudioExecutor& previous,
+            const GraphExecutionPlan& plan,
+            const AudioExecutionSpec& spec,
+            int voiceIndex = 0) const;
     size_t preparationCount(const String& nodeId, int voiceIndex = 0) const;
+    // processors and oscillator regions this executor prepared rather than adopted
+    size_t preparedProcessorCount() const;
     size_t serviceNonRealtimePreparation() const;
     bool hasActiveVoiceTail(int voiceIndex) const;
     bool hasVoiceTailProcessor(int voiceIndex) const;
@@ -136,10 +154,13 @@ private:
 
     struct CachedProcessor {
         AudioModuleRole role { AudioModuleRole::None };
-        std::unique_ptr<NodeAudioProcessor> processor;
+        // shared with the executor of a later graph that adopts it
+        std::shared_ptr<NodeAudioProcessor> processor;
         PreparationSignature preparation;
         size_t preparationCount {};
         bool prepared {};
+        bool referenced {};
+        String nodeId;
     };
 
     struct PreparedVoice {
@@ -155,8 +176,11 @@ private:
         const GraphExecutionPlan* plan {};
         size_t maximumFrameCount {};
         double sampleRate {};
+        // indexed by step ordinal, so dispatch never looks a node up by id
+        std::vector<CachedProcessor*> cachedProcessors;
         std::vector<NodeAudioProcessor*> processors;
-        std::vector<std::unique_ptr<OscillatorRegion>> oscillatorRegions;
+        std::vector<NodeAudioProcessor*> tailProcessors;
+        std::vector<std::shared_ptr<OscillatorRegion>> oscillatorRegions;
         std::vector<OscillatorRegion*> oscillatorRegionByStep;
     };
 
@@ -165,6 +189,19 @@ private:
             int voiceIndex,
             AudioModuleRole role,
             const NodeAudioProcessorFactory& factory) const;
+    PreparedVoice* preparedVoiceFor(int voiceIndex) const;
+    static PreparationSignature preparationSignatureFor(
+            const GraphExecutionStep& step,
+            const AudioExecutionSpec& spec);
+    bool adoptOscillatorRegions(
+            const PreparedVoice& previous,
+            const GraphExecutionPlan& plan,
+            const AudioExecutionSpec& spec,
+            int voiceIndex) const;
+    static void adoptRole(
+            CachedProcessor& cached,
+            AudioModuleRole role,
+            const NodeAudioProcessorFactory& factory);
     void removeUnreferencedProcessors() const;
     static PreparedVoice::OscillatorRegion* oscillatorRegionForStep(
             PreparedVoice& voice,
@@ -190,7 +227,8 @@ private:
     mutable std::vector<SignalPayload> bufferSlots;
     mutable const SignalPayload* realtimeOutput {};
     mutable std::unordered_map<ProcessorKey, CachedProcessor, ProcessorKeyHash> processors;
-    mutable std::unordered_map<int, PreparedVoice> preparedVoices;
+    mutable std::vector<PreparedVoice> preparedVoices;
+    mutable size_t ownPreparationCount {};
     mutable std::vector<String> diagnosticNodeIds;
     mutable std::vector<std::optional<NodeAudioResult>> diagnosticCache;
     mutable std::vector<size_t> diagnosticProcessCounts;
@@ -2,6 +2,8 @@
 #include "FingerprintBuilder.h"
 #include "PreviewPitchResolver.h"
 
+#include <Thread/RealtimeWorkerPool.h>
+
 #include <algorithm>
 
 namespace CycleV2 {
@@ -39,6 +41,11 @@ GraphPreviewResult captureProbePreviews(
 
 GraphPresentationModel::GraphPresentationModel() :
         asyncState(std::make_shared<AsyncState>()) {
+    // the refresh worker claims nodes alongside these, so leave it a core of its own
+    const int previewWorkers = RealtimeWorkerPool::defaultWorkerCount() - 1;
+    if (previewWorkers > 0) {
+        previewPool = std::make_unique<RealtimeWorkerPool>(previewWorkers, Thread::Priority::low);
+    }
 }
 
 GraphPresentationModel::~GraphPresentationModel() {
@@ -95,6 +102,11 @@ bool GraphPresentationModel::refresh(
     if (!compile && !request.edit.isValid()) {
         return true;
     }
+
+    // a compile has just drained the async worker, so nothing else is dispatching to the pool
+    PreviewSchedule schedule;
+    schedule.pool = compile ? previewPool.get() : nullptr;
+    schedule.focusNodeIds = previewFocus;
     const auto updateResult = updateGraph.executeDeferredPublication(
             next.compileResult.plan,
             request,
@@ -104,7 +116,8 @@ bool GraphPresentationModel::refresh(
                         next,
                         products,
                         compile,
-                        previewRendered);
+                        previewRendered,
+                        schedule);
             });
     updateGraph.publish(request, updateResult);
     if (previewRendered) {
@@ -187,6 +200,7 @@ void GraphPresentationModel::refreshAsync(
     refresh->requestFingerprint = requestFingerprint;
     refresh->snapshot = std::move(next);
     refresh->completion = std::move(completion);
+    refresh->focusNodeIds = previewFocus;
     asyncWorker.post([this, refresh] {
         if (!isCurrent(*refresh)) {
             updateGraph.recordDecision(
@@ -228,13 +242,18 @@ bool GraphPresentationModel::executeAsyncProducts(
         return isCurrent(refresh);
     }
 
+    PreviewSchedule schedule;
+    schedule.pool = previewPool.get();
+    schedule.focusNodeIds = refresh.focusNodeIds;
+    schedule.isCurrent = [&] { return isCurrent(refresh); };
+
     return renderPreviewProducts(
             refresh.graph,
             next,
             products,
             false,
             refresh.previewRendered,
-            [&] { return isCurrent(refresh); });
+            schedule);
 }
 
 bool GraphPresentationModel::renderPreviewProducts(
@@ -243,7 +262,7 @@ bool GraphPresentationModel::renderPreviewProducts(
         const std::vector<PlannedNodeProduct>& products,
         bool renderFullGraph,
         bool& previewRendered,
-        GraphAudioExecutor::CancellationCheck cancellationCheck) {
+        const PreviewSchedule& schedule) {
     previewRendered = false;
     const bool hasPreviewTraversal = std::any_of(
             products.begin(), products.end(), [](const auto& product) {
@@ -270,13 +289,13 @@ bool GraphPresentationModel::renderPreviewProducts(
                 previewFrameCount,
                 {},
                 previewVoice);
-        snapshot.previewResult = GraphPreviewExecutor().render(
+        snapshot.previewResult = GraphPreviewExecutor(schedule).render(
                 snapshot.compileResult.plan,
                 audio,
                 graph.getSignalProbes(),
                 40);
-        previewRendered = true;
-        return true;
+        previewRendered = !snapshot.previewResult.cancelled;
+        return previewRendered;
     }
 
     std::vector<uint8_t> dirtyNodes(snapshot.compileResult.plan.steps.size());
@@ -296,17 +315,20 @@ bool GraphPresentationModel::renderPreviewProducts(
             previewFrameCount,
             dirtyNodes,
             previewVoice,
-            cancellationCheck);
-    if (audio.cancelled || (cancellationCheck && !cancellationCheck())) {
+            schedule.isCurrent);
+    if (audio.cancelled || (schedule.isCurrent && !schedule.isCurrent())) {
         return false;
     }
-    GraphPreviewExecutor().renderIncremental(
+    GraphPreviewExecutor(schedule).renderIncremental(
             snapshot.compileResult.plan,
             audio,
             graph.getSignalProbes(),
             dirtyNodes,
             40,
             snapshot.previewResult);
+    if (snapshot.previewResult.cancelled) {
+        return false;
+    }
     previewRendered = true;
     return true;
 }
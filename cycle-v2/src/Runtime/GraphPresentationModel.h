@@ -48,6 +48,8 @@ public:
             const String& field,
             uint64_t effectiveFingerprint,
             uint64_t documentRevision);
+    // nodes whose previews should be rendered first, like the one under the mouse
+    void setPreviewFocus(std::vector<String> nodeIds) { previewFocus = std::move(nodeIds); }
 
     const GraphPresentationSnapshot& snapshot() const { return current; }
     const GraphCompileResult& compileResult() const { return current.compileResult; }
@@ -56,6 +58,7 @@ public:
     uint64_t revision() const { return presentationRevision; }
     size_t compilationCount() const { return compilations; }
     size_t previewRenderCount() const { return previewRenders; }
+    double previewQueueMilliseconds() const { return asyncWorker.lastQueueMilliseconds(); }
     size_t previewAudioProcessCount(const String& nodeId) const {
         return previewAudioExecutor.diagnosticProcessCount(nodeId);
     }
@@ -88,6 +91,7 @@ private:
         uint64_t requestFingerprint {};
         GraphPresentationSnapshot snapshot;
         std::function<void()> completion;
+        std::vector<String> focusNodeIds;
         bool previewRendered {};
     };
 
@@ -107,7 +111,7 @@ private:
             const std::vector<PlannedNodeProduct>& products,
             bool renderFullGraph,
             bool& previewRendered,
-            GraphAudioExecutor::CancellationCheck cancellationCheck = {});
+            const PreviewSchedule& schedule = {});
     std::function<void()> publishAsyncRefresh(std::shared_ptr<AsyncRefresh> refresh);
     bool isCurrent(const AsyncRefresh& refresh) const;
     CausalUpdateRequest updateRequest(
@@ -132,6 +136,8 @@ private:
     uint64_t publishedGeneration {};
     std::optional<EditIdentity> latestMovementIdentity;
     String latestMovementStream;
+    std::vector<String> previewFocus;
+    std::unique_ptr<RealtimeWorkerPool> previewPool;
     MessageThreadWorker asyncWorker;
     std::shared_ptr<AsyncState> asyncState;
 };
@@ -1,6 +1,10 @@
 #include "GraphPreviewExecutor.h"
 
+#include <Thread/RealtimeWorkerPool.h>
+
+#include <algorithm>
 #include <functional>
+#include <numeric>
 
 namespace CycleV2 {
 
@@ -132,13 +136,84 @@ PreviewResultView viewOf(const NodePreviewResult& preview) {
     };
 }
 
+// a node waits for the wave its last rendered input settles in, so each wave only reads finished ones
+std::vector<int> scheduleWaves(
+        const GraphExecutionPlan& plan,
+        const std::vector<size_t>& stepIndices,
+        int& waveCount) {
+    std::vector<uint8_t> rendered(plan.steps.size());
+    for (const size_t stepIndex : stepIndices) {
+        rendered[stepIndex] = 1;
+    }
+
+    std::vector<int> settledWave(plan.steps.size());
+    std::vector<int> waveByStep(plan.steps.size());
+    waveCount = 0;
+    for (size_t stepIndex = 0; stepIndex < plan.steps.size(); ++stepIndex) {
+        int wave = 0;
+        for (const auto& input : plan.steps[stepIndex].inputs) {
+            if (input.sourceStepIndex >= 0
+                    && static_cast<size_t>(input.sourceStepIndex) < stepIndex) {
+                wave = jmax(wave, settledWave[static_cast<size_t>(input.sourceStepIndex)]);
+            }
+        }
+
+        // aliasing steps resolve while their wave is prepared, before anything in it renders
+        const bool rendersInWave = rendered[stepIndex] != 0 && plan.steps[stepIndex].previewable;
+        waveByStep[stepIndex] = wave;
+        settledWave[stepIndex] = rendersInWave ? wave + 1 : wave;
+        if (rendered[stepIndex] != 0) {
+            waveCount = jmax(waveCount, wave + 1);
+        }
+    }
+
+    return waveByStep;
+}
+
+// the focused nodes and everything upstream of them
+std::vector<uint8_t> focusedSteps(
+        const GraphExecutionPlan& plan,
+        const std::vector<String>& focusNodeIds) {
+    std::vector<uint8_t> focused(plan.steps.size());
+    for (const auto& nodeId : focusNodeIds) {
+        const auto found = plan.dependencyIndex.stepIndexById.find(nodeId);
+        if (found != plan.dependencyIndex.stepIndexById.end()) {
+            focused[static_cast<size_t>(found->second)] = 1;
+        }
+    }
+
+    for (size_t stepIndex = plan.steps.size(); stepIndex-- > 0;) {
+        if (focused[stepIndex] == 0) {
+            continue;
+        }
+        for (const auto& input : plan.steps[stepIndex].inputs) {
+            if (input.sourceStepIndex >= 0
+                    && static_cast<size_t>(input.sourceStepIndex) < plan.steps.size()) {
+                focused[static_cast<size_t>(input.sourceStepIndex)] = 1;
+            }
+        }
+    }
+
+    return focused;
+}
+
+struct PendingPreview {
+    size_t stepIndex {};
+    std::unique_ptr<NodePreviewProcessor> processor;
+    PreviewProcessContext context;
+    double renderMilliseconds {};
+    bool rendered {};
+};
+
 GraphPreviewResult renderPreview(
         const GraphExecutionPlan& plan,
         const std::vector<const NodeAudioResult*>& audioNodes,
         size_t pointCount,
         GraphPreviewResult result = {},
         const std::vector<uint8_t>* dirtyNodes = nullptr,
-        const PreviewControlContext* controlContext = nullptr) {
+        const PreviewControlContext* controlContext = nullptr,
+        const PreviewSchedule* schedule = nullptr) {
+    const double startMilliseconds = Time::getMillisecondCounterHiRes();
     if (result.previewResultIndexByStep.size() != plan.steps.size()) {
         result.nodes.clear();
         result.previewResultIndexByStep.assign(plan.steps.size(), -1);
@@ -148,6 +223,9 @@ GraphPreviewResult renderPreview(
     result.aliasedInputCount = 0;
     result.reusedCapturedTraversalCount = 0;
     result.renderedNodeCount = 0;
+    result.renderWaveCount = 0;
+    result.renderMilliseconds = 0.0;
+    result.cancelled = false;
     result.nodes.reserve(plan.steps.size());
     std::vector<PreviewResultView> workspace(plan.steps.size());
     const auto audioIndex = indexAudioResults(plan, audioNodes, result);
@@ -188,90 +266,176 @@ GraphPreviewResult renderPreview(
         return PreviewResultView {};
     };
 
+    RealtimeWorkerPool* pool = schedule != nullptr ? schedule->pool : nullptr;
+    auto isCurrent = [schedule] {
+        return schedule == nullptr || !schedule->isCurrent || schedule->isCurrent();
+    };
+
+    int waveCount {};
+    const auto waveByStep = scheduleWaves(plan, stepIndices, waveCount);
+    const auto focused = schedule != nullptr && !schedule->focusNodeIds.empty()
+            ? focusedSteps(plan, schedule->focusNodeIds)
+            : std::vector<uint8_t>(plan.steps.size());
+    std::vector<PendingPreview> pending;
+    std::vector<size_t> renderOrder;
+
+    // slots are claimed in plan order up front, so the layout of nodes doesn't depend on the waves
+    std::vector<std::unique_ptr<NodePreviewProcessor>> processors(plan.steps.size());
     for (const size_t stepIndex : stepIndices) {
         const auto& step = plan.steps[stepIndex];
-        const auto inputPreview = dirtyNodes == nullptr
-                ? inputPreviewForStep(step, workspace, result)
-                : resolveInput(stepIndex);
-        const int cachedIndex = result.previewResultIndexByStep[stepIndex];
-
         if (!step.previewable) {
-            workspace[stepIndex] = inputPreview;
-            if (inputPreview.hasValues()) {
-                ++result.aliasedInputCount;
-            }
             continue;
         }
 
-        auto processor = factory.create(step.previewRole);
-        if (processor == nullptr) {
-            continue;
+        processors[stepIndex] = factory.create(step.previewRole);
+        const int cachedIndex = result.previewResultIndexByStep[stepIndex];
+        if (processors[stepIndex] != nullptr
+                && (cachedIndex < 0 || static_cast<size_t>(cachedIndex) >= result.nodes.size())) {
+            result.previewResultIndexByStep[stepIndex] = static_cast<int>(result.nodes.size());
+            result.nodes.emplace_back();
         }
+    }
 
-        PreviewProcessContext context;
-        context.pointCount = pointCount;
-        context.controlContext = controlContext;
-        context.configuration = &step.configuration;
-        if (stepIndex < audioIndex.size() && audioIndex[stepIndex] != nullptr) {
-            context.capturedOutput = &audioIndex[stepIndex]->output;
-            if (context.capturedOutput->traversalGrid.isValid()) {
-                context.frequencySampling = context.capturedOutput
-                        ->traversalGrid.metadata.frequencySampling;
-                context.frequencyMidiNote = context.capturedOutput
-                        ->traversalGrid.metadata.frequencyMidiNote;
-            }
-        }
-        context.parameters = step.parameters;
-        context.outputPorts.reserve(step.outputs.size());
-
-        for (const auto& output : step.outputs) {
-            context.outputPorts.push_back({
-                    output.portId,
-                    output.domain,
-                    output.channelLayout
-            });
+    for (int wave = 0; wave < waveCount; ++wave) {
+        if (!isCurrent()) {
+            result.cancelled = true;
+            break;
         }
 
-        context.input.summary = inputPreview.primary;
-        if (step.previewRole != PreviewModuleRole::SignalSpy
-                && inputPreview.primary != nullptr) {
-            context.input.grid = inputPreview.primary->data();
-            context.input.gridSize = inputPreview.primary->size();
-            context.input.gridColumns = inputPreview.gridColumns;
-            context.input.gridRows = inputPreview.gridRows;
-            context.input.domain = inputPreview.domain;
-            context.domain = inputPreview.domain;
-            context.frequencySampling = inputPreview.frequencySampling;
-            context.frequencyMidiNote = inputPreview.frequencyMidiNote;
+        pending.clear();
+        for (const size_t stepIndex : stepIndices) {
+            if (waveByStep[stepIndex] != wave) {
+                continue;
+            }
+
+            const auto& step = plan.steps[stepIndex];
+            const auto inputPreview = dirtyNodes == nullptr
+                    ? inputPreviewForStep(step, workspace, result)
+                    : resolveInput(stepIndex);
+
+            if (!step.previewable) {
+                workspace[stepIndex] = inputPreview;
+                if (inputPreview.hasValues()) {
+                    ++result.aliasedInputCount;
+                }
+                continue;
+            }
+
+            if (processors[stepIndex] == nullptr) {
+                continue;
+            }
+
+            PendingPreview& preview = pending.emplace_back();
+            preview.stepIndex = stepIndex;
+            preview.processor = std::move(processors[stepIndex]);
+
+            PreviewProcessContext& context = preview.context;
+            context.pointCount = pointCount;
+            context.controlContext = controlContext;
+            context.configuration = &step.configuration;
+            if (stepIndex < audioIndex.size() && audioIndex[stepIndex] != nullptr) {
+                context.capturedOutput = &audioIndex[stepIndex]->output;
+                if (context.capturedOutput->traversalGrid.isValid()) {
+                    context.frequencySampling = context.capturedOutput
+                            ->traversalGrid.metadata.frequencySampling;
+                    context.frequencyMidiNote = context.capturedOutput
+                            ->traversalGrid.metadata.frequencyMidiNote;
+                }
+            }
+            context.parameters = step.parameters;
+            context.outputPorts.reserve(step.outputs.size());
+
+            for (const auto& output : step.outputs) {
+                context.outputPorts.push_back({
+                        output.portId,
+                        output.domain,
+                        output.channelLayout
+                });
+            }
+
+            context.input.summary = inputPreview.primary;
+            if (step.previewRole != PreviewModuleRole::SignalSpy
+                    && inputPreview.primary != nullptr) {
+                context.input.grid = inputPreview.primary->data();
+                context.input.gridSize = inputPreview.primary->size();
+                context.input.gridColumns = inputPreview.gridColumns;
+                context.input.gridRows = inputPreview.gridRows;
+                context.input.domain = inputPreview.domain;
+                context.domain = inputPreview.domain;
+                context.frequencySampling = inputPreview.frequencySampling;
+                context.frequencyMidiNote = inputPreview.frequencyMidiNote;
+            }
+            addAudioTraversalGridToContext(context, step, audioIndex, result);
         }
-        addAudioTraversalGridToContext(context, step, audioIndex, result);
-        processor->render(context);
-        ++result.renderedNodeCount;
-        if (context.reusedCapturedTraversal) {
-            ++result.reusedCapturedTraversalCount;
+        if (pending.empty()) {
+            continue;
         }
+        ++result.renderWaveCount;
+
+        // workers claim in order, so the focused nodes start first
+        renderOrder.resize(pending.size());
+        std::iota(renderOrder.begin(), renderOrder.end(), (size_t) 0);
+        std::stable_partition(renderOrder.begin(), renderOrder.end(), [&](size_t index) {
+            return focused[pending[index].stepIndex] != 0;
+        });
+
+        auto renderPending = [&](int index) {
+            PendingPreview& preview = pending[renderOrder[(size_t) index]];
+            if (!isCurrent()) {
+                return;
+            }
 
-        NodePreviewResult preview {
-                step.nodeId,
-                step.previewRole,
-                std::move(context.primary),
-                std::move(context.secondary),
-                context.gridColumns,
-                context.gridRows,
-                context.domain,
-                context.frequencySampling,
-                context.frequencyMidiNote
+            const double nodeStart = Time::getMillisecondCounterHiRes();
+            preview.processor->render(preview.context);
+            preview.renderMilliseconds = Time::getMillisecondCounterHiRes() - nodeStart;
+            preview.rendered = true;
         };
-        if (cachedIndex >= 0 && static_cast<size_t>(cachedIndex) < result.nodes.size()) {
-            result.nodes[static_cast<size_t>(cachedIndex)] = std::move(preview);
-            workspace[stepIndex] = viewOf(result.nodes[static_cast<size_t>(cachedIndex)]);
+
+        if (pool != nullptr && pending.size() > 1) {
+            pool->parallelFor((int) pending.size(), renderPending);
         } else {
-            result.nodes.push_back(std::move(preview));
-            result.previewResultIndexByStep[stepIndex] = static_cast<int>(result.nodes.size() - 1);
-            workspace[stepIndex] = viewOf(result.nodes.back());
+            for (int index = 0; index < (int) pending.size(); ++index) {
+                renderPending(index);
+            }
+        }
+
+        // published in plan order, so the result layout doesn't depend on which worker finished first
+        for (auto& rendered : pending) {
+            if (!rendered.rendered) {
+                result.cancelled = true;
+                continue;
+            }
+
+            const size_t stepIndex = rendered.stepIndex;
+            const auto& step = plan.steps[stepIndex];
+            const auto slot = static_cast<size_t>(result.previewResultIndexByStep[stepIndex]);
+            PreviewProcessContext& context = rendered.context;
+            ++result.renderedNodeCount;
+            if (context.reusedCapturedTraversal) {
+                ++result.reusedCapturedTraversalCount;
+            }
+
+            NodePreviewResult preview {
+                    step.nodeId,
+                    step.previewRole,
+                    std::move(context.primary),
+                    std::move(context.secondary),
+                    context.gridColumns,
+                    context.gridRows,
+                    context.domain,
+                    context.frequencySampling,
+                    context.frequencyMidiNote,
+                    rendered.renderMilliseconds
+            };
+            result.nodes[slot] = std::move(preview);
+            workspace[stepIndex] = viewOf(result.nodes[slot]);
+        }
+        if (result.cancelled) {
+            break;
         }
     }
 
+    result.renderMilliseconds = Time::getMillisecondCounterHiRes() - startMilliseconds;
     return result;
 }
 
@@ -334,14 +498,14 @@ void appendProbePreviews(
 }
 
 GraphPreviewResult GraphPreviewExecutor::render(const GraphExecutionPlan& plan, size_t pointCount) const {
-    return renderPreview(plan, {}, pointCount);
+    return renderPreview(plan, {}, pointCount, {}, nullptr, nullptr, &schedule);
 }
 
 GraphPreviewResult GraphPreviewExecutor::render(
         const GraphExecutionPlan& plan,
         size_t pointCount,
         const PreviewControlContext& controlContext) const {
-    return renderPreview(plan, {}, pointCount, {}, nullptr, &controlContext);
+    return renderPreview(plan, {}, pointCount, {}, nullptr, &controlContext, &schedule);
 }
 
 GraphPreviewResult GraphPreviewExecutor::render(
@@ -353,7 +517,7 @@ GraphPreviewResult GraphPreviewExecutor::render(
     for (const auto& node : audioResult.nodes) {
         nodes.push_back(&node);
     }
-    return renderPreview(plan, nodes, pointCount);
+    return renderPreview(plan, nodes, pointCount, {}, nullptr, nullptr, &schedule);
 }
 
 GraphPreviewResult GraphPreviewExecutor::render(
@@ -366,7 +530,7 @@ GraphPreviewResult GraphPreviewExecutor::render(
     for (const auto& node : audioResult.nodes) {
         nodes.push_back(&node);
     }
-    GraphPreviewResult result = renderPreview(plan, nodes, pointCount);
+    GraphPreviewResult result = renderPreview(plan, nodes, pointCount, {}, nullptr, nullptr, &schedule);
     appendProbePreviews(result, plan, nodes, probes);
     return result;
 }
@@ -376,7 +540,8 @@ GraphPreviewResult GraphPreviewExecutor::render(
         const GraphAudioResultView& audioResult,
         const std::vector<SignalProbe>& probes,
         size_t pointCount) const {
-    GraphPreviewResult result = renderPreview(plan, audioResult.nodes, pointCount);
+    GraphPreviewResult result = renderPreview(
+            plan, audioResult.nodes, pointCount, {}, nullptr, nullptr, &schedule);
     appendProbePreviews(result, plan, audioResult.nodes, probes);
     return result;
 }
@@ -405,7 +570,8 @@ void GraphPreviewExecutor::renderIncremental(
         const std::vector<uint8_t>& dirtyNodes,
         size_t pointCount,
         GraphPreviewResult& result) const {
-    result = renderPreview(plan, audioResult.nodes, pointCount, std::move(result), &dirtyNodes);
+    result = renderPreview(
+            plan, audioResult.nodes, pointCount, std::move(result), &dirtyNodes, nullptr, &schedule);
     appendProbePreviews(result, plan, audioResult.nodes, probes);
 }
 
@@ -4,6 +4,10 @@
 #include "GraphAudioExecutor.h"
 #include "../Graph/GraphCompiler.h"
 
+#include <functional>
+
+class RealtimeWorkerPool;
+
 namespace CycleV2 {
 
 struct PreviewControlContext;
@@ -19,6 +23,7 @@ struct NodePreviewResult {
     TraversalGridFrequencySampling frequencySampling {
             TraversalGridFrequencySampling::LinearBins };
     int frequencyMidiNote { 48 };
+    double renderMilliseconds {};
 };
 
 struct GraphPreviewResult {
@@ -44,10 +49,30 @@ struct GraphPreviewResult {
     size_t aliasedInputCount {};
     size_t reusedCapturedTraversalCount {};
     size_t renderedNodeCount {};
+    size_t renderWaveCount {};
+    double renderMilliseconds {};
+    bool cancelled {};
+};
+
+/*
+ * How a render is spread out. Nodes are rendered in waves, each holding the
+ * nodes whose rendered inputs all finished in earlier waves, and a wave's
+ * nodes run side by side on the pool when there is one. The focus nodes and
+ * everything upstream of them start first within a wave, and isCurrent is
+ * polled before each node so a superseded revision stops early and comes
+ * back marked cancelled.
+ */
+struct PreviewSchedule {
+    RealtimeWorkerPool* pool {};
+    std::vector<String> focusNodeIds;
+    std::function<bool()> isCurrent;
 };
 
 class GraphPreviewExecutor {
 public:
+    GraphPreviewExecutor() = default;
+    explicit GraphPreviewExecutor(PreviewSchedule scheduleToUse) : schedule(std::move(scheduleToUse)) {}
+
     GraphPreviewResult render(const GraphExecutionPlan& plan, size_t pointCount) const;
     GraphPreviewResult render(
             const GraphExecutionPlan& plan,
@@ -81,6 +106,9 @@ public:
             const std::vector<uint8_t>& dirtyNodes,
             size_t pointCount,
             GraphPreviewResult& result) const;
+
+private:
+    PreviewSchedule schedule;
 };
 
 }
@@ -20,6 +20,11 @@ public:
         worker.addJob(new Job(state, std::move(work), std::move(publication)), true);
     }
 
+    // how long the last job to start waited behind the ones before it
+    double lastQueueMilliseconds() const {
+        return state->queueMilliseconds.load();
+    }
+
     void cancelAndWait() {
         constexpr int waitForLifetimeSafety = -1;
         worker.removeAllJobs(true, waitForLifetimeSafety);
@@ -33,6 +38,7 @@ public:
 private:
     struct State {
         std::atomic<bool> alive { true };
+        std::atomic<double> queueMilliseconds {};
     };
 
     class Job final : public juce::ThreadPoolJob {
@@ -44,10 +50,12 @@ private:
                 ThreadPoolJob("Cycle V2 causal preview")
             ,   state       (std::move(stateToUse))
             ,   work        (std::move(workToUse))
-            ,   publication (std::move(publicationToUse)) {
+            ,   publication (std::move(publicationToUse))
+            ,   postedMilliseconds (juce::Time::getMillisecondCounterHiRes()) {
         }
 
         JobStatus runJob() override {
+            state->queueMilliseconds.store(juce::Time::getMillisecondCounterHiRes() - postedMilliseconds);
             if (!state->alive.load() || !work()) {
                 return jobHasFinished;
             }
@@ -67,6 +75,7 @@ private:
         std::shared_ptr<State> state;
         std::function<bool()> work;
         std::function<void()> publication;
+        double postedMilliseconds {};
     };
 
     juce::ThreadPool worker { 1 };
@@ -4,42 +4,116 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
 namespace CycleV2 {
 
 using namespace juce;
 
-RealtimeGraphRenderer::RealtimeGraphRenderer() {
+namespace {
+
+std::atomic<uint64_t> nextGraphLineage { 1 };
+
+}
+
+RealtimeGraphRenderer::RealtimeGraphRenderer(int numWorkers) :
+        voices(maximumVoiceCount),
+        laneSplices(maximumVoiceCount) {
     midiControls.prepare(maximumEventsPerChannel);
     for (auto& voice : voices) {
         voice.context.events.reserve(RealtimeMidiEventQueue::capacity * 2);
         midiControls.prepareVoice(voice.context);
     }
+    if (numWorkers > 0) {
+        workerPool = std::make_unique<RealtimeWorkerPool>(numWorkers);
+    }
 }
 
 std::unique_ptr<RealtimeGraphRenderer::PreparedGraph>
 RealtimeGraphRenderer::prepareGraph(
         GraphExecutionPlan plan,
         uint64_t revision,
-        const AudioExecutionSpec& spec) {
+        const AudioExecutionSpec& spec,
+        size_t voiceCount,
+        size_t laneCount,
+        const PreparedGraph* previous) {
     auto prepared = std::make_unique<PreparedGraph>();
     prepared->revision = revision;
     prepared->plan = std::move(plan);
     prepared->spec = spec;
-    for (size_t voiceIndex = 0; voiceIndex < voiceCount; ++voiceIndex) {
-        prepared->executor.prepareExecution(
+    prepared->voiceCount = jlimit((size_t) 1, maximumVoiceCount, voiceCount);
+
+    const size_t lanes = jlimit((size_t) 1, prepared->voiceCount, laneCount);
+    prepared->laneMixes.resize(lanes);
+    prepared->laneChanged.assign(lanes, true);
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        prepared->executors.push_back(std::make_unique<GraphAudioExecutor>());
+        for (auto& channel : prepared->laneMixes[lane]) {
+            channel.assign(spec.maximumFrameCount, 0.f);
+        }
+    }
+
+    // voice v must land on the executor that rendered it before, with processors prepared the same way
+    const bool continues = previous != nullptr
+            && previous->voiceCount == prepared->voiceCount
+            && previous->laneCount() == lanes
+            && previous->spec.maximumFrameCount == spec.maximumFrameCount
+            && previous->spec.sampleRate == spec.sampleRate
+            && previous->spec.bpm == spec.bpm
+            && previous->spec.beatsPerMeasure == spec.beatsPerMeasure;
+    prepared->lineage = continues ? previous->lineage : nextGraphLineage.fetch_add(1);
+
+    for (size_t voiceIndex = 0; voiceIndex < prepared->voiceCount; ++voiceIndex) {
+        if (continues) {
+            prepared->adoptedProcessorCount += prepared->executorFor((int) voiceIndex).adoptPreparedState(
+                    previous->executorFor((int) voiceIndex),
+                    prepared->plan,
+                    prepared->spec,
+                    (int) voiceIndex);
+        }
+        prepared->executorFor((int) voiceIndex).prepareExecution(
                 prepared->plan,
                 prepared->spec,
                 (int) voiceIndex);
     }
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        const size_t laneProcessorCount = prepared->executors[lane]->preparedProcessorCount();
+        prepared->preparedProcessorCount += laneProcessorCount;
+        prepared->laneChanged[lane] = laneProcessorCount > 0;
+    }
     return prepared;
 }
 
+size_t RealtimeGraphRenderer::renderLaneCount() const {
+    return workerPool == nullptr ? 1 : (size_t) workerPool->getNumWorkers() + 1;
+}
+
+size_t RealtimeGraphRenderer::polyphony() const {
+    return preparedGraph == nullptr ? defaultVoiceCount : preparedGraph->voiceCount;
+}
+
 void RealtimeGraphRenderer::setPreparedGraph(PreparedGraph* graph) {
     if (preparedGraph == graph) {
         return;
     }
-    resetVoices();
+
+    const bool carriesVoices = graph != nullptr
+            && preparedGraph != nullptr
+            && graph->lineage == preparedGraph->lineage
+            && lastFrameCount > 0;
+    if (!carriesVoices) {
+        resetVoices();
+    } else {
+        // the old lane mixes still hold the last block, which the new lanes start from
+        const size_t lastFrame = (size_t) lastFrameCount - 1;
+        for (size_t lane = 0; lane < graph->laneCount(); ++lane) {
+            LaneSplice& splice = laneSplices[lane];
+            splice.remaining = graph->laneChanged[lane] ? spliceFrameCount : 0;
+            for (size_t channel = 0; channel < 2; ++channel) {
+                splice.offset[channel] = preparedGraph->laneMixes[lane][channel][lastFrame];
+            }
+        }
+    }
     preparedGraph = graph;
     activeRevision.store(graph == nullptr ? 0 : graph->revision, std::memory_order_release);
 }
@@ -62,6 +136,7 @@ void RealtimeGraphRenderer::process(
             || frameCount <= 0
             || (size_t) frameCount > preparedGraph->spec.maximumFrameCount) {
         activeVoices.store(0, std::memory_order_relaxed);
+        releasedVoices.store(0, std::memory_order_relaxed);
         outputPeak.store(0.f, std::memory_order_relaxed);
         outputRms.store(0.f, std::memory_order_relaxed);
         return;
@@ -82,15 +157,19 @@ void RealtimeGraphRenderer::resetVoices() {
         voice.normalizedTime = 0.f;
     }
     scheduledEventCount = 0;
+    for (auto& splice : laneSplices) {
+        splice.remaining = 0;
+    }
     midiControls.reset();
     activeVoices.store(0, std::memory_order_relaxed);
+    releasedVoices.store(0, std::memory_order_relaxed);
 }
 
 void RealtimeGraphRenderer::beginBlock() {
     midiControls.beginBlock();
-    for (auto& voice : voices) {
-        voice.context.events.clear();
-        voice.context.controlEvents.clear();
+    for (size_t index = 0; index < polyphony(); ++index) {
+        voices[index].context.events.clear();
+        voices[index].context.controlEvents.clear();
     }
 }
 
@@ -155,7 +234,8 @@ void RealtimeGraphRenderer::applyEvent(
 
         case RealtimeMidiEvent::Kind::NoteOff: {
             Voice* oldestMatchingVoice {};
-            for (auto& voice : voices) {
+            for (size_t index = 0; index < polyphony(); ++index) {
+                Voice& voice = voices[index];
                 if (voice.active
                         && !voice.released
                         && voice.source == event.source
@@ -168,8 +248,9 @@ void RealtimeGraphRenderer::applyEvent(
                 }
             }
             if (oldestMatchingVoice != nullptr) {
-                const bool hasTail = preparedGraph->executor.hasVoiceTailProcessor(
-                        oldestMatchingVoice->context.voiceIndex);
+                const int voiceIndex = oldestMatchingVoice->context.voiceIndex;
+                const bool hasTail = preparedGraph->executorFor(voiceIndex)
+                        .hasVoiceTailProcessor(voiceIndex);
                 oldestMatchingVoice->context.events.push_back({
                         hasTail ? NoteLifecycleType::NoteOff : NoteLifecycleType::Reset,
                         sampleOffset,
@@ -194,12 +275,14 @@ void RealtimeGraphRenderer::applyEvent(
 void RealtimeGraphRenderer::releaseSource(
         MidiEventSource source,
         size_t sampleOffset) {
-    for (auto& voice : voices) {
+    for (size_t index = 0; index < polyphony(); ++index) {
+        Voice& voice = voices[index];
         if (!voice.active || voice.released || voice.source != source) {
             continue;
         }
         const bool hasTail = preparedGraph != nullptr
-                && preparedGraph->executor.hasVoiceTailProcessor(voice.context.voiceIndex);
+                && preparedGraph->executorFor(voice.context.voiceIndex)
+                           .hasVoiceTailProcessor(voice.context.voiceIndex);
         voice.context.events.push_back({
                 hasTail ? NoteLifecycleType::NoteOff : NoteLifecycleType::Reset,
                 sampleOffset,
@@ -212,18 +295,18 @@ void RealtimeGraphRenderer::releaseSource(
 RealtimeGraphRenderer::Voice& RealtimeGraphRenderer::allocateVoice(
         const RealtimeMidiEvent& event,
         size_t sampleOffset) {
-    auto selected = std::find_if(voices.begin(), voices.end(), [](const auto& voice) {
+    const auto available = voices.begin() + (std::ptrdiff_t) polyphony();
+    auto selected = std::find_if(voices.begin(), available, [](const auto& voice) {
         return !voice.active;
     });
-    if (selected == voices.end()) {
-        selected = std::min_element(voices.begin(), voices.end(), [](const auto& left, const auto& right) {
-            return left.startOrder < right.startOrder;
-        });
-        selected->context.events.push_back({
+    if (selected == available) {
+        Voice& stolen = selectVoiceToSteal();
+        stolen.context.events.push_back({
                 NoteLifecycleType::Reset,
                 sampleOffset,
-                selected->context.voiceIndex
+                stolen.context.voiceIndex
         });
+        selected = voices.begin() + std::distance(voices.data(), &stolen);
     }
 
     const int voiceIndex = (int) std::distance(voices.begin(), selected);
@@ -237,23 +320,133 @@ RealtimeGraphRenderer::Voice& RealtimeGraphRenderer::allocateVoice(
     selected->noteNumber = event.data1;
     selected->velocity = (float) event.data2 / 127.f;
     selected->normalizedTime = 0.f;
+    // unmeasured until its first block, so a note started this block is stolen last
+    selected->level = std::numeric_limits<float>::max();
     selected->active = true;
     selected->released = false;
     return *selected;
 }
 
+/*
+ * Released voices are only finishing their tails, so they go before held
+ * ones. Among the candidates the quietest goes first, using the level of the
+ * voice's last rendered block, and the oldest breaks ties.
+ */
+RealtimeGraphRenderer::Voice& RealtimeGraphRenderer::selectVoiceToSteal() {
+    const auto available = voices.begin() + (std::ptrdiff_t) polyphony();
+    const bool anyReleased = std::any_of(voices.begin(), available, [](const auto& voice) {
+        return voice.released;
+    });
+
+    Voice* selected {};
+    for (auto voice = voices.begin(); voice != available; ++voice) {
+        if (anyReleased && !voice->released) {
+            continue;
+        }
+        if (selected == nullptr
+                || voice->level < selected->level
+                || (voice->level == selected->level && voice->startOrder < selected->startOrder)) {
+            selected = &*voice;
+        }
+    }
+    return *selected;
+}
+
+void RealtimeGraphRenderer::renderVoice(
+        Voice& voice,
+        int frameCount,
+        double sampleRate,
+        float timeIncrement) {
+    const size_t lane = (size_t) voice.context.voiceIndex % preparedGraph->laneCount();
+    auto& mix = preparedGraph->laneMixes[lane];
+    GraphAudioExecutor& executor = preparedGraph->executorFor(voice.context.voiceIndex);
+
+    const auto output = executor.processRealtime(
+            preparedGraph->plan,
+            (size_t) frameCount,
+            { sampleRate },
+            voice.context);
+    if (output.isValid() && output.payload != nullptr) {
+        const auto& payload = *output.payload;
+        const SignalBuffer& rightSamples = payload.isStereo()
+                ? payload.secondaryBlock.samples
+                : payload.block.samples;
+        Buffer<float> left(const_cast<float*>(payload.block.samples.data()), frameCount);
+        Buffer<float> right(const_cast<float*>(rightSamples.data()), frameCount);
+        Buffer<float>(mix[0].data(), frameCount).add(left);
+        Buffer<float>(mix[1].data(), frameCount).add(right);
+        voice.level = jmax(left.normL2(), right.normL2()) / std::sqrt((float) frameCount);
+    } else {
+        voice.level = 0.f;
+    }
+
+    voice.normalizedTime = jmin(
+            1.f,
+            voice.normalizedTime + timeIncrement * (float) frameCount);
+    if (voice.released && !executor.hasActiveVoiceTail(voice.context.voiceIndex)) {
+        voice.active = false;
+    }
+}
+
+void RealtimeGraphRenderer::renderLane(
+        size_t lane,
+        int frameCount,
+        double sampleRate,
+        float timeIncrement) {
+    auto& mix = preparedGraph->laneMixes[lane];
+    Buffer<float>(mix[0].data(), frameCount).zero();
+    Buffer<float>(mix[1].data(), frameCount).zero();
+    for (size_t index = lane; index < polyphony(); index += preparedGraph->laneCount()) {
+        if (voices[index].active) {
+            renderVoice(voices[index], frameCount, sampleRate, timeIncrement);
+        }
+    }
+    spliceLane(lane, frameCount);
+}
+
+/*
+ * A lane that prepared new processors restarts their state, so its first
+ * sample can jump away from the last one the old graph rendered. The jump is
+ * added back and faded out rather than crossfading two renders, since the
+ * processors the graphs share can only advance once per block.
+ */
+void RealtimeGraphRenderer::spliceLane(size_t lane, int frameCount) {
+    LaneSplice& splice = laneSplices[lane];
+    if (splice.remaining <= 0) {
+        return;
+    }
+
+    auto& mix = preparedGraph->laneMixes[lane];
+    if (splice.remaining == spliceFrameCount) {
+        for (size_t channel = 0; channel < 2; ++channel) {
+            splice.offset[channel] -= mix[channel][0];
+        }
+    }
+
+    const int count = jmin(frameCount, splice.remaining);
+    for (size_t channel = 0; channel < 2; ++channel) {
+        float* samples = mix[channel].data();
+        for (int i = 0; i < count; ++i) {
+            const float gain = (float) (splice.remaining - i) / (float) spliceFrameCount;
+            samples[i] += splice.offset[channel] * gain;
+        }
+    }
+    splice.remaining -= count;
+}
+
 void RealtimeGraphRenderer::renderVoices(
         float* const* outputChannels,
         int outputChannelCount,
         int frameCount,
         double sampleRate) {
-    size_t activeCount = 0;
     constexpr float voiceDurationSeconds = 7.f;
     const float timeIncrement = sampleRate > 0.
             ? 1.f / ((float) sampleRate * voiceDurationSeconds)
             : 0.f;
 
-    for (auto& voice : voices) {
+    // MIDI state is shared, so every voice's controls are filled before the lanes fan out
+    for (size_t index = 0; index < polyphony(); ++index) {
+        Voice& voice = voices[index];
         if (!voice.active) {
             continue;
         }
@@ -262,49 +455,42 @@ void RealtimeGraphRenderer::renderVoices(
         voice.context.controls.normalizedVoiceTime = voice.normalizedTime;
         voice.context.controls.normalizedVoiceTimeIncrement = timeIncrement;
         midiControls.populateVoice(voice.context, voice.midiChannel);
+    }
 
-        const auto output = preparedGraph->executor.processRealtime(
-                preparedGraph->plan,
-                (size_t) frameCount,
-                { sampleRate },
-                voice.context);
-        if (output.isValid() && output.payload != nullptr && outputChannelCount > 0) {
-            const auto& payload = *output.payload;
-            if (outputChannels[0] != nullptr) {
-                Buffer<float>(outputChannels[0], frameCount).add(
-                        Buffer<float>(
-                                const_cast<float*>(payload.block.samples.data()),
-                                frameCount));
-            }
-            if (outputChannelCount > 1 && outputChannels[1] != nullptr) {
-                const SignalBuffer& right = payload.isStereo()
-                        ? payload.secondaryBlock.samples
-                        : payload.block.samples;
-                Buffer<float>(outputChannels[1], frameCount).add(
-                        Buffer<float>(const_cast<float*>(right.data()), frameCount));
-            }
+    lastFrameCount = frameCount;
+    const size_t laneCount = preparedGraph->laneCount();
+    auto renderJob = [&](int lane) {
+        renderLane((size_t) lane, frameCount, sampleRate, timeIncrement);
+    };
+    if (workerPool != nullptr && laneCount > 1) {
+        workerPool->parallelFor((int) laneCount, renderJob);
+    } else {
+        for (size_t lane = 0; lane < laneCount; ++lane) {
+            renderJob((int) lane);
         }
+    }
 
-        voice.normalizedTime = jmin(
-                1.f,
-                voice.normalizedTime + timeIncrement * (float) frameCount);
-        if (voice.released && !preparedGraph->executor.hasActiveVoiceTail(
-                voice.context.voiceIndex)) {
-            voice.active = false;
+    for (int channel = 0; channel < jmin(2, outputChannelCount); ++channel) {
+        if (outputChannels[channel] == nullptr) {
+            continue;
         }
-        if (voice.active) {
-            ++activeCount;
+        Buffer<float> output(outputChannels[channel], frameCount);
+        for (size_t lane = 0; lane < laneCount; ++lane) {
+            output.add(Buffer<float>(preparedGraph->laneMixes[lane][(size_t) channel].data(), frameCount));
         }
+        output.mul(outputHeadroom).clip(-1.f, 1.f);
     }
 
-    for (int channel = 0; channel < jmin(2, outputChannelCount); ++channel) {
-        if (outputChannels[channel] != nullptr) {
-            Buffer<float>(outputChannels[channel], frameCount)
-                    .mul(outputHeadroom)
-                    .clip(-1.f, 1.f);
+    size_t activeCount = 0;
+    size_t releasedCount = 0;
+    for (size_t index = 0; index < polyphony(); ++index) {
+        if (voices[index].active) {
+            ++activeCount;
+            releasedCount += voices[index].released ? 1 : 0;
         }
     }
     activeVoices.store(activeCount, std::memory_order_relaxed);
+    releasedVoices.store(releasedCount, std::memory_order_relaxed);
 }
 
 void RealtimeGraphRenderer::publishMetrics(
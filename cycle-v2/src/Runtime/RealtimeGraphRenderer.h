@@ -5,6 +5,9 @@
 #include <array>
 #include <atomic>
 #include <memory>
+#include <vector>
+
+#include <Thread/RealtimeWorkerPool.h>
 
 #include "GraphAudioExecutor.h"
 #include "MidiControlState.h"
@@ -14,30 +17,58 @@ namespace CycleV2 {
 
 class RealtimeGraphRenderer {
 public:
-    static constexpr size_t voiceCount = 8;
+    static constexpr size_t defaultVoiceCount = 8;
+    static constexpr size_t maximumVoiceCount = 64;
 
+    /*
+     * An executor renders its voices one at a time, so voices are spread over
+     * render lanes that each own an executor and a stereo mix. Voice v always
+     * renders on lane v % laneCount, which keeps its processor state on one
+     * executor, and lanes are summed in order so the mix is deterministic.
+     *
+     * A graph prepared from a previous one with the same voices, lanes and
+     * spec adopts its unchanged processors and inherits its lineage. Swapping
+     * between graphs of one lineage keeps voices sounding, and only lanes that
+     * prepared something new are spliced onto the old output.
+     */
     struct PreparedGraph {
         uint64_t revision {};
+        uint64_t lineage {};
         GraphExecutionPlan plan;
         AudioExecutionSpec spec;
-        GraphAudioExecutor executor;
+        size_t voiceCount { defaultVoiceCount };
+        size_t adoptedProcessorCount {};
+        size_t preparedProcessorCount {};
+        std::vector<std::unique_ptr<GraphAudioExecutor>> executors;
+        std::vector<std::array<std::vector<float>, 2>> laneMixes;
+        std::vector<bool> laneChanged;
+
+        size_t laneCount() const { return executors.size(); }
+        GraphAudioExecutor& executorFor(int voiceIndex) const {
+            return *executors[(size_t) voiceIndex % executors.size()];
+        }
     };
 
     struct Diagnostics {
         uint64_t callbackCount {};
         uint64_t graphRevision {};
         size_t activeVoiceCount {};
+        size_t releasedVoiceCount {};
         size_t droppedMidiEvents {};
         float peak {};
         float rms {};
     };
 
-    RealtimeGraphRenderer();
+    explicit RealtimeGraphRenderer(int numWorkers = 0);
 
     static std::unique_ptr<PreparedGraph> prepareGraph(
             GraphExecutionPlan plan,
             uint64_t revision,
-            const AudioExecutionSpec& spec);
+            const AudioExecutionSpec& spec,
+            size_t voiceCount = defaultVoiceCount,
+            size_t laneCount = 1,
+            const PreparedGraph* previous = nullptr);
+    size_t renderLaneCount() const;
     void setPreparedGraph(PreparedGraph* graph);
     void process(
             RealtimeMidiEventQueue& events,
@@ -52,6 +83,7 @@ public:
                 callbackCounter.load(std::memory_order_acquire),
                 activeRevision.load(std::memory_order_acquire),
                 activeVoices.load(std::memory_order_acquire),
+                releasedVoices.load(std::memory_order_acquire),
                 events.droppedEventCount(),
                 outputPeak.load(std::memory_order_acquire),
                 outputRms.load(std::memory_order_acquire)
@@ -67,6 +99,7 @@ private:
         int noteNumber { 60 };
         float velocity { 1.f };
         float normalizedTime {};
+        float level {};
         bool active {};
         bool released {};
     };
@@ -80,6 +113,11 @@ private:
     void applyEvent(const RealtimeMidiEvent& event, size_t sampleOffset);
     void releaseSource(MidiEventSource source, size_t sampleOffset);
     Voice& allocateVoice(const RealtimeMidiEvent& event, size_t sampleOffset);
+    Voice& selectVoiceToSteal();
+    size_t polyphony() const;
+    void renderVoice(Voice& voice, int frameCount, double sampleRate, float timeIncrement);
+    void renderLane(size_t lane, int frameCount, double sampleRate, float timeIncrement);
+    void spliceLane(size_t lane, int frameCount);
     void renderVoices(
             float* const* outputChannels,
             int outputChannelCount,
@@ -90,12 +128,23 @@ private:
             int outputChannelCount,
             int frameCount);
 
+    // the step between the old and new graph's output decays away over this many samples
+    static constexpr int spliceFrameCount = 256;
+
+    struct LaneSplice {
+        std::array<float, 2> offset {};
+        int remaining {};
+    };
+
     static constexpr float outputHeadroom = 0.125f;
     static constexpr size_t maximumEventsPerChannel = 128;
     static constexpr size_t maximumScheduledEvents = RealtimeMidiEventQueue::capacity * 2;
 
     PreparedGraph* preparedGraph {};
-    std::array<Voice, voiceCount> voices;
+    std::vector<Voice> voices;
+    std::vector<LaneSplice> laneSplices;
+    int lastFrameCount {};
+    std::unique_ptr<RealtimeWorkerPool> workerPool;
     MidiControlState midiControls;
     std::array<RealtimeMidiEvent, maximumScheduledEvents> scheduledEvents;
     size_t scheduledEventCount {};
@@ -105,6 +154,7 @@ private:
     std::atomic<uint64_t> callbackCounter {};
     std::atomic<uint64_t> activeRevision {};
     std::atomic<size_t> activeVoices {};
+    std::atomic<size_t> releasedVoices {};
     std::atomic<float> outputPeak {};
     std::atomic<float> outputRms {};
 };
@@ -52,6 +52,30 @@ bool inputComesFromRegion(
             && regionSteps[(size_t) input->sourceStepIndex];
 }
 
+// visits the slots an operation reads, which callers may rewrite
+template <typename OperationT, typename Visitor>
+void forEachInput(OperationT& operation, Visitor&& visit) {
+    using Type = decltype(operation.type);
+    switch (operation.type) {
+        case Type::TimeTrimesh:
+        case Type::SpectralTrimesh:
+            return;
+        case Type::Ifft:
+            visit(operation.leftInput);
+            visit(operation.rightInput);
+            return;
+        case Type::Elementwise:
+            visit(operation.leftInput);
+            for (auto& term : operation.terms) {
+                visit(term.input);
+            }
+            return;
+        default:
+            visit(operation.leftInput);
+            return;
+    }
+}
+
 void applySpectralLayer(
         PortDomain domain,
         Buffer<float> source,
@@ -146,7 +170,7 @@ bool SpectralOscillatorFrameRenderer::prepare(
     std::vector<std::array<int, 2>> slotsForStep(
             plan.steps.size(),
             { -1, -1 });
-    int slotCount = 0;
+    int logicalSlotCount = 0;
 
     for (const int stepIndex : region.stepIndices) {
         const auto& step = plan.steps[(size_t) stepIndex];
@@ -157,7 +181,7 @@ bool SpectralOscillatorFrameRenderer::prepare(
         for (size_t outputIndex = 0;
                 outputIndex < step.outputs.size() && outputIndex < operation.outputs.size();
                 ++outputIndex) {
-            operation.outputs[outputIndex] = slotCount++;
+            operation.outputs[outputIndex] = logicalSlotCount++;
             slotsForStep[(size_t) stepIndex][outputIndex] = operation.outputs[outputIndex];
         }
 
@@ -239,8 +263,15 @@ bool SpectralOscillatorFrameRenderer::prepare(
                 break;
             }
             case AudioModuleRole::Ifft:     operation.type = OperationType::Ifft; break;
-            case AudioModuleRole::Add:      operation.type = OperationType::Add; break;
-            case AudioModuleRole::Multiply: operation.type = OperationType::Multiply; break;
+            case AudioModuleRole::Add:
+            case AudioModuleRole::Multiply:
+                operation.type = OperationType::Elementwise;
+                operation.terms.push_back({
+                        step.audioRole == AudioModuleRole::Multiply,
+                        operation.rightInput,
+                        operation.outputDomain == PortDomain::SpectralMagnitudeSignal
+                });
+                break;
             default: return false;
         }
         operations.push_back(std::move(operation));
@@ -249,9 +280,17 @@ bool SpectralOscillatorFrameRenderer::prepare(
     const auto& materialization = slotsForStep[
             (size_t) region.materializationStepIndex];
     outputSlot = materialization[0];
-    if (outputSlot < 0 || slotCount <= 0) {
+    if (outputSlot < 0 || logicalSlotCount <= 0) {
         return false;
     }
+
+    slotCount = logicalSlotCount;
+    if (fusesOperations) {
+        elideTransformPairs();
+        fuseElementwise(logicalSlotCount);
+        removeUnusedOperations(logicalSlotCount);
+        slotCount = assignSlots(logicalSlotCount);
+    }
     slotMemory.resize(2 * slotCount * slotStride);
 
     transforms.clear();
@@ -352,25 +391,9 @@ bool SpectralOscillatorFrameRenderer::renderFrame(
                 break;
             }
 
-            case OperationType::Add:
-                for (int channel = 0; channel < 2; ++channel) {
-                    auto output = slot(operation.outputs[0], channel, count);
-                    slot(operation.leftInput, channel, count).copyTo(output);
-                    output.add(slot(operation.rightInput, channel, count));
-                    if (operation.outputDomain == PortDomain::SpectralMagnitudeSignal) {
-                        output.threshLT(0.f);
-                    }
-                }
-                break;
-
-            case OperationType::Multiply:
+            case OperationType::Elementwise:
                 for (int channel = 0; channel < 2; ++channel) {
-                    auto output = slot(operation.outputs[0], channel, count);
-                    slot(operation.leftInput, channel, count).copyTo(output);
-                    output.mul(slot(operation.rightInput, channel, count));
-                    if (operation.outputDomain == PortDomain::SpectralMagnitudeSignal) {
-                        output.threshLT(0.f);
-                    }
+                    renderElementwise(operation, channel, count);
                 }
                 break;
         }
@@ -382,6 +405,218 @@ bool SpectralOscillatorFrameRenderer::renderFrame(
     return true;
 }
 
+/*
+ * Runs the operation's terms a tile at a time, so a chain of them reads each
+ * input and writes the output once per frame. The running value stays in the
+ * tile until every term is applied, which also lets the output share a slot
+ * with one of the inputs.
+ */
+void SpectralOscillatorFrameRenderer::renderElementwise(
+        const Operation& operation,
+        int channel,
+        int count) {
+    auto input = slot(operation.leftInput, channel, count);
+    auto output = slot(operation.outputs[0], channel, count);
+
+    for (int start = 0; start < count; start += elementwiseTileSize) {
+        const int size = jmin(elementwiseTileSize, count - start);
+        Buffer<float> value(tile.data(), size);
+        input.section(start, size).copyTo(value);
+
+        for (const auto& term : operation.terms) {
+            auto operand = slot(term.input, channel, count).section(start, size);
+            if (term.multiply) {
+                value.mul(operand);
+            } else {
+                value.add(operand);
+            }
+            if (term.clamp) {
+                value.threshLT(0.f);
+            }
+        }
+        value.copyTo(output.section(start, size));
+    }
+}
+
+// an inverse transform of a forward transform's own outputs gives back the frame it was given
+void SpectralOscillatorFrameRenderer::elideTransformPairs() {
+    for (const auto& inverse : operations) {
+        if (inverse.type != OperationType::Ifft) {
+            continue;
+        }
+        const auto forward = std::find_if(
+                operations.begin(),
+                operations.end(),
+                [&](const Operation& operation) {
+                    return operation.type == OperationType::Fft
+                            && operation.outputs[0] == inverse.leftInput
+                            && operation.outputs[1] == inverse.rightInput;
+                });
+        if (forward == operations.end()) {
+            continue;
+        }
+
+        const int frame = forward->leftInput;
+        const int inverted = inverse.outputs[0];
+        for (auto& operation : operations) {
+            forEachInput(operation, [&](int& input) {
+                if (input == inverted) {
+                    input = frame;
+                }
+            });
+        }
+        if (outputSlot == inverted) {
+            outputSlot = frame;
+        }
+    }
+}
+
+/*
+ * Folds an add or multiply into the one reading its result when nothing else
+ * does. Both are commutative, so the folded side can be either operand.
+ */
+void SpectralOscillatorFrameRenderer::fuseElementwise(int logicalSlotCount) {
+    std::vector<int> producers((size_t) logicalSlotCount, -1);
+    std::vector<int> readCounts((size_t) logicalSlotCount);
+    for (size_t index = 0; index < operations.size(); ++index) {
+        auto& operation = operations[index];
+        for (const int output : operation.outputs) {
+            if (output >= 0) {
+                producers[(size_t) output] = (int) index;
+            }
+        }
+        forEachInput(operation, [&](int& input) {
+            ++readCounts[(size_t) input];
+        });
+    }
+
+    const auto fusable = [&](const Operation& operation, int input) -> Operation* {
+        const int producer = input >= 0 ? producers[(size_t) input] : -1;
+        if (producer < 0 || readCounts[(size_t) input] != 1 || input == outputSlot) {
+            return nullptr;
+        }
+        auto& source = operations[(size_t) producer];
+        return source.type == OperationType::Elementwise
+                        && source.outputDomain == operation.outputDomain
+                ? &source
+                : nullptr;
+    };
+
+    for (auto& operation : operations) {
+        if (operation.type != OperationType::Elementwise || operation.terms.size() != 1) {
+            continue;
+        }
+
+        auto terms = operation.terms;
+        Operation* source = fusable(operation, operation.leftInput);
+        if (source == nullptr && (source = fusable(operation, terms.front().input)) != nullptr) {
+            terms.front().input = operation.leftInput;
+        }
+        if (source == nullptr) {
+            continue;
+        }
+
+        operation.leftInput = source->leftInput;
+        operation.terms = source->terms;
+        operation.terms.insert(operation.terms.end(), terms.begin(), terms.end());
+        source->terms.clear();
+        source->leftInput = -1;
+    }
+}
+
+void SpectralOscillatorFrameRenderer::removeUnusedOperations(int logicalSlotCount) {
+    std::vector<bool> live((size_t) logicalSlotCount);
+    std::vector<bool> keep(operations.size());
+    live[(size_t) outputSlot] = true;
+
+    for (size_t index = operations.size(); index-- > 0;) {
+        auto& operation = operations[index];
+        keep[index] = std::any_of(
+                operation.outputs.begin(),
+                operation.outputs.end(),
+                [&](int output) {
+                    return output >= 0 && live[(size_t) output];
+                });
+        if (keep[index]) {
+            forEachInput(operation, [&](int& input) {
+                if (input >= 0) {
+                    live[(size_t) input] = true;
+                }
+            });
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t index = 0; index < operations.size(); ++index) {
+        if (keep[index]) {
+            if (kept != index) {
+                operations[kept] = std::move(operations[index]);
+            }
+            ++kept;
+        }
+    }
+    operations.resize(kept);
+}
+
+/*
+ * Maps the program's slots onto as few as it needs at once: a slot is free
+ * again after the last operation reading it. Only elementwise operations
+ * write over a slot they read, as the others fill their outputs while still
+ * reading.
+ */
+int SpectralOscillatorFrameRenderer::assignSlots(int logicalSlotCount) {
+    std::vector<int> lastReads((size_t) logicalSlotCount, -1);
+    for (size_t index = 0; index < operations.size(); ++index) {
+        forEachInput(operations[index], [&](int& input) {
+            lastReads[(size_t) input] = (int) index;
+        });
+    }
+    lastReads[(size_t) outputSlot] = (int) operations.size();
+
+    std::vector<int> physical((size_t) logicalSlotCount, -1);
+    std::vector<int> freeSlots;
+    std::vector<int> released;
+    int physicalCount = 0;
+
+    for (size_t index = 0; index < operations.size(); ++index) {
+        auto& operation = operations[index];
+        released.clear();
+        forEachInput(operation, [&](int& input) {
+            const int logical = input;
+            if (lastReads[(size_t) logical] == (int) index
+                    && std::find(released.begin(), released.end(), physical[(size_t) logical])
+                            == released.end()) {
+                released.push_back(physical[(size_t) logical]);
+            }
+            input = physical[(size_t) logical];
+        });
+
+        for (auto& output : operation.outputs) {
+            if (output < 0) {
+                continue;
+            }
+            const int logical = output;
+            if (operation.type == OperationType::Elementwise && !released.empty()) {
+                output = released.back();
+                released.pop_back();
+            } else if (!freeSlots.empty()) {
+                output = freeSlots.back();
+                freeSlots.pop_back();
+            } else {
+                output = physicalCount++;
+            }
+            physical[(size_t) logical] = output;
+            if (lastReads[(size_t) logical] < 0) {
+                released.push_back(output);
+            }
+        }
+        freeSlots.insert(freeSlots.end(), released.begin(), released.end());
+    }
+
+    outputSlot = physical[(size_t) outputSlot];
+    return physicalCount;
+}
+
 int SpectralOscillatorFrameRenderer::valueCount(
         PortDomain domain,
         int frameSize) {
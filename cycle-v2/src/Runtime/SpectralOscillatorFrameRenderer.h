@@ -31,6 +31,16 @@ public:
             Buffer<float> right);
     size_t frameRenderCount() const { return renderCount; }
 
+    /*
+     * Whether prepare optimizes the program it builds from the region's
+     * steps: inverse transforms of an untouched forward transform are
+     * dropped, chains of adds and multiplies run as one pass, and slots are
+     * reused once nothing reads them. Off runs one operation per step.
+     */
+    void setFusesOperations(bool shouldFuse) { fusesOperations = shouldFuse; }
+    size_t operationCount() const { return operations.size(); }
+    int intermediateSlotCount() const { return slotCount; }
+
 private:
     enum class OperationType {
         TimeTrimesh,
@@ -38,8 +48,14 @@ private:
         SpectralLayer,
         Fft,
         Ifft,
-        Add,
-        Multiply
+        Elementwise
+    };
+
+    // one add or multiply applied to the running value, clamped at zero for magnitudes
+    struct ElementwiseTerm {
+        bool multiply {};
+        int input { -1 };
+        bool clamp {};
     };
 
     struct Operation {
@@ -52,19 +68,31 @@ private:
         float pan { 0.5f };
         float range { 0.5f };
         bool additive { true };
+        std::vector<ElementwiseTerm> terms;
         std::unique_ptr<Rasterization::VoiceRasterizer> timeRasterizer;
         std::unique_ptr<Rasterization::VoiceCycleState> timeState;
         std::unique_ptr<TrimeshBlockwiseDsp> spectralRasterizer;
     };
 
+    static constexpr int elementwiseTileSize = 256;
+
     static int valueCount(PortDomain domain, int frameSize);
     Buffer<float> slot(int slotIndex, int channel, int valueCount);
     Transform* transformFor(int frameSize);
 
+    void elideTransformPairs();
+    void fuseElementwise(int logicalSlotCount);
+    void removeUnusedOperations(int logicalSlotCount);
+    int assignSlots(int logicalSlotCount);
+    void renderElementwise(const Operation& operation, int channel, int count);
+
     int maximumFrameSize {};
     int slotStride {};
+    int slotCount {};
     int outputSlot { -1 };
+    bool fusesOperations { true };
     size_t renderCount {};
+    std::array<float, elementwiseTileSize> tile {};
     std::vector<Operation> operations;
     std::vector<std::unique_ptr<Transform>> transforms;
     ScopedAlloc<float> slotMemory;
@@ -898,9 +898,22 @@ void NodeCanvas::showEdgeMenu(int edgeIndex, Point<float> screenPosition) {
             });
 }
 
+void NodeCanvas::updatePreviewFocus() {
+    std::vector<String> focus;
+    if (expandedNodeId.isNotEmpty()) {
+        focus.push_back(expandedNodeId);
+    }
+    const Node* hovered = queries.findNodeAt(viewport.toWorld(lastMousePosition));
+    if (hovered != nullptr && hovered->id != expandedNodeId) {
+        focus.push_back(hovered->id);
+    }
+    presentation.setPreviewFocus(std::move(focus));
+}
+
 void NodeCanvas::refreshCompiledState() {
     compiledStateRefreshPending = false;
     editorCoordinator.clearPreviewCache();
+    updatePreviewFocus();
     presentation.refresh(graph, document.revision(), document.lastChange());
     refreshProbeDetail();
 }
@@ -912,6 +925,7 @@ void NodeCanvas::refreshCompiledStateAsync() {
     const GraphChangeSet& refreshChange = commands.hasTransientEdit()
             ? commands.transientChanges()
             : document.lastChange();
+    updatePreviewFocus();
     presentation.refreshAsync(
             refreshGraph,
             document.revision(),
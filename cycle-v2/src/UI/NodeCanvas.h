@@ -170,6 +170,7 @@ private:
     Point<float> viewportCentreWorld() const;
     void refreshCompiledState();
     void refreshCompiledStateAsync();
+    void updatePreviewFocus();
     void setPreviewVoiceLength(double seconds);
     void openProbeDetail(const String& probeId);
     void refreshProbeDetail();
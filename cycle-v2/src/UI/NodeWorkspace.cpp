@@ -244,6 +244,7 @@ var NodeWorkspace::performanceStateForAutomation() const {
     object->setProperty("callbackCount", (int64) status.renderer.callbackCount);
     object->setProperty("graphRevision", (int64) status.renderer.graphRevision);
     object->setProperty("activeVoiceCount", (int) status.renderer.activeVoiceCount);
+    object->setProperty("releasedVoiceCount", (int) status.renderer.releasedVoiceCount);
     object->setProperty("droppedMidiEvents", (int) status.renderer.droppedMidiEvents);
     object->setProperty("peak", status.renderer.peak);
     object->setProperty("rms", status.renderer.rms);
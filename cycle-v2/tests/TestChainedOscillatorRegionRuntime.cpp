@@ -15,6 +15,9 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <iostream>
+#include <vector>
 
 using namespace CycleV2;
 
@@ -36,6 +39,66 @@ public:
     std::array<float, CycleDsp::maximumUnisonOrder> renderedPhases {};
 };
 
+CycleDsp::UnisonVoiceLayout spreadLayout(int order) {
+    CycleDsp::UnisonIndividualConfiguration configuration;
+    configuration.order = order;
+    configuration.detuneWidthCents = 20.f;
+    for (int i = 0; i < order; ++i) {
+        const float position = order > 1 ? (float) i / (float) (order - 1) : 0.5f;
+        configuration.detunePositions[(size_t) i] = position;
+        configuration.pans[(size_t) i] = position;
+        configuration.phaseCycles[(size_t) i] = 0.137f * (float) i;
+    }
+    return CycleDsp::UnisonCore::makeIndividualLayout(configuration);
+}
+
+std::vector<float> renderTrimeshLanes(
+        TrimeshOscillatorCycleRenderer& renderer,
+        const CycleDsp::UnisonVoiceLayout& layout,
+        int blockCount) {
+    constexpr int blockSize = 256;
+    ChainedOscillatorRegionRuntime runtime;
+    REQUIRE(runtime.prepare(blockSize, 4096, 44100.0, layout));
+
+    std::vector<float> output((size_t) (2 * blockSize * blockCount));
+    for (int block = 0; block < blockCount; ++block) {
+        float* left = output.data() + 2 * blockSize * block;
+        REQUIRE(runtime.process(
+                57, 1.f, {},
+                Buffer<float>(left, blockSize),
+                Buffer<float>(left + blockSize, blockSize),
+                renderer));
+    }
+    return output;
+}
+
+// mesh -> fft -> ifft, with mag * mag + mag between them when processed
+NodeGraph spectralChainGraph(bool processed) {
+    GraphNodeFactory factory;
+    NodeGraph graph;
+    graph.addNode(factory.createNode(NodeKind::VoiceContext, "voice", {}));
+    graph.addNode(factory.createNode(NodeKind::TrilinearMesh, "mesh", {}));
+    graph.addNode(factory.createNode(NodeKind::Fft, "fft", {}));
+    graph.addNode(factory.createNode(NodeKind::Ifft, "ifft", {}));
+    REQUIRE(GraphEditor().connect(graph, { "voice", "context", false }, { "mesh", "context", true }).succeeded());
+    REQUIRE(GraphEditor().connect(graph, { "mesh", "out", false }, { "fft", "time", true }).succeeded());
+    REQUIRE(GraphEditor().connect(graph, { "fft", "phase", false }, { "ifft", "phase", true }).succeeded());
+
+    if (!processed) {
+        REQUIRE(GraphEditor().connect(graph, { "fft", "mag", false }, { "ifft", "mag", true }).succeeded());
+        return graph;
+    }
+
+    graph.addNode(factory.createNode(NodeKind::Multiply, "square", {}));
+    graph.addNode(factory.createNode(NodeKind::Add, "sum", {}));
+    REQUIRE(GraphEditor().connect(graph, { "fft", "mag", false }, { "square", "left", true }).succeeded());
+    REQUIRE(GraphEditor().connect(graph, { "fft", "mag", false }, { "square", "right", true }).succeeded());
+    REQUIRE(GraphEditor().connect(graph, { "square", "out", false }, { "sum", "left", true }).succeeded());
+    REQUIRE(GraphEditor().connect(graph, { "fft", "mag", false }, { "sum", "right", true }).succeeded());
+    REQUIRE(GraphEditor().connect(graph, { "sum", "out", false }, { "ifft", "mag", true }).succeeded());
+    return graph;
+}
+
 }
 
 TEST_CASE("Chained oscillator runtime folds prepared lanes with Cycle 1 pan and level",
@@ -150,6 +213,73 @@ TEST_CASE("Trimesh oscillator lanes consume the mature chained VoiceRasterizer",
     mesh->destroy();
 }
 
+TEST_CASE("Trimesh oscillator lanes share one cycle between unison voices",
+        "[cycle-v2][runtime][oscillator-region][unison][trimesh]") {
+    auto mesh = TrimeshMeshFactory::createDefaultMesh("SharedLaneTrimesh");
+    auto configuration = std::make_shared<TrimeshConfiguration>();
+    configuration->mesh = std::shared_ptr<const Mesh>(mesh.get(), [](const Mesh*) {});
+    const auto layout = spreadLayout(5);
+
+    TrimeshOscillatorCycleRenderer shared;
+    TrimeshOscillatorCycleRenderer separate;
+    separate.setSliceSharing(false);
+    REQUIRE(shared.prepare(configuration, layout.order));
+    REQUIRE(separate.prepare(configuration, layout.order));
+    REQUIRE(shared.sharesSlices());
+    REQUIRE_FALSE(separate.sharesSlices());
+
+    const auto expected = renderTrimeshLanes(separate, layout, 16);
+    const auto actual = renderTrimeshLanes(shared, layout, 16);
+
+    // each lane is the shared cycle turned by its phase, so only rounding separates them
+    double error = 0.0;
+    double energy = 0.0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        error += (double) (actual[i] - expected[i]) * (actual[i] - expected[i]);
+        energy += (double) expected[i] * expected[i];
+    }
+    REQUIRE(energy > 0.0);
+    REQUIRE(std::sqrt(error / energy) < 1.0e-3);
+
+    // the highest lane drives the shared cycle, the rest only sample it
+    REQUIRE(separate.sliceRenderCount() > 4 * shared.sliceRenderCount());
+
+    configuration.reset();
+    mesh->destroy();
+}
+
+TEST_CASE("Trimesh oscillator cycle render time against unison lane count",
+        "[cycle-v2][runtime][oscillator-region][unison][trimesh][benchmark][.]") {
+    auto mesh = TrimeshMeshFactory::createDefaultMesh("LaneCountTrimesh");
+    auto configuration = std::make_shared<TrimeshConfiguration>();
+    configuration->mesh = std::shared_ptr<const Mesh>(mesh.get(), [](const Mesh*) {});
+    constexpr int blockCount = 400;
+
+    for (int order = 1; order <= CycleDsp::maximumUnisonOrder; ++order) {
+        const auto layout = spreadLayout(order);
+        double milliseconds[2] {};
+
+        for (bool sharing : { false, true }) {
+            TrimeshOscillatorCycleRenderer renderer;
+            renderer.setSliceSharing(sharing);
+            REQUIRE(renderer.prepare(configuration, order));
+
+            const double start = Time::getMillisecondCounterHiRes();
+            const auto output = renderTrimeshLanes(renderer, layout, blockCount);
+            milliseconds[sharing ? 1 : 0] = Time::getMillisecondCounterHiRes() - start;
+            REQUIRE(std::isfinite(output.back()));
+        }
+
+        const double seconds = blockCount * 256 / 44100.0;
+        std::cout << order << " lanes: separate " << 0.1 * milliseconds[0] / seconds << "% cpu"
+                  << ", shared " << 0.1 * milliseconds[1] / seconds << "% cpu"
+                  << " (" << milliseconds[0] / milliseconds[1] << "x)" << std::endl;
+    }
+
+    configuration.reset();
+    mesh->destroy();
+}
+
 TEST_CASE("Spectral oscillator recipes preserve a fixed Trimesh frame through FFT",
         "[cycle-v2][runtime][oscillator-region][spectral-frame][trimesh]") {
     GraphNodeFactory factory;
@@ -225,6 +355,95 @@ TEST_CASE("Spectral oscillator recipes preserve a fixed Trimesh frame through FF
             }) < 1.0e-5f);
 }
 
+TEST_CASE("Spectral oscillator frames run a fused program over reused slots",
+        "[cycle-v2][runtime][oscillator-region][spectral-frame][trimesh]") {
+    for (bool processed : { false, true }) {
+        INFO("processed " << processed);
+        const auto graph = spectralChainGraph(processed);
+        const auto compiled = GraphCompiler().compile(graph);
+        REQUIRE(compiled.succeeded());
+        REQUIRE(compiled.plan.oscillatorRegions.size() == 1);
+        const auto& region = compiled.plan.oscillatorRegions.front();
+
+        SpectralOscillatorFrameRenderer fused;
+        SpectralOscillatorFrameRenderer stepwise;
+        stepwise.setFusesOperations(false);
+        REQUIRE(fused.prepare(compiled.plan, region, 16384));
+        REQUIRE(stepwise.prepare(compiled.plan, region, 16384));
+
+        // the ifft of an untouched fft is the mesh frame itself
+        if (processed) {
+            REQUIRE(stepwise.operationCount() == 5);
+            REQUIRE(fused.operationCount() == 4);
+            REQUIRE(fused.intermediateSlotCount() == 3);
+        } else {
+            REQUIRE(stepwise.operationCount() == 3);
+            REQUIRE(fused.operationCount() == 1);
+            REQUIRE(fused.intermediateSlotCount() == 1);
+        }
+        REQUIRE(stepwise.intermediateSlotCount() == (processed ? 6 : 4));
+
+        constexpr int frameSize = 1024;
+        std::array<float, 2 * frameSize> expected {};
+        std::array<float, 2 * frameSize> actual {};
+        REQUIRE(stepwise.renderFrame(
+                frameSize, 60,
+                Buffer<float>(expected.data(), frameSize),
+                Buffer<float>(expected.data() + frameSize, frameSize)));
+        REQUIRE(fused.renderFrame(
+                frameSize, 60,
+                Buffer<float>(actual.data(), frameSize),
+                Buffer<float>(actual.data() + frameSize, frameSize)));
+
+        REQUIRE(std::any_of(actual.begin(), actual.end(), [](float sample) {
+            return sample != 0.f;
+        }));
+        REQUIRE(Buffer<float>(actual.data(), 2 * frameSize).normDiffL2({
+                        expected.data(),
+                        2 * frameSize
+                }) < 1.0e-4f);
+    }
+}
+
+TEST_CASE("Spectral oscillator frame rate, fused against stepwise",
+        "[cycle-v2][runtime][oscillator-region][spectral-frame][benchmark][.]") {
+    constexpr int framesPerRun = 2000;
+
+    for (bool processed : { false, true }) {
+        const auto graph = spectralChainGraph(processed);
+        const auto compiled = GraphCompiler().compile(graph);
+        REQUIRE(compiled.succeeded());
+        const auto& region = compiled.plan.oscillatorRegions.front();
+
+        for (int frameSize : { 256, 2048 }) {
+            std::vector<float> output((size_t) (2 * frameSize));
+            double framesPerSecond[2] {};
+
+            for (bool fusing : { false, true }) {
+                SpectralOscillatorFrameRenderer renderer;
+                renderer.setFusesOperations(fusing);
+                REQUIRE(renderer.prepare(compiled.plan, region, 16384));
+
+                const double start = Time::getMillisecondCounterHiRes();
+                for (int frame = 0; frame < framesPerRun; ++frame) {
+                    renderer.renderFrame(
+                            frameSize, 60,
+                            Buffer<float>(output.data(), frameSize),
+                            Buffer<float>(output.data() + frameSize, frameSize));
+                }
+                const double elapsed = Time::getMillisecondCounterHiRes() - start;
+                framesPerSecond[fusing ? 1 : 0] = 1000.0 * framesPerRun / elapsed;
+                REQUIRE(std::isfinite(output.back()));
+            }
+
+            std::cout << (processed ? "fft-mul-add-ifft" : "fft-ifft") << " " << frameSize
+                      << ": stepwise " << framesPerSecond[0] << " frames/s"
+                      << ", fused " << framesPerSecond[1] << " frames/s"
+                      << " (" << framesPerSecond[1] / framesPerSecond[0] << "x)" << std::endl;
+        }
+    }
+}
+
 TEST_CASE("Stengah phase layer pans survive spectral materialization",
         "[cycle-v2][runtime][oscillator-region][spectral-frame][pan][preset]") {
   #if defined(CYCLE_V2_SOURCE_DIR)
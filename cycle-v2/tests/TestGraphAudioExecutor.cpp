@@ -1,3 +1,4 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 
@@ -23,7 +24,9 @@
 #include <array>
 #include <atomic>
 #include <cstdlib>
+#include <iostream>
 #include <new>
+#include <string>
 
 #if JUCE_MAC
 #include <pthread.h>
@@ -2117,3 +2120,108 @@ TEST_CASE("Realtime observation is optional and fan-out shares compiled slot sto
     REQUIRE(observer.sourceSamples != nullptr);
     REQUIRE(observer.consumerSamples == observer.sourceSamples);
 }
+
+TEST_CASE("Prepared voices resolve processors by step ordinal across recompiles",
+        "[cycle-v2][runtime][realtime]") {
+    GraphNodeFactory factory;
+    NodeGraph graph;
+    graph.addNode(factory.createNode(NodeKind::Envelope, "env", {}));
+    setEnvelopePurpose(graph, "env", EnvelopePurpose::Volume);
+    graph.addNode(factory.createNode(NodeKind::WaveSource, "wave", {}));
+    graph.addNode(factory.createNode(NodeKind::Multiply, "multiply", {}));
+    graph.addNode(factory.createNode(NodeKind::Output, "output", {}));
+    graph.addEdge({ "wave", "out", "multiply", "left", PortDomain::TimeSignal, ConnectionKind::Signal });
+    graph.addEdge({ "env", "env", "multiply", "right", PortDomain::EnvelopeSignal, ConnectionKind::Signal });
+    graph.addEdge({ "multiply", "out", "output", "time", PortDomain::TimeSignal, ConnectionKind::Signal });
+
+    GraphCompiler compiler;
+    const auto first = compiler.compile(graph);
+    const auto recompiled = compiler.compile(graph);
+    REQUIRE(first.succeeded());
+    REQUIRE(recompiled.succeeded());
+
+    GraphAudioExecutor executor;
+    AudioExecutionSpec spec;
+    spec.maximumFrameCount = 16;
+    executor.prepareExecution(first.plan, spec, 0);
+    REQUIRE(executor.hasVoiceTailProcessor(0));
+    REQUIRE_FALSE(executor.hasVoiceTailProcessor(3));
+
+    executor.prepareExecution(recompiled.plan, spec, 0);
+    executor.prepareExecution(recompiled.plan, spec, 2);
+    REQUIRE(executor.preparationCount("env", 0) == 1);
+    REQUIRE(executor.preparationCount("env", 2) == 1);
+    REQUIRE(executor.hasVoiceTailProcessor(2));
+
+    AudioVoiceContext voice;
+    voice.voiceIndex = 2;
+    size_t realtimeAllocations {};
+    {
+        ScopedRealtimeAllocationCount allocationCount;
+        REQUIRE(executor.processRealtime(recompiled.plan, 16, {}, voice).isValid());
+        realtimeAllocations = allocationCount.count();
+    }
+    REQUIRE(realtimeAllocations == 0);
+
+    NodeGraph withoutEnvelope;
+    withoutEnvelope.addNode(factory.createNode(NodeKind::WaveSource, "wave", {}));
+    const auto replacement = compiler.compile(withoutEnvelope);
+    REQUIRE(replacement.succeeded());
+    executor.prepareExecution(replacement.plan, spec, 0);
+    REQUIRE_FALSE(executor.hasVoiceTailProcessor(0));
+    REQUIRE(executor.preparationCount("env", 0) == 0);
+    REQUIRE(executor.preparationCount("wave", 0) == 1);
+    REQUIRE(executor.preparationCount("env", 2) == 1);
+}
+
+TEST_CASE("Realtime dispatch overhead for long processor chains",
+        "[cycle-v2][runtime][realtime][benchmark][.]") {
+    const auto chainPlan = [](int nodeCount) {
+        const auto signalPort = [](String id, bool input) {
+            return Port { id, id, PortDomain::TimeSignal, ChannelLayout::Mono, PortPurpose::Signal, input };
+        };
+        GraphNodeFactory factory;
+        NodeGraph graph;
+        String previous = "node0";
+        graph.addNode({ previous, NodeKind::GenericProcessor, {}, {}, {}, {}, { signalPort("out", false) } });
+        for (int index = 1; index < nodeCount; ++index) {
+            const String id = "node" + String(index);
+            graph.addNode({
+                    id,
+                    NodeKind::GenericProcessor,
+                    {},
+                    {},
+                    {},
+                    { signalPort("in", true) },
+                    { signalPort("out", false) }
+            });
+            graph.addEdge({ previous, "out", id, "in", PortDomain::TimeSignal, ConnectionKind::Signal });
+            previous = id;
+        }
+        graph.addNode(factory.createNode(NodeKind::Output, "output", {}));
+        graph.addEdge({ previous, "out", "output", "time", PortDomain::TimeSignal, ConnectionKind::Signal });
+        auto compiled = GraphCompiler().compile(graph);
+        REQUIRE(compiled.succeeded());
+        return compiled.plan;
+    };
+
+    constexpr size_t frameCount = 64;
+    for (const int nodeCount : { 50, 200, 1000 }) {
+        const auto plan = chainPlan(nodeCount);
+        GraphAudioExecutor executor;
+        AudioExecutionSpec spec;
+        spec.maximumFrameCount = frameCount;
+        executor.prepareExecution(plan, spec);
+        AudioVoiceContext voice;
+        std::cout << nodeCount << " nodes: " << plan.buffers.size() << " buffers in "
+                  << plan.bufferSlotCount << " slots" << std::endl;
+
+        BENCHMARK("processRealtime " + std::to_string(nodeCount) + " nodes") {
+            return executor.processRealtime(plan, frameCount, {}, voice).payload;
+        };
+        BENCHMARK("prepareExecution unchanged " + std::to_string(nodeCount) + " nodes") {
+            executor.prepareExecution(plan, spec);
+            return executor.hasVoiceTailProcessor(0);
+        };
+    }
+}
@@ -1,3 +1,4 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 
@@ -5,9 +6,11 @@
 #include "../src/Graph/GraphEditor.h"
 #include "../src/Nodes/Control/ModulationTriple.h"
 #include "../src/Graph/GraphNodeFactory.h"
+#include "../src/Graph/GraphSerializer.h"
 #include "../src/Nodes/Effect2D/CurveNodeModels.h"
 
 #include <algorithm>
+#include <iostream>
 
 using namespace CycleV2;
 
@@ -86,6 +89,76 @@ const GraphBufferPlan& findBuffer(const GraphExecutionPlan& plan, const String&
     return *found;
 }
 
+void requireDisjointSlotLifetimes(const GraphExecutionPlan& plan) {
+    REQUIRE(plan.bufferSlotCount <= plan.buffers.size());
+    for (size_t i = 0; i < plan.buffers.size(); ++i) {
+        const auto& left = plan.buffers[i];
+        REQUIRE(left.slot >= 0);
+        REQUIRE((size_t) left.slot < plan.bufferSlotCount);
+        for (size_t j = i + 1; j < plan.buffers.size(); ++j) {
+            const auto& right = plan.buffers[j];
+            if (left.slot != right.slot) {
+                continue;
+            }
+            INFO(left.id << " and " << right.id << " share slot " << left.slot);
+            const int leftLast = std::max(left.lastConsumerStep, left.firstProducerStep);
+            const int rightLast = std::max(right.lastConsumerStep, right.firstProducerStep);
+            REQUIRE((leftLast < right.firstProducerStep || rightLast < left.firstProducerStep));
+        }
+    }
+}
+
+// independent effect chains, so an edit to one leaves the others untouched
+NodeGraph effectChainGraph(int chainCount, int chainLength) {
+    GraphNodeFactory factory;
+    NodeGraph graph;
+    for (int chain = 0; chain < chainCount; ++chain) {
+        String previous;
+        for (int link = 0; link < chainLength; ++link) {
+            const String id = "fx." + String(chain) + "." + String(link);
+            graph.addNode(factory.createNode(link % 2 == 0 ? NodeKind::Equalizer : NodeKind::Delay, id, {}));
+            if (previous.isNotEmpty()) {
+                graph.addEdge({ previous, "time", id, "time", PortDomain::TimeSignal, ConnectionKind::Signal });
+            }
+            previous = id;
+        }
+    }
+    return graph;
+}
+
+void requireSamePlan(const GraphExecutionPlan& actual, const GraphExecutionPlan& expected) {
+    REQUIRE(actual.nodeOrder == expected.nodeOrder);
+    REQUIRE(actual.steps.size() == expected.steps.size());
+    REQUIRE(actual.buffers.size() == expected.buffers.size());
+    REQUIRE(actual.bufferSlotCount == expected.bufferSlotCount);
+    REQUIRE(actual.dependencyIndex.dependents == expected.dependencyIndex.dependents);
+    for (size_t stepIndex = 0; stepIndex < actual.steps.size(); ++stepIndex) {
+        const auto& step = actual.steps[stepIndex];
+        const auto& expectedStep = expected.steps[stepIndex];
+        INFO(step.nodeId);
+        REQUIRE(step.nodeId == expectedStep.nodeId);
+        REQUIRE(step.configuration.key == expectedStep.configuration.key);
+        REQUIRE(step.inputs.size() == expectedStep.inputs.size());
+        for (size_t inputIndex = 0; inputIndex < step.inputs.size(); ++inputIndex) {
+            REQUIRE(step.inputs[inputIndex].sourceStepIndex == expectedStep.inputs[inputIndex].sourceStepIndex);
+            REQUIRE(step.inputs[inputIndex].sourceBufferIndex == expectedStep.inputs[inputIndex].sourceBufferIndex);
+        }
+    }
+}
+
+std::vector<File> presetCorpus() {
+    const File root(CYCLE_V2_SOURCE_DIR);
+    std::vector<File> files;
+    for (const File& directory : { root.getChildFile("content").getChildFile("presets"),
+                                   root.getChildFile("resources") }) {
+        for (const auto& file : directory.findChildFiles(File::findFiles, false, "*.cyclegraph")) {
+            files.push_back(file);
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
 }
 
 TEST_CASE("Demo graph compiles to a stable execution order", "[cycle-v2][graph]") {
@@ -736,3 +809,112 @@ TEST_CASE("Compiler assigns output slots and source lifetimes before processing"
     REQUIRE(buffer.firstProducerStep >= 0);
     REQUIRE(buffer.lastConsumerStep > buffer.firstProducerStep);
 }
+
+TEST_CASE("Compiler shares buffer slots between disjoint lifetimes", "[cycle-v2][graph]") {
+    GraphNodeFactory factory;
+    NodeGraph graph;
+    graph.addNode(graphNode("source", {}, { output("signal", PortDomain::TimeSignal) }));
+    for (const String& id : { String("a"), String("b"), String("c") }) {
+        graph.addNode(graphNode(
+                id,
+                { input("in", PortDomain::TimeSignal) },
+                { output("signal", PortDomain::TimeSignal) }));
+    }
+    graph.addNode(factory.createNode(NodeKind::Output, "output", {}));
+    graph.addEdge({ "source", "signal", "a", "in", PortDomain::TimeSignal, ConnectionKind::Signal });
+    graph.addEdge({ "a", "signal", "b", "in", PortDomain::TimeSignal, ConnectionKind::Signal });
+    graph.addEdge({ "b", "signal", "c", "in", PortDomain::TimeSignal, ConnectionKind::Signal });
+    graph.addEdge({ "c", "signal", "output", "time", PortDomain::TimeSignal, ConnectionKind::Signal });
+
+    const auto result = GraphCompiler().compile(graph);
+    REQUIRE(result.succeeded());
+    requireDisjointSlotLifetimes(result.plan);
+
+    const auto& source = findBuffer(result.plan, "source", "signal");
+    const auto& a = findBuffer(result.plan, "a", "signal");
+    const auto& b = findBuffer(result.plan, "b", "signal");
+    const auto& c = findBuffer(result.plan, "c", "signal");
+
+    // a reads source while writing its own output, so those two can't alias
+    CHECK(source.slot != a.slot);
+    CHECK(source.slot == b.slot);
+    CHECK(b.slot != c.slot);
+    CHECK(result.plan.bufferSlotCount < result.plan.buffers.size());
+
+    // the realtime output is a view into the sink's input, so nothing after it may reuse the slot
+    const int sinkStep = stepPlanIndex(result.plan, "output");
+    for (const auto& buffer : result.plan.buffers) {
+        if (&buffer != &c && buffer.firstProducerStep > c.firstProducerStep) {
+            CHECK(buffer.slot != c.slot);
+        }
+    }
+    CHECK(c.lastConsumerStep == sinkStep);
+}
+
+TEST_CASE("Repository presets compile to disjoint buffer slot lifetimes", "[cycle-v2][graph][presets]") {
+    const auto files = presetCorpus();
+    REQUIRE_FALSE(files.empty());
+    for (const auto& file : files) {
+        INFO(file.getFileName());
+        const NodeGraph graph = GraphSerializer().fromJsonString(file.loadFileAsString());
+        const auto result = GraphCompiler().compile(graph);
+        REQUIRE(result.succeeded());
+        requireDisjointSlotLifetimes(result.plan);
+    }
+}
+
+TEST_CASE("Buffer slot counts across the preset corpus", "[cycle-v2][graph][presets][report][.]") {
+    size_t totalBuffers {};
+    size_t totalSlots {};
+    for (const auto& file : presetCorpus()) {
+        const NodeGraph graph = GraphSerializer().fromJsonString(file.loadFileAsString());
+        const auto result = GraphCompiler().compile(graph);
+        if (!result.succeeded()) {
+            continue;
+        }
+        totalBuffers += result.plan.buffers.size();
+        totalSlots += result.plan.bufferSlotCount;
+        std::cout << file.getFileName() << ": "
+                  << result.plan.buffers.size() << " buffers -> "
+                  << result.plan.bufferSlotCount << " slots" << std::endl;
+    }
+    std::cout << "total: " << totalBuffers << " buffers -> " << totalSlots << " slots" << std::endl;
+}
+
+TEST_CASE("Recompiling after an edit matches a fresh compile", "[cycle-v2][graph]") {
+    NodeGraph graph = effectChainGraph(6, 5);
+    GraphCompiler compiler;
+    const auto before = compiler.compile(graph);
+    REQUIRE(before.succeeded());
+
+    const auto edit = GraphEditor().setNodeParameter(graph, "fx.2.2", "band1Gain", "Band 1 Gain", "0.8");
+    REQUIRE(edit.succeeded());
+    const auto edited = compiler.compile(graph);
+
+    REQUIRE(edited.succeeded());
+    requireSamePlan(edited.plan, GraphCompiler().compile(graph).plan);
+    CHECK(findStep(edited.plan, "fx.2.2").configuration.revision
+            > findStep(before.plan, "fx.2.2").configuration.revision);
+    CHECK(findStep(edited.plan, "fx.2.1").configuration.value
+            == findStep(before.plan, "fx.2.1").configuration.value);
+
+    graph.addEdge({ "fx.0.4", "time", "fx.1.0", "time", PortDomain::TimeSignal, ConnectionKind::Signal });
+    const auto relinked = compiler.compile(graph);
+
+    REQUIRE(relinked.succeeded());
+    requireSamePlan(relinked.plan, GraphCompiler().compile(graph).plan);
+    REQUIRE(findStep(relinked.plan, "fx.1.0").inputs.size() == 1);
+}
+
+TEST_CASE("Compile time on large synthetic graphs", "[cycle-v2][graph][benchmark][.]") {
+    for (const int chainCount : { 8, 32, 128 }) {
+        NodeGraph graph = effectChainGraph(chainCount, 12);
+        GraphCompiler compiler;
+        REQUIRE(compiler.compile(graph).succeeded());
+
+        const std::string nodes = std::to_string(graph.getNodes().size()) + " nodes";
+        BENCHMARK("compile " + nodes) {
+            return compiler.compile(graph).plan.steps.size();
+        };
+    }
+}
@@ -14,6 +14,7 @@
 
 #include <Curve/Mesh/Mesh.h>
 #include <Curve/Mesh/Vertex.h>
+#include <Thread/RealtimeWorkerPool.h>
 
 #include <algorithm>
 #include <cmath>
@@ -663,6 +664,51 @@ TEST_CASE("Incremental preview rendering preserves clean cached nodes",
     REQUIRE(findPreview(result, "waveMesh").primary == cleanBefore);
 }
 
+TEST_CASE("Pooled preview rendering matches the serial render", "[cycle-v2][runtime][preview]") {
+    const auto compileResult = GraphCompiler().compile(NodeGraph::createDemoGraph());
+    REQUIRE(compileResult.succeeded());
+
+    const auto serial = GraphPreviewExecutor().render(compileResult.plan, 16);
+
+    RealtimeWorkerPool pool(3, Thread::Priority::normal);
+    PreviewSchedule schedule;
+    schedule.pool = &pool;
+    schedule.focusNodeIds = { "env" };
+    const auto pooled = GraphPreviewExecutor(schedule).render(compileResult.plan, 16);
+
+    REQUIRE_FALSE(pooled.cancelled);
+    REQUIRE(pooled.renderedNodeCount == serial.renderedNodeCount);
+    REQUIRE(pooled.renderWaveCount == serial.renderWaveCount);
+    // independent nodes share a wave
+    REQUIRE(pooled.renderWaveCount < pooled.renderedNodeCount);
+    REQUIRE(pooled.previewResultIndexByStep == serial.previewResultIndexByStep);
+    REQUIRE(pooled.nodes.size() == serial.nodes.size());
+
+    for (size_t i = 0; i < serial.nodes.size(); ++i) {
+        INFO(serial.nodes[i].nodeId);
+        REQUIRE(pooled.nodes[i].nodeId == serial.nodes[i].nodeId);
+        REQUIRE(pooled.nodes[i].primary == serial.nodes[i].primary);
+        REQUIRE(pooled.nodes[i].secondary == serial.nodes[i].secondary);
+        REQUIRE(pooled.nodes[i].renderMilliseconds >= 0.0);
+    }
+}
+
+TEST_CASE("A superseded preview render stops before finishing", "[cycle-v2][runtime][preview]") {
+    const auto compileResult = GraphCompiler().compile(NodeGraph::createDemoGraph());
+    REQUIRE(compileResult.succeeded());
+
+    const auto complete = GraphPreviewExecutor().render(compileResult.plan, 16);
+    REQUIRE(complete.renderedNodeCount > 1);
+
+    int checks = 0;
+    PreviewSchedule schedule;
+    schedule.isCurrent = [&] { return ++checks <= 2; };
+    const auto superseded = GraphPreviewExecutor(schedule).render(compileResult.plan, 16);
+
+    REQUIRE(superseded.cancelled);
+    REQUIRE(superseded.renderedNodeCount < complete.renderedNodeCount);
+}
+
 TEST_CASE("Graph preview executor skips non-preview utility nodes", "[cycle-v2][runtime]") {
     const auto compileResult = GraphCompiler().compile(NodeGraph::createDemoGraph());
     REQUIRE(compileResult.succeeded());
@@ -1,11 +1,29 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 
 #include "../src/Graph/GraphCompiler.h"
+#include "../src/Graph/GraphEditor.h"
 #include "../src/Graph/NodeGraph.h"
 #include "../src/Runtime/RealtimeGraphRenderer.h"
 
+#include <iostream>
+#include <string>
+
 using namespace CycleV2;
 using namespace juce;
+using Catch::Approx;
+
+namespace {
+    void pressNotes(RealtimeMidiEventQueue& queue, int count, int firstNote, double time) {
+        for (int note = 0; note < count; ++note) {
+            REQUIRE(queue.enqueue(
+                    MidiMessage::noteOn(1, firstNote + note, (uint8) 100),
+                    MidiEventSource::Hardware,
+                    time));
+        }
+    }
+}
 
 TEST_CASE("Realtime graph renderer turns MIDI note gestures into graph audio",
         "[cycle-v2][audio-device][realtime][midi]") {
@@ -53,7 +71,7 @@ TEST_CASE("Realtime graph renderer isolates voices and steals the oldest voice",
     RealtimeMidiEventQueue queue;
     renderer.setPreparedGraph(prepared.get());
 
-    for (size_t note = 0; note < RealtimeGraphRenderer::voiceCount + 1; ++note) {
+    for (size_t note = 0; note < RealtimeGraphRenderer::defaultVoiceCount + 1; ++note) {
         REQUIRE(queue.enqueue(
                 MidiMessage::noteOn(1, 48 + (int) note, (uint8) 100),
                 MidiEventSource::Hardware,
@@ -63,7 +81,7 @@ TEST_CASE("Realtime graph renderer isolates voices and steals the oldest voice",
     AudioBuffer<float> output(2, 64);
     float* channels[] { output.getWritePointer(0), output.getWritePointer(1) };
     renderer.process(queue, channels, 2, 64, 44100.0, 2.0);
-    REQUIRE(renderer.diagnostics(queue).activeVoiceCount == RealtimeGraphRenderer::voiceCount);
+    REQUIRE(renderer.diagnostics(queue).activeVoiceCount == RealtimeGraphRenderer::defaultVoiceCount);
 }
 
 TEST_CASE("Realtime graph renderer defers events beyond the current callback",
@@ -91,3 +109,212 @@ TEST_CASE("Realtime graph renderer defers events beyond the current callback",
     REQUIRE(renderer.diagnostics(queue).activeVoiceCount == 1);
     REQUIRE(renderer.diagnostics(queue).peak > 0.f);
 }
+
+TEST_CASE("Realtime graph renderer honours the polyphony chosen at prepare time",
+        "[cycle-v2][audio-device][realtime][midi]") {
+    const auto compiled = GraphCompiler().compile(NodeGraph::createDemoGraph());
+    REQUIRE(compiled.succeeded());
+
+    AudioExecutionSpec spec;
+    spec.maximumFrameCount = 64;
+    auto prepared = RealtimeGraphRenderer::prepareGraph(compiled.plan, 1, spec, 16, 3);
+    REQUIRE(prepared->voiceCount == 16);
+    REQUIRE(prepared->laneCount() == 3);
+    REQUIRE(RealtimeGraphRenderer::prepareGraph(compiled.plan, 1, spec, 1000)->voiceCount
+            == RealtimeGraphRenderer::maximumVoiceCount);
+
+    RealtimeGraphRenderer renderer;
+    RealtimeMidiEventQueue queue;
+    renderer.setPreparedGraph(prepared.get());
+    pressNotes(queue, 17, 40, 2.0);
+
+    AudioBuffer<float> output(2, 64);
+    float* channels[] { output.getWritePointer(0), output.getWritePointer(1) };
+    renderer.process(queue, channels, 2, 64, 44100.0, 2.0);
+    REQUIRE(renderer.diagnostics(queue).activeVoiceCount == 16);
+    REQUIRE(renderer.diagnostics(queue).peak > 0.f);
+}
+
+TEST_CASE("Realtime graph renderer steals released voices before held ones",
+        "[cycle-v2][audio-device][realtime][midi]") {
+    const auto compiled = GraphCompiler().compile(NodeGraph::createDemoGraph());
+    REQUIRE(compiled.succeeded());
+
+    AudioExecutionSpec spec;
+    spec.maximumFrameCount = 64;
+    auto prepared = RealtimeGraphRenderer::prepareGraph(compiled.plan, 1, spec);
+    RealtimeGraphRenderer renderer;
+    RealtimeMidiEventQueue queue;
+    renderer.setPreparedGraph(prepared.get());
+
+    AudioBuffer<float> output(2, 64);
+    float* channels[] { output.getWritePointer(0), output.getWritePointer(1) };
+    pressNotes(queue, (int) RealtimeGraphRenderer::defaultVoiceCount, 48, 2.0);
+    renderer.process(queue, channels, 2, 64, 44100.0, 2.0);
+
+    // the newest note is released, so it is still the only tail when the next note arrives
+    REQUIRE(queue.enqueue(MidiMessage::noteOff(1, 55), MidiEventSource::Hardware, 2.1));
+    renderer.process(queue, channels, 2, 64, 44100.0, 2.1);
+    REQUIRE(renderer.diagnostics(queue).activeVoiceCount == RealtimeGraphRenderer::defaultVoiceCount);
+    REQUIRE(renderer.diagnostics(queue).releasedVoiceCount == 1);
+
+    pressNotes(queue, 1, 72, 2.2);
+    renderer.process(queue, channels, 2, 64, 44100.0, 2.2);
+    REQUIRE(renderer.diagnostics(queue).activeVoiceCount == RealtimeGraphRenderer::defaultVoiceCount);
+    REQUIRE(renderer.diagnostics(queue).releasedVoiceCount == 0);
+}
+
+TEST_CASE("Realtime graph renderer mixes pooled lanes like a single lane",
+        "[cycle-v2][audio-device][realtime][midi]") {
+    const auto compiled = GraphCompiler().compile(NodeGraph::createDemoGraph());
+    REQUIRE(compiled.succeeded());
+
+    AudioExecutionSpec spec;
+    spec.maximumFrameCount = 128;
+    auto serialGraph = RealtimeGraphRenderer::prepareGraph(compiled.plan, 1, spec, 12, 1);
+    RealtimeGraphRenderer serial;
+    serial.setPreparedGraph(serialGraph.get());
+
+    RealtimeGraphRenderer pooled(2);
+    REQUIRE(pooled.renderLaneCount() == 3);
+    auto pooledGraph = RealtimeGraphRenderer::prepareGraph(
+            compiled.plan, 1, spec, 12, pooled.renderLaneCount());
+    pooled.setPreparedGraph(pooledGraph.get());
+
+    RealtimeMidiEventQueue serialQueue, pooledQueue;
+    pressNotes(serialQueue, 10, 50, 2.0);
+    pressNotes(pooledQueue, 10, 50, 2.0);
+
+    AudioBuffer<float> serialOutput(2, 128), pooledOutput(2, 128);
+    float* serialChannels[] { serialOutput.getWritePointer(0), serialOutput.getWritePointer(1) };
+    float* pooledChannels[] { pooledOutput.getWritePointer(0), pooledOutput.getWritePointer(1) };
+    for (int block = 0; block < 4; ++block) {
+        const double time = 2.0 + block * 0.01;
+        serial.process(serialQueue, serialChannels, 2, 128, 44100.0, time);
+        pooled.process(pooledQueue, pooledChannels, 2, 128, 44100.0, time);
+
+        for (int channel = 0; channel < 2; ++channel) {
+            for (int i = 0; i < 128; ++i) {
+                REQUIRE(pooledOutput.getSample(channel, i)
+                        == Approx(serialOutput.getSample(channel, i)).margin(1.0e-5f));
+            }
+        }
+    }
+    REQUIRE(pooled.diagnostics(pooledQueue).activeVoiceCount == 10);
+    REQUIRE(serial.diagnostics(serialQueue).peak > 0.f);
+}
+
+TEST_CASE("Realtime graph renderer swaps in an edited graph without cutting voices",
+        "[cycle-v2][audio-device][realtime][midi]") {
+    NodeGraph graph = NodeGraph::createDemoGraph();
+    GraphCompiler compiler;
+    const auto compiled = compiler.compile(graph);
+    REQUIRE(compiled.succeeded());
+    REQUIRE(GraphEditor().setNodeParameter(graph, "scratchEnv", "red", "Red", "0.75").succeeded());
+    const auto edited = compiler.compile(graph);
+    REQUIRE(edited.succeeded());
+
+    AudioExecutionSpec spec;
+    spec.maximumFrameCount = 128;
+    RealtimeGraphRenderer renderer(1);
+    auto first = RealtimeGraphRenderer::prepareGraph(compiled.plan, 1, spec, 8, renderer.renderLaneCount());
+    auto second = RealtimeGraphRenderer::prepareGraph(
+            edited.plan, 2, spec, 8, renderer.renderLaneCount(), first.get());
+    auto unrelated = RealtimeGraphRenderer::prepareGraph(edited.plan, 3, spec, 8, renderer.renderLaneCount());
+
+    REQUIRE(second->lineage == first->lineage);
+    REQUIRE(unrelated->lineage != first->lineage);
+    REQUIRE(second->adoptedProcessorCount > 0);
+    REQUIRE(second->preparedProcessorCount < first->preparedProcessorCount);
+    REQUIRE(second->executorFor(0).preparationCount("env", 0) == 1);
+    REQUIRE(second->executorFor(1).preparationCount("multiply", 1) == 1);
+
+    RealtimeMidiEventQueue queue;
+    AudioBuffer<float> output(2, 128);
+    float* channels[] { output.getWritePointer(0), output.getWritePointer(1) };
+    renderer.setPreparedGraph(first.get());
+    pressNotes(queue, 2, 60, 1.0);
+    renderer.process(queue, channels, 2, 128, 44100.0, 1.0);
+    REQUIRE(renderer.diagnostics(queue).activeVoiceCount == 2);
+
+    renderer.setPreparedGraph(second.get());
+    renderer.process(queue, channels, 2, 128, 44100.0, 1.01);
+    REQUIRE(renderer.diagnostics(queue).graphRevision == 2);
+    REQUIRE(renderer.diagnostics(queue).activeVoiceCount == 2);
+    REQUIRE(renderer.diagnostics(queue).peak > 0.f);
+
+    renderer.setPreparedGraph(unrelated.get());
+    renderer.process(queue, channels, 2, 128, 44100.0, 1.02);
+    REQUIRE(renderer.diagnostics(queue).activeVoiceCount == 0);
+}
+
+TEST_CASE("Realtime graph renderer prepare time for a one-parameter edit",
+        "[cycle-v2][audio-device][realtime][benchmark][.]") {
+    NodeGraph graph = NodeGraph::createDemoGraph();
+    GraphCompiler compiler;
+    const auto compiled = compiler.compile(graph);
+    REQUIRE(compiled.succeeded());
+    REQUIRE(GraphEditor().setNodeParameter(graph, "scratchEnv", "red", "Red", "0.75").succeeded());
+    const auto edited = compiler.compile(graph);
+    REQUIRE(edited.succeeded());
+
+    AudioExecutionSpec spec;
+    spec.maximumFrameCount = 512;
+    const size_t lanes = (size_t) RealtimeWorkerPool::defaultWorkerCount() + 1;
+    auto previous = RealtimeGraphRenderer::prepareGraph(
+            compiled.plan, 1, spec, RealtimeGraphRenderer::maximumVoiceCount, lanes);
+
+    auto adopted = RealtimeGraphRenderer::prepareGraph(
+            edited.plan, 2, spec, RealtimeGraphRenderer::maximumVoiceCount, lanes, previous.get());
+    std::cout << "RealtimeGraphRenderer edit adopts " << adopted->adoptedProcessorCount
+              << " processors, prepares " << adopted->preparedProcessorCount
+              << " of " << previous->preparedProcessorCount << std::endl;
+
+    BENCHMARK("fresh preparation") {
+        return RealtimeGraphRenderer::prepareGraph(
+                edited.plan, 2, spec, RealtimeGraphRenderer::maximumVoiceCount, lanes);
+    };
+    BENCHMARK("adopting preparation") {
+        return RealtimeGraphRenderer::prepareGraph(
+                edited.plan, 2, spec, RealtimeGraphRenderer::maximumVoiceCount, lanes, previous.get());
+    };
+}
+
+TEST_CASE("Realtime graph renderer callback time by active voice count",
+        "[cycle-v2][audio-device][realtime][benchmark][.]") {
+    const auto compiled = GraphCompiler().compile(NodeGraph::createDemoGraph());
+    REQUIRE(compiled.succeeded());
+
+    constexpr int blockSize = 512;
+    AudioExecutionSpec spec;
+    spec.maximumFrameCount = blockSize;
+    AudioBuffer<float> output(2, blockSize);
+    float* channels[] { output.getWritePointer(0), output.getWritePointer(1) };
+
+    const int workers = RealtimeWorkerPool::defaultWorkerCount();
+    std::cout << "RealtimeGraphRenderer workers=" << workers << " block=" << blockSize << std::endl;
+
+    for (int voices : { 1, 8, 16, 32, 64 }) {
+        for (bool usePool : { false, true }) {
+            RealtimeGraphRenderer renderer(usePool ? workers : 0);
+            auto prepared = RealtimeGraphRenderer::prepareGraph(
+                    compiled.plan,
+                    1,
+                    spec,
+                    RealtimeGraphRenderer::maximumVoiceCount,
+                    renderer.renderLaneCount());
+            RealtimeMidiEventQueue queue;
+            renderer.setPreparedGraph(prepared.get());
+            pressNotes(queue, voices, 24, 1.0);
+            renderer.process(queue, channels, 2, blockSize, 44100.0, 1.0);
+            REQUIRE(renderer.diagnostics(queue).activeVoiceCount == (size_t) voices);
+
+            const std::string name = std::to_string(voices) + " voices, "
+                    + std::to_string(renderer.renderLaneCount()) + " lanes";
+            BENCHMARK(name) {
+                renderer.process(queue, channels, 2, blockSize, 44100.0, 1.0);
+                return output.getSample(0, 0);
+            };
+        }
+    }
+}
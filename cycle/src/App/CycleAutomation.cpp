@@ -1206,6 +1206,7 @@ namespace {
         vertex->values[Vertex::Phase] += dx;
         vertex->values[Vertex::Amp] += dy;
         mesh->validate();
+        mesh->markEdited();
         return true;
     }
 
@@ -755,6 +755,8 @@ void CycleTour::performAction(Action& action) {
                         movingVert->values[action.id] = action.value;
                     }
 
+                    itr->markMeshEdited();
+
                     if(action.triggersUpdate) {
                         getObj(VertexPropertiesPanel).setSelectedAndCaller(itr);
                         itr->postUpdateMessage();
@@ -79,7 +79,10 @@ public:
         addSectionLabel(visualInputLabel, "Input and dialogs", visualPanel);
         addSettingButton(selectWithRightButton, "Select with right click", getSetting(SelectWithRight) == 1);
         addSettingButton(nativeDialogsButton, "Use native file dialogs", getSetting(NativeDialogs) == 1);
-        visualPanel->setSize(560, 280);
+        addSectionLabel(visualPresetsLabel, "Presets", visualPanel);
+        addSettingButton(compactPresetsButton, "Save compact binary presets (older versions can't open them)",
+                         getSetting(CompactPresets) == 1);
+        visualPanel->setSize(560, 380);
         tabs.addTab("Visual", Colour::greyLevel(0.08f), visualPanel, true);
 
         pitchPanel = new Component();
@@ -137,6 +140,10 @@ public:
             getSetting(SelectWithRight) = selectWithRightButton.getToggleState();
         } else if (button == &nativeDialogsButton) {
             getSetting(NativeDialogs) = nativeDialogsButton.getToggleState();
+        } else if (button == &compactPresetsButton) {
+            getSetting(CompactPresets) = compactPresetsButton.getToggleState();
+            getObj(Document).setSaveFormat(compactPresetsButton.getToggleState()
+                    ? Document::BinaryFormat : Document::JsonFormat);
         }
     }
 
@@ -212,6 +219,11 @@ private:
             button->setBounds(r.removeFromTop(32));
             r.removeFromTop(6);
         }
+
+        r.removeFromTop(14);
+        visualPresetsLabel.setBounds(r.removeFromTop(22));
+        r.removeFromTop(8);
+        compactPresetsButton.setBounds(r.removeFromTop(32));
     }
 
     void layoutPitchPanel() {
@@ -238,9 +250,11 @@ private:
     ToggleButton realtimeUpdateButton;
     ToggleButton selectWithRightButton;
     ToggleButton nativeDialogsButton;
+    ToggleButton compactPresetsButton;
 
     Label visualEditingLabel;
     Label visualInputLabel;
+    Label visualPresetsLabel;
 
     Label pitchAlgoLabel;
     Label pitchTipLabel;
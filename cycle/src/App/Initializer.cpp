@@ -1,5 +1,6 @@
 #include <Algo/Pitch/PitchTracker.h>
 #include <App/AppConstants.h>
+#include <App/Doc/Document.h>
 #include <App/EditWatcher.h>
 #include <Audio/AudioHub.h>
 #include <Audio/Multisample.h>
@@ -186,6 +187,9 @@ void Initializer::doPostInitWiring() {
     getObj(GeneralControls).addKeyListener(handler);
     getObj(VertexPropertiesPanel).addKeyListener(handler);
 
+    // the setting is read from disk in Settings::init, so only now is it known
+    getObj(Document).setSaveFormat(getSetting(CompactPresets) ? Document::BinaryFormat : Document::JsonFormat);
+
     repo->setConsole(&getObj(Console));
     repo->setGuideCurveProvider(&getObj(GuideCurvePanel));
     getObj(TimeRasterizer).setGuideCurveProvider(&getObj(GuideCurvePanel));
@@ -290,6 +294,7 @@ void Initializer::setDefaultSettings() {
     getObj(Settings).addDocumentSetting(DocSettings::ResamplingAlgoRend,   "ResamplingAlgoRend",   Resampling::Sinc);
     getObj(Settings).addDocumentSetting(DocSettings::OversampleFactorRltm, "OversampleFactorRltm", 1);
     getObj(Settings).addDocumentSetting(DocSettings::OversampleFactorRend, "OversampleFactorRend", 2);
+    getObj(Settings).addDocumentSetting(DocSettings::NativeRateRendering,  "NativeRateRendering",  true);
 
     getSetting(IgnoringMessages) 		= true;
     getSetting(MagnitudeDrawMode) 		= true;
@@ -305,6 +310,7 @@ void Initializer::setDefaultSettings() {
     getSetting(UseRedDepth) 			= false;
     getSetting(UseBlueDepth) 			= false;
     getSetting(UseLargerPoints) 		= false;
+    getSetting(ParallelVoiceRendering) 	= false;
     getSetting(TimeEnabled) 			= true;
     getSetting(FilterEnabled) 			= true;
     getSetting(PhaseEnabled) 			= true;
@@ -100,6 +100,8 @@ namespace {
         for (auto* vert : mesh->getVerts()) {
             vert->values[dim] = minValue + vert->values[dim] * scale;
         }
+
+        mesh->markEdited();
     }
 
     bool rangeAlreadyUsesEffectPadding(const VertexRange& range, float padding, bool hasRightPadding) {
@@ -0,0 +1,82 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <App/Doc/Document.h>
+#include <App/SingletonRepo.h>
+#include <JuceHeader.h>
+
+#include <iostream>
+
+#include "CycleTestHarness.h"
+
+using namespace juce;
+using namespace CycleTestSupport;
+
+namespace {
+    struct FormatTiming {
+        double saveMillis { 0 };
+        double loadMillis { 0 };
+        int64 bytes { 0 };
+    };
+
+    FormatTiming timeFormat(SingletonRepo& repo, Document::Format format) {
+        auto& document = repo.get<Document>("Document");
+        FormatTiming timing;
+
+        document.setSaveFormat(format);
+
+        MemoryOutputStream saved;
+        double start = Time::getMillisecondCounterHiRes();
+        document.save(&saved);
+        timing.saveMillis = Time::getMillisecondCounterHiRes() - start;
+        timing.bytes = (int64) saved.getDataSize();
+
+        MemoryInputStream input(saved.getData(), saved.getDataSize(), false);
+
+        ScopedPresetLoadSuppression suppressPresetUpdates(repo);
+        start = Time::getMillisecondCounterHiRes();
+        REQUIRE(document.open(&input));
+        timing.loadMillis = Time::getMillisecondCounterHiRes() - start;
+
+        return timing;
+    }
+}
+
+TEST_CASE("Preset save and load time by format", "[cycle][preset][benchmark][.]") {
+    CycleTestHarness harness;
+    auto& repo = harness.getRepo();
+    auto& document = repo.get<Document>("Document");
+
+    Array<File> presets;
+    File(String(CYCLE_SOURCE_DIR) + "/content/presets").findChildFiles(presets, File::findFiles, false, "*.cyc");
+    presets.sort();
+
+    FormatTiming jsonTotal, binaryTotal;
+
+    for (auto& preset : presets) {
+        {
+            ScopedPresetLoadSuppression suppressPresetUpdates(repo);
+            REQUIRE(document.open(preset.getFullPathName()));
+        }
+
+        FormatTiming json = timeFormat(repo, Document::JsonFormat);
+        FormatTiming binary = timeFormat(repo, Document::BinaryFormat);
+
+        std::cout << preset.getFileName()
+                  << ": json " << json.bytes / 1024 << " kB save " << json.saveMillis << " ms load " << json.loadMillis << " ms"
+                  << ", binary " << binary.bytes / 1024 << " kB save " << binary.saveMillis << " ms load " << binary.loadMillis << " ms"
+                  << std::endl;
+
+        for (auto [total, timing] : { std::make_pair(&jsonTotal, json), std::make_pair(&binaryTotal, binary) }) {
+            total->saveMillis += timing.saveMillis;
+            total->loadMillis += timing.loadMillis;
+            total->bytes += timing.bytes;
+        }
+    }
+
+    std::cout << presets.size() << " presets"
+              << ": json " << jsonTotal.bytes / 1024 << " kB save " << jsonTotal.saveMillis << " ms load " << jsonTotal.loadMillis << " ms"
+              << ", binary " << binaryTotal.bytes / 1024 << " kB save " << binaryTotal.saveMillis << " ms load " << binaryTotal.loadMillis << " ms"
+              << std::endl;
+
+    document.setSaveFormat(Document::JsonFormat);
+}
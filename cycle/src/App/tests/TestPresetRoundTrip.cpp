@@ -4,6 +4,7 @@
 
 #include <App/Doc/Document.h>
 #include <App/Doc/DocumentDetails.h>
+#include <App/Doc/PresetBinary.h>
 #include <App/Doc/PresetJson.h>
 #include <App/MeshLibrary.h>
 #include <App/Settings.h>
@@ -12,7 +13,7 @@
 #include <Curve/Curve.h>
 #include <JuceHeader.h>
 
-#include "../Initializer.h"
+#include "CycleTestHarness.h"
 #include <Inter/Interactor.h>
 #include "../../Util/CycleEnums.h"
 #include "../../UI/Effects/EffectGuiRegistry.h"
@@ -26,127 +27,9 @@
 #include "../../UI/VertexPanels/GuideCurvePanel.h"
 
 using namespace juce;
+using namespace CycleTestSupport;
 
 namespace {
-    void seedDefaultMeshLibrary(SingletonRepo& repo) {
-        auto& meshLib = repo.get<MeshLibrary>("MeshLibrary");
-
-        meshLib.addGroup(MeshLibrary::TypeEnvelope);
-        meshLib.addGroup(MeshLibrary::TypeEnvelope);
-        meshLib.addGroup(MeshLibrary::TypeEnvelope);
-        meshLib.addGroup(MeshLibrary::TypeMesh);
-        meshLib.addGroup(MeshLibrary::TypeMesh);
-        meshLib.addGroup(MeshLibrary::TypeMesh);
-        meshLib.addGroup(MeshLibrary::TypeMesh);
-        meshLib.addGroup(MeshLibrary::TypeEnvelope);
-        meshLib.addGroup(MeshLibrary::TypeMesh);
-        meshLib.addGroup(MeshLibrary::TypeMesh);
-        meshLib.addGroup(MeshLibrary::TypeMesh);
-
-        meshLib.addLayer(LayerGroups::GroupVolume);
-        meshLib.addLayer(LayerGroups::GroupPitch);
-        meshLib.addLayer(LayerGroups::GroupScratch);
-        meshLib.addLayer(LayerGroups::GroupGuideCurve);
-        meshLib.addLayer(LayerGroups::GroupTime);
-        meshLib.addLayer(LayerGroups::GroupSpect);
-        meshLib.addLayer(LayerGroups::GroupPhase);
-        meshLib.addLayer(LayerGroups::GroupWavePitch);
-        meshLib.addLayer(LayerGroups::GroupWaveshaper);
-        meshLib.addLayer(LayerGroups::GroupIrModeller);
-
-        Mesh* waveshaperMesh = meshLib.getCurrentMesh(LayerGroups::GroupWaveshaper);
-        Mesh* irModellerMesh = meshLib.getCurrentMesh(LayerGroups::GroupIrModeller);
-
-        repo.get<WaveshaperUI>("WaveshaperUI").getEffectRasterizer()->setMesh(waveshaperMesh);
-        repo.get<IrModellerUI>("IrModellerUI").getEffectRasterizer()->setMesh(irModellerMesh);
-        repo.get<IrModeller>("IrModeller").setMesh(irModellerMesh);
-    }
-
-    class ScopedPresetLoadSuppression {
-    public:
-        explicit ScopedPresetLoadSuppression(SingletonRepo& repo) :
-                updater                     (repo.get<Updater>("Updater"))
-            ,   ignoringEditMessages        (repo.get<Settings>("Settings").getGlobalSetting(AppSettings::IgnoringEditMessages), true)
-            ,   ignoringMessages            (repo.get<Settings>("Settings").getGlobalSetting(AppSettings::IgnoringMessages), true) {
-            updater.clearPendingUpdates();
-        }
-
-        ~ScopedPresetLoadSuppression() {
-            updater.clearPendingUpdates();
-        }
-
-    private:
-        Updater& updater;
-        ScopedValueSetter<int> ignoringEditMessages;
-        ScopedValueSetter<int> ignoringMessages;
-    };
-
-    class CycleTestHarness {
-    public:
-        CycleTestHarness() {
-            if (juceInitRefCount++ == 0) {
-                juceInitialiser = std::make_unique<ScopedJuceInitialiser_GUI>();
-            }
-
-            if (refCount++ == 0) {
-                Curve::calcTable();
-            }
-
-            initializer = std::make_unique<Initializer>();
-            repo = initializer->getSingletonRepo();
-
-            repo->setSuppressAudioDeviceInit(true);
-            repo->setSuppressSavableAutoRegistration(true);
-            repo->setSuppressInitializerInit(true);
-            repo->instantiate();
-            initializer->setConstants();
-            initializer->setDefaultSettings();
-            initializer->instantiate();
-            repo->setMorphPositioner(&repo->get<MorphPanel>("MorphPanel"));
-            seedDefaultMeshLibrary(*repo);
-            repo->init();
-            initializer->doPostInitWiring();
-
-            auto& document = repo->get<Document>("Document");
-            document.registerSavable(&repo->get<MeshLibrary>("MeshLibrary"));
-            document.registerSavable(&repo->get<OscControlPanel>("OscControlPanel"));
-            document.registerSavable(&repo->get<Settings>("Settings"));
-            document.registerSavable(&repo->get<MainPanel>("MainPanel"));
-            document.registerSavable(&repo->get<ModMatrixPanel>("ModMatrixPanel"));
-            document.registerSavable(&repo->get<GuideCurvePanel>("GuideCurvePanel"));
-            document.registerSavable(&repo->get<MorphPanel>("MorphPanel"));
-            document.registerSavable(&repo->get<Envelope2D>("Envelope2D"));
-        }
-
-        ~CycleTestHarness() {
-            if (initializer != nullptr) {
-                initializer->freeUIResources();
-            }
-
-            initializer = nullptr;
-
-            if (--refCount == 0) {
-                Curve::deleteTable();
-            }
-
-            if (--juceInitRefCount == 0) {
-                juceInitialiser = nullptr;
-            }
-        }
-
-        SingletonRepo& getRepo() const {
-            return *repo;
-        }
-
-    private:
-        inline static int refCount = 0;
-        inline static int juceInitRefCount = 0;
-        inline static std::unique_ptr<ScopedJuceInitialiser_GUI> juceInitialiser;
-
-        std::unique_ptr<Initializer> initializer;
-        SingletonRepo* repo{};
-    };
-
     bool isLegacyXmlPreset(const File& presetFile) {
         std::unique_ptr<InputStream> stream(presetFile.createInputStream());
         DocumentDetails details;
@@ -271,6 +154,50 @@ TEST_CASE("Legacy pierce preset restores modulation matrix wiring", "[cycle][pre
     REQUIRE(hasMapping(modMatrix.mappings, ModMatrixPanel::ModWheel, ModMatrixPanel::TimeSurfId, ModMatrixPanel::BlueDim));
 }
 
+TEST_CASE("Presets save as JSON unless binary is chosen, and both carry the schema", "[cycle][preset]") {
+    CycleTestHarness harness;
+    auto& repo = harness.getRepo();
+    auto& document = repo.get<Document>("Document");
+    File presetFile(String(CYCLE_SOURCE_DIR) + "/content/presets/pierce.cyc");
+
+    REQUIRE(presetFile.existsAsFile());
+    REQUIRE(document.getSaveFormat() == Document::JsonFormat);
+
+    {
+        ScopedPresetLoadSuppression suppressPresetUpdates(repo);
+        REQUIRE(document.open(presetFile.getFullPathName()));
+    }
+
+    MemoryOutputStream jsonPreset;
+    document.save(&jsonPreset);
+    REQUIRE(jsonPreset.getDataSize() > Document::headerSizeBytes);
+
+    {
+        MemoryInputStream input(jsonPreset.getData(), jsonPreset.getDataSize(), false);
+        input.setPosition(Document::headerSizeBytes);
+        REQUIRE_FALSE(PresetBinary::isBinary(input));
+
+        GZIPDecompressorInputStream decompressed(&input, false);
+        var root = JSON::parse(decompressed.readEntireStreamAsString());
+        REQUIRE(PresetJson::property(root, "format").toString() == "amaranth-preset");
+        REQUIRE(int(PresetJson::property(root, "schemaVersion")) == 2);
+    }
+
+    document.setSaveFormat(Document::BinaryFormat);
+
+    MemoryOutputStream binaryPreset;
+    document.save(&binaryPreset);
+    document.setSaveFormat(Document::JsonFormat);
+
+    MemoryInputStream input(binaryPreset.getData(), binaryPreset.getDataSize(), false);
+    input.setPosition(Document::headerSizeBytes);
+
+    PresetBinary::Reader reader;
+    REQUIRE(reader.open(input));
+    REQUIRE(reader.readSection("format").toString() == "amaranth-preset");
+    REQUIRE(int(reader.readSection("schemaVersion")) == 2);
+}
+
 TEST_CASE("Guide curve noise contribution is bipolar", "[cycle][guide-curves]") {
     CycleTestHarness harness;
     auto& guidePanel = harness.getRepo().get<GuideCurvePanel>("GuideCurvePanel");
@@ -0,0 +1,71 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <App/Doc/Document.h>
+#include <App/SingletonRepo.h>
+#include <Design/Updating/Updater.h>
+#include <Thread/RealtimeWorkerPool.h>
+#include <JuceHeader.h>
+
+#include <algorithm>
+#include <iostream>
+
+#include "CycleTestHarness.h"
+#include "../../Util/CycleEnums.h"
+
+using namespace juce;
+using namespace CycleTestSupport;
+
+namespace {
+    constexpr int numPresets = 3;
+    constexpr int numPasses = 20;
+
+    Array<File> largestPresets() {
+        Array<File> presets = File(String(CYCLE_SOURCE_DIR) + "/content/presets")
+                .findChildFiles(File::findFiles, false, "*.cyc");
+
+        std::sort(presets.begin(), presets.end(), [](const File& a, const File& b) {
+            return a.getSize() > b.getSize();
+        });
+
+        presets.removeRange(numPresets, presets.size());
+        return presets;
+    }
+
+    // mean milliseconds of the pass a mesh drag triggers on the main waveform
+    double timeDragPass(Updater& updater) {
+        updater.update(UpdateSources::SourceWaveform3D, Update);
+
+        double start = Time::getMillisecondCounterHiRes();
+        for (int i = 0; i < numPasses; ++i) {
+            updater.update(UpdateSources::SourceWaveform3D, Update);
+        }
+
+        return (Time::getMillisecondCounterHiRes() - start) / numPasses;
+    }
+}
+
+TEST_CASE("Drag update pass time on the largest presets", "[cycle][updating][benchmark][.]") {
+    CycleTestHarness harness;
+    auto& repo = harness.getRepo();
+    auto& updater = repo.get<Updater>("Updater");
+    const int workers = jmin(2, RealtimeWorkerPool::defaultWorkerCount());
+
+    updater.setThrottling(false, 0);
+
+    for (auto& preset : largestPresets()) {
+        {
+            ScopedPresetLoadSuppression suppressPresetUpdates(repo);
+            REQUIRE(repo.get<Document>("Document").open(preset.getFullPathName()));
+        }
+
+        updater.setUpdateWorkers(0);
+        double serial = timeDragPass(updater);
+
+        updater.setUpdateWorkers(workers);
+        double parallel = timeDragPass(updater);
+
+        std::cout << preset.getFileName() << " (" << preset.getSize() / 1024 << " kB)"
+                  << ": serial " << serial << " ms"
+                  << ", " << workers << " workers " << parallel << " ms" << std::endl;
+    }
+}
@@ -109,15 +109,11 @@ bool CycDelay::setSpinIters(double value) {
     return true;
 }
 
-//void CycDelay::setSampleRate(double value)
-//{
-//	if(sampleRate == value)
-//		return;
-//
-//	sampleRate = value;
-//
-//	pendingWetBufferUpdate = true;
-//}
+void CycDelay::setSampleRate(double value) {
+    if (Util::assignAndWereDifferent(sampleRate, value)) {
+        pendingWetBufferUpdate = true;
+    }
+}
 
 void CycDelay::setUI(GuilessEffect* comp) {
     ui = comp;
@@ -25,6 +25,7 @@ public:
 	bool setFeedback(double value);
 	bool setSpinIters(double value);
 	bool setDelayTime(double value);
+	void setSampleRate(double value);
 	static int calcSpinIters(double value);
 	void recalculateWetBuffers(bool print = false);
 	void setUI(GuilessEffect* comp);
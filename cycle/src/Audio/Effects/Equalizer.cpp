@@ -32,11 +32,14 @@ void Equalizer::processBuffer(AudioSampleBuffer &buffer) {
 
     ScopedLock sl(stateLock);
 
-    for (int c = 0; c < jmin(2, buffer.getNumChannels()); ++c) {
-        Buffer destBuffer(buffer.getWritePointer(c), numSamples);
+    const int numChannels = jmin(2, buffer.getNumChannels());
+    Buffer<float> channels[2];
 
-        core.process(c, destBuffer);
+    for (int c = 0; c < numChannels; ++c) {
+        channels[c] = Buffer<float>(buffer.getWritePointer(c), numSamples);
     }
+
+    core.process(0, channels, numChannels);
 }
 
 void Equalizer::setSampleRate(double samplerate) {
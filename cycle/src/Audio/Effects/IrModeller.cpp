@@ -1,3 +1,4 @@
+#include <Algo/Resampling.h>
 #include <Array/Buffer.h>
 #include <Util/StatusChecker.h>
 #include <Util/Util.h>
@@ -29,6 +30,7 @@ IrModeller::IrModeller(SingletonRepo *repo) :
     ,   blockSizeAction(blockSize)
     ,   prefiltAction(prefilterChg)
     ,   rasterizeAction(rasterize)
+    ,   renderRateAction(renderRate)
     ,   audioThdRasterizer(repo, "ImpulseRasterizerAudioThd")
     ,   oversampler(repo, 8) {
     setConvBufferSize(convBufferSize);
@@ -38,6 +40,7 @@ IrModeller::IrModeller(SingletonRepo *repo) :
     oversampler.setOversampleFactor(2);
 
     pendingActions.add(&blockSizeAction);
+    pendingActions.add(&renderRateAction);
     pendingActions.add(&impulseSizeAction);
     pendingActions.add(&convSizeAction);
     pendingActions.add(&unloadWavAction);
@@ -114,7 +117,7 @@ void IrModeller::trimWave() {
 }
 
 void IrModeller::rasterizeImpulseDirect() {
-    rasterizeImpulse(audio.rawImpulse, audioThdRasterizer, true);
+    rasterizeImpulse(audio, audioThdRasterizer, true);
     filterImpulse(audio);
 
     for (auto & conv : convolvers) {
@@ -123,29 +126,19 @@ void IrModeller::rasterizeImpulseDirect() {
 }
 
 void IrModeller::rasterizeGraphicImpulse() {
-    Buffer<float> impulse = graphic.rawImpulse;
-
-    if (impulse.empty()) {
+    if (graphic.rawImpulse.empty()) {
         return;
     }
 
     if (usingWavFile) {
-        int wavSize = wavImpulse.audio.size();
-        int maxSamples = jmin(wavSize, impulse.size());
-
-        Buffer<float> channel = wavImpulse.audio.left;
-        channel.copyTo(impulse);
-
-        if (maxSamples < impulse.size()) {
-            impulse.offset(maxSamples).zero();
-        }
+        copyWave(graphic.rawImpulse, graphic.sampleRate);
     } else {
         FXRasterizer* waveform = ui->getLocalRasterizer();
         if (waveform == nullptr || !waveform->canRasterizeWaveform()) {
             return;
         }
 
-        rasterizeImpulse(impulse, *waveform, false);
+        rasterizeImpulse(graphic, *waveform, false);
     }
 
     filterImpulse(graphic);
@@ -173,13 +166,19 @@ void IrModeller::filterImpulse(ConvState& chan) {
 }
 
 void IrModeller::rasterizeImpulse(
-        Buffer<float> impulse,
+        ConvState& state,
         FXRasterizer& waveform,
         bool isAudioThread) {
-    if (impulse.empty()) {
+    if (state.rawImpulse.empty()) {
         return;
     }
 
+    Buffer<float> impulse = state.rawImpulse.withSize(state.renderedLength);
+
+    if (impulse.size() < state.rawImpulse.size()) {
+        state.rawImpulse.offset(impulse.size()).zero();
+    }
+
     Float32 sum = 0;
 
     if (!usingWavFile) {
@@ -207,14 +206,27 @@ void IrModeller::rasterizeImpulse(
 
 //		sum = impulse.sum();
     } else {
-        Buffer<float> wavBuff = wavImpulse.audio.left;
-        int maxSamples = jmin(wavBuff.size(), impulse.size());
+        copyWave(impulse, state.sampleRate);
+    }
+}
 
-        wavBuff.copyTo(impulse);
+// wave impulses are resampled from their own rate to the one they convolve at
+void IrModeller::copyWave(Buffer<float> impulse, double sampleRate) {
+    Buffer<float> wave = wavImpulse.audio.left;
+    impulse.zero();
 
-        if (maxSamples < impulse.size()) {
-            impulse.offset(maxSamples).zero();
-        }
+    double ratio = wavImpulse.samplerate > 0 ? sampleRate / wavImpulse.samplerate : 1.;
+
+    if (ratio == 1.) {
+        wave.copyTo(impulse);
+        return;
+    }
+
+    int numSource = jmin(wave.size(), (int) (impulse.size() / ratio));
+    int numDest = jmin(impulse.size(), roundToInt(numSource * ratio));
+
+    if (numSource >= 2 && numDest >= 2) {
+        Resampling::linResample(wave.withSize(numSource), impulse.withSize(numDest));
     }
 }
 
@@ -292,8 +304,13 @@ void IrModeller::checkForPendingUpdates() {
                     unloadWave();
                     break;
 
+                case renderRate:
+                    audio.sampleRate = renderRateAction.getValue();
+                    setAudioImpulseLength(audio.length);
+                    break;
+
                 case prefilterChg:
-                    calcPrefiltLevels(audio.levels);
+                    calcPrefiltLevels(audio);
                     filterImpulse(audio);
                     convolvers[0].init(convolvers[0].getBlockSize(), audio.impulse);
                     convolvers[1].init(convolvers[1].getBlockSize(), audio.impulse);
@@ -322,21 +339,27 @@ void IrModeller::setImpulseLength(ConvState &state, int length) {
     if (length == 0)
         return;
 
-    bool sizeChanged = length != state.impulse.size();
+    // the impulse lasts as long at any rate, padded to the size its transform needs
+    int renderedLength = CycleDsp::irImpulseLengthAtRate(length, state.sampleRate);
+    int size = NumberUtils::nextPower2(renderedLength);
+    bool sizeChanged = size != state.impulse.size();
+
+    state.length = length;
+    state.renderedLength = renderedLength;
 
     if (sizeChanged) {
-        state.memory.resize(2 * length + length / 2);
+        state.memory.resize(2 * size + size / 2);
         state.memory.zero();
 
-        state.rawImpulse = state.memory.place(length);
-        state.impulse = state.memory.place(length);
-        state.levels = state.memory.place(length / 2);
-
-        state.fft.allocate(length, Transform::DivFwdByN, true);
+        state.rawImpulse = state.memory.place(size);
+        state.impulse = state.memory.place(size);
+        state.levels = state.memory.place(size / 2);
 
-        calcPrefiltLevels(state.levels);
+        state.fft.allocate(size, Transform::DivFwdByN, true);
     }
 
+    calcPrefiltLevels(state);
+
     if (&state == &audio) {
         rasterizeImpulseDirect();
     } else {
@@ -383,7 +406,7 @@ void IrModeller::setPendingAction(PendingUpdate type, int value) {
             break;
 
         case prefilterChg:
-            calcPrefiltLevels(graphic.levels);
+            calcPrefiltLevels(graphic);
             prefiltAction.trigger();
             break;
     }
@@ -462,7 +485,7 @@ void IrModeller::unloadWave() {
     waveLoaded = false;
 
     setAudioImpulseLength(calcLength(ui->getParamGroup().getKnobValue(Length)));
-    rasterizeImpulse(audio.rawImpulse, audioThdRasterizer, true);
+    rasterizeImpulse(audio, audioThdRasterizer, true);
     filterImpulse(audio);
 }
 
@@ -485,7 +508,7 @@ bool IrModeller::willBeEnabled() const {
 bool IrModeller::doParamChange(int param, double value, bool doFurtherUpdate) {
     switch (param) {
         case Length: {
-            int oldLength = audio.impulse.size();
+            int oldLength = audio.length;
             int length = calcLength(value);
 
             if (oldLength == length)
@@ -525,6 +548,11 @@ void IrModeller::audioFileModelled() {
     rasterizeAction.trigger();
 }
 
-void IrModeller::calcPrefiltLevels(Buffer<float> buff) {
-    CycleDsp::buildIrPrefilterLevels(buff, prefilt.getTargetValue());
+void IrModeller::calcPrefiltLevels(ConvState& state) {
+    CycleDsp::buildIrPrefilterLevels(state.levels, prefilt.getTargetValue(), state.sampleRate);
+}
+
+// message thread; the audio impulse is re-rendered for the rate on the audio thread
+void IrModeller::setSampleRate(double rate) {
+    renderRateAction.setValueAndTrigger(rate);
 }
@@ -41,7 +41,8 @@ public:
         blockSize,
         rasterize,
         unloadWav,
-        prefilterChg
+        prefilterChg,
+        renderRate
     };
 
     explicit IrModeller(SingletonRepo* repo);
@@ -91,17 +92,19 @@ public:
     void rasterizeImpulseDirect();
     void rasterizeGraphicImpulse();
     void setPendingAction(PendingUpdate type, int value = -1);
+    void setSampleRate(double rate);
     void audioFileModelled();
 
 private:
     void filterImpulse(ConvState& chan);
-    void rasterizeImpulse(Buffer<float> impulse, FXRasterizer& waveform, bool isAudioThread);
+    void rasterizeImpulse(ConvState& state, FXRasterizer& waveform, bool isAudioThread);
+    void copyWave(Buffer<float> impulse, double sampleRate);
     void unloadWave();
     void setImpulseLength(ConvState& state, int length);
     void setAudioImpulseLength(int length);
     void setAudioBlockSize(int size);
     void setConvBufferSize(int size);
-    void calcPrefiltLevels(Buffer<float> buff);
+    void calcPrefiltLevels(ConvState& state);
 
     class ConvState
     {
@@ -110,6 +113,11 @@ private:
 
         ScopedAlloc<Float32> memory;
 
+        // length is in samples at the tuned rate; the impulse spans the first
+        // renderedLength samples at sampleRate and is zero padded to a power of two
+        double sampleRate { CycleDsp::irTunedSampleRate };
+        int length {}, renderedLength {};
+
         int blockSize;
         Buffer<float> impulse, rawImpulse;
         Buffer<float> levels;
@@ -152,6 +160,7 @@ private:
     PendingActionValue<int> blockSizeAction;
     PendingActionValue<int> prefiltAction;
     PendingActionValue<bool> rasterizeAction;
+    PendingActionValue<double> renderRateAction;
 
     IrModeller(const IrModeller& IrModeller);
     friend class ConvTest;
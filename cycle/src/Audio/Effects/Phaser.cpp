@@ -1,88 +1,54 @@
 #include <App/SingletonRepo.h>
 #include <UI/Panels/MainPanel.h>
 
-#include <cmath>
 #include "Phaser.h"
 
 #include "../../UI/Effects/PhaserUI.h"
 
 Phaser::Phaser(SingletonRepo* repo) :
-        Effect(repo, "Phaser")
-    ,	feedback(.7f)
-    ,	lfoPhase(0.f)
-    ,	depth(1.f)
-    ,	zm1(0.f)
-    ,	samplerate(44100.f) {
-    setMin(440);
-    setMax(1600);
-    setRate(.5f);
+        Effect(repo, "Phaser") {
+    phaser.configure(configuration);
 }
 
 void Phaser::processBuffer(AudioSampleBuffer& buffer) {
-    for(int i = 0; i < buffer.getNumChannels(); ++i) {
-        for(int j = 0; j < buffer.getNumSamples(); ++j) {
-            update(*buffer.getWritePointer(i, j));
-        }
+    const int numSamples = buffer.getNumSamples();
+
+    if (buffer.getNumChannels() == 0) {
+        return;
     }
-}
 
-void Phaser::doParamChange(int index, float value)
-{
-    switch(index) {
-        case Rate: 		setRate(value);		break;
-        case Feedback:	setFeedback(value);	break;
-        case Depth: 	setDepth(value);	break;
-        case Min:		setMin(value);		break;
-        case Max:		setMax(value);		break;
-        default: throw std::invalid_argument("Invalid Parameter Index: " + std::to_string(index));
+    Buffer<float> left(buffer.getWritePointer(0), numSamples);
+    Buffer<float> right;
+
+    if (buffer.getNumChannels() > 1) {
+        right = Buffer<float>(buffer.getWritePointer(1), numSamples);
     }
-}
 
-void Phaser::setMin(float min) {
-    dmin = min / (samplerate / 2.f);
+    phaser.process(left, right);
 }
 
-void Phaser::setMax(float max) {
-    dmax = max / (samplerate / 2.f);
-}
+bool Phaser::doParamChange(int index, double value, bool doFurtherUpdate) {
+    (void) doFurtherUpdate;
 
-void Phaser::setRate(float rate) {
-    lfoInc = 2.f * M_PI * (rate / samplerate);
-}
+    switch(index) {
+        case Rate: 		configuration.rate 			= (float) value;	break;
+        case Feedback:	configuration.feedback 		= (float) value;	break;
+        case Depth: 	configuration.depth 		= (float) value;	break;
+        case Min:		configuration.minFrequency 	= (float) value;	break;
+        case Max:		configuration.maxFrequency 	= (float) value;	break;
+        default: throw std::invalid_argument("Invalid Parameter Index: " + std::to_string(index));
+    }
 
-void Phaser::setFeedback(float feedback) {
-    this->feedback = feedback;
+    phaser.configure(configuration);
+    return false;
 }
 
-void Phaser::setDepth(float depth) {
-    this->depth = depth;
+void Phaser::setSampleRate(double value) {
+    configuration.sampleRate = value;
+    phaser.configure(configuration);
 }
 
 bool Phaser::isEnabled() const {
     return false;
     // return getObj(MainPanel).getPhaserCmpt()->isEffectEnabled();
 }
-
-void Phaser::update(float& inSamp) {
-    float d = dmin + (dmax - dmin) * ((std::sin(lfoPhase) + 1.f) / 2.f);
-    lfoPhase += lfoInc;
-
-    if (lfoPhase >= M_PI * 2.f) {
-        lfoPhase -= M_PI * 2.f;
-    }
-
-    for (auto& allpassDelay : allpassDelays) {
-        allpassDelay.delay(d);
-    }
-
-    float y = allpassDelays[0].update(
-                allpassDelays[1].update(
-                    allpassDelays[2].update(
-                        allpassDelays[3].update(
-                            allpassDelays[4].update(
-                                allpassDelays[5].update(inSamp + zm1 * feedback))))));
-    zm1 = y;
-
-    inSamp += y * depth;
-}
-
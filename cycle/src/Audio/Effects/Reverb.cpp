@@ -2,6 +2,7 @@
 #include <App/SingletonRepo.h>
 #include <Audio/CycleDsp/ReverbKernel.h>
 #include <Util/Arithmetic.h>
+#include <Util/Util.h>
 
 #include "Reverb.h"
 
@@ -20,11 +21,11 @@ ReverbEffect::ReverbEffect(SingletonRepo* repo) :
     ,	perBlockDecay	(0.004f)
     ,	rolloffFactor	(0.5f)
     ,	feedbackFactor	(0.09f)
+    ,	sampleRate		(CycleDsp::reverbTunedSampleRate)
     ,	blockSizeAction	(blockSize)
-    ,	kernelSizeAction(kernelSize)
-    ,	kernelFilterAction(filterAction)
     ,	timeSinceLastFilterAction(0)
     ,	timeSinceLastResizeAction(0)
+    ,	convolverHeadSize(0)
 {
     seed = Time::currentTimeMillis();
 
@@ -85,7 +86,7 @@ bool ReverbEffect::doParamChange(int index, double value, bool doFutherUpdate)
         case Size: {
             roomSize = value;
 
-            int length = NumberUtils::nextPower2((int) powf(2, 12 + 6 * roomSize));
+            int length = CycleDsp::reverbKernelLength(roomSize, sampleRate);
             if (length != kernel[0].size()) {
                 setPendingAction(kernelSize, length);
             }
@@ -129,20 +130,21 @@ void ReverbEffect::setPendingAction(int action, int value) {
     switch (action) {
         case blockSize: {
             blockSizeAction.setValueAndTrigger(value);
+
+            convolverHeadSize = NumberUtils::nextPower2(value);
+            rebuildConvolvers();
             break;
         }
 
         case kernelSize:
-            kernelSizeAction.setValueAndTrigger(value);
+            createKernel(value);
             break;
 
         case filterAction: {
             if (Time::currentTimeMillis() - timeSinceLastFilterAction >= 50) {
                 timeSinceLastFilterAction = Time::currentTimeMillis();
-                kernelFilterAction.trigger();
+                updateKernelSections();
             } else {
-                kernelFilterAction.dismiss();
-
                 stopTimer(kernelSize);
                 startTimer(kernelSize, 30);
             }
@@ -172,16 +174,15 @@ void ReverbEffect::timerCallback(int id) {
 void ReverbEffect::createKernel(int size) {
     jassert(size > 0);
 
-    int nextPow2 = NumberUtils::nextPower2(size);
-
-    if (nextPow2 < 256) {
+    // lengths are powers of two at the tuned rate, and scaled from there
+    if (size < 256) {
         return;
     }
 
-    kernelMemory.resize(nextPow2 * 2);
+    kernelMemory.resize(size * 2);
 
     for (int c = 0; c < 2; ++c) {
-        kernel[c] = kernelMemory.section(c * nextPow2, nextPow2);
+        kernel[c] = kernelMemory.section(c * size, size);
     }
 
     updateKernelSections();
@@ -193,26 +194,33 @@ void ReverbEffect::updateKernelSections()
     configuration.roomSize = roomSize;
     configuration.damping = rolloffFactor;
     configuration.highPass = highpass;
+    configuration.sampleRate = sampleRate;
     CycleDsp::buildReverbKernel(configuration, kernel.left, kernel.right);
 
-    leftConv .init(leftConv.headBlockSize, 	leftConv.tailBlockSize,  kernel.left);
-    rightConv.init(rightConv.headBlockSize, rightConv.tailBlockSize, kernel.right);
+    rebuildConvolvers();
 }
 
-void ReverbEffect::setBlockSize(int size) {
-    int nextPow2 = NumberUtils::nextPower2(size);
+void ReverbEffect::rebuildConvolvers() {
+    // the convolvers pick up their new stages at their next process() call
+    leftConv .init(convolverHeadSize, 16 * convolverHeadSize, kernel.left);
+    rightConv.init(convolverHeadSize, 16 * convolverHeadSize, kernel.right);
+}
+
+// message thread, like the other kernel rebuilds
+void ReverbEffect::setSampleRate(double rate) {
+    if (Util::assignAndWereDifferent(sampleRate, rate)) {
+        createKernel(CycleDsp::reverbKernelLength(roomSize, sampleRate));
+    }
+}
 
+void ReverbEffect::setBlockSize(int size) {
     blockMemory.ensureSize(size * 3);
     mergeBuffer = blockMemory.place(size);
     mergeBuffer.zero();
 
-    ConvReverb* convolvers[] = { &leftConv, &rightConv };
-
     for(int i = 0; i < 2; ++i) {
         outBuffer[i] = blockMemory.place(size);
         outBuffer[i].zero();
-
-        convolvers[i]->init(nextPow2, 16 * nextPow2, kernel[i]);
     }
 }
 
@@ -220,15 +228,6 @@ void ReverbEffect::audioThreadUpdate() {
     if(blockSizeAction.isPending()) {
         setBlockSize(blockSizeAction.getValueAndDismiss());
     }
-
-    if(kernelSizeAction.isPending()) {
-        createKernel(kernelSizeAction.getValueAndDismiss());
-    }
-
-    if(kernelFilterAction.isPending()) {
-        updateKernelSections();
-        kernelFilterAction.dismiss();
-    }
 }
 
 void ReverbEffect::resetOutputBuffer() {
@@ -26,9 +26,11 @@ public:
     void setPendingAction(int action, int value);
     void createKernel(int size);
     void updateKernelSections();
+    void rebuildConvolvers();
     void audioThreadUpdate() override;
     void resetOutputBuffer();
     void setBlockSize(int size);
+    void setSampleRate(double rate);
     void randomizePhase(Buffer<float> buffer);
     void setUI(GuilessEffect* comp) { ui = comp; }
     void timerCallback(int id) override;
@@ -36,17 +38,19 @@ public:
 private:
     float roomSize, wetLevel, dryLevel, width, highpass;
     float perBlockDecay, rolloffFactor, feedbackFactor;
+    double sampleRate;
 
     Reverb 				model;
     StereoBuffer		kernel;
     StereoBuffer  		outBuffer;
     Ref<GuilessEffect> 	ui;
 
+    // only the output buffers are resized on the audio thread; kernels and
+    // convolver stages are rebuilt by setPendingAction on the message thread
     PendingActionValue<int> blockSizeAction;
-    PendingActionValue<int> kernelSizeAction;
-    PendingAction kernelFilterAction;
 
     int64 timeSinceLastFilterAction, timeSinceLastResizeAction;
+    int convolverHeadSize;
 
     ConvReverb leftConv, rightConv;
 
@@ -38,9 +38,14 @@ void Waveshaper::rasterizeTable() {
         return;
     }
 
-    ScopedLock sl1(getObj(SynthAudioSource).getLock());
+    auto table = std::make_shared<WaveshaperTransfer>();
+    table->rasterizeFrom(waveformProvider->sampler(), getRealConstant(WaveshaperPadding));
+    transfer.publish(std::move(table));
+}
 
-    transfer.rasterizeFrom(waveformProvider->sampler(), getRealConstant(WaveshaperPadding));
+void Waveshaper::clearTable() {
+    // a new transfer starts out cleared
+    transfer.publish(std::make_shared<WaveshaperTransfer>());
 }
 
 void Waveshaper::processBuffer(AudioSampleBuffer& audioBuffer) {
@@ -59,7 +64,7 @@ void Waveshaper::processBuffer(AudioSampleBuffer& audioBuffer) {
         buffer.add(0.5f);
         buffer.clip(0.f, 1.f);
 
-        transfer.applyLookup(buffer);
+        transfer.current().applyLookup(buffer);
 
         oversamplers[i]->stopOversamplingBlock();
         postamp.maybeApplyRamp(rampBuffer.withSize(buffer.size()), buffer);
@@ -78,7 +83,7 @@ void Waveshaper::processVertexBuffer(Buffer<Float32> outputBuffer) {
     outputBuffer.mul((float) preamp.getTargetValue()).add(0.5f);
     outputBuffer.clip(0.f, 1.f);
 
-    transfer.applyLookup(outputBuffer.withSize(oversampSize));
+    transfer.latest()->applyLookup(outputBuffer.withSize(oversampSize));
 
     if (doOversample) {
         oversamplers[graphicOvspIndex]->stopOversamplingBlock();
@@ -105,6 +110,8 @@ bool Waveshaper::doParamChange(int param, double value, bool doFurtherUpdate) {
 }
 
 void Waveshaper::audioThreadUpdate() {
+    transfer.adopt();
+
     if (pendingOversampleFactor > 0) {
         for (int i = 0; i < graphicOvspIndex; ++i) {
             oversamplers[i]->setOversampleFactor(pendingOversampleFactor);
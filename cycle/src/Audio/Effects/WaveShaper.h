@@ -6,6 +6,7 @@
 #include <Audio/WaveshaperTransfer.h>
 #include <Curve/Rasterization/Rasterizer/Rasterizer.h>
 #include <Obj/Ref.h>
+#include <Thread/SnapshotMailbox.h>
 #include <Util/NumberUtils.h>
 
 #include "AudioEffect.h"
@@ -28,7 +29,7 @@ public:
     bool isEnabled() const override;
     int getLatencySamples();
     void rasterizeTable();
-    void clearTable() { transfer.clearTable(); }
+    void clearTable();
     void processBuffer(AudioSampleBuffer& audioBuffer) override;
     void processVertexBuffer(Buffer<Float32> outputBuffer);
     void updateSmoothedParameters(int deltaSamples);
@@ -41,8 +42,9 @@ public:
     void setUI(WaveshaperUI* comp)					{ this->ui = comp; 								 			}
     int getOversampleFactor() const					{ return oversamplers[graphicOvspIndex]->getOversampleFactor(); }
 
+    // audio thread
     void linInterpTable(float& value) {
-        value = transfer.lookup(value);
+        value = transfer.current().lookup(value);
     }
 
     static double calcPostamp(double value)	{ return NumberUtils::fromDecibels(45 * (2 * value - 1)); 	}
@@ -59,7 +61,9 @@ private:
     ScopedAlloc<Float32> rampBuffer;
     ScopedAlloc<Float32> graphicOversampleBuf;
     ScopedAlloc<Float32> oversampleBuffers;
-    WaveshaperTransfer transfer;
+
+    // rasterized on the message thread, adopted by the audio thread once per block
+    SnapshotMailbox<WaveshaperTransfer> transfer;
 
     OwnedArray<Oversampler> oversamplers;
     CriticalSection graphicLock;
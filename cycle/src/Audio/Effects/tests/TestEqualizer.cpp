@@ -9,10 +9,10 @@ namespace
 {
 float getMagnitude(const Complex32& value)
 {
-  #ifdef USE_ACCELERATE
-    return std::abs(value);
-  #else
+  #ifdef USE_IPP
     return std::sqrt(value.re * value.re + value.im * value.im);
+  #else
+    return std::abs(value);
   #endif
 }
 
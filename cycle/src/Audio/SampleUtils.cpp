@@ -208,9 +208,8 @@ void SampleUtils::updateMidiNoteNumber(int note) {
         return;
     }
 
-    double period = 44100.0 / NumberUtils::noteToFrequency(note, 0);
-
     if (PitchedSample* sample = multisample->getCurrentSample()) {
+        double period = sample->periodForNote(note);
         vector<PitchFrame>& frames = sample->periods;
         frames.clear();
 
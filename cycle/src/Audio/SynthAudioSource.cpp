@@ -1,9 +1,12 @@
+#include <limits>
+
 #include <App/Doc/Document.h>
 #include <App/MeshLibrary.h>
 #include <App/SingletonRepo.h>
 #include <Audio/CycleDsp/CyclicFrameLaneRenderer.h>
 #include <Audio/PluginProcessor.h>
 #include <Util/Arithmetic.h>
+#include <Util/Util.h>
 
 #include "SynthAudioSource.h"
 #include "AudioSourceRepo.h"
@@ -12,6 +15,7 @@
 #include "../UI/Panels/OscControlPanel.h"
 #include "../UI/Panels/ModMatrixPanel.h"
 #include "../UI/VertexPanels/GuideCurvePanel.h"
+#include "../UI/VertexPanels/Spectrum3D.h"
 #include "../Util/CycleEnums.h"
 
 SynthAudioSource::SynthAudioSource(SingletonRepo* repo) :
@@ -27,15 +31,18 @@ SynthAudioSource::SynthAudioSource(SingletonRepo* repo) :
     ,	lastAudioLevel		(0.f)
     ,	lastBlueLevel		(0.f)
     , 	tempoScale			(1.)
+    ,	renderSampleRate	(compatibilitySampleRate)
     , 	samplesProcessed	(-1)
     , 	tempRendBuffer		(2)
     , 	resampBuff			(2)
     , 	numEnvelopeDims		(2)
+    ,	appliedLayerValidity(-1)
     ,	globalRasterAction	(GlobalRasterAction)
     , 	globalChangeAction	(GlobalChangeAction)
     ,	qualityChangeAction (QualityChangeAction)
     ,	initResamplerAction	(InitResamplerAction)
     ,	updateCycleCachesAction(UpdateCycleCachesAction)
+    ,	renderRateAction	(RenderRateAction)
     ,	controlFreqAction	(ControlFreqAction)
     ,	unisonVoicesAction	(UnisonVoicesAction)
     ,	modwRouteAction		(ModwRouteAction) {
@@ -46,6 +53,7 @@ SynthAudioSource::SynthAudioSource(SingletonRepo* repo) :
     pendingActions.add(&qualityChangeAction);
     pendingActions.add(&initResamplerAction);
     pendingActions.add(&updateCycleCachesAction);
+    pendingActions.add(&renderRateAction);
     pendingActions.add(&controlFreqAction);
     pendingActions.add(&unisonVoicesAction);
     pendingActions.add(&modwRouteAction);
@@ -53,11 +61,7 @@ SynthAudioSource::SynthAudioSource(SingletonRepo* repo) :
     unisonVoicesAction.trigger();
 
     for (int fftOrderIdx = 0; fftOrderIdx < numOctaves; ++fftOrderIdx) {
-        int fftOrder 		= fftOrderIdx + 3;
-        int size 			= 1 << fftOrder;
-        sizeToIndex[size] 	= fftOrderIdx;
-
-        ffts[fftOrderIdx].allocate(size, Transform::ScaleType::DivFwdByN, true);
+        sizeToIndex[1 << (fftOrderIdx + 3)] = fftOrderIdx;
     }
 
     getObj(Document).addListener(this);
@@ -106,11 +110,20 @@ void SynthAudioSource::init() {
     }
 
     synth.addSound(new SynthSound(repo));
+    renderThreadsChanged();
+
+    getObj(MeshLibrary).addListener(this);
 }
 
 void SynthAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
-    calcDeclickEnvelope(sampleRate);
-    synth.setCurrentPlaybackSampleRate(sampleRate);
+    // so deferring a contended block's midi doesn't allocate on the audio thread
+    deferredMidi.ensureSize(midiReserveBytes);
+    mergedMidi.ensureSize(midiReserveBytes);
+
+    updateEffectSampleRates();
+    updateRenderSampleRate();
+    calcDeclickEnvelope(renderSampleRate);
+    synth.setCurrentPlaybackSampleRate(renderSampleRate);
 
     for (auto voice: voices) {
         voice->initCycleBuffers();
@@ -130,19 +143,91 @@ void SynthAudioSource::releaseResources() {
 
 
 void SynthAudioSource::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiMessages) {
-    ScopedLock lock(audioLock);
+    lockStats.blocks.fetch_add(1, std::memory_order_relaxed);
+
+    ScopedTryLock lock(audioLock);
+
+    // A structural edit (adding or removing a layer, vertex or envelope, loading a
+    // sample or IR) still holds audioLock while it rewires the voices. Rather than
+    // wait on it, this block is output as silence - an audible dropout while such an
+    // edit is in flight - and its midi plays, at the same offsets, in the next block.
+    // Render meshes, guide curves and the waveshaper transfer reach the audio thread
+    // through SnapshotMailbox instead. lockStats counts the dropped blocks.
+    if (! lock.isLocked()) {
+        lockStats.contendedBlocks.fetch_add(1, std::memory_order_relaxed);
+        deferMidi(midiMessages);
+        buffer.clear();
+        lastAudioLevel = 0;
+        return;
+    }
 
+    mergeDeferredMidi(midiMessages, buffer.getNumSamples());
     doAudioThreadUpdates();
 
     buffer.clear();
 
+    if (isRenderingAtHostRate()) {
+        renderSynthBlock(buffer, midiMessages);
+    } else {
+        processResampledBlock(buffer, midiMessages);
+    }
+
+    StereoBuffer outBuffer(buffer);
+    float audioLevel = 0;
+
+    for(int i = 0; i < outBuffer.numChannels; ++i) {
+        audioLevel = jmax(audioLevel, outBuffer[i].max());
+    }
+
+    lastAudioLevel = audioLevel;
+}
+
+namespace {
+    // keeps each event's offset, except that none may land before what dest already
+    // holds, so a later block's note-off can't overtake a deferred note-on
+    void appendInOrder(MidiBuffer& dest, const MidiBuffer& source, int numSamples) {
+        const int earliest = dest.isEmpty() ? 0 : dest.getLastEventTime();
+
+        for (const MidiMessageMetadata md : source) {
+            dest.addEvent(md.getMessage(), jlimit(earliest, jmax(earliest, numSamples - 1), md.samplePosition));
+        }
+    }
+}
+
+void SynthAudioSource::deferMidi(const MidiBuffer& midiMessages) {
+    appendInOrder(deferredMidi, midiMessages, std::numeric_limits<int>::max());
+}
+
+void SynthAudioSource::mergeDeferredMidi(MidiBuffer& midiMessages, int numSamples) {
+    if (deferredMidi.isEmpty()) {
+        return;
+    }
+
+    lockStats.deferredMidiBlocks.fetch_add(1, std::memory_order_relaxed);
+
+    mergedMidi.clear();
+    appendInOrder(mergedMidi, deferredMidi, numSamples);
+    appendInOrder(mergedMidi, midiMessages, numSamples);
+    midiMessages.swapWith(mergedMidi);
+    deferredMidi.clear();
+}
+
+SynthAudioSource::LockContentionStats SynthAudioSource::getLockContentionStats() const {
+    return {
+        lockStats.blocks.load(std::memory_order_relaxed),
+        lockStats.contendedBlocks.load(std::memory_order_relaxed),
+        lockStats.deferredMidiBlocks.load(std::memory_order_relaxed)
+    };
+}
+
+void SynthAudioSource::processResampledBlock(AudioSampleBuffer& buffer, MidiBuffer& midiMessages) {
     int numSamples 		= buffer.getNumSamples();
     double sampleRate 	= getObj(AudioHub).getSampleRate();
-    bool needToResample = sampleRate != 44100.0;
+    bool needToResample = sampleRate != compatibilitySampleRate;
     int numSamples44k   = numSamples;
 
     if (needToResample) {
-        double ratio = 44100.0 / sampleRate;
+        double ratio = compatibilitySampleRate / sampleRate;
         numSamples44k = (int) (ratio * (samplesProcessed + numSamples) + 0.999999999) -
                         (int) (ratio * samplesProcessed + 0.999999999);
 
@@ -160,16 +245,6 @@ void SynthAudioSource::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiM
 
     StereoBuffer outBuffer(buffer);
     StereoBuffer& rendBuffer = needToResample ? tempRendBuffer : outBuffer;
-    auto& meshLib = getObj(MeshLibrary);
-
-    float deltaPerSample = 1.0 / 44100.0 / getObj(OscControlPanel).getLengthInSeconds();
-    for(auto& scratchRast : globalScratch) {
-        MeshLibrary::EnvProps* props = meshLib.getEnvProps(LayerGroups::GroupScratch, scratchRast.layerIndex);
-
-        if(props->active && scratchRast.sampleable) {
-            scratchRast.rast.renderToBuffer(numSamples, deltaPerSample, 0, *props, 1.f);
-        }
-    }
 
     float* channels[] = { rendBuffer.left.get(), rendBuffer.right.get() };
     AudioSampleBuffer buffer44k(channels, buffer.getNumChannels(), numSamples44k);
@@ -182,34 +257,8 @@ void SynthAudioSource::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiM
         midiBuff = &midi44k;
     }
 
-    // sound processing @ 44100
     if (numSamples44k > 0) {
-        synth.renderNextBlock(buffer44k, *midiBuff, 0, numSamples44k);
-
-        waveshaper-> updateSmoothedParameters(numSamples44k);
-        tubeModel->	 updateSmoothedParameters(numSamples44k);
-        equalizer->	 updateSmoothedParameters(numSamples44k);
-
-        for (auto voice : voices) {
-            // todo why is this condition necessary? Makes more sense to invert it.
-            if(voice->getCurrentlyPlayingNote() >= 0) {
-                voice->updateSmoothedParameters(numSamples44k);
-                getObj(MeshLibrary).updateSmoothedParameters(voice->getVoiceIndex(), numSamples44k);
-            }
-        }
-
-        for(auto postProcessEffect : postProcessEffects) {
-            postProcessEffect->process(buffer44k);
-        }
-
-        volumeScale.update(numSamples44k);
-
-        for(int i = 0; i < buffer.getNumChannels(); ++i) {
-            volumeScale.maybeApplyRamp(
-                workBuffer.withSize(numSamples44k),
-                Buffer<float>(buffer44k, i)
-            );
-        }
+        renderSynthBlock(buffer44k, *midiBuff);
     }
 
     if (needToResample) {
@@ -232,14 +281,47 @@ void SynthAudioSource::processBlock(AudioSampleBuffer &buffer, MidiBuffer &midiM
         resampleAccum[ch].write(rendBuffer[ch]);
         resampleAccum[ch].read(numSamples).copyTo(outBuffer[ch]);
     }
+}
 
-    float audioLevel = 0;
+void SynthAudioSource::renderSynthBlock(AudioSampleBuffer& block, MidiBuffer& midi) {
+    int numSamples = block.getNumSamples();
+    auto& meshLib = getObj(MeshLibrary);
 
-    for(int i = 0; i < rendBuffer.numChannels; ++i) {
-        audioLevel = jmax(audioLevel, outBuffer[i].max());
+    float deltaPerSample = 1.0 / renderSampleRate / getObj(OscControlPanel).getLengthInSeconds();
+    for(auto& scratchRast : globalScratch) {
+        MeshLibrary::EnvProps* props = meshLib.getEnvProps(LayerGroups::GroupScratch, scratchRast.layerIndex);
+
+        if(props->active && scratchRast.sampleable) {
+            scratchRast.rast.renderToBuffer(numSamples, deltaPerSample, 0, *props, 1.f);
+        }
     }
 
-    lastAudioLevel = audioLevel;
+    synth.renderNextBlock(block, midi, 0, numSamples);
+
+    waveshaper-> updateSmoothedParameters(numSamples);
+    tubeModel->	 updateSmoothedParameters(numSamples);
+    equalizer->	 updateSmoothedParameters(numSamples);
+
+    for (auto voice : voices) {
+        // todo why is this condition necessary? Makes more sense to invert it.
+        if(voice->getCurrentlyPlayingNote() >= 0) {
+            voice->updateSmoothedParameters(numSamples);
+            meshLib.updateSmoothedParameters(voice->getVoiceIndex(), numSamples);
+        }
+    }
+
+    for(auto postProcessEffect : postProcessEffects) {
+        postProcessEffect->process(block);
+    }
+
+    volumeScale.update(numSamples);
+
+    for(int i = 0; i < block.getNumChannels(); ++i) {
+        volumeScale.maybeApplyRamp(
+            workBuffer.withSize(numSamples),
+            Buffer<float>(block, i)
+        );
+    }
 }
 
 void SynthAudioSource::paramChanged(int controller, float value) {
@@ -276,11 +358,56 @@ void SynthAudioSource::setEnvelopeMeshes(bool lock) {
 void SynthAudioSource::enablementChanged() {
     ScopedLock sl(audioLock);
 
+    appliedLayerValidity = calcLayerValidity();
+
     for (auto voice : voices) {
         voice->enablementChanged();
     }
 }
 
+/*
+ * A mouse-up follows every edit, but few edits change which layers can play.
+ * Only those need the voices reconfigured under the audio lock.
+ */
+void SynthAudioSource::layerValidityMayHaveChanged() {
+    if (calcLayerValidity() != appliedLayerValidity) {
+        enablementChanged();
+    }
+}
+
+// the same conditions SynthesizerVoice::testMeshConditions sets its flags from
+int SynthAudioSource::calcLayerValidity() {
+    auto& spectrum3D = getObj(Spectrum3D);
+    bool haveTime = getObj(MeshLibrary).hasAnyValidLayers(LayerGroups::GroupTime);
+
+    return (haveTime ? 1 : 0)
+         | (spectrum3D.haveAnyValidLayers(true, haveTime) ? 2 : 0)
+         | (spectrum3D.haveAnyValidLayers(false, haveTime) ? 4 : 0);
+}
+
+/*
+ * A copy with more cubes than the voices reserved for renders nothing, so grow
+ * them before it goes out. This is the one mesh edit that waits on the audio
+ * thread, and only when the mesh outgrows every earlier one.
+ */
+void SynthAudioSource::renderMeshesAboutToChange() {
+    MeshLibrary::LayerGroup& timeGroup = getObj(MeshLibrary).getLayerGroup(LayerGroups::GroupTime);
+
+    for (auto& layer : timeGroup.layers) {
+        if (layer.mesh == nullptr) {
+            continue;
+        }
+
+        for (auto* voice : voices) {
+            if (! voice->isVoiceRasterizerPreparedFor(*layer.mesh)) {
+                ScopedLock sl(audioLock);
+                prepareVoiceRasterizersAtSafeBoundary();
+                return;
+            }
+        }
+    }
+}
+
 void SynthAudioSource::prepNewVoice() {
     ScopedLock sl(audioLock);
 
@@ -326,9 +453,7 @@ Effect* SynthAudioSource::getDspEffect(int fxEnum) {
     }
 }
 
-void SynthAudioSource::calcDeclickEnvelope(double /*samplerate*/) {
-    const double samplerate = 44100.0;
-
+void SynthAudioSource::calcDeclickEnvelope(double samplerate) {
     int attackLength 	= (int) ceil(0.00145 * samplerate);
     int releaseLength 	= (int) ceil(0.01 * samplerate);
 
@@ -460,8 +585,12 @@ void SynthAudioSource::initResampler() {
 }
 
 void SynthAudioSource::doAudioThreadUpdates() {
+    // whatever the message thread published since the last block
+    getObj(MeshLibrary).adoptRenderMeshes();
+    getObj(GuideCurvePanel).getAudioTables().adopt();
+
     for (auto pendingAction : pendingActions) {
-        if (pendingAction->isPending()) {
+        if (pendingAction->takePending()) {
             switch (pendingAction->getId()) {
                 case QualityChangeAction:							break;
                 case GlobalRasterAction:	rasterizeGlobalEnvs();	break;
@@ -477,6 +606,8 @@ void SynthAudioSource::doAudioThreadUpdates() {
                     break;
                 }
 
+                case RenderRateAction:		updateRenderSampleRate(); break;
+
                 case UpdateCycleCachesAction:
                     if(voices.size() != 0) {
                         voices.getFirst()->updateCycleCaches();
@@ -491,8 +622,6 @@ void SynthAudioSource::doAudioThreadUpdates() {
                 default:
                     break;
             }
-
-            pendingAction->dismiss();
         }
     }
 
@@ -549,7 +678,7 @@ void SynthAudioSource::updateTempoScale() {
 
 void SynthAudioSource::updateGlobality() {
     MeshLibrary::LayerGroup& scratchGroup = getObj(MeshLibrary).getLayerGroup(LayerGroups::GroupScratch);
-    GuideCurveProvider& guideCurveProvider = getObj(GuideCurvePanel);
+    GuideCurveProvider& guideCurveProvider = getObj(GuideCurvePanel).getAudioTables();
 
     globalScratch.clear();
 
@@ -602,6 +731,63 @@ void SynthAudioSource::rasterizeGlobalEnvs() {
 void SynthAudioSource::qualityChanged() {
 }
 
+void SynthAudioSource::renderRateChanged() {
+    updateEffectSampleRates();
+    renderRateAction.trigger();
+}
+
+void SynthAudioSource::renderThreadsChanged() {
+    int numThreads = 0;
+
+    if (getSetting(ParallelVoiceRendering)) {
+        // the audio thread renders voices too, so more workers than this would sit idle
+        numThreads = jmin(RealtimeWorkerPool::defaultWorkerCount(), getConstant(MaxNumVoices) - 1);
+    }
+
+    ScopedLock sl(audioLock);
+    synth.setRenderThreadCount(numThreads);
+}
+
+bool SynthAudioSource::isRenderingAtHostRate() const {
+    return renderSampleRate == (double) getObj(AudioHub).getSampleRate();
+}
+
+double SynthAudioSource::chooseRenderSampleRate() {
+    const double hostRate = getObj(AudioHub).getSampleRate();
+    const bool native = getDocSetting(NativeRateRendering) && hostRate <= maxNativeSampleRate;
+
+    return native ? hostRate : compatibilitySampleRate;
+}
+
+// the reverb kernel and IR impulse are sized in samples, so they're rebuilt for the
+// rate they'll render at before the audio thread switches to it
+void SynthAudioSource::updateEffectSampleRates() {
+    const double rate = chooseRenderSampleRate();
+
+    reverb->setSampleRate(rate);
+    tubeModel->setSampleRate(rate);
+}
+
+void SynthAudioSource::updateRenderSampleRate() {
+    if (! Util::assignAndWereDifferent(renderSampleRate, chooseRenderSampleRate())) {
+        return;
+    }
+
+    calcDeclickEnvelope(renderSampleRate);
+    equalizer->setSampleRate(renderSampleRate);
+    delay->setSampleRate(renderSampleRate);
+    synth.setCurrentPlaybackSampleRate(renderSampleRate);
+
+    if (! isRenderingAtHostRate()) {
+        initResampler();
+    }
+
+    // sounding notes hold phase increments for the previous rate
+    for (auto voice : voices) {
+        voice->stop(false);
+    }
+}
+
 SynthSound::SynthSound(SingletonRepo* repo) : SingletonAccessor(repo, "SynthSound") {}
 
 bool SynthSound::appliesToNote(int midiNoteNumber) {
@@ -617,4 +803,5 @@ void SynthAudioSource::documentAboutToLoad() {
 
 void SynthAudioSource::documentHasLoaded() {
     numEnvelopeDims = getObj(Document).getVersionValue() >= 2 ? 3 : 2;
+    renderRateChanged();
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <map>
 
 #include <App/SingletonAccessor.h>
@@ -8,6 +9,7 @@
 #include <Algo/Oversampler.h>
 #include <Algo/Resampler.h>
 #include <App/Doc/Document.h>
+#include <App/MeshLibrary.h>
 #include <Audio/AudioHub.h>
 #include <Audio/AudioSourceProcessor.h>
 #include <Audio/SmoothedParameter.h>
@@ -48,6 +50,7 @@ class SynthAudioSource:
     ,	public SingletonAccessor
     ,	public Document::Listener
     ,	public AudioHub::SettingListener
+    ,	public MeshLibrary::Listener
 {
 public:
     explicit SynthAudioSource(SingletonRepo* repo);
@@ -59,9 +62,12 @@ public:
     void calcFades();
     void controlFreqChanged();
     void enablementChanged();
+    void layerValidityMayHaveChanged();
     void prepNewVoice();
     void prepareVoiceRasterizersAtSafeBoundary();
     void qualityChanged();
+    void renderRateChanged();
+    void renderThreadsChanged();
     void releaseResources() override;
     void paramChanged(int controller, float value);
     void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
@@ -72,11 +78,13 @@ public:
 
     void documentAboutToLoad() override;
     void documentHasLoaded() override;
+    void renderMeshesAboutToChange() override;
 
     Effect* getDspEffect(int fxEnum);
 
     float getModValue();
     double getTempoScale() const	{ return tempoScale; 		}
+    double getRenderSampleRate() const { return renderSampleRate; }
     CycDelay& getDelay() 			{ return *delay; 			}
     Equalizer& getEqualizer()		{ return *equalizer; 		}
     Waveshaper& getWaveshaper() 	{ return *waveshaper; 		}
@@ -112,9 +120,10 @@ public:
 
     Synthesizer synth;
 
-    Transform& getFFT(int sizePow2)
+    int getSizeIndex(int sizePow2) const
     {
-        return ffts[sizeToIndex[sizePow2]];
+        auto it = sizeToIndex.find(sizePow2);
+        return it == sizeToIndex.end() ? 0 : it->second;
     }
 
     /*
@@ -127,15 +136,58 @@ public:
     }
     */
 
+    /*
+     * processBlock only try-locks the audio lock, so these count the blocks it
+     * gave up to a message-thread edit instead of waiting. Meshes, guide tables
+     * and the waveshaper reach the audio thread as published snapshots, so only
+     * structural edits -- adding or removing layers, loading a preset,
+     * reconfiguring voices -- still take the lock.
+     */
+    struct LockContentionStats
+    {
+        int64 blocks;
+        int64 contendedBlocks;
+        int64 deferredMidiBlocks;
+    };
+
+    LockContentionStats getLockContentionStats() const;
+
+    bool isRenderingAtHostRate() const;
     void updateTempoScale();
+    void updateRenderSampleRate();
+    void updateEffectSampleRates();
+    double chooseRenderSampleRate();
     void updateGlobality();
     void rasterizeGlobalEnvs();
     void doAudioThreadUpdates() override;
 
+    // Voices and post effects render at the host rate up to this limit, which keeps the
+    // lowest note's period within MaxCyclePeriod. Above it, and when the document opts
+    // out, rendering falls back to 44.1kHz and is resampled to the host rate.
+    static constexpr double compatibilitySampleRate = 44100.0;
+    static constexpr double maxNativeSampleRate 	= 96000.0;
+
+    // cycle sizes from 8 to 2048 samples, indexing fadeIns/fadeOuts and the voices' FFTs
+    enum { numOctaves = 9 };
+
 private:
     void convertMidiTo44k(const MidiBuffer& source, MidiBuffer& dest, int numSamples44k);
+    void renderSynthBlock(AudioSampleBuffer& block, MidiBuffer& midi);
+    void processResampledBlock(AudioSampleBuffer& buffer, MidiBuffer& midiMessages);
+    void deferMidi(const MidiBuffer& midiMessages);
+    void mergeDeferredMidi(MidiBuffer& midiMessages, int numSamples);
+    int calcLayerValidity();
 
-    enum { numOctaves = 9 };
+    static constexpr int midiReserveBytes = 4096;
+
+    struct
+    {
+        std::atomic<int64> blocks 				{ 0 };
+        std::atomic<int64> contendedBlocks 		{ 0 };
+        std::atomic<int64> deferredMidiBlocks 	{ 0 };
+    } lockStats;
+
+    MidiBuffer deferredMidi, mergedMidi;
 
     enum
     {
@@ -150,15 +202,18 @@ private:
     ,	ControlFreqAction
     ,	UnisonVoicesAction
     ,	ModwRouteAction
+    ,	RenderRateAction
     };
 
     int numEnvelopeDims;
+    int appliedLayerValidity;
 
     int64 	samplesProcessed;
 
     float 	lastAudioLevel;
     float 	lastBlueLevel;
     double 	tempoScale;
+    double 	renderSampleRate;
 
     map<int, int> 		sizeToIndex;
     SmoothedParameter 	volumeScale;
@@ -181,6 +236,7 @@ private:
     PendingActionValue<bool>  	qualityChangeAction;
     PendingActionValue<bool>  	initResamplerAction;
     PendingActionValue<bool>  	updateCycleCachesAction;
+    PendingActionValue<bool>  	renderRateAction;
     PendingActionValue<int>   	controlFreqAction;
     PendingActionValue<int>   	unisonVoicesAction;
     PendingActionValue<float> 	modwRouteAction;
@@ -199,7 +255,6 @@ private:
 
     Buffer<Float32> 			fadeIns	[numOctaves];
     Buffer<Float32> 			fadeOuts[numOctaves];
-    Transform					ffts	[numOctaves];
 
     Array<Effect*> 				postProcessEffects;
     Array<MidiMessage> 			carryMessages;
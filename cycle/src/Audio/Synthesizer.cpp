@@ -2,8 +2,14 @@
 
 #include "Synthesizer.h"
 #include "../Audio/SynthAudioSource.h"
+#include "../Audio/Voices/SynthesizerVoice.h"
 #include "../UI/Panels/ModMatrixPanel.h"
 
+Synthesizer::Synthesizer(SingletonRepo* repo) : SingletonAccessor(repo, "Synthesizer") {
+}
+
+Synthesizer::~Synthesizer() = default;
+
 void Synthesizer::handleController(int midiChannel,
                                    int controllerNumber,
                                    int controllerValue) {
@@ -21,3 +27,68 @@ void Synthesizer::handleController(int midiChannel,
         }
     }
 }
+
+void Synthesizer::setRenderThreadCount(int numThreads) {
+    if (numThreads == getRenderThreadCount()) {
+        return;
+    }
+
+    workerPool.reset();
+
+    if (numThreads > 0) {
+        workerPool = std::make_unique<RealtimeWorkerPool>(numThreads);
+    }
+
+    // sized here so the audio thread never grows them
+    activeVoices.ensureStorageAllocated(getNumVoices());
+    voiceHasOutput.ensureStorageAllocated(getNumVoices());
+}
+
+int Synthesizer::getRenderThreadCount() const {
+    return workerPool == nullptr ? 0 : workerPool->getNumWorkers();
+}
+
+void Synthesizer::renderVoices(AudioBuffer<float>& buffer, int startSample, int numSamples) {
+    if (workerPool == nullptr) {
+        Synthesiser::renderVoices(buffer, startSample, numSamples);
+        return;
+    }
+
+    renderVoicesInParallel(buffer, startSample, numSamples);
+}
+
+/*
+ * Voices render into their own scratch buffers across the pool, then are summed
+ * on this thread in voice-index order, so the mix is the same as the serial path.
+ */
+void Synthesizer::renderVoicesInParallel(AudioBuffer<float>& buffer, int startSample, int numSamples) {
+    activeVoices.clearQuick();
+
+    for (auto* voice : voices) {
+        auto* synthVoice = dynamic_cast<SynthesizerVoice*>(voice);
+
+        if (synthVoice == nullptr) {
+            voice->renderNextBlock(buffer, startSample, numSamples);
+        } else if (synthVoice->needsRendering()) {
+            activeVoices.add(synthVoice);
+        }
+    }
+
+    voiceHasOutput.clearQuick();
+    voiceHasOutput.insertMultiple(0, false, activeVoices.size());
+
+    const int numChannels = buffer.getNumChannels();
+
+    auto renderJob = [&](int index) {
+        voiceHasOutput.setUnchecked(index,
+                activeVoices.getUnchecked(index)->renderToVoiceBuffer(startSample, numSamples, numChannels));
+    };
+
+    workerPool->parallelFor(activeVoices.size(), renderJob);
+
+    for (int i = 0; i < activeVoices.size(); ++i) {
+        if (voiceHasOutput.getUnchecked(i)) {
+            activeVoices.getUnchecked(i)->addRenderedBlock(buffer, startSample, numSamples);
+        }
+    }
+}
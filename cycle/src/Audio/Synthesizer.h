@@ -1,8 +1,13 @@
 #pragma once
 
+#include <memory>
+
 #include <App/SingletonAccessor.h>
+#include <Thread/RealtimeWorkerPool.h>
 #include "JuceHeader.h"
 
+class SynthesizerVoice;
+
 class Synthesizer :
         public Synthesiser
     ,	public SingletonAccessor
@@ -19,6 +24,23 @@ public:
         SpeedParam,
     };
 
-    explicit Synthesizer(SingletonRepo* repo) : SingletonAccessor(repo, "Synthesizer") {}
+    explicit Synthesizer(SingletonRepo* repo);
+    ~Synthesizer() override;
+
     void handleController (int midiChannel, int controllerNumber, int controllerValue) override;
+
+    // message thread only, and with the audio lock held; 0 renders voices serially
+    void setRenderThreadCount(int numThreads);
+    int getRenderThreadCount() const;
+
+protected:
+    using Synthesiser::renderVoices;
+    void renderVoices(AudioBuffer<float>& buffer, int startSample, int numSamples) override;
+
+private:
+    void renderVoicesInParallel(AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    std::unique_ptr<RealtimeWorkerPool> workerPool;
+    Array<SynthesizerVoice*> activeVoices;
+    Array<bool> voiceHasOutput;
 };
@@ -55,7 +55,10 @@ CycleBasedVoice::CycleBasedVoice(SynthesizerVoice* parent, SingletonRepo* repo)
     tempBuffer.resize(maxPeriod);
 
     timeRasterizer.setCalcDepthDimensions(false);
-    timeRasterizer.setGuideCurveProvider(&getObj(GuideCurvePanel));
+    timeRasterizer.setGuideCurveProvider(&getObj(GuideCurvePanel).getAudioTables());
+
+    // private scratch instead of the shared memory pool, so voices can render concurrently
+    oversamplerMemory.resize(2 * maxPeriod);
 
     for (int c = 0; c < 2; ++c) {
         // we reuse this as a CCS fft buffer -> 2(n + 1) samples
@@ -63,7 +66,8 @@ CycleBasedVoice::CycleBasedVoice(SynthesizerVoice* parent, SingletonRepo* repo)
         pastCycle[c].resize(maxPeriod);
         biasedCycle[c].resize(maxPeriod);
 
-        oversamplers.add(new Oversampler(repo));
+        oversamplers.add(new Oversampler());
+        oversamplers.getLast()->setMemoryBuffer(oversamplerMemory.section(c * maxPeriod, maxPeriod));
     }
 
     unisonVoiceCountChanged();
@@ -133,7 +137,7 @@ void CycleBasedVoice::initialiseNote(const int midiNoteNumber, const float veloc
 
     if (parent != nullptr) {
         // remember envelopes are unaffected by speed mesh distortion
-        noteState.timePerOutputSample = parent->speedScale.getCurrentValue() / 44100.0;
+        noteState.timePerOutputSample = parent->speedScale.getCurrentValue() / audioSource->getRenderSampleRate();
     }
 
     initialiseNoteExtra(midiNoteNumber, velocity);
@@ -202,6 +206,8 @@ void CycleBasedVoice::initCycleBuffers() {
     if (cycleBufferMemory.ensureSize(totalSize))
         cycleBufferMemory.zero(totalSize);
 
+    oversampleAccumMemory.ensureSize(2 * oversamplers[0]->getOversampleFactor() * bufferSize);
+
     for (auto& group: groups) {
         for (auto& c: group.cycleBuffer) {
             Buffer<float> buf = cycleBufferMemory.section(offset, cycleBuffSize);
@@ -449,7 +455,7 @@ void CycleBasedVoice::renderInterpolatedCycles(int numSamples) {
     bool singleFrame = noteState.numUnisonVoices == 1;
 
     int half = noteState.nextPow2 / 2;
-    int sizeIndex = audioSource->sizeToIndex[noteState.nextPow2];
+    int sizeIndex = audioSource->getSizeIndex(noteState.nextPow2);
     long lastSampleToRender = noteState.totalSamplesPlayed + (long) numSamples;
 
     while (frame.frontier < lastSampleToRender) {
@@ -738,13 +744,13 @@ double CycleBasedVoice::getAngleDelta(int midiNumber, float detuneCents, double
     double pitchWheelSemis = parent ? parent->getPitchWheelValueSemitones() : 0;
 
     if (detuneCents == 0.f && pitchEnvVal == 0.5 && pitchWheelSemis == 0.) {
-        return audioSource->angleDeltas[midiNumber - Constants::LowestMidiNote] / 44100.0;
+        return audioSource->angleDeltas[midiNumber - Constants::LowestMidiNote] / audioSource->getRenderSampleRate();
     }
 
     double pitchEnvSemis = NumberUtils::unitPitchToSemis(pitchEnvVal);
     double fineTune = NumberUtils::noteToFrequency(midiNumber, detuneCents + (pitchEnvSemis + pitchWheelSemis) * 100);
 
-    return fineTune / 44100.0;
+    return fineTune / audioSource->getRenderSampleRate();
 }
 
 void CycleBasedVoice::testIfOversamplingChanged() {
@@ -797,18 +803,13 @@ void CycleBasedVoice::ensureOversampleBufferSize(int numSamples) {
         return;
     }
 
-    Buffer<float> workBuffer = parent->audioSource->getWorkBuffer();
+    // per-voice rather than the audio source's work buffer, so voices can render concurrently;
+    // initCycleBuffers() presizes this for the device block size
     int ovspNumSamples = oversamplers[0]->getOversampleFactor() * numSamples;
+    oversampleAccumMemory.ensureSize(ovspNumSamples * 2);
 
-    if (workBuffer.size() < 2 * ovspNumSamples) {
-        emergencyBuffer.ensureSize(ovspNumSamples * 2);
-
-        oversampleAccumBuf.left = emergencyBuffer.withSize(ovspNumSamples);
-        oversampleAccumBuf.right = Buffer(emergencyBuffer + ovspNumSamples, ovspNumSamples);
-    } else {
-        oversampleAccumBuf.left = workBuffer.withSize(ovspNumSamples);
-        oversampleAccumBuf.right = (workBuffer + ovspNumSamples).withSize(ovspNumSamples);
-    }
+    oversampleAccumBuf.left = oversampleAccumMemory.withSize(ovspNumSamples);
+    oversampleAccumBuf.right = Buffer(oversampleAccumMemory + ovspNumSamples, ovspNumSamples);
 }
 
 inline void CycleBasedVoice::updateChainAngleDelta(VoiceParameterGroup& group,
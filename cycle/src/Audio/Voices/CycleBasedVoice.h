@@ -41,6 +41,7 @@ public:
 
     void initCycleBuffers();
     void prepareVoiceRasterizer();
+    bool isVoiceRasterizerPreparedFor(const Mesh& mesh) const { return timeRasterizer.isPreparedFor(mesh); }
     virtual void testNumLayersChanged();
 
     void testIfOversamplingChanged();
@@ -153,7 +154,8 @@ protected:
     OwnedArray<Oversampler> oversamplers;
 
     StereoBuffer oversampleAccumBuf;
-    ScopedAlloc<Float32> emergencyBuffer;
+    ScopedAlloc<Float32> oversampleAccumMemory;
+    ScopedAlloc<Float32> oversamplerMemory;
     ScopedAlloc<Float32> rastBuffer;
     ScopedAlloc<Float32> tempBuffer;
     ScopedAlloc<Float32> cycleBufferMemory;
@@ -39,8 +39,11 @@ void GraphicSynthVoice::startNote(const int midiNoteNumber,
 
     int displayKey = midiNoteNumber - 12;
 
-    groups[0].angleDelta = MidiMessage::getMidiNoteInHertz(displayKey) / 44100.0;
-    increment = speedScale / (44100.f * (float) groups[0].angleDelta);
+    // the table synth plays straight to the device, without the resampler
+    const double sampleRate = SynthesiserVoice::getSampleRate();
+
+    groups[0].angleDelta = MidiMessage::getMidiNoteInHertz(displayKey) / sampleRate;
+    increment = speedScale / ((float) sampleRate * (float) groups[0].angleDelta);
     currentAngle = 0;
     noteState.totalSamplesPlayed = 0;
 
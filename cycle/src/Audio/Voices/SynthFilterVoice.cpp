@@ -45,14 +45,20 @@ SynthFilterVoice::SynthFilterVoice(SynthesizerVoice* parent, SingletonRepo* repo
     phaseAccumBuffer[Left]	.resize(maxPartials);
     phaseAccumBuffer[Right]	.resize(maxPartials);
 
-    auto& guideCurvePanel = getObj(GuideCurvePanel);
+    static_assert(numFftSizes == SynthAudioSource::numOctaves);
 
-    freqRasterizer.setGuideCurveProvider(&guideCurvePanel);
+    for (int i = 0; i < numFftSizes; ++i) {
+        ffts[i].allocate(8 << i, Transform::ScaleType::DivFwdByN, true);
+    }
+
+    auto& guideCurves = getObj(GuideCurvePanel).getAudioTables();
+
+    freqRasterizer.setGuideCurveProvider(&guideCurves);
     freqRasterizer.setWrapsEnds(false);
     freqRasterizer.setCalcDepthDimensions(false);
     freqRasterizer.setXLimits(-(float) spectMargin, 1.f + (float) spectMargin);
 
-    phaseRasterizer.setGuideCurveProvider(&guideCurvePanel);
+    phaseRasterizer.setGuideCurveProvider(&guideCurves);
     phaseRasterizer.setWrapsEnds(false);
     phaseRasterizer.setCalcDepthDimensions(false);
     phaseRasterizer.setXLimits(-(float) spectMargin, 1.f + (float) spectMargin);
@@ -126,7 +132,7 @@ void SynthFilterVoice::calcCycle(VoiceParameterGroup& group) {
     // forward fft for time-domain cycle
     if (doFwdFFT) {
         for (int c = 0; c < channelCount; ++c) {
-            Transform& fft = audioSource->getFFT(noteState.nextPow2);
+            Transform& fft = ffts[audioSource->getSizeIndex(noteState.nextPow2)];
             fft.forward(accumBufs[c]);
             fft.getMagnitudes().copyTo(magBufs[c]);
             fft.getPhases().copyTo(phaseBufs[c]);
@@ -149,7 +155,7 @@ void SynthFilterVoice::calcCycle(VoiceParameterGroup& group) {
 
     // inverse FFT
     for(int c = 0; c < channelCount; ++c) {
-        Transform& fft = audioSource->getFFT(noteState.nextPow2);
+        Transform& fft = ffts[audioSource->getSizeIndex(noteState.nextPow2)];
 
         magBufs[c].copyTo(fft.getMagnitudes());
         phaseBufs[c].copyTo(fft.getPhases());
@@ -174,8 +180,9 @@ bool SynthFilterVoice::calcTimeDomain(VoiceParameterGroup& group, int samplingSi
     for (int layerIdx = 0; layerIdx < layerSize; ++layerIdx) {
         MeshLibrary::Layer& layer = parent->meshLib->getLayer(LayerGroups::GroupTime, layerIdx);
         MeshLibrary::Properties& props = *layer.props;
+        Mesh* mesh = parent->meshLib->getRenderMesh(LayerGroups::GroupTime, layerIdx);
 
-        if (!props.active || !layer.mesh->hasEnoughCubesForCrossSection()) {
+        if (!props.active || !mesh->hasEnoughCubesForCrossSection()) {
             continue;
         }
 
@@ -184,7 +191,7 @@ bool SynthFilterVoice::calcTimeDomain(VoiceParameterGroup& group, int samplingSi
         const bool rendered = CycleDsp::OscillatorLaneRasterizer::renderFixedFrame(
                 timeRasterizer,
                 {
-                        layer.mesh,
+                        mesh,
                         position,
                         0.f,
                         random.nextInt(GuideCurvePanel::tableSize)
@@ -213,10 +220,11 @@ void SynthFilterVoice::calcMagnitudeFilters(Buffer<Float32> fftRamp) {
 
     Buffer harmRast(rastBuffer.withSize(noteState.numHarmonics));
 
-    for(auto& layer : freqLayers->layers) {
-        MeshLibrary::Properties& props = *layer.props;
+    for (int i = 0; i < freqLayers->size(); ++i) {
+        MeshLibrary::Properties& props = *freqLayers->layers[i].props;
+        Mesh* mesh = parent->meshLib->getRenderMesh(LayerGroups::GroupSpect, i);
 
-        if (!props.active || !layer.mesh->hasEnoughCubesForCrossSection()) {
+        if (!props.active || !mesh->hasEnoughCubesForCrossSection()) {
             continue;
         }
 
@@ -224,7 +232,7 @@ void SynthFilterVoice::calcMagnitudeFilters(Buffer<Float32> fftRamp) {
 
         freqRasterizer.setMorphPosition(props.pos[parent->voiceIndex].withTime(progress));
         freqRasterizer.setNoiseSeed(random.nextInt(GuideCurvePanel::tableSize));
-        freqRasterizer.renderWaveformOnly(layer.mesh);
+        freqRasterizer.renderWaveformOnly(mesh);
 
         auto sampler = freqRasterizer.sampler();
         if (sampler.isSampleable()) {
@@ -306,10 +314,10 @@ void SynthFilterVoice::calcPhaseDomain(Buffer<float> fftRamp,
 
     bool haveAnyValidPhaseLayers = false;
 
-    for(auto& layer : phaseLayers->layers) {
-        MeshLibrary::Properties& props = *layer.props;
+    for (int i = 0; i < phaseLayers->size(); ++i) {
+        MeshLibrary::Properties& props = *phaseLayers->layers[i].props;
 
-        if (props.active && layer.mesh->hasEnoughCubesForCrossSection()) {
+        if (props.active && parent->meshLib->getRenderMesh(LayerGroups::GroupPhase, i)->hasEnoughCubesForCrossSection()) {
             float layerPan 			= props.pan;
             noteState.isStereo     |= (fabsf(layerPan - 0.5f) > 0.03f);
             haveAnyValidPhaseLayers = true;
@@ -336,10 +344,10 @@ void SynthFilterVoice::calcPhaseDomain(Buffer<float> fftRamp,
         int layerSize = phaseLayers->size();
 
         for (int i = 0; i < layerSize; ++i) {
-            MeshLibrary::Layer& layer 		= phaseLayers->layers[i];
-            MeshLibrary::Properties& props 	= *layer.props;
+            MeshLibrary::Properties& props 	= *phaseLayers->layers[i].props;
+            Mesh* mesh 						= parent->meshLib->getRenderMesh(LayerGroups::GroupPhase, i);
 
-            if(! props.active || ! layer.mesh->hasEnoughCubesForCrossSection()) {
+            if(! props.active || ! mesh->hasEnoughCubesForCrossSection()) {
                 continue;
             }
 
@@ -347,7 +355,7 @@ void SynthFilterVoice::calcPhaseDomain(Buffer<float> fftRamp,
 
             phaseRasterizer.setMorphPosition(props.pos[parent->voiceIndex].withTime(progress));
             phaseRasterizer.setNoiseSeed(random.nextInt(GuideCurvePanel::tableSize));
-            phaseRasterizer.renderWaveformOnly(layer.mesh);
+            phaseRasterizer.renderWaveformOnly(mesh);
 
             auto sampler = phaseRasterizer.sampler();
             if (sampler.isSampleable()) {
@@ -3,6 +3,7 @@
 #include <App/MeshLibrary.h>
 #include <Array/ScopedAlloc.h>
 #include <Algo/Convolver.h>
+#include <Algo/FFT.h>
 #include <Curve/Rasterization/Rasterizer/TrilinearMeshRasterizer.h>
 #include <Obj/Ref.h>
 #include "CycleBasedVoice.h"
@@ -40,6 +41,11 @@ private:
 	ScopedAlloc<Float32> phaseScaleRamp;
 	ScopedAlloc<Float32> latencyMoveBuff;
 
+	enum { numFftSizes = 9 };
+
+	// one per cycle size, owned by the voice so voices can render on separate threads
+	Transform ffts[numFftSizes];
+
 	Buffer<float> rastBuf;
 	Buffer<float> magBufs[2], phaseBufs[2], samplingBufs[2], accumBufs[2];
 
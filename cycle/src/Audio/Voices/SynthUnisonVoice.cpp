@@ -57,6 +57,7 @@ void SynthUnisonVoice::initialiseNoteExtra(const int midiNoteNumber, const float
         for (int meshIdx = 0; meshIdx < group.layerStates.size(); ++meshIdx) {
             CycleState& state = group.layerStates[meshIdx];
             MeshLibrary::Layer layer = parent->meshLib->getLayer(LayerGroups::GroupTime, meshIdx);
+            Mesh* mesh = parent->meshLib->getRenderMesh(LayerGroups::GroupTime, meshIdx);
 
             state.reset();
 
@@ -69,10 +70,10 @@ void SynthUnisonVoice::initialiseNoteExtra(const int midiNoteNumber, const float
                 timeRasterizer.setState(&state);
                 timeRasterizer.setMorphPosition(pos);
                 timeRasterizer.setWrapsEnds(true);
-                timeRasterizer.renderOrdinary(layer.mesh, oscPhase);
+                timeRasterizer.renderOrdinary(mesh, oscPhase);
             } else {
                 CycleDsp::OscillatorLaneRasterizer::prime(timeRasterizer, {
-                        layer.mesh,
+                        mesh,
                         &state,
                         pos,
                         oscPhase,
@@ -102,9 +103,10 @@ void SynthUnisonVoice::calcCycle(VoiceParameterGroup& group) {
 
     for (int meshIdx = 0; meshIdx < layerSize; ++meshIdx) {
         MeshLibrary::Layer layer = parent->meshLib->getLayer(LayerGroups::GroupTime, meshIdx);
+        Mesh* mesh = parent->meshLib->getRenderMesh(LayerGroups::GroupTime, meshIdx);
         CycleState& state = group.layerStates[meshIdx];
 
-        if (!layer.props->active || !layer.mesh->hasEnoughCubesForCrossSection()) {
+        if (!layer.props->active || !mesh->hasEnoughCubesForCrossSection()) {
             continue;
         }
 
@@ -132,7 +134,7 @@ void SynthUnisonVoice::calcCycle(VoiceParameterGroup& group) {
             timeRasterizer.setNoiseSeed(random.nextInt(GuideCurvePanel::tableSize));
             timeRasterizer.setInterceptPadding((float) delta);
             timeRasterizer.setState(&state);
-            timeRasterizer.renderOrdinary(layer.mesh, totalPhase);
+            timeRasterizer.renderOrdinary(mesh, totalPhase);
 
             auto sampler = timeRasterizer.sampler();
             if (sampler.isSampleable()) {
@@ -147,8 +149,9 @@ void SynthUnisonVoice::calcCycle(VoiceParameterGroup& group) {
             }
         } else {
             delta = group.angleDelta / double(oversampleFactor);
+
             CycleDsp::OscillatorLaneRasterizer::render(timeRasterizer, {
-                    layer.mesh,
+                    mesh,
                     &state,
                     pos,
                     totalPhase,
@@ -49,7 +49,7 @@ SynthesizerVoice::SynthesizerVoice(int voiceIndex, SingletonRepo* repo) :
     envGroups[1] = &pitchGroup;
     envGroups[2] = &scratchGroup;
 
-    auto& guideCurveProvider = getObj(GuideCurvePanel);
+    auto& guideCurveProvider = getObj(GuideCurvePanel).getAudioTables();
 
     for (auto group: envGroups) {
         group->envGroup.emplace_back(EnvRasterizer(&guideCurveProvider, "EnvRasterizer" + String(group->layerGroup) + "_0"), 0);
@@ -161,12 +161,21 @@ void SynthesizerVoice::stopNote(float velocity, bool allowTailOff) {
 }
 
 void SynthesizerVoice::renderNextBlock(AudioSampleBuffer& audioBuffer, int startSample, int numSamples) {
-    if (numSamples == 0 || (!flags.playing && latencyFillerSamplesLeft == 0)) {
-        return;
+    if (renderToVoiceBuffer(startSample, numSamples, audioBuffer.getNumChannels())) {
+        addRenderedBlock(audioBuffer, startSample, numSamples);
+    }
+}
+
+/*
+ * Touches only this voice's state and read-only shared tables, so voices can
+ * render concurrently. Returns whether renderBuffer holds output to be mixed.
+ */
+bool SynthesizerVoice::renderToVoiceBuffer(int startSample, int numSamples, int numChans) {
+    if (numSamples == 0 || ! needsRendering()) {
+        return false;
     }
 
     blockStartOffset = startSample;
-    int originalNumSamples = numSamples;
 
     if (latencyFillerSamplesLeft > 0) {
         numSamples = jmin(latencyFillerSamplesLeft, numSamples);
@@ -175,29 +184,24 @@ void SynthesizerVoice::renderNextBlock(AudioSampleBuffer& audioBuffer, int start
     }
 
     float mappedVelocity = getEffectiveLevel();
-    int numChans = audioBuffer.getNumChannels();
 
     /// buffer prep
     for (int i = 0; i < numChans; ++i) {
         chanMemory[i].ensureSize(numSamples);
         renderBuffer[i] = chanMemory[i].withSize(numSamples);
+        renderBuffer[i].zero();
     }
 
     renderBuffer.numChannels = numChans;
-    StereoBuffer outputBuffer(audioBuffer, startSample, originalNumSamples);
-
-    for (int i = 0; i < numChans; ++i) {
-        renderBuffer[i].zero();
-    }
 
     /// latency filling
     if (latencyFillerSamplesLeft > 0) {
-        fillRemainingLatencySamples(outputBuffer, numSamples, mappedVelocity);
-        return;
+        fillRemainingLatencySamples(numSamples, mappedVelocity);
+        return true;
     }
 
     if (!flags.playing) {
-        return;
+        return false;
     }
 
     /// render
@@ -225,17 +229,20 @@ void SynthesizerVoice::renderNextBlock(AudioSampleBuffer& audioBuffer, int start
         }
     }
 
-    for (int i = 0; i < outputBuffer.numChannels; ++i) {
+    return true;
+}
+
+void SynthesizerVoice::addRenderedBlock(AudioSampleBuffer& audioBuffer, int startSample, int numSamples) {
+    StereoBuffer outputBuffer(audioBuffer, startSample, numSamples);
+
+    for (int i = 0; i < jmin(outputBuffer.numChannels, renderBuffer.numChannels); ++i) {
         outputBuffer[i].add(renderBuffer[i]);
     }
 }
 
-void SynthesizerVoice::fillRemainingLatencySamples(StereoBuffer& outputBuffer, int numSamples, float mappedVelocity) {
+void SynthesizerVoice::fillRemainingLatencySamples(int numSamples, float mappedVelocity) {
     currentVoice->render(renderBuffer);
-
-    for (int c = 0; c < renderBuffer.numChannels; ++c) {
-        outputBuffer[c].addProduct(renderBuffer[c], mappedVelocity);
-    }
+    renderBuffer.mul(mappedVelocity);
 
     latencyFillerSamplesLeft -= numSamples;
 
@@ -406,7 +413,7 @@ void SynthesizerVoice::resetNote() {
 
 void SynthesizerVoice::calcEnvelopeBuffers(int numSamples) {
     speedScale.update(numSamples);
-    double deltaX = speedScale.getCurrentValue() / 44100.0; //getSampleRate();
+    double deltaX = speedScale.getCurrentValue() / audioSource->getRenderSampleRate();
 
     bool anyActive = false;
 
@@ -431,7 +438,7 @@ void SynthesizerVoice::calcEnvelopeBuffers(int numSamples) {
 
 void SynthesizerVoice::fetchEnvelopeMeshes() {
     envRasterizers.clear();
-    auto& guideCurveProvider = getObj(GuideCurvePanel);
+    auto& guideCurveProvider = getObj(GuideCurvePanel).getAudioTables();
 
     for (int groupIndex = 0; groupIndex < numElementsInArray(envGroups); ++groupIndex) {
         EnvRastGroup& group = *envGroups[groupIndex];
@@ -565,6 +572,10 @@ void SynthesizerVoice::prepareVoiceRasterizer() {
     unisonVoice.prepareVoiceRasterizer();
 }
 
+bool SynthesizerVoice::isVoiceRasterizerPreparedFor(const Mesh& mesh) const {
+    return unisonVoice.isVoiceRasterizerPreparedFor(mesh);
+}
+
 void SynthesizerVoice::envGlobalityChanged() {
     fetchEnvelopeMeshes();
 }
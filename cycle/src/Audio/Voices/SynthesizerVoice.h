@@ -39,6 +39,7 @@ public:
 	void envGlobalityChanged();
 	void prepNewVoice();
     void prepareVoiceRasterizer();
+    bool isVoiceRasterizerPreparedFor(const Mesh& mesh) const;
 
 	/* Midi */
 	void startNote(int midiNoteNumber,
@@ -61,8 +62,11 @@ public:
 						 int newValue) override;
 
 	/* Rendering */
-	void fillRemainingLatencySamples(StereoBuffer& outputBuffer, int numSamples, float mappedVelocity);
+	void fillRemainingLatencySamples(int numSamples, float mappedVelocity);
 	void renderNextBlock(AudioSampleBuffer& outputBuffer, int startSample, int numSamples) override;
+	bool renderToVoiceBuffer(int startSample, int numSamples, int numChans);
+	void addRenderedBlock(AudioSampleBuffer& outputBuffer, int startSample, int numSamples);
+	bool needsRendering() const { return flags.playing || latencyFillerSamplesLeft > 0; }
 	void startLatencyFillingOrStopNote();
 
 	/* Accessors */
@@ -0,0 +1,90 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <thread>
+
+#include <App/Doc/Document.h>
+#include <App/SingletonRepo.h>
+#include <Audio/AudioHub.h>
+#include <JuceHeader.h>
+
+#include "../SynthAudioSource.h"
+#include "../../App/tests/CycleTestHarness.h"
+
+using namespace juce;
+using namespace CycleTestSupport;
+
+namespace {
+    constexpr int blockSize = 512;
+    constexpr double sampleRate = 48000.0;
+
+    // holds the audio lock on another thread, the way a message-thread mesh edit would
+    class LockHolder {
+    public:
+        explicit LockHolder(CriticalSection& lock) :
+                thread([this, &lock] {
+                    ScopedLock sl(lock);
+                    acquired.signal();
+                    release.wait(-1);
+                }) {
+            acquired.wait(-1);
+        }
+
+        ~LockHolder() {
+            release.signal();
+            thread.join();
+        }
+
+    private:
+        WaitableEvent acquired, release;
+        std::thread thread;
+    };
+}
+
+TEST_CASE("processBlock never waits on the audio lock and defers midi while it is held",
+        "[cycle][audio][realtime]") {
+    CycleTestHarness harness;
+    auto& repo = harness.getRepo();
+    auto& source = repo.get<SynthAudioSource>("SynthAudioSource");
+
+    File presetFile(String(CYCLE_SOURCE_DIR) + "/content/presets/Warmth.cyc");
+    REQUIRE(presetFile.existsAsFile());
+
+    {
+        ScopedPresetLoadSuppression suppressPresetUpdates(repo);
+        REQUIRE(repo.get<Document>("Document").open(presetFile.getFullPathName()));
+    }
+
+    repo.get<AudioHub>("AudioHub").prepareToPlay(blockSize, sampleRate);
+    source.prepareToPlay(blockSize, sampleRate);
+    source.allNotesOff();
+
+    const auto before = source.getLockContentionStats();
+    AudioSampleBuffer block(2, blockSize);
+    MidiBuffer midi;
+
+    {
+        LockHolder holder(source.getLock());
+
+        midi.addEvent(MidiMessage::noteOn(1, 60, (uint8) 100), 0);
+        source.processBlock(block, midi);
+
+        REQUIRE(block.getMagnitude(0, blockSize) == 0.f);
+    }
+
+    const auto contended = source.getLockContentionStats();
+    REQUIRE(contended.blocks - before.blocks == 1);
+    REQUIRE(contended.contendedBlocks - before.contendedBlocks == 1);
+
+    float level = 0;
+
+    for (int i = 0; i < 16; ++i) {
+        midi.clear();
+        source.processBlock(block, midi);
+        level = jmax(level, block.getMagnitude(0, blockSize));
+    }
+
+    const auto after = source.getLockContentionStats();
+    REQUIRE(level > 0.f);
+    REQUIRE(after.contendedBlocks == contended.contendedBlocks);
+    REQUIRE(after.deferredMidiBlocks - contended.deferredMidiBlocks == 1);
+}
@@ -0,0 +1,158 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <App/Doc/Document.h>
+#include <App/Settings.h>
+#include <App/SingletonRepo.h>
+#include <Audio/AudioHub.h>
+#include <JuceHeader.h>
+
+#include "../SynthAudioSource.h"
+#include "../../App/tests/CycleTestHarness.h"
+#include "../../Util/CycleEnums.h"
+
+using namespace juce;
+using namespace CycleTestSupport;
+
+namespace {
+    constexpr int blockSize = 512;
+    constexpr int noteNumber = 57;
+
+    void prepareSource(SingletonRepo& repo, double hostRate, bool nativeRate) {
+        auto& settings = repo.get<Settings>("Settings");
+        auto& source = repo.get<SynthAudioSource>("SynthAudioSource");
+
+        settings.getDocumentSetting(DocSettings::NativeRateRendering) = nativeRate;
+        repo.get<AudioHub>("AudioHub").prepareToPlay(blockSize, hostRate);
+        source.prepareToPlay(blockSize, hostRate);
+        source.allNotesOff();
+    }
+
+    void loadPreset(SingletonRepo& repo, const String& name) {
+        File presetFile(String(CYCLE_SOURCE_DIR) + "/content/presets/" + name);
+        REQUIRE(presetFile.existsAsFile());
+
+        ScopedPresetLoadSuppression suppressPresetUpdates(repo);
+        REQUIRE(repo.get<Document>("Document").open(presetFile.getFullPathName()));
+    }
+
+    AudioSampleBuffer renderNote(SynthAudioSource& source, int numBlocks) {
+        AudioSampleBuffer output(2, blockSize * numBlocks);
+        AudioSampleBuffer block(2, blockSize);
+        MidiBuffer midi;
+
+        midi.addEvent(MidiMessage::noteOn(1, noteNumber, (uint8) 100), 0);
+
+        for (int i = 0; i < numBlocks; ++i) {
+            source.processBlock(block, midi);
+            midi.clear();
+
+            for (int ch = 0; ch < 2; ++ch) {
+                output.copyFrom(ch, i * blockSize, block, ch, 0, blockSize);
+            }
+        }
+
+        return output;
+    }
+
+    // lag of the strongest autocorrelation peak within one octave around the note's period
+    int estimatePeriod(const AudioSampleBuffer& output, double hostRate) {
+        const float* samples = output.getReadPointer(0);
+        const int start = output.getNumSamples() / 2;
+        const int window = output.getNumSamples() / 4;
+        const double expected = hostRate / MidiMessage::getMidiNoteInHertz(noteNumber);
+
+        int bestLag = 0;
+        double bestScore = -1e30;
+
+        for (int lag = int(expected * 0.7); lag <= int(expected * 1.4); ++lag) {
+            double score = 0;
+
+            for (int i = 0; i < window; ++i) {
+                score += samples[start + i] * samples[start + i + lag];
+            }
+
+            if (score > bestScore) {
+                bestScore = score;
+                bestLag = lag;
+            }
+        }
+
+        return bestLag;
+    }
+}
+
+TEST_CASE("Synth renders at the host rate unless the 44.1kHz compatibility path is selected",
+        "[cycle][audio][sample-rate]") {
+    CycleTestHarness harness;
+    auto& repo = harness.getRepo();
+    auto& source = repo.get<SynthAudioSource>("SynthAudioSource");
+
+    REQUIRE(repo.get<Settings>("Settings").getDocumentSetting(DocSettings::NativeRateRendering) == 1);
+
+    prepareSource(repo, 48000.0, true);
+    REQUIRE(source.getRenderSampleRate() == Catch::Approx(48000.0));
+    REQUIRE(source.isRenderingAtHostRate());
+
+    prepareSource(repo, 48000.0, false);
+    REQUIRE(source.getRenderSampleRate() == Catch::Approx(SynthAudioSource::compatibilitySampleRate));
+    REQUIRE_FALSE(source.isRenderingAtHostRate());
+
+    prepareSource(repo, 192000.0, true);
+    REQUIRE(source.getRenderSampleRate() == Catch::Approx(SynthAudioSource::compatibilitySampleRate));
+}
+
+TEST_CASE("Native and compatibility rendering agree on pitch", "[cycle][audio][sample-rate]") {
+    CycleTestHarness harness;
+    auto& repo = harness.getRepo();
+    auto& source = repo.get<SynthAudioSource>("SynthAudioSource");
+    loadPreset(repo, "Warmth.cyc");
+
+    for (double hostRate : { 48000.0, 96000.0 }) {
+        prepareSource(repo, hostRate, true);
+        AudioSampleBuffer native = renderNote(source, 32);
+
+        prepareSource(repo, hostRate, false);
+        AudioSampleBuffer compatible = renderNote(source, 32);
+
+        REQUIRE(native.getMagnitude(0, 0, native.getNumSamples()) > 0.f);
+        REQUIRE(compatible.getMagnitude(0, 0, compatible.getNumSamples()) > 0.f);
+
+        const int nativePeriod = estimatePeriod(native, hostRate);
+        const int compatiblePeriod = estimatePeriod(compatible, hostRate);
+
+        REQUIRE(std::abs(nativePeriod - compatiblePeriod) <= 1);
+    }
+}
+
+TEST_CASE("Synth block cost at host rate versus 44.1kHz with resampling", "[cycle][audio][sample-rate][benchmark][.]") {
+    CycleTestHarness harness;
+    auto& repo = harness.getRepo();
+    auto& source = repo.get<SynthAudioSource>("SynthAudioSource");
+    loadPreset(repo, "Warmth.cyc");
+
+    AudioSampleBuffer block(2, blockSize);
+    MidiBuffer midi;
+
+    for (double hostRate : { 48000.0, 96000.0 }) {
+        for (bool nativeRate : { true, false }) {
+            prepareSource(repo, hostRate, nativeRate);
+
+            for (int note : { 48, 55, 60, 64, 67 }) {
+                midi.addEvent(MidiMessage::noteOn(1, note, (uint8) 100), 0);
+            }
+
+            source.processBlock(block, midi);
+            midi.clear();
+
+            const String name = String(hostRate / 1000.0, 0) + "kHz "
+                    + (nativeRate ? "native" : "44.1kHz + resample") + ", block " + String(blockSize);
+
+            BENCHMARK(name.toStdString()) {
+                source.processBlock(block, midi);
+                return block.getSample(0, 0);
+            };
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <App/Doc/Document.h>
+#include <App/SingletonRepo.h>
+#include <Audio/AudioHub.h>
+#include <JuceHeader.h>
+
+#include "../SynthAudioSource.h"
+#include "../../App/tests/CycleTestHarness.h"
+
+using namespace juce;
+using namespace CycleTestSupport;
+
+namespace {
+    constexpr int blockSize = 512;
+    constexpr double sampleRate = 48000.0;
+
+    void prepareChord(SingletonRepo& repo, const String& preset) {
+        File presetFile(String(CYCLE_SOURCE_DIR) + "/content/presets/" + preset);
+        REQUIRE(presetFile.existsAsFile());
+
+        {
+            ScopedPresetLoadSuppression suppressPresetUpdates(repo);
+            REQUIRE(repo.get<Document>("Document").open(presetFile.getFullPathName()));
+        }
+
+        repo.get<AudioHub>("AudioHub").prepareToPlay(blockSize, sampleRate);
+        repo.get<SynthAudioSource>("SynthAudioSource").prepareToPlay(blockSize, sampleRate);
+    }
+
+    double renderChordEnergy(SynthAudioSource& source, int numThreads, int numNotes, int numBlocks) {
+        source.allNotesOff();
+        source.synth.setRenderThreadCount(numThreads);
+
+        AudioSampleBuffer block(2, blockSize);
+        MidiBuffer midi;
+        double energy = 0;
+
+        for (int i = 0; i < numNotes; ++i) {
+            midi.addEvent(MidiMessage::noteOn(1, 48 + 3 * i, (uint8) 100), 0);
+        }
+
+        for (int i = 0; i < numBlocks; ++i) {
+            source.processBlock(block, midi);
+            midi.clear();
+
+            for (int ch = 0; ch < 2; ++ch) {
+                energy += block.getRMSLevel(ch, 0, blockSize);
+            }
+        }
+
+        return energy;
+    }
+}
+
+TEST_CASE("Parallel voice rendering mixes the same chord as serial rendering", "[cycle][audio][voice-threads]") {
+    CycleTestHarness harness;
+    auto& repo = harness.getRepo();
+    auto& source = repo.get<SynthAudioSource>("SynthAudioSource");
+    prepareChord(repo, "Warmth.cyc");
+
+    const double serial = renderChordEnergy(source, 0, 8, 24);
+    const double parallel = renderChordEnergy(source, 3, 8, 24);
+
+    REQUIRE(source.synth.getRenderThreadCount() == 3);
+    REQUIRE(serial > 0);
+
+    // voices start with randomised unison phases, so only the energy is comparable
+    REQUIRE(parallel == Catch::Approx(serial).epsilon(0.05));
+
+    source.synth.setRenderThreadCount(0);
+    REQUIRE(source.synth.getRenderThreadCount() == 0);
+}
+
+TEST_CASE("Synth block cost by voice count, serial versus parallel voices",
+        "[cycle][audio][voice-threads][benchmark][.]") {
+    CycleTestHarness harness;
+    auto& repo = harness.getRepo();
+    auto& source = repo.get<SynthAudioSource>("SynthAudioSource");
+    prepareChord(repo, "Warmth.cyc");
+
+    AudioSampleBuffer block(2, blockSize);
+    MidiBuffer midi;
+
+    for (int numThreads : { 0, RealtimeWorkerPool::defaultWorkerCount() }) {
+        for (int numNotes : { 1, 4, 8, 12 }) {
+            renderChordEnergy(source, numThreads, numNotes, 1);
+
+            const String name = String(numNotes) + " voices, "
+                    + (numThreads == 0 ? String("serial") : String(numThreads) + " workers");
+
+            BENCHMARK(name.toStdString()) {
+                source.processBlock(block, midi);
+                return block.getSample(0, 0);
+            };
+        }
+    }
+
+    source.synth.setRenderThreadCount(0);
+}
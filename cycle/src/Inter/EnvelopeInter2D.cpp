@@ -384,11 +384,15 @@ bool EnvelopeInter2D::synchronizeEnvPoints(Vertex* vertex, bool vertexIsLoopVert
                 }
             }
 
+            markMeshEdited();
+
             didAnything = true;
         } else if (sustainCube != nullptr && sustainCube->guideCurveAt(Vertex::Time) < 0) {
             for (int i = 0; i < VertCube::numVerts; ++i) {
                 sustainCube->getVertex(i)->setMaxSharpness();
             }
+
+            markMeshEdited();
         }
     }
 
@@ -696,6 +700,8 @@ void EnvelopeInter2D::adjustAddedLine(VertCube* addedLine) {
         lowFace[i]->values[Vertex::Time] = 0.f;
         highFace[i]->values[Vertex::Time] = 1.f;
     }
+
+    markMeshEdited();
 }
 
 void EnvelopeInter2D::doSustainReleaseChange(bool isSustain) {
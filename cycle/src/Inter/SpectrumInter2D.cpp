@@ -75,7 +75,7 @@ bool SpectrumInter2D::locateClosestElement() {
 
 void SpectrumInter2D::doExtraMouseUp() {
     if (getMesh()->getNumCubes() < 6) {
-        getObj(SynthAudioSource).enablementChanged();
+        getObj(SynthAudioSource).layerValidityMayHaveChanged();
     }
 }
 
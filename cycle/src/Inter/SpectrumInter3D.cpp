@@ -57,7 +57,7 @@ void SpectrumInter3D::updateSelectionClient() {
 void SpectrumInter3D::doExtraMouseUp() {
     Interactor3D::doExtraMouseUp();
 
-    getObj(SynthAudioSource).enablementChanged();
+    getObj(SynthAudioSource).layerValidityMayHaveChanged();
 }
 
 void SpectrumInter3D::meshSelectionChanged(Mesh* mesh) {
@@ -121,22 +121,15 @@ Interactor* SpectrumInter3D::getOppositeInteractor() {
     return &getObj(SpectrumInter2D);
 }
 
+// the voices render published copies of the spectrum meshes, so swapping one needs no audio lock
 void SpectrumInter3D::enterClientLock(bool audioThreadApplicable) {
-    if (audioThreadApplicable) {
-        getObj(SynthAudioSource).getLock().enter();
-    }
-
     panel->getRenderLock().enter();
 }
 
 void SpectrumInter3D::meshSelectionFinished() {
-    getObj(SynthAudioSource).enablementChanged();
+    getObj(SynthAudioSource).layerValidityMayHaveChanged();
 }
 
 void SpectrumInter3D::exitClientLock(bool audioThreadApplicable) {
     panel->getRenderLock().exit();
-
-    if (audioThreadApplicable) {
-        getObj(SynthAudioSource).getLock().exit();
-    }
 }
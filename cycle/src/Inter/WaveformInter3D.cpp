@@ -46,6 +46,7 @@ void WaveformInter3D::doPhaseShift(float shift) {
     }
 
     validateLinePhases();
+    markMeshEdited();
     triggerRefreshUpdate();
 }
 
@@ -125,7 +126,7 @@ bool WaveformInter3D::isCurrentMeshActive() {
 void WaveformInter3D::doExtraMouseUp() {
     Interactor3D::doExtraMouseUp();
 
-    getObj(SynthAudioSource).enablementChanged();
+    getObj(SynthAudioSource).layerValidityMayHaveChanged();
 }
 
 void WaveformInter3D::updateRastDims() {
@@ -136,25 +137,17 @@ Interactor* WaveformInter3D::getOppositeInteractor() {
     return &getObj(WaveformInter2D);
 }
 
+// the voices render published copies of the time meshes, so swapping one needs no audio lock
 void WaveformInter3D::enterClientLock(bool audioThreadApplicable) {
-    if (audioThreadApplicable) {
-        getObj(SynthAudioSource).getLock().enter();
-    }
-
     panel->getRenderLock().enter();
 }
 
 void WaveformInter3D::meshSelectionFinished() {
-    getObj(SynthAudioSource).enablementChanged();
+    getObj(SynthAudioSource).layerValidityMayHaveChanged();
 }
 
 void WaveformInter3D::exitClientLock(bool audioThreadApplicable) {
     panel->getRenderLock().exit();
-
-    if (audioThreadApplicable) {
-        getObj(SynthAudioSource).prepareVoiceRasterizersAtSafeBoundary();
-        getObj(SynthAudioSource).getLock().exit();
-    }
 }
 
 String WaveformInter3D::getYString(float yVal, int yIndex, const Column& col, float fundFreq) {
@@ -1,6 +1,7 @@
 #include <algorithm>
 
 #include <App/Doc/Document.h>
+#include <App/Doc/PresetBinary.h>
 #include <App/Doc/PresetJson.h>
 #include <App/AppConstants.h>
 #include <App/EditWatcher.h>
@@ -41,6 +42,11 @@ namespace {
 
         stream->setPosition(0);
 
+        if (PresetBinary::isBinary(*stream)) {
+            PresetBinary::Reader reader;
+            return reader.open(*stream) && details.readJSON(reader.readSection("details"));
+        }
+
         GZIPDecompressorInputStream decompStream(stream.get(), false);
         String presetDocString(decompStream.readEntireStreamAsString().trimStart());
 
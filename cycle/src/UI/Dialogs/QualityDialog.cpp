@@ -18,6 +18,8 @@ QualityDialog::QualityDialog(SingletonRepo* repo) :
     ,	rltmLabel("", 		"Oversampling")
     ,	rltmHqLabel("", 	"Resampling")
     ,	ctrlFreqLbl("",     "Control update rate")
+    ,	nativeRateLbl("",   "Render at host sample rate")
+    ,	voiceThreadsLbl("", "Render voices across cores")
     ,	paramSmoothLbl("", 	"Parameter smoothing")
 {
     rltmOvsp	.addItem("None", 	OversampRltm1x	);
@@ -59,6 +61,10 @@ QualityDialog::QualityDialog(SingletonRepo* repo) :
     addAndMakeVisible(&modulationTitle);
     addAndMakeVisible(&ctrlFreqCmbo	);
     addAndMakeVisible(&ctrlFreqLbl	);
+    addAndMakeVisible(&nativeRateLbl);
+    addAndMakeVisible(&nativeRate	);
+    addAndMakeVisible(&voiceThreadsLbl);
+    addAndMakeVisible(&voiceThreads	);
 
     addAndMakeVisible(&paramSmoothLbl);
     addAndMakeVisible(&useSmooth	);
@@ -70,6 +76,8 @@ QualityDialog::QualityDialog(SingletonRepo* repo) :
     rendAlgoCmbo.addListener(this);
 //	useCache	.addListener(this);
     useSmooth	.addListener(this);
+    nativeRate	.addListener(this);
+    voiceThreads.addListener(this);
 
     qualityTitle.setFont(FontOptions(18));
     modulationTitle.setFont(FontOptions(18));
@@ -86,16 +94,18 @@ QualityDialog::QualityDialog(SingletonRepo* repo) :
         label->setJustificationType(Justification::centredLeft);
     }
 
-    for (auto* label : { &rltmLabel, &rltmHqLabel, &paramSmoothLbl, &ctrlFreqLbl }) {
+    for (auto* label : { &rltmLabel, &rltmHqLabel, &paramSmoothLbl, &ctrlFreqLbl, &nativeRateLbl, &voiceThreadsLbl }) {
         label->setColour(Label::textColourId, Colour::greyLevel(0.76f));
         label->setJustificationType(Justification::centredRight);
     }
 
-    useSmooth.setColour(ToggleButton::textColourId, Colour::greyLevel(0.76f));
-    useSmooth.setColour(ToggleButton::tickColourId, Colours::orange);
-    useSmooth.setColour(ToggleButton::tickDisabledColourId, Colour::greyLevel(0.58f));
+    for (auto* toggle : { &useSmooth, &nativeRate, &voiceThreads }) {
+        toggle->setColour(ToggleButton::textColourId, Colour::greyLevel(0.76f));
+        toggle->setColour(ToggleButton::tickColourId, Colours::orange);
+        toggle->setColour(ToggleButton::tickDisabledColourId, Colour::greyLevel(0.58f));
+    }
 
-    setSize(500, 350);
+    setSize(500, 436);
 }
 
 void QualityDialog::comboBoxChanged(ComboBox* box) {
@@ -256,11 +266,20 @@ void QualityDialog::updateSelections() {
     rendAlgoCmbo.setSelectedId(resampAlgoRend);
 
     useSmooth.setToggleState(getDocSetting(ParameterSmoothing) == 1, dontSendNotification);
+    nativeRate.setToggleState(getDocSetting(NativeRateRendering) == 1, dontSendNotification);
+    voiceThreads.setToggleState(getSetting(ParallelVoiceRendering) == 1, dontSendNotification);
 }
 
 void QualityDialog::buttonClicked(Button* button) {
     if (button == &useSmooth) {
         getDocSetting(ParameterSmoothing) ^= true;
+    } else if (button == &nativeRate) {
+        getDocSetting(NativeRateRendering) ^= true;
+        getObj(SynthAudioSource).renderRateChanged();
+        getObj(EditWatcher).setHaveEditedWithoutUndo(true);
+    } else if (button == &voiceThreads) {
+        getSetting(ParallelVoiceRendering) ^= true;
+        getObj(SynthAudioSource).renderThreadsChanged();
     }
 
     updateSelections();
@@ -312,6 +331,18 @@ void QualityDialog::resized() {
     layoutDualControlRow(rltmHqLabel, rltmAlgoCmbo, rendAlgoCmbo);
     layoutSingleControlRow(ctrlFreqLbl, ctrlFreqCmbo);
 
+    auto layoutToggleRow = [&](Label& label, ToggleButton& toggle) {
+        Rectangle<int> row = bounds.removeFromTop(rowHeight);
+        label.setBounds(row.removeFromLeft(labelWidth));
+        row.removeFromLeft(columnGap);
+        toggle.setBounds(row.removeFromLeft(28).withSizeKeepingCentre(22, 22));
+    };
+
+    layoutToggleRow(nativeRateLbl, nativeRate);
+    bounds.removeFromTop(12);
+    layoutToggleRow(voiceThreadsLbl, voiceThreads);
+    bounds.removeFromTop(12);
+
     bounds.removeFromTop(10);
     modulationTitle.setBounds(bounds.removeFromTop(28));
     bounds.removeFromTop(16);
@@ -321,11 +352,7 @@ void QualityDialog::resized() {
 //	row	.removeFromLeft(1);
 //	useCacheLbl	.setBounds(row);
 
-    Rectangle<int> row = bounds.removeFromTop(rowHeight);
-    paramSmoothLbl.setBounds(row.removeFromLeft(labelWidth));
-    row.removeFromLeft(columnGap);
-    useSmooth.setBounds(row.removeFromLeft(28).withSizeKeepingCentre(22, 22));
-
+    layoutToggleRow(paramSmoothLbl, useSmooth);
 }
 
 void QualityDialog::paint(Graphics& g) {
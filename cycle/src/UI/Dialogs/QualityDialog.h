@@ -52,6 +52,6 @@ private:
 
     ComboBox 		rltmOvsp, rendOvsp, ctrlFreqCmbo, rltmAlgoCmbo, rendAlgoCmbo;
     Label 			qualityTitle, modulationTitle, rltmTitle, rendTitle, rltmLabel, paramSmoothLbl;
-    Label           ctrlFreqLbl, rltmHqLabel;
-    ToggleButton 	useSmooth;
+    Label           ctrlFreqLbl, rltmHqLabel, nativeRateLbl, voiceThreadsLbl;
+    ToggleButton 	useSmooth, nativeRate, voiceThreads;
 };
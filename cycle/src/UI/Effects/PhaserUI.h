@@ -4,6 +4,7 @@
 #include "../../UI/Effects/GuilessEffect.h"
 #include "../../Audio/Effects/AudioEffect.h"
 #include "../../Audio/Effects/Phaser.h"
+#include "../../Util/CycleEnums.h"
 
 class SingletonRepo;
 
@@ -265,6 +265,8 @@ void VertexPropertiesPanel::sliderValueChanged(Slider* slider) {
 			refreshCube(lines);
 		}
 
+		currentInteractor->markMeshEdited();
+
 		if(getSetting(UpdateGfxRealtime)) {
 			currentInteractor->triggerRefreshUpdate();
 		}
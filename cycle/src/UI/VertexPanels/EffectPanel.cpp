@@ -109,7 +109,7 @@ bool EffectPanel::addNewCube(float startTime, float x, float y, float curve) {
     vertex->values[Vertex::Curve] = curve;
     state.currentVertex = vertex;
 
-    verts.push_back(vertex);
+    getMesh()->addVertex(vertex);
 
     DBG(getName() + "::addNewVertex"
         + " mesh=" + String::toHexString((pointer_sized_int) getMesh())
@@ -76,6 +76,7 @@ void GuideCurvePanel::init() {
     noiseArray = constMemory.place(tableSize);
     GuideCurveTableDsp::initializeNoise(noiseArray);
     phaseMoveBuffer = constMemory.place(tableSize);
+    audioTables.setNoise(noiseArray);
 
     createNameImage("Guide Curves");
     dynMemory.resize(tableSize * 4);
@@ -128,6 +129,8 @@ void GuideCurvePanel::rasterizeAllTables() {
     localRasterizer.setMesh(guideCurveGroup.getCurrentMesh());
     localRasterizer.performUpdate(Update);
 
+    publishAudioTables();
+
     exitClientLock();
 }
 
@@ -153,6 +156,32 @@ void GuideCurvePanel::rasterizeTable() {
     } else {
         props.table.set(0.5f);
     }
+
+    publishAudioTables();
+}
+
+void GuideCurvePanel::publishAudioTables() {
+    ScopedLock sl(renderLock);
+
+    auto snapshot = std::make_shared<AudioTables::Snapshot>();
+    snapshot->memory.resize(jmax(1, (int) guideTables.size()) * tableSize);
+
+    for (int i = 0; i < (int) guideTables.size(); ++i) {
+        const GuideCurveProps& props = guideTables[i];
+        Buffer<Float32> table = snapshot->memory.place(tableSize);
+
+        if (props.table.size() == tableSize) {
+            props.table.copyTo(table);
+        } else {
+            table.zero();
+        }
+
+        snapshot->tables.push_back(table);
+        snapshot->parameters.push_back(props.parameters());
+        snapshot->densities.push_back(getTableDensity(i));
+    }
+
+    audioTables.publish(std::move(snapshot));
 }
 
 void GuideCurvePanel::preDraw()
@@ -292,6 +321,8 @@ void GuideCurvePanel::sliderValueChanged(Slider* slider) {
         props.phaseOffsetLevel = powf(phaseOffset.getValue(), 2);
     }
 
+    publishAudioTables();
+
     if (getSetting(UpdateGfxRealtime)) {
         postUpdateMessage();
     }
@@ -383,14 +414,13 @@ void GuideCurvePanel::setMeshAndUpdate(Mesh* mesh) {
     repaint();
 }
 
+// the audio thread reads the published tables, so editing the panel's own needs no audio lock
 void GuideCurvePanel::enterClientLock() {
-    getObj(SynthAudioSource).getLock().enter();
     renderLock.enter();
 }
 
 void GuideCurvePanel::exitClientLock() {
     renderLock.exit();
-    getObj(SynthAudioSource).getLock().exit();
 }
 
 Mesh* GuideCurvePanel::getCurrentMesh() {
@@ -579,6 +609,68 @@ void GuideCurvePanel::sampleDownAddNoise(int index,
             context);
 }
 
+GuideCurvePanel::CopiedTables::CopiedTables() :
+        phaseScratch(tableSize) {
+}
+
+float GuideCurvePanel::CopiedTables::getTableValue(
+        int guideIndex,
+        float progress,
+        const NoiseContext& context) {
+    const Snapshot& copy = snapshot();
+
+    if (! isPositiveAndBelow(guideIndex, (int) copy.tables.size())) {
+        return 0;
+    }
+
+    return GuideCurveTableDsp::tableValue(
+            copy.tables[guideIndex],
+            noiseArray,
+            copy.parameters[guideIndex],
+            progress,
+            context);
+}
+
+void GuideCurvePanel::CopiedTables::sampleDownAddNoise(
+        int index,
+        Buffer<float> dest,
+        const NoiseContext& context) {
+    const Snapshot& copy = snapshot();
+
+    if (! isPositiveAndBelow(index, (int) copy.tables.size())) {
+        dest.zero();
+        return;
+    }
+
+    GuideCurveTableDsp::sampleDownAddNoise(
+            copy.tables[index],
+            noiseArray,
+            phaseScratch,
+            copy.parameters[index],
+            dest,
+            context);
+}
+
+Buffer<Float32> GuideCurvePanel::CopiedTables::getTable(int index) {
+    const Snapshot& copy = snapshot();
+
+    if (! isPositiveAndBelow(index, (int) copy.tables.size())) {
+        return {};
+    }
+
+    return copy.tables[index];
+}
+
+int GuideCurvePanel::CopiedTables::getTableDensity(int index) {
+    const Snapshot& copy = snapshot();
+
+    if (! isPositiveAndBelow(index, (int) copy.densities.size())) {
+        return 0;
+    }
+
+    return copy.densities[index];
+}
+
 void GuideCurvePanel::reset() {
     //	panelControls->resetLayerBox();
 
@@ -6,6 +6,7 @@
 #include <Curve/GuideCurveProvider.h>
 #include <Curve/Mesh/Mesh.h>
 #include <Obj/Ref.h>
+#include <Thread/SnapshotMailbox.h>
 #include <UI/Widgets/Knob.h>
 
 #include "EffectPanel.h"
@@ -33,6 +34,70 @@ class GuideCurvePanel :
 public:
     enum { tableSize = 8192, tableModulo = tableSize - 1 };
 
+    /*
+     * Reads the guide curves from a copy of every table and its noise
+     * parameters instead of the live tables, so it needs no render lock. One
+     * instance per reading thread, as it samples through a scratch buffer.
+     */
+    class CopiedTables : public GuideCurveProvider {
+    public:
+        struct Snapshot {
+            ScopedAlloc<Float32> memory;
+            vector<Buffer<Float32>> tables;
+            vector<GuideCurveTableParameters> parameters;
+            vector<int> densities;
+        };
+
+        CopiedTables();
+
+        void setNoise(Buffer<float> noise) { noiseArray = noise; }
+
+        float getTableValue(int guideIndex, float progress, const NoiseContext& context) override;
+        void sampleDownAddNoise(int index, Buffer<float> dest, const NoiseContext& context) override;
+        Buffer<Float32> getTable(int index) override;
+        int getTableDensity(int index) override;
+
+    protected:
+        virtual const Snapshot& snapshot() const = 0;
+
+    private:
+        Buffer<float> noiseArray;
+        ScopedAlloc<Float32> phaseScratch;
+    };
+
+    /*
+     * The guide curves as the audio thread sees them: published whenever a
+     * table or its noise parameters change and adopted once per block, so the
+     * panel rasterizes under its render lock alone. Read it on the audio
+     * thread, or with the audio lock held.
+     */
+    class AudioTables : public CopiedTables {
+    public:
+        void publish(std::shared_ptr<const Snapshot> snapshot) { snapshots.publish(std::move(snapshot)); }
+        void adopt() { snapshots.adopt(); }
+
+        // message thread
+        [[nodiscard]] std::shared_ptr<const Snapshot> latest() const { return snapshots.latest(); }
+
+    protected:
+        const Snapshot& snapshot() const override { return snapshots.current(); }
+
+    private:
+        SnapshotMailbox<Snapshot> snapshots;
+    };
+
+    // the guide curves as they were when a render off the message thread took them
+    class HeldTables : public CopiedTables {
+    public:
+        void hold(std::shared_ptr<const Snapshot> snapshot) { held = std::move(snapshot); }
+
+    protected:
+        const Snapshot& snapshot() const override { return *held; }
+
+    private:
+        std::shared_ptr<const Snapshot> held { std::make_shared<const Snapshot>() };
+    };
+
     explicit GuideCurvePanel(SingletonRepo* repo);
 
     bool isEffectEnabled() const override;
@@ -68,6 +133,10 @@ public:
     void triggerButton(int id);
     void updateDspSync() override;
     void updateKnobsImplicit();
+    void publishAudioTables();
+
+    AudioTables& getAudioTables() { return audioTables; }
+    Buffer<float> getNoiseArray() const { return noiseArray; }
 
     int getLayerType() override { return layerType; }
 
@@ -143,6 +212,7 @@ private:
     Buffer<float> noiseArray;
     Buffer<float> phaseMoveBuffer;
     vector<GuideCurveProps> guideTables;
+    AudioTables audioTables;
 
     std::unique_ptr<MeshSelector<Mesh> > meshSelector;
 
@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
+#include <numeric>
 
 #include <Algo/AutoModeller.h>
 #include <App/AppConstants.h>
@@ -11,6 +14,7 @@
 #include <Definitions.h>
 #include <Design/Updating/Updater.h>
 #include <Thread/LockTracer.h>
+#include <Thread/RealtimeWorkerPool.h>
 #include <Util/Arithmetic.h>
 #include <Util/LogRegions.h>
 #include <Util/NumberUtils.h>
@@ -86,8 +90,209 @@ bool logColumnsNaNOnce(const char* label, const vector<Column>& columns) {
 
     return false;
 }
+
+// the columns a stage redoes: those given, or every one of them
+const vector<int>& columnsToRedo(const vector<int>* columns, int numColumns, vector<int>& all) {
+    if (columns != nullptr) {
+        return *columns;
+    }
+
+    all.resize((size_t) jmax(0, numColumns));
+    std::iota(all.begin(), all.end(), 0);
+    return all;
+}
+
+bool sameColumnSizes(const vector<Column>& a, const vector<Column>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].size() != b[i].size()) {
+            return false;
+        }
+    }
+
+    return true;
+}
 }
 
+/*
+ * Everything a render of the time columns reads, copied on the message thread so
+ * the render can run without it: the published mesh copies, the guide tables, the
+ * slice positions and scratch times. It renders into columns of its own, laid out
+ * like the preEnvCols it renders, and lists each tile's columns as it finishes.
+ */
+struct VisualDsp::TimeJob {
+    int columnSize {};
+
+    std::shared_ptr<const MeshLibrary::RenderMeshes> meshes;
+    std::shared_ptr<const GuideCurvePanel::CopiedTables::Snapshot> guideTables;
+    Buffer<float> guideNoise;
+
+    Rasterization::GraphicRasterizer rasterizer { true, 0.f };
+    vector<Rasterization::TimeColumnRasterizer::Layer> layers;
+    Rasterization::TimeColumnRasterizer::Context context;
+
+    ScopedAlloc<Float32> zoomProgress, scratchTimes, columnMemory;
+    vector<char> scratchResolved;
+    vector<Column> columns;
+    vector<int> columnsToRender;
+
+    std::atomic<bool> cancelled { false };
+    std::atomic<bool> finished { false };
+
+    CriticalSection landedLock;
+    vector<int> landed;
+};
+
+/*
+ * Renders one time job at a time. A job submitted while another renders cancels
+ * it, since the new one redoes every column the old one hadn't delivered.
+ */
+class VisualDsp::TimeColumnThread : public Thread {
+public:
+    TimeColumnThread(VisualDsp& dsp, RealtimeWorkerPool* pool) :
+            Thread  ("TimeColumns")
+        ,   dsp     (dsp)
+        ,   pool    (pool) {
+    }
+
+    ~TimeColumnThread() override {
+        cancel();
+        signalThreadShouldExit();
+        notify();
+        stopThread(5000);
+    }
+
+    void submit(std::shared_ptr<TimeJob> job) {
+        {
+            const ScopedLock sl(jobLock);
+            cancelLocked();
+            pending = std::move(job);
+        }
+
+        notify();
+    }
+
+    void cancel() {
+        const ScopedLock sl(jobLock);
+        cancelLocked();
+    }
+
+    void run() override {
+        while (!threadShouldExit()) {
+            std::shared_ptr<TimeJob> job;
+
+            {
+                const ScopedLock sl(jobLock);
+                job.swap(pending);
+                running = job;
+            }
+
+            if (job == nullptr) {
+                wait(-1);
+                continue;
+            }
+
+            render(*job);
+
+            const ScopedLock sl(jobLock);
+            running.reset();
+        }
+    }
+
+private:
+    void cancelLocked() {
+        for (auto* job : { &pending, &running }) {
+            if (*job != nullptr) {
+                (*job)->cancelled = true;
+            }
+        }
+
+        pending.reset();
+    }
+
+    void render(TimeJob& job) {
+        prepareLanes(job);
+
+        auto context = job.context;
+        context.cancelled = &job.cancelled;
+        context.tileRendered = [this, &job](int first, int end) {
+            {
+                const ScopedLock sl(job.landedLock);
+
+                for (int i = first; i < end; ++i) {
+                    job.landed.push_back(job.columnsToRender[(size_t) i]);
+                }
+            }
+
+            dsp.triggerAsyncUpdate();
+        };
+
+        if (pool != nullptr) {
+            context.pool  = pool;
+            context.lanes = &lanes;
+        } else {
+            const auto& lane = lanes.front();
+
+            context.rasterizer  = lane.rasterizer;
+            context.layerBuffer = lane.layerBuffer;
+            context.sumBuffer   = lane.sumBuffer;
+        }
+
+        Rasterization::TimeColumnRasterizer().render(context);
+
+        if (!job.cancelled) {
+            job.finished = true;
+            dsp.triggerAsyncUpdate();
+        }
+    }
+
+    // each lane reads the job's copy of the guide tables through a provider of its own
+    void prepareLanes(const TimeJob& job) {
+        // the calling thread takes a lane too
+        int numLanes = pool != nullptr ? pool->getNumWorkers() + 1 : 1;
+        int numLayers = (int) job.layers.size();
+        int laneSize = (numLayers + 1) * job.columnSize;
+
+        while ((int) laneRasterizers.size() < numLanes) {
+            laneRasterizers.push_back(std::make_unique<Rasterization::GraphicRasterizer>(true, 0.f));
+            laneGuides.push_back(std::make_unique<GuideCurvePanel::HeldTables>());
+        }
+
+        laneMemory.ensureSize(numLanes * laneSize);
+        lanes.clear();
+
+        for (int i = 0; i < numLanes; ++i) {
+            auto& guides = *laneGuides[(size_t) i];
+            guides.setNoise(job.guideNoise);
+            guides.hold(job.guideTables);
+
+            auto& rasterizer = *laneRasterizers[(size_t) i];
+            rasterizer.copyBatchStateFrom(job.rasterizer);
+            rasterizer.setGuideCurveProvider(&guides);
+
+            Rasterization::TimeColumnRasterizer::Lane lane;
+            lane.rasterizer  = &rasterizer;
+            lane.layerBuffer = laneMemory.place(numLayers * job.columnSize);
+            lane.sumBuffer   = laneMemory.place(job.columnSize);
+            lanes.push_back(lane);
+        }
+    }
+
+    VisualDsp& dsp;
+    RealtimeWorkerPool* pool;
+
+    CriticalSection jobLock;
+    std::shared_ptr<TimeJob> pending, running;
+
+    vector<std::unique_ptr<Rasterization::GraphicRasterizer>> laneRasterizers;
+    vector<std::unique_ptr<GuideCurvePanel::HeldTables>> laneGuides;
+    vector<Rasterization::TimeColumnRasterizer::Lane> lanes;
+    ScopedAlloc<Float32> laneMemory;
+};
+
 VisualDsp::VisualDsp(SingletonRepo* repo) :
         SingletonAccessor(repo, "VisualDsp")
     ,	timeProcessor	(this, repo, TimeStage)
@@ -102,6 +307,22 @@ VisualDsp::VisualDsp(SingletonRepo* repo) :
         ffts[fftOrderIdx].allocate(size, Transform::DivFwdByN, true);
         ffts[fftOrderIdx].setRemovesOffset(true);
     }
+
+    // the update graph may run on its own pool, so the columns get a separate one
+    int numWorkers = jmin(3, RealtimeWorkerPool::defaultWorkerCount());
+
+    if (numWorkers > 0) {
+        columnPool = std::make_unique<RealtimeWorkerPool>(numWorkers, Thread::Priority::normal);
+    }
+
+    timeThread = std::make_unique<TimeColumnThread>(*this, columnPool.get());
+    timeThread->startThread(Thread::Priority::normal);
+}
+
+VisualDsp::~VisualDsp() {
+    // landing tiles call back into this, so the thread stops first
+    timeThread = nullptr;
+    cancelPendingUpdate();
 }
 
 void VisualDsp::init() {
@@ -401,8 +622,7 @@ void VisualDsp::calcTimeDomain(int numColumns) {
     MeshLibrary::LayerGroup& timeGroup = meshLib->getLayerGroup(LayerGroups::GroupTime);
     auto& morphPanel = getObj(MorphPanel);
 
-    int nextPow2   = preEnvCols.front().size();
-    int memorySize = nextPow2 * (timeGroup.size() + 2);
+    int nextPow2 = preEnvCols.front().size();
 
     float modTime = morphPanel.getValue(Vertex::Time);
     double modPan = morphPanel.getPanSlider()->getValue();
@@ -411,12 +631,8 @@ void VisualDsp::calcTimeDomain(int numColumns) {
     int reductionFactor = getSetting(ReductionFactor);
     int primeDim        = getSetting(CurrentMorphAxis);
 
-    ScopedAlloc<Float32> memory(memorySize);
-
-    Buffer<float> timeBuffer = memory.place(timeGroup.size() * nextPow2);
-    Buffer<float> sumBuffer  = memory.place(nextPow2);
-    Buffer<float> timeRamp 	 = memory.place(nextPow2);
-    timeRamp.ramp();
+    // the cache only reads the column size off this
+    ScopedAlloc<Float32> sumBuffer(nextPow2);
 
     int timeInc	= timeProcessor.isDetailReduced() ? reductionFactor : 1;
 
@@ -437,8 +653,13 @@ void VisualDsp::calcTimeDomain(int numColumns) {
     int numActiveLayers = surface->getNumActiveLayers();
 
     if (numActiveLayers == 0) {
+        timeThread->cancel();
+        timeJob = nullptr;
+
         ScopedLock sl(timeColumnLock);
         preEnvCols.clear();
+        staleTimeColumns.clear();
+        timeColumnCache.invalidate();
         return;
     }
 
@@ -453,7 +674,6 @@ void VisualDsp::calcTimeDomain(int numColumns) {
     context.rasterizer = timeRasterizer;
     context.columns = &preEnvCols;
     context.zoomProgress = zoomProgress;
-    context.layerBuffer = timeBuffer;
     context.sumBuffer = sumBuffer;
     context.numColumns = numColumns;
     context.numActiveLayers = numActiveLayers;
@@ -462,29 +682,232 @@ void VisualDsp::calcTimeDomain(int numColumns) {
     context.panelTime = modTime;
     context.panelPan = (float) modPan;
     context.useScratchTime = stage >= ViewStages::PostEnvelopes;
-    context.resolveScratchTime = [this, &timeGroup](int layerIndex,
-                                                    int sampleIndex,
-                                                    float fallback,
-                                                    float& scratchTime) {
-        return getScratchTimeForLayer(
-                timeGroup.layers[layerIndex].props,
-                sampleIndex,
-                fallback,
-                scratchTime);
+
+    // scratch times resolve here, from the scratch contexts, and the job keeps the results
+    int numSlices = zoomProgress.size();
+    ScopedAlloc<Float32> scratchTimes(jmax(1, timeGroup.size() * numSlices));
+    vector<char> scratchResolved((size_t) (timeGroup.size() * numSlices), 0);
+
+    if (context.useScratchTime && primeDim == Vertex::Time) {
+        for (int layer = 0; layer < timeGroup.size(); ++layer) {
+            for (int i = 0; i < numSlices; ++i) {
+                int index = layer * numSlices + i;
+                scratchResolved[(size_t) index] = getScratchTimeForLayer(
+                        timeGroup.layers[layer].props,
+                        i,
+                        zoomProgress[i],
+                        scratchTimes[index]);
+            }
+        }
+    }
+
+    auto resolverFor = [numSlices](Buffer<float> times, const vector<char>* resolved) {
+        return [numSlices, times, resolved](int layerIndex, int sampleIndex, float fallback, float& scratchTime) {
+            int index = layerIndex * numSlices + sampleIndex;
+            bool isResolved = (*resolved)[(size_t) index] != 0;
+
+            scratchTime = isResolved ? times[index] : fallback;
+            return isResolved;
+        };
     };
 
-    Cycle::Rasterization::TimeColumnRasterizer().render(context);
+    context.resolveScratchTime = resolverFor(scratchTimes, &scratchResolved);
+
+    // a job that was cancelled leaves its columns stale, so the next one picks them up
+    if (! timeColumnCache.findChangedColumns(context, changedTimeColumns)
+            || (int) staleTimeColumns.size() != numColumns) {
+        staleTimeColumns.assign((size_t) numColumns, 1);
+    } else {
+        for (int col : changedTimeColumns) {
+            staleTimeColumns[(size_t) col] = 1;
+        }
+    }
+
+    auto job = std::make_shared<TimeJob>();
+
+    for (int col = 0; col < numColumns; ++col) {
+        if (staleTimeColumns[(size_t) col]) {
+            job->columnsToRender.push_back(col);
+        }
+    }
+
+    if (job->columnsToRender.empty()) {
+        return;
+    }
+
+    meshLib->publishRenderMeshes();
+    job->meshes = meshLib->latestRenderMeshes();
+
+    auto& guideCurves = getObj(GuideCurvePanel);
+    job->guideTables = guideCurves.getAudioTables().latest();
+    job->guideNoise  = guideCurves.getNoiseArray();
+
+    job->columnSize = nextPow2;
+    job->rasterizer.copyBatchStateFrom(*timeRasterizer);
+
+    const auto& groups = job->meshes->groups;
+    bool haveCopies = isPositiveAndBelow((int) LayerGroups::GroupTime, (int) groups.size());
+
+    for (int i = 0; i < (int) layers.size(); ++i) {
+        const auto* copies = haveCopies ? &groups[LayerGroups::GroupTime] : nullptr;
+        Mesh* copy = copies != nullptr && i < (int) copies->size() ? (*copies)[(size_t) i].mesh.get() : nullptr;
+
+        job->layers.push_back({ copy, layers[(size_t) i].active, layers[(size_t) i].pan });
+    }
+
+    job->zoomProgress.resize(numSlices);
+    zoomProgress.copyTo(job->zoomProgress);
+
+    job->scratchTimes.resize(scratchTimes.size());
+    scratchTimes.copyTo(job->scratchTimes);
+    job->scratchResolved = scratchResolved;
+
+    int memorySize = 0;
+    for (int col : job->columnsToRender) {
+        memorySize += preEnvCols[(size_t) col].size();
+    }
+
+    job->columnMemory.resize(memorySize);
+    job->columns.resize((size_t) numColumns);
+
+    for (int col : job->columnsToRender) {
+        const Column& column = preEnvCols[(size_t) col];
+        job->columns[(size_t) col] = Column(job->columnMemory.place(column.size()), column.size(), column.x, column.midiKey);
+    }
+
+    Cycle::Rasterization::TimeColumnRasterizer::Context& jobContext = job->context;
+    jobContext = context;
+    jobContext.layers = &job->layers;
+    jobContext.rasterizer = &job->rasterizer;
+    jobContext.columns = &job->columns;
+    jobContext.zoomProgress = job->zoomProgress;
+    jobContext.sumBuffer = {};
+    jobContext.columnsToRender = &job->columnsToRender;
+    jobContext.resolveScratchTime = resolverFor(job->scratchTimes, &job->scratchResolved);
+
+    timeJob = job;
+    timeJobPass = getObj(Updater).getGraph().getNumPasses();
+    timeThread->submit(std::move(job));
 }
 
-void VisualDsp::calcSpectrogram(int numColumns) {
-    checkFFTColumns(numColumns);
+bool VisualDsp::isCoveredByTimeJob() {
+    // a job started this pass brings the later stages its columns as they land
+    return timeJob != nullptr && timeJobPass == getObj(Updater).getGraph().getNumPasses();
+}
+
+void VisualDsp::handleAsyncUpdate() {
+    if (timeJob == nullptr) {
+        return;
+    }
+
+    // read before the landed columns, so that once it's set they're all there
+    bool finished = timeJob->finished;
+
+    landedTimeColumns.clear();
+
+    {
+        ScopedLock sl(timeJob->landedLock);
+        landedTimeColumns.swap(timeJob->landed);
+    }
+
+    ScopedLock lock(calculationLock);
+
+    if (! landedTimeColumns.empty()) {
+        {
+            ScopedLock sl(timeColumnLock);
+
+            for (int col : landedTimeColumns) {
+                const Column& rendered = timeJob->columns[(size_t) col];
+
+                if (isPositiveAndBelow(col, (int) preEnvCols.size())
+                        && isPositiveAndBelow(col, (int) staleTimeColumns.size())
+                        && preEnvCols[(size_t) col].size() == rendered.size()) {
+                    rendered.copyTo(preEnvCols[(size_t) col]);
+                    staleTimeColumns[(size_t) col] = 0;
+                }
+            }
+        }
+
+        processLandedColumns(landedTimeColumns);
+
+        staleFXColumns.resize(preEnvCols.size(), 0);
+
+        for (int col : landedTimeColumns) {
+            staleFXColumns[(size_t) col] = 1;
+        }
+    }
+
+    // the effects carry state across columns, so they wait for the whole job
+    if (finished) {
+        fxColumns.clear();
+
+        for (int col = 0; col < (int) staleFXColumns.size(); ++col) {
+            if (staleFXColumns[(size_t) col]) {
+                fxColumns.push_back(col);
+            }
+        }
+
+        bool allColumns = fxColumns.size() == preEnvCols.size();
+        processThroughEffects(fxProcessor.getNumColumns(), allColumns ? nullptr : &fxColumns);
 
+        staleFXColumns.clear();
+        timeJob = nullptr;
+    }
+
+    getObj(Waveform3D).bakeTexturesNextRepaint();
+    getObj(Spectrum3D).bakeTexturesNextRepaint();
+    getObj(Waveform3D).repaint();
+    getObj(Spectrum3D).repaint();
+}
+
+void VisualDsp::processLandedColumns(const vector<int>& columns) {
+    const vector<int>* landed = columns.size() == preEnvCols.size() ? nullptr : &columns;
+
+    if (getSetting(ViewStage) >= ViewStages::PostEnvelopes) {
+        processThroughEnvelopes(envProcessor.getNumColumns(), landed);
+    }
+
+    if (! getSetting(DrawWave)) {
+        calcSpectrogram(fftProcessor.getNumColumns(), landed);
+    }
+}
+
+void VisualDsp::mirrorColumns(const vector<Column>& columns, const Buffer<Float32>& array,
+                              ScopedAlloc<Float32>& mirrorArray, vector<Column>& mirror) {
+    mirrorArray.ensureSize(array.size());
+    mirror.resize(columns.size());
+
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const Column& column = columns[i];
+        auto offset = (int) (column.get() - array.get());
+
+        mirror[i] = Column(mirrorArray + offset, column.size(), column.x, column.midiKey);
+    }
+}
+
+void VisualDsp::calcSpectrogram(int numColumns, const vector<int>* columns) {
     static const float invSqrtHalf = 1 / sqrtf(0.5f);
 
     int stage = getSetting(ViewStage);
     int reductionFactor = getSetting(ReductionFactor);
 
     vector<Column>& timeColumns = stage == ViewStages::PreProcessing ? preEnvCols : postEnvCols;
+
+    // the columns left alone keep what the last pass made of them, so the grid has to be the same
+    bool redoSome = columns != nullptr
+                 && (int) preEnvCols.size() == numColumns
+                 && (int) timeColumns.size() == numColumns
+                 && (int) fftPreFXCols.size() == numColumns
+                 && sameColumnSizes(phasePreFXCols, rawPhasePreFXCols);
+
+    if (! redoSome) {
+        columns = nullptr;
+        checkFFTColumns(numColumns);
+        mirrorColumns(phasePreFXCols, phasePreFXArray, rawPhasePreFXArray, rawPhasePreFXCols);
+    }
+
+    vector<int> allColumns;
+    const vector<int>& toRedo = columnsToRedo(columns, numColumns, allColumns);
     auto& morphPanel = getObj(MorphPanel);
 
     logColumnsNaNOnce(stage == ViewStages::PreProcessing
@@ -571,7 +994,12 @@ void VisualDsp::calcSpectrogram(int numColumns) {
     Buffer magBuf(fft.getMagnitudes(), numHarmonics);
     Buffer phaseBuf(fft.getPhases(), numHarmonics);
 
-    for (int colIdx = 0, timeColIdx = 0; colIdx < numColumns; ++colIdx, timeColIdx += timeColInc) {
+    // columns between rasterized ones reuse the layers of the last one rasterized
+    int lastMagCol = -1, lastPhaseCol = -1;
+
+    for (int colIdx : toRedo) {
+        int timeColIdx = jmin(colIdx * timeColInc, numTimeColumns - 1);
+
         if (primeDim == Vertex::Red) {
             int lastNumHarmonics = numHarmonics;
 
@@ -594,10 +1022,6 @@ void VisualDsp::calcSpectrogram(int numColumns) {
             }
         }
 
-        if(timeColIdx >= numTimeColumns) {
-            timeColIdx = numTimeColumns - 1;
-        }
-
         if (doForwardFFT) {
             logColumnNaNOnce("calcSpectrogram before forward timeColumn", timeColumns[timeColIdx], timeColIdx);
             ffts[sizeIndex].forward(timeColumns[timeColIdx]);
@@ -608,7 +1032,10 @@ void VisualDsp::calcSpectrogram(int numColumns) {
         }
 
         if (isFilterEnabled) {
-            int fftIdx = jmin(zoomProgress.size() - 1, colIdx * fftProcInc);
+            int magCol = colIdx - colIdx % colMagRatio;
+            int fftIdx = jmin(zoomProgress.size() - 1, magCol * fftProcInc);
+            bool rasterizeMags = magCol != lastMagCol;
+            lastMagCol = magCol;
 
             spectRasterizer->getMorphPosition()[primeDim] = zoomProgress[fftIdx];
 
@@ -620,10 +1047,10 @@ void VisualDsp::calcSpectrogram(int numColumns) {
                     continue;
                 }
 
-                float scratchTime = primeDim != Vertex::Time ? modTime : zoomProgress[colIdx * fftProcInc];
+                float scratchTime = primeDim != Vertex::Time ? modTime : zoomProgress[magCol * fftProcInc];
 
                 if (primeDim == Vertex::Time && stage >= ViewStages::PostEnvelopes) {
-                    getScratchTimeForLayer(spectLayer.props, fftIdx, zoomProgress[colIdx * fftProcInc], scratchTime);
+                    getScratchTimeForLayer(spectLayer.props, fftIdx, zoomProgress[magCol * fftProcInc], scratchTime);
                 }
 
                 float relativePan = Arithmetic::getRelativePan(spectLayer.props->pan, modPan);
@@ -632,32 +1059,36 @@ void VisualDsp::calcSpectrogram(int numColumns) {
                     continue;
                 }
 
-                if (colIdx % colMagRatio == 0) {
-                    spectRasterizer->setNoiseSeed(colIdx * 1997);
+                if (rasterizeMags) {
+                    spectRasterizer->setNoiseSeed(magCol * 1997);
                     spectRasterizer->setYellow(scratchTime);
                     spectRasterizer->renderWaveformOnly(spectLayer.mesh, 0.f);
 
                     auto sampler = spectRasterizer->sampler();
                     if (!sampler.isSampleable()) {
                         localBuffer.zero();
-                        continue;
-                    }
 
-                    sampler.sampleAtIntervals(fftRamp, localBuffer);
+                        // as in a full pass, where only the rasterized column skips the layer
+                        if (colIdx == magCol) {
+                            continue;
+                        }
+                    } else {
+                        sampler.sampleAtIntervals(fftRamp, localBuffer);
+
+                        float dynamicRange = sqrtf(Spectrum3D::calcDynamicRangeScale(spectLayer.props->range));
+                        float multiplicand = relativePan;
 
-                    float dynamicRange = sqrtf(Spectrum3D::calcDynamicRangeScale(spectLayer.props->range));
-                    float multiplicand = relativePan;
+                        float thresh = powf(1e-19f, 1.f / dynamicRange);
+                        localBuffer.threshLT(thresh).pow(dynamicRange);
 
-                    float thresh = powf(1e-19f, 1.f / dynamicRange);
-                    localBuffer.threshLT(thresh).pow(dynamicRange);
+                        multiplicand *= powf(2.f, dynamicRange);
 
-                    multiplicand *= powf(2.f, dynamicRange);
+                        if(spectLayer.props->mode == Spectrum3D::Additive) {
+                            multiplicand *= additiveScale * volumeEnv[magCol * fftProcInc];
+                        }
 
-                    if(spectLayer.props->mode == Spectrum3D::Additive) {
-                        multiplicand *= additiveScale * volumeEnv[colIdx * fftProcInc];
+                        localBuffer.mul(multiplicand);
                     }
-
-                    localBuffer.mul(multiplicand);
                 }
 
                 // need to specify size because with varying-size columns and
@@ -678,7 +1109,10 @@ void VisualDsp::calcSpectrogram(int numColumns) {
         }
 
         if (isPhaseEnabled) {
-            int fftIdx = jmin(zoomProgress.size() - 1, colIdx * fftProcInc);
+            int phaseCol = colIdx - colIdx % colPhaseRatio;
+            int fftIdx = jmin(zoomProgress.size() - 1, phaseCol * fftProcInc);
+            bool rasterizePhases = phaseCol != lastPhaseCol;
+            lastPhaseCol = phaseCol;
 
             phaseRasterizer->getMorphPosition()[primeDim] = zoomProgress[fftIdx];
             workBuffer.zero();
@@ -692,14 +1126,14 @@ void VisualDsp::calcSpectrogram(int numColumns) {
                     continue;
                 }
 
-                float scratchTime = primeDim != Vertex::Time ? modTime : zoomProgress[colIdx * fftProcInc];
+                float scratchTime = primeDim != Vertex::Time ? modTime : zoomProgress[phaseCol * fftProcInc];
 
                 if (primeDim == Vertex::Time && stage >= ViewStages::PostEnvelopes) {
-                    getScratchTimeForLayer(layer.props, fftIdx, zoomProgress[colIdx * fftProcInc], scratchTime);
+                    getScratchTimeForLayer(layer.props, fftIdx, zoomProgress[phaseCol * fftProcInc], scratchTime);
                 }
 
-                if(colIdx % colPhaseRatio == 0) {
-                    phaseRasterizer->setNoiseSeed(colIdx * 671);
+                if (rasterizePhases) {
+                    phaseRasterizer->setNoiseSeed(phaseCol * 671);
                     phaseRasterizer->setYellow(scratchTime);
                     phaseRasterizer->renderWaveformOnly(layer.mesh, 0.f);
 
@@ -735,7 +1169,7 @@ void VisualDsp::calcSpectrogram(int numColumns) {
 
         fftCol.threshGT(1.f);
 
-        phaseBuf.copyTo(phasePreFXCols[colIdx]);
+        phaseBuf.copyTo(rawPhasePreFXCols[colIdx]);
 
         if (doInverseFFT) {
             logColumnNaNOnce("calcSpectrogram before inverse fftPreFXCol", fftPreFXCols[colIdx], colIdx);
@@ -755,10 +1189,13 @@ void VisualDsp::calcSpectrogram(int numColumns) {
 
     bool processUnison = stage >= ViewStages::PostFX && unison->getOrder(false) > 1;
 
-    processFrequency(timeColumns, processUnison);
+    processFrequency(timeColumns, processUnison, columns);
 
     // end = ippGetCpuClocks();
 
+    // unwrapping runs along the columns, so it starts over from every column's raw phases
+    rawPhasePreFXArray.withSize(phasePreFXArray.size()).copyTo(phasePreFXArray);
+
     if (getSetting(ViewStage) < ViewStages::PostFX) {
         if (primeDim == Vertex::Time)
             unwrapPhaseColumns(phasePreFXCols);
@@ -1188,14 +1625,30 @@ void VisualDsp::unwrapPhaseColumns(vector<Column>& phaseColumns) {
     }
 }
 
-void VisualDsp::processThroughEnvelopes(int numColumns) {
-    checkEnvelopeColumns(numColumns);
+void VisualDsp::processThroughEnvelopes(int numColumns, const vector<int>* columns) {
+    bool redoSome = columns != nullptr
+                 && (int) preEnvCols.size() == numColumns
+                 && sameColumnSizes(preEnvCols, postEnvCols);
+
+    if (redoSome) {
+        ScopedLock sl(envColumnLock);
+
+        for (int colIdx : *columns) {
+            preEnvCols[colIdx].copyTo(postEnvCols[colIdx]);
+        }
+    } else {
+        columns = nullptr;
+        checkEnvelopeColumns(numColumns);
+    }
 
     // do not clear postEnvCols becase it's used as dest time array in
     // spectrogram calculation
     if(preEnvCols.empty() || postEnvCols.empty())
         return;
 
+    vector<int> allColumns;
+    const vector<int>& toRedo = columnsToRedo(columns, numColumns, allColumns);
+
     int stage = getSetting(ViewStage);
     ScopedAlloc<Float32> phaseMoveMem(postEnvCols.front().size());
     Buffer phaseMoveBuffer(phaseMoveMem);
@@ -1240,22 +1693,23 @@ void VisualDsp::processThroughEnvelopes(int numColumns) {
 //		else
         {
             float volumeScale = areBeforeFX ? getObj(OscControlPanel).getVolumeScale() : 1;
-            int start = 0;
 
             auto& volRast = getObj(EnvVolumeRast).get();
 
             auto sampler = volRast.sampler();
-            if (sampler.isSampleable() && getSetting(CurrentMorphAxis) == Vertex::Time) {
-                int size = postEnvCols[0].size();
-                double delta = 1 / (double) volumeEnv.size() / double(size);
-                sampler.sampleWithInterval(phaseMoveBuffer, delta, 0.);
-
-                phaseMoveBuffer.mul(volumeScale);
-                postEnvCols[0].mul(phaseMoveBuffer);
-                start = 1;
-            }
+            bool sampleFirstColumn = sampler.isSampleable() && getSetting(CurrentMorphAxis) == Vertex::Time;
+
+            for (int colIdx : toRedo) {
+                if (colIdx == 0 && sampleFirstColumn) {
+                    int size = postEnvCols[0].size();
+                    double delta = 1 / (double) volumeEnv.size() / double(size);
+                    sampler.sampleWithInterval(phaseMoveBuffer, delta, 0.);
+
+                    phaseMoveBuffer.mul(volumeScale);
+                    postEnvCols[0].mul(phaseMoveBuffer);
+                    continue;
+                }
 
-            for(int colIdx = start; colIdx < numColumns; ++colIdx) {
                 int idx = envInc * colIdx;
                 float envScale = idx >= volumeEnv.size() ? volumeEnv.back() : volumeEnv[idx];
 
@@ -1265,24 +1719,25 @@ void VisualDsp::processThroughEnvelopes(int numColumns) {
     } else {
         float volumeScale = areBeforeFX ? getObj(OscControlPanel).getVolumeScale() : 1;
 
-        for(int colIdx = 0; colIdx < numColumns; ++colIdx) {
+        for (int colIdx : toRedo) {
             postEnvCols[colIdx].mul(volumeScale);
         }
     }
 
     if(stage == ViewStages::PostEnvelopes) {
-        processFrequency(postEnvCols, false);
+        processFrequency(postEnvCols, false, columns);
     }
 
     logColumnsNaNOnce("processThroughEnvelopes output postEnvCols", postEnvCols);
 }
 
-void VisualDsp::processFrequency(vector<Column>& columns, bool processUnison) {
+void VisualDsp::processFrequency(vector<Column>& columns, bool processUnison, const vector<int>* columnsToRender) {
     Cycle::Rasterization::UnisonPhaseColumnRenderer::Context context;
     context.meshLibrary = meshLib;
     context.pitchRasterizer = &getObj(EnvPitchRast).get();
     context.unison = unison;
     context.columns = &columns;
+    context.columnsToRender = columnsToRender;
     context.numFftOrders = numFFTOrders;
     context.currentMorphAxis = getSetting(CurrentMorphAxis);
     context.processUnison = processUnison;
@@ -1372,6 +1827,8 @@ void VisualDsp::trackWavePhaseEnvelope() {
         }
     }
 
+    // the vertices were set after addCube marked the mesh
+    wavePhase->markEdited();
 }
 
 Buffer<float> VisualDsp::getFreqColumn(float position, bool isMags) {
@@ -1446,13 +1903,11 @@ Buffer<Float32> VisualDsp::getFreqArray() {
                : (postFX ? phasePostFXArray : phasePreFXArray);
 }
 
-void VisualDsp::processThroughEffects(int numColumns) {
+void VisualDsp::processThroughEffects(int numColumns, const vector<int>* columns) {
     if (getSetting(ViewStage) < ViewStages::PostFX || getSetting(DrawWave)) {
         return;
     }
 
-    checkEffectsColumns(numColumns);
-
     auto& synth = getObj(SynthAudioSource);
     Waveshaper& waveshaper 	= synth.getWaveshaper();
     IrModeller& tubeModel 	= synth.getIrModeller();
@@ -1462,14 +1917,50 @@ void VisualDsp::processThroughEffects(int numColumns) {
     bool haveIrModeller 	= tubeModel.willBeEnabled();
     bool haveEqualizer		= equalizer.isEnabled();
     bool haveUnison 		= unison->isEnabled() && unison->getOrder(false) > 1;
+    bool haveStatefulFX		= haveWaveshaper || haveIrModeller || haveEqualizer;
     float volumeScale 		= getObj(OscControlPanel).getVolumeScale();
 
-    for (auto & postFXCol : postFXCols) {
-        postFXCol.latency = 0;
+    bool redoSome = columns != nullptr
+                 && ! columns->empty()
+                 && (int) preEnvCols.size() == numColumns
+                 && sameColumnSizes(postEnvCols, postFXCols)
+                 && sameColumnSizes(fftPreFXCols, fftPostFXCols)
+                 && sameColumnSizes(phasePreFXCols, rawPhasePostFXCols)
+                 && sameColumnSizes(phasePostFXCols, rawPhasePostFXCols)
+                 && (int) postFXCols.size() == numColumns;
+
+    vector<int> allColumns, fromFirstChanged;
+
+    if (redoSome && haveStatefulFX) {
+        // the effects carry state from column to column, so every column from the first
+        // changed one on changes too, and those before it replay to rebuild that state
+        int first = *std::min_element(columns->begin(), columns->end());
+
+        fromFirstChanged.resize((size_t) (numColumns - first));
+        std::iota(fromFirstChanged.begin(), fromFirstChanged.end(), first);
+        columns = &fromFirstChanged;
     }
 
+    if (! redoSome) {
+        columns = nullptr;
+        checkEffectsColumns(numColumns);
+        mirrorColumns(phasePostFXCols, phasePostFXArray, rawPhasePostFXArray, rawPhasePostFXCols);
+    }
+
+    // redone columns get new spectra; processed ones also run through the effects
+    const vector<int>& toRedo = columnsToRedo(columns, numColumns, allColumns);
+    const vector<int>& toProcess = haveStatefulFX ? columnsToRedo(nullptr, numColumns, allColumns) : toRedo;
+
     ScopedLock sl(fxColumnLock);
 
+    for (int colIdx : toProcess) {
+        if (redoSome) {
+            postEnvCols[colIdx].copyTo(postFXCols[colIdx]);
+        }
+
+        postFXCols[colIdx].latency = 0;
+    }
+
     if (haveWaveshaper) {
         waveshaper.clearGraphicDelayLine();
 
@@ -1510,18 +2001,29 @@ void VisualDsp::processThroughEffects(int numColumns) {
         }
     }
 
-    postFXArray.mul(volumeScale);
+    for (int colIdx : toProcess) {
+        postFXCols[colIdx].mul(volumeScale);
+    }
 
     if(!haveWaveshaper && !haveIrModeller && !haveUnison && !haveEqualizer) {
         // prefXcols are copied in checkColumns()
 
-        copyArrayOrParts(fftPreFXCols, fftPostFXCols);
-        copyArrayOrParts(phasePreFXCols, phasePostFXCols);
+        if (redoSome) {
+            for (int colIdx : toRedo) {
+                fftPreFXCols[colIdx].copyTo(fftPostFXCols[colIdx]);
+                phasePreFXCols[colIdx].copyTo(rawPhasePostFXCols[colIdx]);
+            }
+        } else {
+            copyArrayOrParts(fftPreFXCols, fftPostFXCols);
+            copyArrayOrParts(phasePreFXCols, rawPhasePostFXCols);
+        }
 
         int tension = getConstant(AmpTensionScale);
 
         // need to first unmap amplitudes to apply volume scaling appropriately
-        for (auto& fftPostFXCol: fftPostFXCols) {
+        for (int colIdx : toRedo) {
+            Column& fftPostFXCol = fftPostFXCols[colIdx];
+
             Arithmetic::applyInvLogMapping(fftPostFXCol, tension);
             fftPostFXCol.mul(volumeScale);
             Arithmetic::applyLogMapping(fftPostFXCol, tension);
@@ -1532,17 +2034,21 @@ void VisualDsp::processThroughEffects(int numColumns) {
         ScopedAlloc<float> mem(postFXCols.front().size());
         Buffer moveBuffer(mem);
 
-        for (int i = 0; i < (int) postFXCols.size(); ++i) {
-            Column& col 	= postFXCols[i];
-            numHarmonics 	= fftPostFXCols[i].size();
-            int sizeIndex 	= sizeToIndex[col.size()];
-            Transform& fft 	= ffts[sizeIndex];
+        for (int i : toProcess) {
+            Column& col = postFXCols[i];
 
             col.latency &= (col.size() - 1);
             if(col.latency > 0) {
                 col.withPhase(col.latency, moveBuffer);
                 col.latency = 0;
             }
+        }
+
+        for (int i : toRedo) {
+            Column& col 	= postFXCols[i];
+            numHarmonics 	= fftPostFXCols[i].size();
+            int sizeIndex 	= sizeToIndex[col.size()];
+            Transform& fft 	= ffts[sizeIndex];
 
             fft.forward(col);
 
@@ -1553,12 +2059,14 @@ void VisualDsp::processThroughEffects(int numColumns) {
             Arithmetic::applyLogMapping(magBuf, getConstant(AmpTensionScale));
 
             magBuf.copyTo(fftPostFXCols[i]);
-            fft.getPhases().copyTo(phasePostFXCols[i]);
+            fft.getPhases().copyTo(rawPhasePostFXCols[i]);
+            rawPhasePostFXCols[i].add((float) M_PI_2);
         }
-
-        phasePostFXArray.add((float) M_PI_2);
     }
 
+    // unwrapping runs along the columns, so it starts over from every column's raw phases
+    rawPhasePostFXArray.withSize(phasePostFXArray.size()).copyTo(phasePostFXArray);
+
     if (getSetting(CurrentMorphAxis) == Vertex::Time) {
         unwrapPhaseColumns(phasePostFXCols);
     } else {
@@ -1586,18 +2094,28 @@ void VisualDsp::destroyArrays() {
     postFXArray		.clear();
     phasePreFXArray	.clear();
     phasePostFXArray.clear();
+    rawPhasePreFXArray.clear();
+    rawPhasePostFXArray.clear();
     preEnvArray		.clear();
     waveTimeArray	.clear();
     waveFFTArray	.clear();
     wavePhaseArray	.clear();
 
+    timeThread->cancel();
+    timeJob = nullptr;
+
     preEnvCols		.clear();
+    timeColumnCache	.invalidate();
+    staleTimeColumns.clear();
+    staleFXColumns	.clear();
     postEnvCols		.clear();
     postFXCols		.clear();
     fftPreFXCols	.clear();
     fftPostFXCols	.clear();
     phasePreFXCols	.clear();
     phasePostFXCols	.clear();
+    rawPhasePreFXCols.clear();
+    rawPhasePostFXCols.clear();
     waveTimeCols	.clear();
     waveFFTCols		.clear();
     wavePhaseCols	.clear();
@@ -1610,13 +2128,21 @@ VisualDsp::GraphicProcessor::GraphicProcessor(VisualDsp* processor, SingletonRep
 {
 }
 
+int VisualDsp::GraphicProcessor::getNumColumns() {
+    int increment = isDetailReduced() ? getSetting(ReductionFactor) : 1;
+
+    return processor->surface->getWindowWidthPixels() / increment;
+}
+
 void VisualDsp::GraphicProcessor::performUpdate(UpdateType update) {
     if (update == Update) {
         ScopedLock lock(processor->calculationLock);
 
-        int reductionFactor = getSetting(ReductionFactor);
-        int increment = isDetailReduced() ? reductionFactor : 1;
-        int numColumns = processor->surface->getWindowWidthPixels() / increment;
+        if (stage != TimeStage && processor->isCoveredByTimeJob()) {
+            return;
+        }
+
+        int numColumns = getNumColumns();
 
         jassert(numColumns > 0);
 
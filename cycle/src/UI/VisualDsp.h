@@ -2,12 +2,14 @@
 
 #include <Algo/FFT.h>
 #include <map>
+#include <memory>
 
 #include <Array/Column.h>
 #include <Array/ScopedAlloc.h>
 #include <App/MeshLibrary.h>
 #include <App/Settings.h>
 #include <App/SingletonAccessor.h>
+#include <Curve/Rasterization/Rasterizer/TimeColumnCache.h>
 #include <Design/Updating/Updateable.h>
 #include <Obj/Ref.h>
 
@@ -18,6 +20,7 @@
 class EnvRasterizer;
 class Spectrum3D;
 class PhaseTrackingTest;
+class RealtimeWorkerPool;
 class Waveform3D;
 class Unison;
 using std::map;
@@ -61,6 +64,7 @@ public:
 
 class VisualDsp :
         public Timer
+    ,	public AsyncUpdater
     ,	public SingletonAccessor {
     friend class PhaseTrackingTest;
 
@@ -78,6 +82,7 @@ public:
 
         GraphicProcessor(VisualDsp* processor, SingletonRepo* repo, StageType stage);
         void performUpdate(UpdateType updateType) override;
+        int getNumColumns();
 
     private:
         StageType stage;
@@ -86,9 +91,11 @@ public:
     /* ----------------------------------------------------------------------------- */
 
     explicit VisualDsp(SingletonRepo* repo);
+    ~VisualDsp() override;
 
     void init() override;
     void reset() override;
+    void handleAsyncUpdate() override;
     void destroyArrays();
     void surfaceResized();
     void calcWaveSpectrogram(int numColumns);
@@ -132,17 +139,24 @@ public:
     const ScratchContext& getScratchContext(int scratchChannel);
 
 private:
+    struct TimeJob;
+    class TimeColumnThread;
+
     GraphicProcessor envProcessor, fftProcessor, fxProcessor, timeProcessor;
 
     void timerCallback() override;
     void calcTimeDomain(int numColumns);
-    void calcSpectrogram(int numColumns);
-    void processThroughEffects(int numColumns);
+    void processLandedColumns(const vector<int>& columns);
+    bool isCoveredByTimeJob();
+    void calcSpectrogram(int numColumns, const vector<int>* columns = nullptr);
+    void processThroughEffects(int numColumns, const vector<int>* columns = nullptr);
     void unwrapPhaseColumns(vector<Column>& phaseColumns);
     void copyArrayOrParts(const vector<Column>& srcColumns, vector<Column>& destColumns);
+    void mirrorColumns(const vector<Column>& columns, const Buffer<Float32>& array,
+                       ScopedAlloc<Float32>& mirrorArray, vector<Column>& mirror);
 
-    void processFrequency(vector<Column>& columns, bool processUnison);
-    void processThroughEnvelopes(int numColumns);
+    void processFrequency(vector<Column>& columns, bool processUnison, const vector<int>* columnsToRender = nullptr);
+    void processThroughEnvelopes(int numColumns, const vector<int>* columns = nullptr);
     void trackWavePhaseEnvelope();
 
     void checkFFTColumns 	 (int numColumns);
@@ -179,6 +193,7 @@ private:
     ScopedAlloc<Float32> fftPreFXArray, fftPostFXArray;			  // fft
     ScopedAlloc<Float32> preEnvArray, postEnvArray, postFXArray;  // time
     ScopedAlloc<Float32> phasePreFXArray, phasePostFXArray;		  // phase
+    ScopedAlloc<Float32> rawPhasePreFXArray, rawPhasePostFXArray;  // phase before unwrapping
     ScopedAlloc<Float32> waveTimeArray, waveFFTArray, wavePhaseArray;
     ScopedAlloc<Float32> volumeEnv, scratchEnv, pitchEnv, scratchEnvPanel;
 
@@ -190,5 +205,20 @@ private:
     vector<Column> preEnvCols, postEnvCols, postFXCols;
     vector<Column> fftPreFXCols, fftPostFXCols;
     vector<Column> phasePreFXCols, phasePostFXCols;
+    vector<Column> rawPhasePreFXCols, rawPhasePostFXCols;
     vector<Column> waveTimeCols, waveFFTCols, wavePhaseCols;
+
+    /*
+     * Time columns render on timeThread, in tiles across this pool, and only where an
+     * edit moved cubes. Tiles land in preEnvCols as they finish and the later stages
+     * redo just those columns; stale columns are the ones no job has delivered yet.
+     */
+    std::unique_ptr<RealtimeWorkerPool> columnPool;
+    std::unique_ptr<TimeColumnThread> timeThread;
+    std::shared_ptr<TimeJob> timeJob;
+    int timeJobPass { -1 };
+
+    Rasterization::TimeColumnCache timeColumnCache;
+    vector<int> changedTimeColumns, landedTimeColumns, fxColumns;
+    vector<char> staleTimeColumns, staleFXColumns;
 };
@@ -22,6 +22,9 @@ namespace Cycle::Rasterization {
             Unison* unison {};
             std::vector<Column>* columns {};
 
+            // only these columns are shifted when set; the voices' phases still advance across the rest
+            const std::vector<int>* columnsToRender {};
+
             int numFftOrders {};
             int currentMorphAxis { Vertex::Time };
 
@@ -82,7 +85,20 @@ namespace Cycle::Rasterization {
             int samplesPerCol = roundToInt(44100.f * timePerColEnv);
             double unitPortionPerSample = timePerColEnv / (float) samplesPerCol;
 
-            for (auto& col : columns) {
+            std::vector<char> selected;
+
+            if (context.columnsToRender != nullptr) {
+                selected.assign(columns.size(), 0);
+
+                for (int colIdx : *context.columnsToRender) {
+                    selected[(size_t) colIdx] = 1;
+                }
+            }
+
+            for (size_t colIdx = 0; colIdx < columns.size(); ++colIdx) {
+                Column& col = columns[colIdx];
+                bool shift = selected.empty() || selected[colIdx] != 0;
+
                 columnSize = col.size();
                 float unitKey = Arithmetic::getUnitValueForGraphicNote(col.midiKey, midiRange);
 
@@ -93,8 +109,10 @@ namespace Cycle::Rasterization {
 
                 jassert(!(columnSize & (columnSize - 1)));
 
-                col.copyTo(columnBuf);
-                col.zero();
+                if (shift) {
+                    col.copyTo(columnBuf);
+                    col.zero();
+                }
 
                 for (int i = 0; i < unisonOrder; ++i) {
                     MeshLibrary::EnvProps* pitchProps =
@@ -136,6 +154,10 @@ namespace Cycle::Rasterization {
 
                     cumePhases[i] += phaseOffset;
 
+                    if (!shift) {
+                        continue;
+                    }
+
                     jassert(remainder >= 0 && remainder <= 1);
 
                     if (context.interpolate) {
@@ -3,6 +3,7 @@
 #include <Audio/Multisample.h>
 #include <Definitions.h>
 #include <Inter/Interactor.h>
+#include <Thread/RealtimeWorkerPool.h>
 
 #include "CycleUpdater.h"
 #include "EnvelopeDelegate.h"
@@ -49,6 +50,9 @@ void CycleUpdater::init() {
     updater->getGraph().setPrintsPath(true);
   #endif
 
+    // the three effect rasterizers are the widest concurrent level
+    updater->setUpdateWorkers(jmin(2, RealtimeWorkerPool::defaultWorkerCount()));
+
     createUpdateGraph();
     graphCreated = true;
 }
@@ -137,6 +141,11 @@ void CycleUpdater::createUpdateGraph() {
     timeUIs         = createNode();
     spectUIs        = createNode();
 
+    // effect rasterizers each own their mesh and output, so they can run side by side
+    guideCurveRast  ->setConcurrent(true);
+    irModelRast     ->setConcurrent(true);
+    wshpRast        ->setConcurrent(true);
+
     univNode->setDebugName("all");
     allButFX->setDebugName("abfx");
     wshpDsp->setDebugName("wdsp");
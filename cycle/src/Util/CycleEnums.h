@@ -91,7 +91,8 @@ namespace AppSettings {
         UseYellowDepth,
         UseRedDepth,
         UseBlueDepth,
-        UseLargerPoints
+        UseLargerPoints,
+        ParallelVoiceRendering
     };
 }
 
@@ -107,7 +108,8 @@ namespace DocSettings {
         ResamplingAlgoRltm,
         ResamplingAlgoRend,
         OversampleFactorRltm,
-        OversampleFactorRend
+        OversampleFactorRend,
+        NativeRateRendering
     };
 }
 
@@ -0,0 +1,77 @@
+#include <algorithm>
+
+#include <Array/SimdKernels.h>
+
+#include "BiquadLanes.h"
+
+BiquadLanes::BiquadLanes(int numStages) :
+        frames((size_t) (blockSize * numLanes))
+    ,   silence((size_t) blockSize)
+    ,   discarded((size_t) blockSize) {
+    setNumStages(numStages);
+}
+
+void BiquadLanes::setNumStages(int stages) {
+    numStages = jmax(0, stages);
+
+    coefficients.assign((size_t) (numStages * coefficientsPerStage * numLanes), 0.0);
+    state.assign((size_t) (numStages * statesPerStage * numLanes), 0.0);
+
+    // b0 of 1 and nothing else passes the input through
+    for (int stage = 0; stage < numStages; ++stage) {
+        std::fill_n(coefficients.begin() + stage * coefficientsPerStage * numLanes, numLanes, 1.0);
+    }
+}
+
+void BiquadLanes::setStage(int lane, int stage, const Dsp::BiquadBase& biquad) {
+    jassert(lane >= 0 && lane < numLanes);
+    jassert(stage >= 0 && stage < numStages);
+
+    // the biquad keeps these already divided by a0
+    const double values[] = { biquad.m_b0, biquad.m_b1, biquad.m_b2, biquad.m_a1, biquad.m_a2 };
+    double* stageCoefficients = coefficients.data() + stage * coefficientsPerStage * numLanes;
+
+    for (int i = 0; i < coefficientsPerStage; ++i) {
+        stageCoefficients[i * numLanes + lane] = values[i];
+    }
+}
+
+int BiquadLanes::setCascade(int lane, int firstStage, Dsp::Cascade& cascade) {
+    for (int i = 0; i < cascade.getNumStages(); ++i) {
+        setStage(lane, firstStage + i, cascade[i]);
+    }
+
+    return firstStage + cascade.getNumStages();
+}
+
+void BiquadLanes::process(int firstLane, const Buffer<float>* channels, int numChannels) {
+    jassert(firstLane >= 0 && firstLane + numChannels <= numLanes);
+
+    if (numStages == 0 || numChannels <= 0 || channels[0].empty()) {
+        return;
+    }
+
+    const int numSamples = channels[0].size();
+    const int lastLane = firstLane + numChannels;
+    const int activeLanes = ((1 << numChannels) - 1) << firstLane;
+
+    for (int offset = 0; offset < numSamples; offset += blockSize) {
+        const int size = jmin(blockSize, numSamples - offset);
+        const float* in[numLanes];
+        float* out[numLanes];
+
+        for (int lane = 0; lane < numLanes; ++lane) {
+            const bool active = lane >= firstLane && lane < lastLane;
+
+            out[lane] = active ? channels[lane - firstLane].get() + offset : discarded.data();
+            in[lane] = active ? out[lane] : silence.data();
+        }
+
+        SimdKernels::get().biquadLanes(
+                in, out, activeLanes, coefficients.data(), numStages, state.data(), frames.data(), size);
+    }
+}
+
+void BiquadLanes::clear() {
+    std::fill(state.begin(), state.end(), 0.0);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+
+#include <Array/Buffer.h>
+#include <Audio/Filters/Cascade.h>
+
+/*
+ * Runs up to four channels through their own biquad cascades at once, each
+ * channel a lane of one vector, with the sections in transposed direct form II
+ * and double precision.
+ *
+ * Every lane has the same number of sections; a section a lane doesn't set
+ * passes its input through. Several cascades can be chained on a lane by
+ * setting them at consecutive first stages, like an equalizer's bands.
+ */
+class BiquadLanes {
+public:
+    static constexpr int numLanes = 4;
+    static constexpr int blockSize = 256;
+
+    explicit BiquadLanes(int numStages = 0);
+
+    // resets every section to pass through and clears the state; allocates
+    void setNumStages(int numStages);
+    int getNumStages() const { return numStages; }
+
+    void setStage(int lane, int stage, const Dsp::BiquadBase& biquad);
+
+    // the cascade's sections from firstStage on; returns the stage after its last
+    int setCascade(int lane, int firstStage, Dsp::Cascade& cascade);
+
+    /*
+     * Filters channels in place as lanes firstLane onwards. Every channel must be
+     * as long as the first, and lanes outside the range keep their state.
+     */
+    void process(int firstLane, const Buffer<float>* channels, int numChannels);
+    void process(int lane, Buffer<float> samples) { process(lane, &samples, 1); }
+
+    void clear();
+
+private:
+    static constexpr int coefficientsPerStage = 5;
+    static constexpr int statesPerStage = 2;
+
+    int numStages {};
+
+    std::vector<double> coefficients;
+    std::vector<double> state;
+    std::vector<double> frames;
+
+    // what lanes without a channel read and write
+    std::vector<float> silence;
+    std::vector<float> discarded;
+};
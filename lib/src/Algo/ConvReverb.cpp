@@ -1,13 +1,61 @@
+#include <algorithm>
+#include <thread>
+
 #include "ConvReverb.h"
 #include "FFT.h"
 #include "../Array/VecOps.h"
 #include "../Util/Arithmetic.h"
 #include "../Definitions.h"
 
+class ConvReverb::TailWorker : public Thread {
+public:
+    explicit TailWorker(ConvReverb& reverb) :
+            Thread("ConvReverbTail")
+        ,   reverb(reverb) {
+    }
+
+    void run() override {
+        while (! threadShouldExit()) {
+            wake.wait(-1);
+
+            while (! threadShouldExit() && reverb.runNextBackgroundJob()) {
+            }
+        }
+    }
+
+    void stop() {
+        signalThreadShouldExit();
+        wake.signal();
+        stopThread(1000);
+    }
+
+    WaitableEvent wake;
+
+private:
+    ConvReverb& reverb;
+};
+
+/* ----------------------------------------------------------------------------- */
+
 ConvReverb::ConvReverb() :
-        outBuffer(2)
+        tailInputPos(0)
+    ,   precalcPos(0)
+    ,   headBlockSize(0)
+    ,   tailBlockSize(0)
+    ,   useWorker(true)
+    ,   waitsForLateJobs(false)
     ,   wetLevel(0.5f)
-    ,   dryLevel(1.f) {
+    ,   dryLevel(1.f)
+    ,   outBuffer(2) {
+}
+
+ConvReverb::~ConvReverb() {
+    if (worker != nullptr) {
+        worker->stop();
+    }
+
+    delete pending.exchange(nullptr);
+    freeRetired();
 }
 
 void ConvReverb::reset() {
@@ -16,17 +64,21 @@ void ConvReverb::reset() {
     precalcPos      = 0;
     tailInputPos    = 0;
 
-    headConvolver.reset();
-    tailConvolver.reset();
-    neckConvolver.reset();
+    deadlineMisses.store(0, std::memory_order_relaxed);
 
-    memory.clear();
+    freeRetired();
+    publish(std::make_unique<Generation>());
 }
 
 void ConvReverb::init(int headSize, int tailSize, const Buffer<float>& kernel) {
-    reset();
+    freeRetired();
+
+    auto generation = std::make_unique<Generation>();
 
     if(headSize == 0 || tailSize == 0) {
+        headBlockSize = 0;
+        tailBlockSize = 0;
+        publish(std::move(generation));
         return;
     }
 
@@ -41,6 +93,7 @@ void ConvReverb::init(int headSize, int tailSize, const Buffer<float>& kernel) {
 
     // test after setting vars
     if(kernel.empty()) {
+        publish(std::move(generation));
         return;
     }
 
@@ -48,126 +101,268 @@ void ConvReverb::init(int headSize, int tailSize, const Buffer<float>& kernel) {
         tailBlockSize /= 2;
     }
 
-    memory.ensureSize(6 * tailBlockSize);
+    tailBlockSize = jmax(tailBlockSize, headBlockSize);
+    generation->tailBlockSize = tailBlockSize;
 
-    ///
-    int headLenIR = jmin(kernel.size(), tailBlockSize);
-    headConvolver.init(headBlockSize, kernel.withSize(headLenIR));
+    int offset = jmin(kernel.size(), 2 * headBlockSize);
+    generation->head.init(headBlockSize, kernel.withSize(offset));
 
-    if(kernel.size() > tailBlockSize) {
-        int neckIrSize = jmin(kernel.size() - tailBlockSize, tailBlockSize);
-        neckConvolver.init(tailBlockSize / 2, kernel.section(tailBlockSize, neckIrSize));
+    auto& stages = generation->stages;
+    int totalBlockSamples = 0;
 
-        neckOutput  = memory.place(tailBlockSize);
-        neckPrecalc = memory.place(tailBlockSize);
-    } else {
-        neckConvolver.active = false;
-        neckOutput.nullify();
-        neckPrecalc.nullify();
+    for (int blockSize = headBlockSize; offset < kernel.size(); blockSize = jmin(2 * blockSize, tailBlockSize)) {
+        int remaining = kernel.size() - offset;
+        int length = blockSize == tailBlockSize ? remaining : jmin(remaining, 2 * blockSize);
+
+        auto stage = std::make_unique<TailStage>();
+        stage->blockSize  = blockSize;
+        stage->background = useWorker && blockSize > 2 * headBlockSize;
+        stage->convolver.init(blockSize, kernel.section(offset, length));
+
+        stages.push_back(std::move(stage));
+        totalBlockSamples += blockSize;
+        offset += length;
     }
 
-    if (kernel.size() > 2 * tailBlockSize) {
-        int tailIrSize = kernel.size() - 2 * tailBlockSize;
-        tailConvolver.init(tailBlockSize, kernel.section(2 * tailBlockSize, tailIrSize));
+    generation->memory.resize(4 * totalBlockSamples);
+    generation->memory.zero();
 
-        tailOutput  = memory.place(tailBlockSize);
-        tailPrecalc = memory.place(tailBlockSize);
-        tailInput   = memory.place(tailBlockSize);
-    } else {
-        tailConvolver.active = false;
-        tailOutput  .nullify();
-        tailPrecalc .nullify();
-        tailInput   .nullify();
+    for (auto& stage : stages) {
+        stage->collected = generation->memory.place(stage->blockSize);
+        stage->jobInput  = generation->memory.place(stage->blockSize);
+        stage->jobOutput = generation->memory.place(stage->blockSize);
+        stage->playing   = generation->memory.place(stage->blockSize);
     }
 
-    if(!neckPrecalc.empty() || !tailPrecalc.empty())
-        neckInput = memory.place(tailBlockSize);
+    bool anyBackground = std::any_of(stages.begin(), stages.end(), [](const auto& stage) {
+        return stage->background;
+    });
 
-    tailOutput  .zero();
-    tailPrecalc .zero();
-    tailInput   .zero();
-    neckOutput  .zero();
-    neckInput   .zero();
-    neckPrecalc .zero();
+    // started before the stages are published, so process() never sees a background stage without it
+    if (worker == nullptr && anyBackground) {
+        worker = std::make_unique<TailWorker>(*this);
+        worker->startThread(Thread::Priority::low);
+    }
 
-    tailInputPos    = 0;
-    precalcPos      = 0;
+    publish(std::move(generation));
+}
+
+void ConvReverb::publish(std::unique_ptr<Generation> generation) {
+    // a generation process() never picked up was never visible to the worker either
+    delete pending.exchange(generation.release(), std::memory_order_acq_rel);
+}
+
+void ConvReverb::adopt(Generation* generation) {
+    claimable.store(generation, std::memory_order_seq_cst);
+
+    if (live != nullptr) {
+        for (auto& stage : live->stages) {
+            int expected = jobPending;
+            stage->job.compare_exchange_strong(expected, jobIdle, std::memory_order_acq_rel);
+        }
+
+        // freed by the next init(), off this thread
+        Generation* old = live.release();
+        old->nextRetired = retired.load(std::memory_order_relaxed);
+
+        while (! retired.compare_exchange_weak(old->nextRetired, old,
+                std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    live.reset(generation);
+
+    tailInputPos = 0;
+    precalcPos   = 0;
+}
+
+void ConvReverb::freeRetired() {
+    Generation* generation = retired.exchange(nullptr, std::memory_order_acquire);
+
+    while (generation != nullptr) {
+        // the worker can only be inside a retired generation for the rest of one job
+        while (workerGeneration.load(std::memory_order_seq_cst) == generation) {
+            std::this_thread::yield();
+        }
+
+        Generation* next = generation->nextRetired;
+        delete generation;
+        generation = next;
+    }
+}
+
+const ConvReverb::Generation* ConvReverb::newest() const {
+    const Generation* generation = pending.load(std::memory_order_acquire);
+    return generation != nullptr ? generation : live.get();
+}
+
+int ConvReverb::getNumStages() const {
+    const Generation* generation = newest();
+    return generation != nullptr ? (int) generation->stages.size() : 0;
+}
+
+int ConvReverb::getNumBackgroundStages() const {
+    const Generation* generation = newest();
+
+    if (generation == nullptr) {
+        return 0;
+    }
+
+    return (int) std::count_if(generation->stages.begin(), generation->stages.end(), [](const auto& stage) {
+        return stage->background;
+    });
 }
 
 void ConvReverb::process(
         const Buffer<float>& input,
         Buffer<float> output) {
 
+    if (Generation* next = pending.exchange(nullptr, std::memory_order_acq_rel)) {
+        adopt(next);
+    }
+
     output.zero();
 
-    headConvolver.process(input, output);
+    if (live == nullptr) {
+        return;
+    }
 
-    if(neckInput.empty()) {
+    live->head.process(input, output);
+
+    if(live->stages.empty()) {
         return;
     }
+
+    for (auto& stage : live->stages) {
+        processStage(*stage, input, output);
+    }
+
+    // every stage block divides the tail block, so one position serves them all
+    tailInputPos = (tailInputPos + input.size()) % live->tailBlockSize;
+    precalcPos   = tailInputPos;
+}
+
+void ConvReverb::processStage(
+        TailStage& stage,
+        const Buffer<float>& input,
+        Buffer<float> output) {
+    int position = tailInputPos;
     int samplesDone = 0;
 
     while (samplesDone < input.size()) {
-        int remaining = input.size() - samplesDone;
-        int samplesToDo = jmin(remaining, headBlockSize - (tailInputPos % headBlockSize));
+        int blockPos    = position % stage.blockSize;
+        int samplesToDo = jmin(input.size() - samplesDone, stage.blockSize - blockPos);
 
-        jassert(tailInputPos + samplesToDo <= tailBlockSize);
+        input.section(samplesDone, samplesToDo).copyTo(stage.collected + blockPos);
 
-        {
-            // sum first tail block
-            if(neckConvolver.active) {
-                Buffer<float> neck = neckPrecalc.section(precalcPos, samplesToDo);
+        Buffer<float> tail = stage.playing.section(blockPos, samplesToDo);
 
-                if(! neck.isProbablyEmpty())
-                    output.section(samplesDone, samplesToDo).add(neck);
-            }
+        if (! tail.isProbablyEmpty()) {
+            output.section(samplesDone, samplesToDo).add(tail);
+        }
 
-            // sum 2nd - nth tail block
-            if (tailConvolver.active) {
-                Buffer<float> tail = tailPrecalc.section(precalcPos, samplesToDo);
+        samplesDone += samplesToDo;
+        position    += samplesToDo;
 
-                if (!tail.isProbablyEmpty()) {
-                    output.section(samplesDone, samplesToDo).add(tail);
-                }
-            }
+        if (blockPos + samplesToDo < stage.blockSize) {
+            continue;
+        }
 
-            precalcPos += samplesToDo;
+        if (! finishJob(stage)) {
+            // the job is late, whether the worker is still running it or never
+            // started it, so this stage goes quiet for a block and drops its output
+            stage.playing.zero();
+            stage.dropOutput = true;
+            continue;
         }
 
-        // fill input buffer for tail convolution
-        input.section(samplesDone, samplesToDo).copyTo(neckInput + tailInputPos);
-        tailInputPos += samplesToDo;
+        if (stage.dropOutput) {
+            stage.jobOutput.zero();
+            stage.dropOutput = false;
+        }
 
-        jassert(tailInputPos <= tailBlockSize);
+        // the previous block's output is due from here on; the block just
+        // collected is not needed until one block from now
+        std::swap(stage.playing, stage.jobOutput);
+        std::swap(stage.collected, stage.jobInput);
 
-        // convolution: first tail block
-        if (neckConvolver.active && tailInputPos % neckConvolver.getBlockSize() == 0) {
-            jassert(tailInputPos >= headBlockSize);
+        if (stage.background && worker != nullptr) {
+            stage.job.store(jobPending, std::memory_order_release);
+            worker->wake.signal();
+        } else {
+            stage.convolver.process(stage.jobInput, stage.jobOutput);
+        }
+    }
+}
 
-            int blockOffset = tailInputPos - neckConvolver.getBlockSize();
-            neckConvolver.process(neckInput .section(blockOffset, neckConvolver.getBlockSize()),
-                                  neckOutput.section(blockOffset, neckConvolver.getBlockSize()));
+bool ConvReverb::finishJob(TailStage& stage) {
+    int state = stage.job.load(std::memory_order_acquire);
 
-            if (tailInputPos == tailBlockSize) {
-                std::swap(neckPrecalc, neckOutput);
-            }
-        }
+    if (state == jobIdle || state == jobDone) {
+        return true;
+    }
 
-        // convolution: 2nd - nth tail block
-        if (tailConvolver.active && tailInputPos == tailBlockSize) {
-            std::swap(tailPrecalc, tailOutput);
+    deadlineMisses.fetch_add(1, std::memory_order_relaxed);
 
-            neckInput.copyTo(tailInput);
-            tailConvolver.process(tailInput, tailOutput);
-        }
+    if (! waitsForLateJobs) {
+        // a tail block can cost 16 head blocks, too much to run here when the worker
+        // is already behind, so one it hasn't started is dropped like a running one
+        int expected = jobPending;
+        stage.job.compare_exchange_strong(expected, jobIdle, std::memory_order_acq_rel);
 
-        if(tailInputPos == tailBlockSize) {
-            tailInputPos = 0;
-            precalcPos = 0;
-        }
+        return false;
+    }
 
-        samplesDone += samplesToDo;
+    claimAndRun(stage);
+
+    while (stage.job.load(std::memory_order_acquire) == jobRunning) {
+        std::this_thread::yield();
     }
+
+    return true;
+}
+
+bool ConvReverb::claimAndRun(TailStage& stage) {
+    int expected = jobPending;
+
+    if (! stage.job.compare_exchange_strong(expected, jobRunning, std::memory_order_acq_rel)) {
+        return false;
+    }
+
+    stage.convolver.process(stage.jobInput, stage.jobOutput);
+    stage.job.store(jobDone, std::memory_order_release);
+
+    return true;
+}
+
+bool ConvReverb::runNextBackgroundJob() {
+    Generation* generation = claimable.load(std::memory_order_seq_cst);
+
+    if (generation == nullptr) {
+        return false;
+    }
+
+    // announce the generation, then check it was not retired in the meantime;
+    // freeRetired() does not delete a generation while it is announced here
+    workerGeneration.store(generation, std::memory_order_seq_cst);
+
+    if (claimable.load(std::memory_order_seq_cst) != generation) {
+        workerGeneration.store(nullptr, std::memory_order_release);
+        return true;
+    }
+
+    bool ranJob = false;
+
+    // stages are ordered by block size, so the nearest deadline is claimed first
+    for (auto& stage : generation->stages) {
+        if (stage->background && claimAndRun(*stage)) {
+            ranJob = true;
+            break;
+        }
+    }
+
+    workerGeneration.store(nullptr, std::memory_order_release);
+    return ranJob;
 }
 
 void BlockConvolver::reset() {
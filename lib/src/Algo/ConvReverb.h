@@ -3,6 +3,8 @@
 #include "../Array/StereoBuffer.h"
 #include "../Util/MicroTimer.h"
 
+#include <atomic>
+#include <memory>
 #include <vector>
 
 using std::vector;
@@ -41,12 +43,35 @@ private:
     friend class ConvReverb;
 };
 
+/*
+ * Non-uniformly partitioned convolution. The head convolver covers the first
+ * two head blocks of the kernel with zero latency; the rest is split into
+ * stages whose block size doubles up to the tail block size, each starting at
+ * twice its block size into the kernel. A stage's block is therefore complete
+ * one whole block before its output is needed, and that block is the stage's
+ * deadline.
+ *
+ * Stages up to twice the head block are convolved on the calling thread at
+ * their block boundary; larger stages are handed to a low-priority worker, so
+ * the cost of a callback no longer grows with the kernel length. A stage the
+ * worker has not started by its deadline is run by the caller; one it is still
+ * running plays silence for a block rather than make the caller wait on it,
+ * unless setWaitsForLateJobs() says the caller is not realtime. Both count in
+ * getDeadlineMisses().
+ *
+ * init() builds a whole new set of stages with its own storage and hands it
+ * over; process() picks it up at the start of its next call, so init() can run
+ * on another thread than process(), but should not itself be called from the
+ * audio thread. Stages given up are freed by the next init(), once the worker
+ * has left them.
+ */
 class ConvReverb {
 public:
     int tailInputPos, precalcPos;
     int headBlockSize, tailBlockSize;
 
     ConvReverb();
+    ~ConvReverb();
 
     void init(int headSize, int tailSize, const Buffer<float>& kernel);
     void process(const Buffer<float>& input, Buffer<float> output);
@@ -54,19 +79,71 @@ public:
     void reset();
     void test();
     void test(int inputSize, int irSize, int headSize, int tailSize, int bufferSize, bool refCheck, bool useTwoStage);
-private:
-    int headClocks, tailClocksA, tailClocks;
 
+    // takes effect on the next init(); without it every stage runs on the calling thread
+    void setBackgroundProcessing(bool shouldUseWorker) { useWorker = shouldUseWorker; }
+
+    // for offline rendering, where a late tail block is worth waiting for
+    void setWaitsForLateJobs(bool shouldWait) { waitsForLateJobs = shouldWait; }
+
+    // these describe the newest stages, whether or not process() has picked them up yet
+    int getNumStages() const;
+    int getNumBackgroundStages() const;
+    int getDeadlineMisses() const { return deadlineMisses.load(std::memory_order_relaxed); }
+
+private:
+    enum JobState { jobIdle, jobPending, jobRunning, jobDone };
+
+    struct TailStage {
+        BlockConvolver convolver;
+        int blockSize {};
+        bool background {};
+
+        // set when a job missed its deadline, so the block it finishes is dropped
+        bool dropOutput {};
+
+        // collected is filled by the caller, jobInput/jobOutput belong to the
+        // job in flight and playing holds the previous job's output
+        Buffer<float> collected, jobInput, jobOutput, playing;
+        std::atomic<int> job { jobIdle };
+    };
+
+    // one init()'s head, stages and the memory their blocks live in
+    struct Generation {
+        BlockConvolver head;
+        int tailBlockSize {};
+        vector<std::unique_ptr<TailStage>> stages;
+        ScopedAlloc<float> memory;
+        Generation* nextRetired {};
+    };
+
+    class TailWorker;
+
+    void publish(std::unique_ptr<Generation> generation);
+    void adopt(Generation* generation);
+    void freeRetired();
+    const Generation* newest() const;
+
+    void processStage(TailStage& stage, const Buffer<float>& input, Buffer<float> output);
+    bool finishJob(TailStage& stage);
+    bool claimAndRun(TailStage& stage);
+    bool runNextBackgroundJob();
+
+    bool useWorker, waitsForLateJobs;
     float wetLevel, dryLevel;
 
-    BlockConvolver  headConvolver, neckConvolver, tailConvolver;
     StereoBuffer    outBuffer;
     MicroTimer      timer;
 
-    Buffer<float>   kernel;
-    Buffer<float>   tailOutput, tailPrecalc;
-    Buffer<float>   neckOutput, neckPrecalc;
-    Buffer<float>   neckInput,  tailInput;
+    // live belongs to process(); the others hand generations between threads
+    std::unique_ptr<Generation> live;
+    std::atomic<Generation*> pending { nullptr };
+    std::atomic<Generation*> retired { nullptr };
+    std::atomic<Generation*> claimable { nullptr };
+    std::atomic<Generation*> workerGeneration { nullptr };
 
-    ScopedAlloc<float> memory;
+    std::unique_ptr<TailWorker> worker;
+    std::atomic<int> deadlineMisses { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(ConvReverb)
 };
@@ -8,7 +8,7 @@ Transform::Transform() :
     order(0),
   #ifdef USE_ACCELERATE
     fftSetup(nullptr),
-  #else
+  #elif defined(USE_IPP)
     spec(nullptr),
   #endif
     convertToCart(false),
@@ -26,7 +26,7 @@ void Transform::clear() {
         vDSP_destroy_fftsetup(fftSetup);
         fftSetup = nullptr;
     }
-  #else
+  #elif defined(USE_IPP)
     if (spec != nullptr) {
         spec = nullptr;
     }
@@ -61,6 +61,26 @@ void Transform::allocate(int bufferSize, ScaleType scaleType, bool convertsToCar
 
     splitComplex.realp = fftBuffer.get();
     splitComplex.imagp = fftBuffer.get() + bufferSize / 2;
+  #elif defined(USE_PORTABLE_SIMD)
+    const int halfSize = bufferSize / 2;
+    twiddles.resize(halfSize);
+    bitReversal.resize(halfSize);
+
+    for (int k = 0; k < halfSize; ++k) {
+        const double angle = -2.0 * MathConstants<double>::pi * k / bufferSize;
+        twiddles[k] = Complex32((float) std::cos(angle), (float) std::sin(angle));
+
+        int reversed = 0;
+        for (int bit = 1, rbit = halfSize >> 1; bit < halfSize; bit <<= 1, rbit >>= 1) {
+            if (k & bit) {
+                reversed |= rbit;
+            }
+        }
+        bitReversal[k] = reversed;
+    }
+
+    memory.ensureSize(bufferSize + 2 + (convertToCart ? bufferSize : 0));
+    fftBuffer = memory.place(bufferSize + 2);
   #else
     int specSize, specBuffSize, buffSize;
     int ippScaleType = -1;
@@ -138,8 +158,12 @@ void Transform::forwardInternal(Buffer<float> src) {
         magnitudes[hsize - 1] = nyquist < 0.f ? -nyquist : nyquist;
         phases[hsize - 1] = nyquist < 0.f ? MathConstants<float>::pi : 0.f;
     }
+  #else
+  #if defined(USE_PORTABLE_SIMD)
+    realForward(src);
   #else
     ippsFFTFwd_RToCCS_32f(src, fftBuffer, spec, workBuff);
+  #endif
 
     if(removeOffset) {
         fftBuffer[0] = 0;
@@ -147,7 +171,15 @@ void Transform::forwardInternal(Buffer<float> src) {
     if (convertToCart) {
         int hsize = size / 2;
         int complexBins = hsize - 1;
+      #if defined(USE_PORTABLE_SIMD)
+        const auto* bins = reinterpret_cast<const Complex32*>(fftBuffer.get() + 2);
+        for (int i = 0; i < complexBins; ++i) {
+            magnitudes[i] = std::abs(bins[i]);
+            phases[i] = std::arg(bins[i]);
+        }
+      #else
         ippsCartToPolar_32fc(reinterpret_cast<Complex32*>(fftBuffer.get()+2), magnitudes, phases, complexBins);
+      #endif
 
         float nyquist = fftBuffer[1];
         magnitudes[hsize - 1] = nyquist < 0.f ? -nyquist : nyquist;
@@ -173,9 +205,9 @@ void Transform::inverse(const Buffer<Complex32>& fftInput, const Buffer<float>&
 
     // this mutates the fftBuffer, referenced by the splitComplex real/imag pointers
     vDSP_ctoz(reinterpret_cast<DSPComplex *>(fftInput.get()), 2, &splitComplex, 1, packedComplexSize);
-  #elif defined(USE_IPP)
+  #else
     Buffer<float> oldBuffer = fftBuffer;
-    fftBuffer = fftInput.toType<Ipp32f>();
+    fftBuffer = fftInput.toType<Float32>();
   #endif
     inverse(dest);
   #ifdef USE_ACCELERATE
@@ -233,7 +265,14 @@ void Transform::inverseInternal(Buffer<float> dest) {
     if (convertToCart) {
         int hsize = size / 2;
         int complexBins = hsize - 1;
+      #if defined(USE_PORTABLE_SIMD)
+        auto* bins = reinterpret_cast<Complex32*>(fftBuffer.get()) + 1;
+        for (int i = 0; i < complexBins; ++i) {
+            bins[i] = std::polar(magnitudes[i], phases[i]);
+        }
+      #else
         ippsPolarToCart_32fc(magnitudes, phases, (Complex32*)fftBuffer.get() + 1, complexBins);
+      #endif
 
         float nyquistPhase = phases[hsize - 1];
         float nyquistSign = (nyquistPhase < -MathConstants<float>::halfPi || nyquistPhase > MathConstants<float>::halfPi) ? -1.f : 1.f;
@@ -242,8 +281,12 @@ void Transform::inverseInternal(Buffer<float> dest) {
     if (removeOffset) {
         fftBuffer[0] = 0;
     }
+  #if defined(USE_PORTABLE_SIMD)
+    realInverse(dest);
+  #else
     ippsFFTInv_CCSToR_32f(fftBuffer, dest, spec, workBuff);
   #endif
+  #endif
 }
 
 int Transform::getFullRealBinCount() const {
@@ -295,6 +338,101 @@ void Transform::setPackedEndpoints(float dc, float nyquist) {
   #endif
 }
 
+#ifdef USE_PORTABLE_SIMD
+
+// iterative radix-2, in place; the size / 2 point twiddles are every other entry of the N point table
+void Transform::complexForward(Complex32* data, int size) const {
+    for (int i = 0; i < size; ++i) {
+        const int j = bitReversal[i];
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+
+    for (int length = 2; length <= size; length <<= 1) {
+        const int half = length / 2;
+        const int stride = 2 * (size / length);
+
+        for (int start = 0; start < size; start += length) {
+            for (int k = 0; k < half; ++k) {
+                const Complex32 odd = data[start + k + half] * twiddles[k * stride];
+                data[start + k + half] = data[start + k] - odd;
+                data[start + k] += odd;
+            }
+        }
+    }
+}
+
+/*
+ * Transforms the N real samples as N / 2 complex ones, then untangles the even
+ * and odd halves: X[k] = E[k] + w^k O[k], with E and O recovered from Z[k] and
+ * conj(Z[N/2 - k]). Bins k and N/2 - k are done together so this works in place.
+ */
+void Transform::realForward(Buffer<float> src) {
+    const int size = 1 << order;
+    const int half = size / 2;
+
+    src.withSize(size).copyTo(fftBuffer);
+    auto* z = reinterpret_cast<Complex32*>(fftBuffer.get());
+
+    complexForward(z, half);
+
+    const float scale = scaleType == DivFwdByN ? 1.f / float(size) : 1.f;
+    const float dc = (z[0].real() + z[0].imag()) * scale;
+    const float nyquist = (z[0].real() - z[0].imag()) * scale;
+
+    for (int k = 1; k <= half / 2; ++k) {
+        const Complex32 a = z[k];
+        const Complex32 b = std::conj(z[half - k]);
+        const Complex32 even = 0.5f * (a + b);
+        const Complex32 odd = Complex32(0, -0.5f) * (a - b);
+
+        z[k] = (even + twiddles[k] * odd) * scale;
+        z[half - k] = std::conj(even - twiddles[k] * odd) * scale;
+    }
+
+    fftBuffer[0] = dc;
+    fftBuffer[1] = nyquist;
+}
+
+void Transform::realInverse(Buffer<float> dest) {
+    const int size = 1 << order;
+    const int half = size / 2;
+
+    // the caller's spectrum is left untouched, as with ippsFFTInv
+    fftBuffer.withSize(size).copyTo(dest);
+    auto* z = reinterpret_cast<Complex32*>(dest.get());
+
+    const float dc = z[0].real();
+    const float nyquist = z[0].imag();
+    z[0] = Complex32(0.5f * (dc + nyquist), 0.5f * (dc - nyquist));
+
+    for (int k = 1; k <= half / 2; ++k) {
+        const Complex32 a = z[k];
+        const Complex32 b = std::conj(z[half - k]);
+        const Complex32 even = 0.5f * (a + b);
+        const Complex32 odd = 0.5f * (a - b) * std::conj(twiddles[k]);
+
+        z[k] = even + Complex32(0, 1) * odd;
+        z[half - k] = std::conj(even - Complex32(0, 1) * odd);
+    }
+
+    // inverse via the conjugate of a forward transform
+    for (int i = 0; i < half; ++i) {
+        z[i] = std::conj(z[i]);
+    }
+
+    complexForward(z, half);
+
+    // the half-size transform leaves a factor of N / 2; unscaled means a factor of N
+    const float scale = scaleType == DivInvByN ? 1.f / float(half) : 2.f;
+    for (int i = 0; i < half; ++i) {
+        z[i] = std::conj(z[i]) * scale;
+    }
+}
+
+#endif
+
 void RealFftFullPolarSpectrum::copyFromPacked(
         RealFftPackedEndpoints endpoints,
         Buffer<float> ordinaryMagnitudes,
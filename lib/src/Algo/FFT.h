@@ -6,7 +6,7 @@
 #ifdef USE_ACCELERATE
   #define VIMAGE_H
   #include <Accelerate/Accelerate.h>
-#else
+#elif defined(USE_IPP)
 #include <ipp.h>
 #endif
 
@@ -236,6 +236,14 @@ private:
     FFTSetup fftSetup;
     Buffer<Complex32> complex;
     DSPSplitComplex splitComplex;
+  #elif defined(USE_PORTABLE_SIMD)
+    // radix-2 real transform, packed like ippsFFTFwd_RToPerm: re[0] = DC, im[0] = nyquist
+    void complexForward(Complex32* data, int size) const;
+    void realForward(Buffer<float> src);
+    void realInverse(Buffer<float> dest);
+
+    ScopedAlloc<Complex32> twiddles;    // e^(-2 pi i k / N), k < N / 2
+    ScopedAlloc<Int32s> bitReversal;    // for the N / 2 point complex transform
   #else
     ScopedAlloc<Int8u> stateBuff;
     IppsFFTSpec_R_32f* spec;
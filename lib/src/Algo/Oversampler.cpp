@@ -1,19 +1,60 @@
+#include <cmath>
+
 #include "Oversampler.h"
 #include "../App/SingletonRepo.h"
 #include "../App/MemoryPool.h"
+#include "../Array/SimdKernels.h"
 #include "../Definitions.h"
 
 #ifdef USE_ACCELERATE
 #define VIMAGE_H
 #include <Accelerate/Accelerate.h>
+#endif
 
 namespace {
 constexpr int kOversamplerPartitionSize = 1024;
+
+// base-rate samples per pass through the half-band stages
+constexpr int kHalfBandChunkSize = 128;
+constexpr int kMaxHalfBandFactor = 8;
+
+/*
+ * The half-band allpass design from elliptic filter theory, as in Valenzuela and
+ * Constantinides (1983): the Jacobi nome q of the transition band, then each
+ * coefficient from theta-function sums in q that converge after a few terms.
+ */
+double nomeSum(double q, int order, int c, bool numerator) {
+    double sum = 0.0;
+    double term;
+    int i = numerator ? 0 : 1;
+    int sign = numerator ? 1 : -1;
+
+    do {
+        term = numerator
+                ? std::pow(q, i * (i + 1)) * std::sin((i * 2 + 1) * c * M_PI / order)
+                : std::pow(q, i * i) * std::cos(i * 2 * c * M_PI / order);
+        sum += term * sign;
+        sign = -sign;
+        ++i;
+    } while (std::abs(term) > 1e-100);
+
+    return sum;
+}
+
+// first order allpass in z^2, which is z^-1 at the lower rate
+inline float allpass(float sample, float coefficient, float& x, float& y) {
+    const float out = (sample - y) * coefficient + x;
+    x = sample;
+    y = out;
+
+    return out;
+}
 }
-#endif
 
 Oversampler::Oversampler(int kernelSize) :
         oversampleFactor (1)
+    ,   engine           (Engine::Polyphase)
+    ,   tapsPerBranch    (0)
   #ifdef USE_IPP
     ,   filterDownState  (nullptr)
     ,   filterUpState    (nullptr)
@@ -44,12 +85,21 @@ void Oversampler::startOversamplingBlock(Buffer<float>& buffer) {
 
         jassert(memoryBuf.size() >= oversampleFactor * buffer.size());
 
-        buffer.mul(oversampleFactor * 0.97f);
-        phase = memoryBuf
-            .withSize(oversampleFactor * buffer.size())
-            .upsampleFrom(buffer, oversampleFactor, phase);
+        const Engine active = activeEngine();
+
+        if (active == Engine::Polyphase) {
+            upsamplePolyphase(buffer, memoryBuf.withSize(destSize));
+        } else if (active == Engine::HalfBandIir) {
+            buffer.mul(0.97f);
+            upsampleHalfBand(buffer, memoryBuf.withSize(destSize));
+        } else {
+            buffer.mul(oversampleFactor * 0.97f);
+            phase = memoryBuf
+                .withSize(oversampleFactor * buffer.size())
+                .upsampleFrom(buffer, oversampleFactor, phase);
+        }
 
-        int partitionPos = 0;
+        int partitionPos = active == Engine::FullRate ? 0 : destSize;
 
         while (partitionPos < destSize) {
             int stepSize = jmin(destSize - partitionPos, 1024);
@@ -59,7 +109,7 @@ void Oversampler::startOversamplingBlock(Buffer<float>& buffer) {
           #ifdef USE_IPP
             ippsFIRSR_32f(partition, partition, stepSize, filterUpState, firUpDly, firUpDly, workBuffUp);
           #else
-            filterAccelerate(partition, firUpDly, accelInputUp, accelOutputUp);
+            filterDirect(partition, firUpDly, directInputUp, directOutputUp);
           #endif
             partition.add(1e-11f);
 
@@ -90,6 +140,28 @@ void Oversampler::sampleDown(Buffer<float> src, Buffer<float> dest, bool wrapTai
         return;
     }
 
+    const Engine active = activeEngine();
+
+    if (active != Engine::FullRate) {
+        auto downsample = [this, active](Buffer<float> input, Buffer<float> output, bool accumulate) {
+            return active == Engine::Polyphase
+                    ? downsamplePolyphase(input, output, accumulate)
+                    : downsampleHalfBand(input, output, accumulate);
+        };
+
+        downsample(src, dest, false);
+
+        // what's still ringing out of the filter wraps around to the start
+        if (wrapTail) {
+            Buffer<float> tail = memoryBuf.withSize(firDownDly.size());
+            tail.zero();
+
+            downsample(tail, dest, true);
+        }
+
+        return;
+    }
+
     int partitionPos = 0;
     int destPos      = 0;
 
@@ -105,7 +177,7 @@ void Oversampler::sampleDown(Buffer<float> src, Buffer<float> dest, bool wrapTai
         jassert(filterDownState);
         ippsFIRSR_32f(partition, partition, srcStep, filterDownState, firDownDly, firDownDly, workBuffDown);
       #else
-        filterAccelerate(partition, firDownDly, accelInputDown, accelOutputDown);
+        filterDirect(partition, firDownDly, directInputDown, directOutputDown);
       #endif
         phase = destPart.downsampleFrom(partition, oversampleFactor, phase);
 
@@ -125,7 +197,7 @@ void Oversampler::sampleDown(Buffer<float> src, Buffer<float> dest, bool wrapTai
       #ifdef USE_IPP
         ippsFIRSR_32f(tail, tail, tail.size(), filterDownState, firDownDly, firDownDly, workBuffDown);
       #else
-        filterAccelerate(tail, firDownDly, accelInputDown, accelOutputDown);
+        filterDirect(tail, firDownDly, directInputDown, directOutputDown);
       #endif
         phase = temp.downsampleFrom(tail, oversampleFactor, phase);
 
@@ -139,6 +211,20 @@ void Oversampler::setOversampleFactor(int factor) {
     updateTaps();
 }
 
+void Oversampler::setEngine(Engine engineToUse) {
+    engine = engineToUse;
+    resetDelayLine();
+}
+
+Oversampler::Engine Oversampler::activeEngine() const {
+    // the half-band cascade only halves, so other factors keep to the FIR
+    if (engine == Engine::HalfBandIir && numHalfBandStages() == 0) {
+        return Engine::Polyphase;
+    }
+
+    return engine;
+}
+
 void Oversampler::setKernelSize(int size) {
     firTaps     .resize(size);
     firUpDly    .resize(size);
@@ -147,12 +233,15 @@ void Oversampler::setKernelSize(int size) {
     firDownDly.zero();
     firUpDly.zero();
 
-#ifdef USE_ACCELERATE
+    polyphaseScratch.resize(kOversamplerPartitionSize + size);
+    halfBandScratch.resize(kHalfBandChunkSize * (kMaxHalfBandFactor + 1));
+
+#ifndef USE_IPP
     const int scratchSize = kOversamplerPartitionSize + size - 1;
-    accelInputUp.resize(scratchSize);
-    accelInputDown.resize(scratchSize);
-    accelOutputUp.resize(kOversamplerPartitionSize);
-    accelOutputDown.resize(kOversamplerPartitionSize);
+    directInputUp.resize(scratchSize);
+    directInputDown.resize(scratchSize);
+    directOutputUp.resize(kOversamplerPartitionSize);
+    directOutputDown.resize(kOversamplerPartitionSize);
 #endif
 
     int buffSize, specSize;
@@ -171,16 +260,26 @@ void Oversampler::setKernelSize(int size) {
 }
 
 Buffer<float> Oversampler::getTail() {
-    return firDownDly;
+    return activeEngine() == Engine::HalfBandIir ? Buffer<float>() : firDownDly;
 }
 
 int Oversampler::getLatencySamples() {
+    if (activeEngine() == Engine::HalfBandIir) {
+        return 0;
+    }
+
     return oversampleFactor > 1 ? firTaps.size() / oversampleFactor : 0;
 }
 
 void Oversampler::resetDelayLine() {
     firDownDly.zero();
     firUpDly.zero();
+    upHistory.zero();
+
+    for (int i = 0; i < maxHalfBandStages; ++i) {
+        upStages[i].reset();
+        downStages[i].reset();
+    }
 }
 
 void Oversampler::updateTaps() {
@@ -205,10 +304,235 @@ void Oversampler::updateTaps() {
     ScopedAlloc<Float32> windowMem(firTaps.size());
     VecOps::sinc(firTaps, windowMem, (float) relativeFreq);
 #endif
+
+    updatePolyphaseBranches();
+    updateHalfBandStages();
 }
 
-#ifdef USE_ACCELERATE
-void Oversampler::filterAccelerate(
+void Oversampler::updatePolyphaseBranches() {
+    const int factor = oversampleFactor;
+    tapsPerBranch = (firTaps.size() + factor - 1) / factor;
+
+    upBranches.resize(factor * tapsPerBranch);
+    upHistory.resize(tapsPerBranch);
+    upHistory.zero();
+
+    // output phase p of the zero-stuffed signal only ever meets taps p, p + factor, ...
+    const float gain = factor * 0.97f;
+
+    for (int p = 0; p < factor; ++p) {
+        for (int k = 0; k < tapsPerBranch; ++k) {
+            const int tap = p + k * factor;
+            upBranches[p * tapsPerBranch + tapsPerBranch - 1 - k] = tap < firTaps.size() ? firTaps[tap] * gain : 0.f;
+        }
+    }
+}
+
+void Oversampler::updateHalfBandStages() {
+    // the stage nearest the base rate needs the sharp transition, the rest only reject images far above it
+    for (int i = 0; i < maxHalfBandStages; ++i) {
+        const int numCoefficients = i == 0 ? 8 : 4;
+        const double transition = i == 0 ? 0.04 : 0.2;
+
+        upStages[i].design(numCoefficients, transition);
+        downStages[i].design(numCoefficients, transition);
+    }
+}
+
+int Oversampler::numHalfBandStages() const {
+    switch (oversampleFactor) {
+        case 2: return 1;
+        case 4: return 2;
+        case 8: return 3;
+        default: return 0;
+    }
+}
+
+void Oversampler::upsamplePolyphase(Buffer<float> src, Buffer<float> dest) {
+    const auto& kernels = SimdKernels::get();
+    const int factor = oversampleFactor;
+    const int historySize = tapsPerBranch - 1;
+
+    jassert(dest.size() >= src.size() * factor);
+
+    for (int offset = 0; offset < src.size(); offset += kOversamplerPartitionSize) {
+        const int size = jmin(kOversamplerPartitionSize, src.size() - offset);
+        Buffer<float> input = polyphaseScratch.withSize(historySize + size);
+
+        upHistory.withSize(historySize).copyTo(input);
+        src.section(offset, size).copyTo(input + historySize);
+
+        float* out = dest + offset * factor;
+
+        for (int i = 0; i < size; ++i) {
+            for (int p = 0; p < factor; ++p) {
+                *out++ = kernels.dot(input + i, upBranches + p * tapsPerBranch, tapsPerBranch) + 1e-11f;
+            }
+        }
+
+        input.section(size, historySize).copyTo(upHistory);
+    }
+}
+
+int Oversampler::downsamplePolyphase(Buffer<float> src, Buffer<float> dest, bool accumulate) {
+    const auto& kernels = SimdKernels::get();
+    const int factor = oversampleFactor;
+    const int numTaps = firTaps.size();
+    const int historySize = numTaps - 1;
+    int written = 0;
+
+    for (int offset = 0; offset < src.size(); offset += kOversamplerPartitionSize) {
+        const int size = jmin(kOversamplerPartitionSize, src.size() - offset);
+        Buffer<float> input = polyphaseScratch.withSize(historySize + size);
+
+        firDownDly.withSize(historySize).copyTo(input);
+        src.section(offset, size).copyTo(input + historySize);
+
+        // only the samples that survive decimation are filtered
+        int pos = phase;
+        for (; pos < size && written < dest.size(); pos += factor) {
+            const float value = kernels.dot(input + pos, firTaps, numTaps);
+            dest[written] = accumulate ? dest[written] + value : value;
+            ++written;
+        }
+
+        if (pos < size) {
+            pos += (size - pos + factor - 1) / factor * factor;
+        }
+
+        phase = pos - size;
+        input.section(size, historySize).copyTo(firDownDly);
+    }
+
+    return written;
+}
+
+void Oversampler::upsampleHalfBand(Buffer<float> src, Buffer<float> dest) {
+    const int numStages = numHalfBandStages();
+    const int factor = oversampleFactor;
+
+    jassert(numStages > 0);
+    jassert(dest.size() >= src.size() * factor);
+
+    float* scratch[] = { halfBandScratch.get(), halfBandScratch + kHalfBandChunkSize * kMaxHalfBandFactor / 2 };
+
+    for (int offset = 0; offset < src.size(); offset += kHalfBandChunkSize) {
+        int size = jmin(kHalfBandChunkSize, src.size() - offset);
+        const float* input = src + offset;
+
+        for (int stage = 0; stage < numStages; ++stage) {
+            float* output = stage == numStages - 1 ? dest + offset * factor : scratch[stage % 2];
+
+            upStages[stage].upsample(input, output, size);
+            input = output;
+            size *= 2;
+        }
+    }
+}
+
+int Oversampler::downsampleHalfBand(Buffer<float> src, Buffer<float> dest, bool accumulate) {
+    const int numStages = numHalfBandStages();
+    const int factor = oversampleFactor;
+    const int numOutputs = jmin(dest.size(), src.size() / factor);
+
+    jassert(numStages > 0);
+
+    float* scratch[] = { halfBandScratch.get(), halfBandScratch + kHalfBandChunkSize * kMaxHalfBandFactor / 2 };
+    float* accumulated = halfBandScratch + kHalfBandChunkSize * kMaxHalfBandFactor;
+
+    for (int offset = 0; offset < numOutputs; offset += kHalfBandChunkSize) {
+        const int outputs = jmin(kHalfBandChunkSize, numOutputs - offset);
+        const float* input = src + offset * factor;
+        int size = outputs * factor;
+
+        // from the highest rate down, so the sharpest stage runs last and slowest
+        for (int stage = numStages - 1; stage >= 0; --stage) {
+            size /= 2;
+
+            float* output = stage > 0 ? scratch[stage % 2]
+                          : accumulate ? accumulated
+                          : dest + offset;
+
+            downStages[stage].downsample(input, output, size);
+            input = output;
+        }
+
+        if (accumulate) {
+            dest.section(offset, outputs).add(Buffer<float>(accumulated, outputs));
+        }
+    }
+
+    return numOutputs;
+}
+
+void Oversampler::HalfBandStage::design(int numCoeffs, double transitionBandwidth) {
+    numCoefficients = jmin(numCoeffs, maxCoefficients);
+
+    double k = std::tan((1.0 - transitionBandwidth * 2.0) * M_PI / 4.0);
+    k *= k;
+
+    const double kRoot = std::pow(1.0 - k * k, 0.25);
+    const double e = 0.5 * (1.0 - kRoot) / (1.0 + kRoot);
+    const double e4 = e * e * e * e;
+    const double q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+    const int order = numCoefficients * 2 + 1;
+
+    for (int i = 0; i < numCoefficients; ++i) {
+        const double w = nomeSum(q, order, i + 1, true) * std::pow(q, 0.25)
+                       / (nomeSum(q, order, i + 1, false) + 0.5);
+        const double wSquared = w * w;
+        const double x = std::sqrt((1.0 - wSquared * k) * (1.0 - wSquared / k)) / (1.0 + wSquared);
+
+        coefficients[i] = (float) ((1.0 - x) / (1.0 + x));
+    }
+
+    reset();
+}
+
+void Oversampler::HalfBandStage::reset() {
+    std::fill(std::begin(x), std::end(x), 0.f);
+    std::fill(std::begin(y), std::end(y), 0.f);
+}
+
+void Oversampler::HalfBandStage::upsample(const float* src, float* dest, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+        float even = src[i];
+        float odd = src[i];
+
+        // even coefficients make one chain, odd ones the other
+        for (int c = 0; c < numCoefficients; c += 2) {
+            even = allpass(even, coefficients[c], x[c], y[c]);
+
+            if (c + 1 < numCoefficients) {
+                odd = allpass(odd, coefficients[c + 1], x[c + 1], y[c + 1]);
+            }
+        }
+
+        dest[2 * i] = even;
+        dest[2 * i + 1] = odd;
+    }
+}
+
+void Oversampler::HalfBandStage::downsample(const float* src, float* dest, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+        float even = src[2 * i + 1];
+        float odd = src[2 * i];
+
+        // even coefficients make one chain, odd ones the other
+        for (int c = 0; c < numCoefficients; c += 2) {
+            even = allpass(even, coefficients[c], x[c], y[c]);
+
+            if (c + 1 < numCoefficients) {
+                odd = allpass(odd, coefficients[c + 1], x[c + 1], y[c + 1]);
+            }
+        }
+
+        dest[i] = 0.5f * (even + odd);
+    }
+}
+
+#ifndef USE_IPP
+void Oversampler::filterDirect(
         Buffer<float> samples,
         Buffer<float> delay,
         Buffer<float> inputScratch,
@@ -219,6 +543,8 @@ void Oversampler::filterAccelerate(
 
     delay.withSize(historySize).copyTo(input);
     samples.copyTo(input + historySize);
+
+  #ifdef USE_ACCELERATE
     vDSP_conv(
             input,
             1,
@@ -228,6 +554,13 @@ void Oversampler::filterAccelerate(
             1,
             (vDSP_Length) output.size(),
             (vDSP_Length) firTaps.size());
+  #else
+    // correlation, like vDSP_conv; the taps are symmetric so it's the same as convolving
+    const auto& kernels = SimdKernels::get();
+    for (int i = 0; i < output.size(); ++i) {
+        output[i] = kernels.dot(input + i, firTaps, firTaps.size());
+    }
+  #endif
     input.offset(samples.size()).withSize(historySize).copyTo(delay);
     output.copyTo(samples);
 }
@@ -7,6 +7,19 @@ class SingletonRepo;
 
 class Oversampler {
 public:
+    /*
+     * How the rate changes are filtered:
+     *
+     *  FullRate     zero-stuffs and runs the FIR over every oversampled sample,
+     *               then again over every one before decimating
+     *  Polyphase    the same FIR, split into one branch per output phase going
+     *               up and only evaluated at kept samples going down
+     *  HalfBandIir  a cascade of 2x allpass half-band stages; almost no latency,
+     *               but not linear phase; only for factors of 2, 4 and 8, others
+     *               use Polyphase
+     */
+    enum class Engine { FullRate, Polyphase, HalfBandIir };
+
     explicit Oversampler(int kernelSize = 32);
     explicit Oversampler(SingletonRepo* repo, int kernelSize = 32);
     virtual ~Oversampler();
@@ -14,6 +27,7 @@ public:
     void resetDelayLine();
     void setKernelSize(int size);
     void setOversampleFactor(int factor);
+    void setEngine(Engine engine);
 
     /**
      * Samples down by `oversampleFactor`, first filtering at the Nyquist frequency.
@@ -52,12 +66,38 @@ public:
     void setMemoryBuffer(const Buffer<float>& buffer) { memoryBuf = buffer; }
     void setMemoryBuf(const Buffer<float>& buffer) { setMemoryBuffer(buffer); }
     int getOversampleFactor() const { return oversampleFactor; }
+    Engine getEngine() const { return engine; }
 
 private:
-    void updateTaps();
+    // two allpass chains in z^2 whose average is a half-band lowpass; each runs at the lower rate
+    struct HalfBandStage {
+        static constexpr int maxCoefficients = 8;
+
+        void design(int numCoefficients, double transitionBandwidth);
+        void reset();
+        void upsample(const float* src, float* dest, int numSamples);   // dest holds 2 * numSamples
+        void downsample(const float* src, float* dest, int numSamples); // src holds 2 * numSamples
 
-#ifdef USE_ACCELERATE
-    void filterAccelerate(
+        int numCoefficients {};
+        float coefficients[maxCoefficients] {};
+        float x[maxCoefficients] {}, y[maxCoefficients] {};
+    };
+
+    static constexpr int maxHalfBandStages = 3;
+
+    void updateTaps();
+    void updatePolyphaseBranches();
+    void updateHalfBandStages();
+
+    void upsamplePolyphase(Buffer<float> src, Buffer<float> dest);
+    void upsampleHalfBand(Buffer<float> src, Buffer<float> dest);
+    int downsamplePolyphase(Buffer<float> src, Buffer<float> dest, bool accumulate);
+    int downsampleHalfBand(Buffer<float> src, Buffer<float> dest, bool accumulate);
+    int numHalfBandStages() const;
+    Engine activeEngine() const;
+
+#ifndef USE_IPP
+    void filterDirect(
             Buffer<float> samples,
             Buffer<float> delay,
             Buffer<float> inputScratch,
@@ -65,14 +105,22 @@ private:
 #endif
 
     int phase, oversampleFactor;
+    Engine engine;
+
+    // upBranches holds each phase's taps reversed, tapsPerBranch apiece
+    int tapsPerBranch;
+    ScopedAlloc<Float32> upBranches, upHistory, polyphaseScratch;
+
+    HalfBandStage upStages[maxHalfBandStages], downStages[maxHalfBandStages];
+    ScopedAlloc<Float32> halfBandScratch;
 
     ScopedAlloc<Int8u> stateUpBuf, stateDownBuf;
     ScopedAlloc<Int8u> workBuffUp, workBuffDown;
     ScopedAlloc<Float32> firTaps, firUpDly, firDownDly;
 
-#ifdef USE_ACCELERATE
-    ScopedAlloc<Float32> accelInputUp, accelInputDown;
-    ScopedAlloc<Float32> accelOutputUp, accelOutputDown;
+#ifndef USE_IPP
+    ScopedAlloc<Float32> directInputUp, directInputDown;
+    ScopedAlloc<Float32> directOutputUp, directOutputDown;
 #endif
 
     Buffer<float> memoryBuf, audioBuf;
@@ -3,6 +3,7 @@
 
 #include <Util/ScopedFunction.h>
 
+#include "PresetBinary.h"
 #include "PresetJson.h"
 #include "Savable.h"
 #include "../AppConstants.h"
@@ -11,7 +12,16 @@
 #include "../../UI/IConsole.h"
 #include "../../Definitions.h"
 
-Document::Document(SingletonRepo* repo) : SingletonAccessor(repo, "Document"), validator(nullptr) {
+namespace {
+    // both encodings carry these, so a reader can tell what it has before applying any section
+    const char* const presetFormatName = "amaranth-preset";
+    const int presetSchemaVersion = 2;
+}
+
+Document::Document(SingletonRepo* repo) :
+        SingletonAccessor(repo, "Document")
+    ,   validator(nullptr)
+    ,   saveFormat(JsonFormat) {
 }
 
 Identifier Document::getJsonSectionKey(Savable* savableItem) {
@@ -70,8 +80,8 @@ var Document::createJsonRoot(DocumentDetails& details, const Array<Savable*>& sa
     auto root = PresetJson::object();
     auto preset = PresetJson::object();
 
-    root->setProperty("format", "amaranth-preset");
-    root->setProperty("schemaVersion", 2);
+    root->setProperty("format", presetFormatName);
+    root->setProperty("schemaVersion", presetSchemaVersion);
     preset->setProperty("details", details.writeJSON());
 
     for (auto savableItem : savableItems) {
@@ -99,7 +109,12 @@ bool Document::applyJsonRoot(const var& root) {
         return false;
     }
 
-    if (var detailsJson = PresetJson::property(preset, "details"); !detailsJson.isVoid()) {
+    applySections([&preset](const Identifier& key) { return PresetJson::property(preset, key); });
+    return true;
+}
+
+void Document::applySections(const std::function<var(const Identifier&)>& sectionFor) {
+    if (var detailsJson = sectionFor("details"); !detailsJson.isVoid()) {
         (void) details.readJSON(detailsJson);
     }
 
@@ -110,14 +125,12 @@ bool Document::applyJsonRoot(const var& root) {
             continue;
         }
 
-        var sectionJson = PresetJson::property(preset, sectionKey);
+        var sectionJson = sectionFor(sectionKey);
 
         if (!sectionJson.isVoid()) {
             (void) savableItem->readJSON(sectionJson);
         }
     }
-
-    return true;
 }
 
 var Document::exportSavableJSON(const String& savableName) const {
@@ -208,6 +221,11 @@ void Document::save(OutputStream* outStream) {
         return;
     }
 
+    if (saveFormat == BinaryFormat) {
+        saveBinary(outStream);
+        return;
+    }
+
     String docString = JSON::toString(createJsonRoot(details, savableItems), true);
     CharPointer_UTF8 utf8Data = docString.toUTF8();
 
@@ -216,6 +234,31 @@ void Document::save(OutputStream* outStream) {
     gzipStream.flush();
 }
 
+void Document::saveBinary(OutputStream* outStream) {
+    PresetBinary::Writer writer;
+    writer.addSection("format", presetFormatName);
+    writer.addSection("schemaVersion", presetSchemaVersion);
+    writer.addSection("details", details.writeJSON());
+
+    for (auto savableItem : savableItems) {
+        Identifier sectionKey = getJsonSectionKey(savableItem);
+
+        if (sectionKey.isNull()) {
+            continue;
+        }
+
+        var sectionJson = savableItem->writeJSON();
+
+        if (!sectionJson.isVoid()) {
+            writer.addSection(sectionKey, sectionJson);
+        }
+    }
+
+    if (!writer.write(*outStream)) {
+        showConsoleMsg("Problem saving preset");
+    }
+}
+
 #ifdef JUCE_DEBUG
 String Document::getPresetString() {
     return JSON::toString(createJsonRoot(details, savableItems), true);
@@ -234,11 +277,16 @@ bool Document::open(InputStream* stream) {
         stream->setPosition(startPosition);
     }
 
+    if (PresetBinary::isBinary(*stream)) {
+        return openBinary(stream);
+    }
+
     ScopedLambda loadToggle(
         [this] { listeners.call(&Listener::documentAboutToLoad); },
         [this] { listeners.call(&Listener::documentHasLoaded); }
     );
 
+    // gzipped JSON, or XML from before the JSON format that the migrator brings up to date
     GZIPDecompressorInputStream decompStream(stream, false);
     String presetDocString(decompStream.readEntireStreamAsString());
     String trimmed = presetDocString.trimStart();
@@ -260,6 +308,24 @@ bool Document::open(InputStream* stream) {
     return applyJsonRoot(jsonRoot);
 }
 
+bool Document::openBinary(InputStream* stream) {
+    PresetBinary::Reader reader;
+
+    // check the directory before listeners see a load start
+    if (!reader.open(*stream)) {
+        return false;
+    }
+
+    ScopedLambda loadToggle(
+        [this] { listeners.call(&Listener::documentAboutToLoad); },
+        [this] { listeners.call(&Listener::documentHasLoaded); }
+    );
+
+    // sections are decoded as each savable asks for them; unknown ones are never read
+    applySections([&reader](const Identifier& key) { return reader.readSection(key); });
+    return true;
+}
+
 bool Document::saveHeaderValidated(DocumentDetails& updatedDetails) {
     if (!validate()) {
         return false;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <vector>
 #include "DocumentDetails.h"
 #include "PresetMigrator.h"
@@ -11,6 +12,11 @@ class Document : public SingletonAccessor {
 public:
     static const int headerSizeBytes = 1024;
 
+    enum Format {
+        JsonFormat,     // gzipped JSON, readable by every version since the JSON migration; the default
+        BinaryFormat    // sectioned PresetBinary container, opt-in through CompactPresets since older versions can't read it
+    };
+
     class Listener {
     public:
         virtual ~Listener() = default;
@@ -35,6 +41,8 @@ public:
     void addListener(Listener* listener)        { listeners.add(listener);      }
     void registerSavable(Savable* toSave)       { savableItems.add(toSave);     }
     void setValidator(IValidator* validator)    { this->validator = validator;  }
+    void setSaveFormat(Format format)           { saveFormat = format;          }
+    Format getSaveFormat() const                { return saveFormat;            }
     var exportSavableJSON(const String& savableName) const;
     var exportPresetJSON();
 
@@ -122,12 +130,16 @@ protected:
     static Identifier getJsonSectionKey(Savable* savableItem);
     static var createJsonRoot(DocumentDetails& details, const Array<Savable*>& savableItems);
     bool applyJsonRoot(const var& root);
+    void applySections(const std::function<var(const Identifier&)>& sectionFor);
+    bool openBinary(InputStream* stream);
+    void saveBinary(OutputStream* outStream);
     bool validate();
 
     DocumentDetails details;
     ListenerList<Listener> listeners;
 
     IValidator* validator;
+    Format saveFormat;
     Array<Savable*> savableItems;
 
     JUCE_LEAK_DETECTOR(Document);
@@ -0,0 +1,775 @@
+#include <cstring>
+#include <vector>
+
+#include "PresetBinary.h"
+
+namespace {
+    enum Tag {
+        TagVoid,
+        TagFalse,
+        TagTrue,
+        TagInt,
+        TagInt64,
+        TagDouble,
+        TagString,
+        TagArray,
+        TagObject,
+        TagTable,
+        TagBinary
+    };
+
+    enum ColumnType {
+        ColumnInt32,
+        ColumnFloat32,
+        ColumnFloat64,
+        ColumnBool
+    };
+
+    enum ShapeKind {
+        ShapeInt,
+        ShapeDouble,
+        ShapeBool,
+        ShapeObject,
+        ShapeArray
+    };
+
+    const int minTableRows     = 2;
+    const int maxShapeDepth    = 4;
+    const int maxShapeChildren = 64;
+    const int maxSections      = 1024;
+
+    /*
+     * The layout shared by every row of a table: nested objects and short
+     * arrays down to numeric or boolean leaves, each leaf becoming a column.
+     */
+    struct Shape {
+        ShapeKind kind { ShapeInt };
+        Array<Identifier> keys;
+        std::vector<Shape> children;
+    };
+
+    bool shapeOf(const var& value, Shape& shape, int depth) {
+        if (value.isInt()) {
+            shape.kind = ShapeInt;
+            return true;
+        }
+
+        if (value.isDouble()) {
+            shape.kind = ShapeDouble;
+            return true;
+        }
+
+        if (value.isBool()) {
+            shape.kind = ShapeBool;
+            return true;
+        }
+
+        if (depth >= maxShapeDepth) {
+            return false;
+        }
+
+        if (auto* object = value.getDynamicObject()) {
+            auto& properties = object->getProperties();
+
+            if (properties.size() > maxShapeChildren) {
+                return false;
+            }
+
+            shape.kind = ShapeObject;
+            shape.children.resize((size_t) properties.size());
+
+            for (int i = 0; i < properties.size(); ++i) {
+                shape.keys.add(properties.getName(i));
+
+                if (! shapeOf(properties.getValueAt(i), shape.children[(size_t) i], depth + 1)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        if (auto* array = value.getArray()) {
+            if (array->size() > maxShapeChildren) {
+                return false;
+            }
+
+            shape.kind = ShapeArray;
+            shape.children.resize((size_t) array->size());
+
+            for (int i = 0; i < array->size(); ++i) {
+                if (! shapeOf(array->getReference(i), shape.children[(size_t) i], depth + 1)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    bool matchesShape(const var& value, const Shape& shape) {
+        switch (shape.kind) {
+            case ShapeInt:      return value.isInt();
+            case ShapeDouble:   return value.isDouble();
+            case ShapeBool:     return value.isBool();
+
+            case ShapeObject: {
+                auto* object = value.getDynamicObject();
+
+                if (object == nullptr || object->getProperties().size() != shape.keys.size()) {
+                    return false;
+                }
+
+                auto& properties = object->getProperties();
+
+                for (int i = 0; i < shape.keys.size(); ++i) {
+                    if (properties.getName(i) != shape.keys[i]
+                            || ! matchesShape(properties.getValueAt(i), shape.children[(size_t) i])) {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            case ShapeArray: {
+                auto* array = value.getArray();
+
+                if (array == nullptr || array->size() != (int) shape.children.size()) {
+                    return false;
+                }
+
+                for (int i = 0; i < array->size(); ++i) {
+                    if (! matchesShape(array->getReference(i), shape.children[(size_t) i])) {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            default:
+                return false;
+        }
+    }
+
+    int countLeaves(const Shape& shape) {
+        if (shape.kind != ShapeObject && shape.kind != ShapeArray) {
+            return 1;
+        }
+
+        int count = 0;
+        for (auto& child : shape.children) {
+            count += countLeaves(child);
+        }
+
+        return count;
+    }
+
+    void collectLeaves(const var& value, const Shape& shape, std::vector<const Shape*>& leaves,
+                       std::vector<std::vector<double>>& columns, int& leaf) {
+        if (shape.kind == ShapeObject) {
+            auto& properties = value.getDynamicObject()->getProperties();
+
+            for (int i = 0; i < shape.keys.size(); ++i) {
+                collectLeaves(properties.getValueAt(i), shape.children[(size_t) i], leaves, columns, leaf);
+            }
+        } else if (shape.kind == ShapeArray) {
+            auto* array = value.getArray();
+
+            for (int i = 0; i < array->size(); ++i) {
+                collectLeaves(array->getReference(i), shape.children[(size_t) i], leaves, columns, leaf);
+            }
+        } else {
+            leaves[(size_t) leaf] = &shape;
+            columns[(size_t) leaf].push_back((double) value);
+            ++leaf;
+        }
+    }
+
+    /* ----------------------------------------------------------------------------- */
+
+    class Encoder {
+    public:
+        MemoryBlock encode(const var& value) {
+            writeValue(value);
+
+            MemoryOutputStream payload;
+            payload.writeCompressedInt(keyNames.size());
+
+            for (auto& key : keyNames) {
+                payload.writeString(key);
+            }
+
+            payload << body.getMemoryBlock();
+            return payload.getMemoryBlock();
+        }
+
+    private:
+        int keyIndex(const Identifier& key) {
+            auto it = keyIndices.find(key.toString());
+
+            if (it != keyIndices.end()) {
+                return it->second;
+            }
+
+            keyNames.add(key.toString());
+            keyIndices[key.toString()] = keyNames.size() - 1;
+
+            return keyNames.size() - 1;
+        }
+
+        void writeTag(Tag tag) {
+            body.writeByte((char) tag);
+        }
+
+        void writeValue(const var& value) {
+            if (value.isBool()) {
+                writeTag((bool) value ? TagTrue : TagFalse);
+            } else if (value.isInt()) {
+                writeTag(TagInt);
+                body.writeInt((int) value);
+            } else if (value.isInt64()) {
+                writeTag(TagInt64);
+                body.writeInt64((int64) value);
+            } else if (value.isDouble()) {
+                writeTag(TagDouble);
+                body.writeDouble((double) value);
+            } else if (value.isString()) {
+                writeTag(TagString);
+                body.writeString(value.toString());
+            } else if (auto* array = value.getArray()) {
+                if (! writeTable(*array)) {
+                    writeTag(TagArray);
+                    body.writeCompressedInt(array->size());
+
+                    for (auto& element : *array) {
+                        writeValue(element);
+                    }
+                }
+            } else if (auto* object = value.getDynamicObject()) {
+                auto& properties = object->getProperties();
+
+                writeTag(TagObject);
+                body.writeCompressedInt(properties.size());
+
+                for (int i = 0; i < properties.size(); ++i) {
+                    body.writeCompressedInt(keyIndex(properties.getName(i)));
+                    writeValue(properties.getValueAt(i));
+                }
+            } else if (auto* block = value.getBinaryData()) {
+                writeTag(TagBinary);
+                body.writeCompressedInt((int) block->getSize());
+                body << *block;
+            } else {
+                writeTag(TagVoid);
+            }
+        }
+
+        void writeShape(const Shape& shape) {
+            body.writeByte((char) shape.kind);
+
+            if (shape.kind == ShapeObject) {
+                body.writeCompressedInt(shape.keys.size());
+
+                for (int i = 0; i < shape.keys.size(); ++i) {
+                    body.writeCompressedInt(keyIndex(shape.keys[i]));
+                    writeShape(shape.children[(size_t) i]);
+                }
+            } else if (shape.kind == ShapeArray) {
+                body.writeCompressedInt((int) shape.children.size());
+
+                for (auto& child : shape.children) {
+                    writeShape(child);
+                }
+            }
+        }
+
+        bool writeTable(const Array<var>& rows) {
+            if (rows.size() < minTableRows || rows.getReference(0).getDynamicObject() == nullptr) {
+                return false;
+            }
+
+            Shape shape;
+            if (! shapeOf(rows.getReference(0), shape, 0)) {
+                return false;
+            }
+
+            for (int i = 1; i < rows.size(); ++i) {
+                if (! matchesShape(rows.getReference(i), shape)) {
+                    return false;
+                }
+            }
+
+            const int numLeaves = countLeaves(shape);
+
+            if (numLeaves == 0) {
+                return false;
+            }
+
+            std::vector<const Shape*> leaves((size_t) numLeaves);
+            std::vector<std::vector<double>> columns((size_t) numLeaves);
+
+            for (auto& column : columns) {
+                column.reserve((size_t) rows.size());
+            }
+
+            for (auto& row : rows) {
+                int leaf = 0;
+                collectLeaves(row, shape, leaves, columns, leaf);
+            }
+
+            writeTag(TagTable);
+            body.writeCompressedInt(rows.size());
+            writeShape(shape);
+
+            for (int i = 0; i < numLeaves; ++i) {
+                writeColumn(leaves[(size_t) i]->kind, columns[(size_t) i]);
+            }
+
+            return true;
+        }
+
+        void writeColumn(ShapeKind kind, const std::vector<double>& values) {
+            const size_t size = values.size();
+
+            if (kind == ShapeBool) {
+                std::vector<uint8> bytes(size);
+
+                for (size_t i = 0; i < size; ++i) {
+                    bytes[i] = values[i] != 0 ? 1 : 0;
+                }
+
+                body.writeByte((char) ColumnBool);
+                body.write(bytes.data(), size);
+                return;
+            }
+
+            if (kind == ShapeDouble) {
+                bool fitsFloat = true;
+
+                for (double value : values) {
+                    if ((double) (float) value != value) {
+                        fitsFloat = false;
+                        break;
+                    }
+                }
+
+                if (! fitsFloat) {
+                    std::vector<uint64> words(size);
+
+                    for (size_t i = 0; i < size; ++i) {
+                        std::memcpy(&words[i], &values[i], sizeof(uint64));
+                        words[i] = ByteOrder::swapIfBigEndian(words[i]);
+                    }
+
+                    body.writeByte((char) ColumnFloat64);
+                    body.write(words.data(), size * sizeof(uint64));
+                    return;
+                }
+            }
+
+            std::vector<uint32> words(size);
+
+            for (size_t i = 0; i < size; ++i) {
+                if (kind == ShapeInt) {
+                    words[i] = (uint32) (int) values[i];
+                } else {
+                    float value = (float) values[i];
+                    std::memcpy(&words[i], &value, sizeof(uint32));
+                }
+
+                words[i] = ByteOrder::swapIfBigEndian(words[i]);
+            }
+
+            body.writeByte((char) (kind == ShapeInt ? ColumnInt32 : ColumnFloat32));
+            body.write(words.data(), size * sizeof(uint32));
+        }
+
+        MemoryOutputStream body;
+        StringArray keyNames;
+        std::map<String, int> keyIndices;
+    };
+
+    /* ----------------------------------------------------------------------------- */
+
+    class Decoder {
+    public:
+        Decoder(const void* data, size_t size) :
+                in(data, size, false) {
+        }
+
+        var decode() {
+            int numKeys = in.readCompressedInt();
+
+            if (numKeys < 0 || numKeys > in.getNumBytesRemaining()) {
+                return {};
+            }
+
+            for (int i = 0; i < numKeys; ++i) {
+                keys.add(in.readString());
+            }
+
+            var value = readValue(0);
+            return failed ? var() : value;
+        }
+
+    private:
+        bool fail() {
+            failed = true;
+            return false;
+        }
+
+        bool readCount(int& count, int64 minBytesEach) {
+            count = in.readCompressedInt();
+
+            if (count < 0 || (int64) count * minBytesEach > in.getNumBytesRemaining()) {
+                return fail();
+            }
+
+            return true;
+        }
+
+        bool readKey(Identifier& key) {
+            int index = in.readCompressedInt();
+
+            if (! isPositiveAndBelow(index, keys.size())) {
+                return fail();
+            }
+
+            key = keys[index];
+            return true;
+        }
+
+        var readValue(int depth) {
+            if (failed || in.isExhausted() || depth > 64) {
+                fail();
+                return {};
+            }
+
+            switch (in.readByte()) {
+                case TagVoid:   return {};
+                case TagFalse:  return false;
+                case TagTrue:   return true;
+                case TagInt:    return in.readInt();
+                case TagInt64:  return in.readInt64();
+                case TagDouble: return in.readDouble();
+                case TagString: return in.readString();
+
+                case TagArray: {
+                    int count;
+                    if (! readCount(count, 1)) {
+                        return {};
+                    }
+
+                    Array<var> elements;
+                    elements.ensureStorageAllocated(count);
+
+                    for (int i = 0; i < count && ! failed; ++i) {
+                        elements.add(readValue(depth + 1));
+                    }
+
+                    return elements;
+                }
+
+                case TagObject: {
+                    int count;
+                    if (! readCount(count, 2)) {
+                        return {};
+                    }
+
+                    DynamicObject::Ptr object(new DynamicObject());
+
+                    for (int i = 0; i < count && ! failed; ++i) {
+                        Identifier key;
+                        if (! readKey(key)) {
+                            return {};
+                        }
+
+                        object->setProperty(key, readValue(depth + 1));
+                    }
+
+                    return var(object.get());
+                }
+
+                case TagTable:
+                    return readTable();
+
+                case TagBinary: {
+                    int size;
+                    if (! readCount(size, 1)) {
+                        return {};
+                    }
+
+                    MemoryBlock block;
+                    in.readIntoMemoryBlock(block, size);
+                    return block;
+                }
+
+                default:
+                    fail();
+                    return {};
+            }
+        }
+
+        bool readShape(Shape& shape, int depth) {
+            int kind = in.readByte();
+
+            if (depth > maxShapeDepth || ! isPositiveAndBelow(kind, (int) ShapeArray + 1)) {
+                return fail();
+            }
+
+            shape.kind = (ShapeKind) kind;
+
+            if (shape.kind == ShapeObject || shape.kind == ShapeArray) {
+                int count;
+                if (! readCount(count, 1) || count > maxShapeChildren) {
+                    return fail();
+                }
+
+                shape.children.resize((size_t) count);
+
+                for (int i = 0; i < count; ++i) {
+                    if (shape.kind == ShapeObject) {
+                        Identifier key;
+                        if (! readKey(key)) {
+                            return false;
+                        }
+
+                        shape.keys.add(key);
+                    }
+
+                    if (! readShape(shape.children[(size_t) i], depth + 1)) {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        bool readColumn(std::vector<double>& values, int numRows) {
+            int type = in.readByte();
+            int width = type == ColumnBool ? 1 : type == ColumnFloat64 ? 8 : 4;
+
+            if (! isPositiveAndBelow(type, (int) ColumnBool + 1)
+                    || (int64) numRows * width > in.getNumBytesRemaining()) {
+                return fail();
+            }
+
+            values.resize((size_t) numRows);
+            auto* bytes = static_cast<const uint8*>(in.getData()) + in.getPosition();
+
+            for (int i = 0; i < numRows; ++i) {
+                const uint8* element = bytes + (size_t) i * (size_t) width;
+
+                switch (type) {
+                    case ColumnBool:
+                        values[(size_t) i] = *element != 0 ? 1.0 : 0.0;
+                        break;
+
+                    case ColumnInt32:
+                        values[(size_t) i] = (int) ByteOrder::littleEndianInt(element);
+                        break;
+
+                    case ColumnFloat32: {
+                        uint32 word = ByteOrder::littleEndianInt(element);
+                        float value;
+                        std::memcpy(&value, &word, sizeof(float));
+                        values[(size_t) i] = value;
+                        break;
+                    }
+
+                    default: {
+                        uint64 word = ByteOrder::littleEndianInt64(element);
+                        std::memcpy(&values[(size_t) i], &word, sizeof(double));
+                        break;
+                    }
+                }
+            }
+
+            in.skipNextBytes((int64) numRows * width);
+            return true;
+        }
+
+        var buildRow(const Shape& shape, const std::vector<std::vector<double>>& columns, int row, int& leaf) {
+            switch (shape.kind) {
+                case ShapeInt:      return (int) columns[(size_t) leaf++][(size_t) row];
+                case ShapeDouble:   return columns[(size_t) leaf++][(size_t) row];
+                case ShapeBool:     return columns[(size_t) leaf++][(size_t) row] != 0;
+
+                case ShapeObject: {
+                    DynamicObject::Ptr object(new DynamicObject());
+
+                    for (int i = 0; i < shape.keys.size(); ++i) {
+                        object->setProperty(shape.keys[i], buildRow(shape.children[(size_t) i], columns, row, leaf));
+                    }
+
+                    return var(object.get());
+                }
+
+                default: {
+                    Array<var> elements;
+
+                    for (auto& child : shape.children) {
+                        elements.add(buildRow(child, columns, row, leaf));
+                    }
+
+                    return elements;
+                }
+            }
+        }
+
+        var readTable() {
+            int numRows;
+            Shape shape;
+
+            if (! readCount(numRows, 0) || ! readShape(shape, 0)) {
+                return {};
+            }
+
+            std::vector<std::vector<double>> columns((size_t) countLeaves(shape));
+
+            if (columns.empty()) {
+                fail();
+                return {};
+            }
+
+            for (auto& column : columns) {
+                if (! readColumn(column, numRows)) {
+                    return {};
+                }
+            }
+
+            Array<var> rows;
+            rows.ensureStorageAllocated(numRows);
+
+            for (int row = 0; row < numRows; ++row) {
+                int leaf = 0;
+                rows.add(buildRow(shape, columns, row, leaf));
+            }
+
+            return rows;
+        }
+
+        MemoryInputStream in;
+        StringArray keys;
+        bool failed { false };
+    };
+}
+
+/* ----------------------------------------------------------------------------- */
+
+MemoryBlock PresetBinary::encode(const var& value) {
+    return Encoder().encode(value);
+}
+
+var PresetBinary::decode(const void* data, size_t size) {
+    return Decoder(data, size).decode();
+}
+
+bool PresetBinary::isBinary(InputStream& stream) {
+    int64 position = stream.getPosition();
+    int code = stream.readInt();
+    stream.setPosition(position);
+
+    return code == magic;
+}
+
+void PresetBinary::Writer::addSection(const Identifier& key, const var& value) {
+    keys.add(key.toString());
+    payloads.add(encode(value));
+}
+
+bool PresetBinary::Writer::write(OutputStream& stream) const {
+    bool ok = stream.writeInt(magic)
+           && stream.writeInt(formatVersion)
+           && stream.writeInt(keys.size());
+
+    for (int i = 0; i < keys.size() && ok; ++i) {
+        ok = stream.writeString(keys[i]) && stream.writeInt((int) payloads.getReference(i).getSize());
+    }
+
+    for (int i = 0; i < payloads.size() && ok; ++i) {
+        ok = stream.write(payloads.getReference(i).getData(), payloads.getReference(i).getSize());
+    }
+
+    return ok;
+}
+
+bool PresetBinary::Reader::open(InputStream& source) {
+    stream = nullptr;
+    entries.clear();
+
+    if (source.readInt() != magic) {
+        return false;
+    }
+
+    version = source.readInt();
+    int numSections = source.readInt();
+
+    if (version < 1 || version > formatVersion || ! isPositiveAndBelow(numSections, maxSections)) {
+        return false;
+    }
+
+    StringArray sectionKeys;
+    Array<int> sizes;
+
+    for (int i = 0; i < numSections; ++i) {
+        sectionKeys.add(source.readString());
+        sizes.add(source.readInt());
+
+        if (sizes.getLast() < 0 || source.isExhausted()) {
+            return false;
+        }
+    }
+
+    int64 offset = source.getPosition();
+
+    for (int i = 0; i < numSections; ++i) {
+        entries[sectionKeys[i]] = { offset, sizes[i] };
+        offset += sizes[i];
+    }
+
+    int64 totalLength = source.getTotalLength();
+
+    if (totalLength >= 0 && offset > totalLength) {
+        entries.clear();
+        return false;
+    }
+
+    stream = &source;
+    return true;
+}
+
+bool PresetBinary::Reader::hasSection(const Identifier& key) const {
+    return entries.find(key.toString()) != entries.end();
+}
+
+StringArray PresetBinary::Reader::getSectionKeys() const {
+    StringArray keys;
+
+    for (auto& entry : entries) {
+        keys.add(entry.first);
+    }
+
+    return keys;
+}
+
+var PresetBinary::Reader::readSection(const Identifier& key) const {
+    auto it = entries.find(key.toString());
+
+    if (stream == nullptr || it == entries.end() || ! stream->setPosition(it->second.offset)) {
+        return {};
+    }
+
+    MemoryBlock payload;
+
+    if (stream->readIntoMemoryBlock(payload, it->second.size) != (size_t) it->second.size) {
+        return {};
+    }
+
+    return decode(payload.getData(), payload.getSize());
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <map>
+#include "JuceHeader.h"
+
+using namespace juce;
+
+/*
+ * Chunked binary container for preset sections.
+ *
+ *   magic, version, section count
+ *   directory: key, payload offset, payload size per section
+ *   payloads
+ *
+ * Each payload is one section's JSON value in a compact tagged encoding.
+ * Arrays of identically shaped objects, such as mesh vertices and cubes,
+ * are stored as little-endian column blocks rather than per-object records.
+ * The directory lets a reader skip to, and decode, only the sections it wants.
+ */
+class PresetBinary {
+public:
+    static const int magic = 0x31425041; // "APB1"
+    static const int formatVersion = 1;
+
+    class Writer {
+    public:
+        void addSection(const Identifier& key, const var& value);
+        bool write(OutputStream& stream) const;
+
+    private:
+        StringArray keys;
+        Array<MemoryBlock> payloads;
+    };
+
+    class Reader {
+    public:
+        // reads the directory only; the stream must outlive the reader
+        bool open(InputStream& stream);
+
+        bool hasSection(const Identifier& key) const;
+        var readSection(const Identifier& key) const;
+        StringArray getSectionKeys() const;
+        int getVersion() const { return version; }
+
+    private:
+        struct Entry {
+            int64 offset;
+            int size;
+        };
+
+        InputStream* stream { nullptr };
+        int version { 0 };
+        std::map<String, Entry> entries;
+    };
+
+    // true if the stream is positioned on a binary container; the position is kept
+    static bool isBinary(InputStream& stream);
+
+    static MemoryBlock encode(const var& value);
+    static var decode(const void* data, size_t size);
+};
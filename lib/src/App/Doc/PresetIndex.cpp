@@ -0,0 +1,157 @@
+#include "PresetIndex.h"
+
+#include "Document.h"
+#include "PresetBinary.h"
+#include "PresetJson.h"
+#include "../../Thread/RealtimeWorkerPool.h"
+
+bool PresetIndex::load() {
+    entries.clear();
+    dirty = false;
+
+    std::unique_ptr<FileInputStream> stream(indexFile.createInputStream());
+    PresetBinary::Reader reader;
+
+    if (stream == nullptr || !reader.open(*stream) || int(reader.readSection("version")) != formatVersion) {
+        return false;
+    }
+
+    var presets = reader.readSection("presets");
+
+    if (auto* values = PresetJson::getArray(presets)) {
+        for (auto& value : *values) {
+            Entry entry;
+
+            entry.path           = PresetJson::stringProperty(value, "path");
+            entry.sizeBytes      = (int64) PresetJson::doubleProperty(value, "size");
+            entry.modifiedMillis = (int64) PresetJson::doubleProperty(value, "modified");
+            entry.createdMillis  = (int64) PresetJson::doubleProperty(value, "created");
+            entry.valid          = PresetJson::boolProperty(value, "valid");
+
+            if (entry.valid) {
+                (void) entry.details.readJSON(PresetJson::property(value, "details"));
+            }
+
+            if (entry.path.isNotEmpty()) {
+                entries[entry.path] = entry;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool PresetIndex::save() {
+    if (indexFile == File()) {
+        return false;
+    }
+
+    Array<var> presets;
+    presets.ensureStorageAllocated((int) entries.size());
+
+    for (auto& [path, entry] : entries) {
+        auto value = PresetJson::object();
+
+        value->setProperty("path",     path);
+        value->setProperty("size",     entry.sizeBytes);
+        value->setProperty("modified", entry.modifiedMillis);
+        value->setProperty("created",  entry.createdMillis);
+        value->setProperty("valid",    entry.valid);
+
+        if (entry.valid) {
+            value->setProperty("details", entry.details.writeJSON());
+        }
+
+        presets.add(PresetJson::toVar(value));
+    }
+
+    PresetBinary::Writer writer;
+    writer.addSection("version", formatVersion);
+    writer.addSection("presets", presets);
+
+    (void) indexFile.getParentDirectory().createDirectory();
+
+    // written beside the old index and swapped in, so a crash mid-save leaves a usable file
+    TemporaryFile temp(indexFile);
+    {
+        std::unique_ptr<FileOutputStream> stream(temp.getFile().createOutputStream());
+
+        if (stream == nullptr || !writer.write(*stream)) {
+            return false;
+        }
+    }
+
+    if (!temp.overwriteTargetFileWithTemporary()) {
+        return false;
+    }
+
+    dirty = false;
+    return true;
+}
+
+void PresetIndex::collect(const File& directory, const String& wildcard, Array<Entry>& current, Array<Entry>& stale) {
+    std::map<String, Entry> listed;
+
+    for (auto& child : RangedDirectoryIterator(directory, false, wildcard, File::findFiles)) {
+        Entry entry;
+
+        entry.path           = child.getFile().getFullPathName();
+        entry.sizeBytes      = child.getFileSize();
+        entry.modifiedMillis = child.getModificationTime().toMilliseconds();
+        entry.createdMillis  = child.getCreationTime().toMilliseconds();
+
+        auto it = entries.find(entry.path);
+
+        if (it != entries.end()
+                && it->second.sizeBytes == entry.sizeBytes
+                && it->second.modifiedMillis == entry.modifiedMillis) {
+            current.add(it->second);
+            listed[entry.path] = it->second;
+        } else {
+            stale.add(entry);
+        }
+    }
+
+    if (listed.size() != entries.size()) {
+        dirty = true;
+    }
+
+    entries.swap(listed);
+}
+
+void PresetIndex::readHeader(Entry& entry, int magicValue) {
+    File file(entry.path);
+    DocumentDetails& details = entry.details;
+
+    details.setDateMillis   (entry.createdMillis);
+    details.setFilename     (entry.path);
+    details.setName         (file.getFileNameWithoutExtension());
+    details.setRevision     (-1);
+    details.setSizeBytes    ((int) entry.sizeBytes);
+
+    std::unique_ptr<InputStream> stream(file.createInputStream());
+    entry.valid = Document::readHeader(stream.get(), details, magicValue);
+}
+
+void PresetIndex::readHeaders(Array<Entry>& entries, int magicValue, RealtimeWorkerPool* pool) {
+    if (pool == nullptr) {
+        for (auto& entry : entries) {
+            readHeader(entry, magicValue);
+        }
+
+        return;
+    }
+
+    for (int start = 0; start < entries.size(); start += RealtimeWorkerPool::maxJobCount) {
+        auto job = [&entries, magicValue, start](int index) {
+            readHeader(entries.getReference(start + index), magicValue);
+        };
+
+        pool->parallelFor(jmin((int) RealtimeWorkerPool::maxJobCount, entries.size() - start), job);
+    }
+}
+
+void PresetIndex::update(const Entry& entry) {
+    entries[entry.path] = entry;
+    dirty = true;
+}
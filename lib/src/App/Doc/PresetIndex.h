@@ -0,0 +1,55 @@
+#pragma once
+
+#include <map>
+#include "DocumentDetails.h"
+#include "JuceHeader.h"
+
+using namespace juce;
+
+class RealtimeWorkerPool;
+
+/*
+ * On-disk cache of preset header details, keyed by path and checked against
+ * each file's size and modification time, so a library scan only opens the
+ * files that changed since the index was last saved.
+ */
+class PresetIndex {
+public:
+    struct Entry {
+        String path;
+        int64 sizeBytes { 0 };
+        int64 modifiedMillis { 0 };
+        int64 createdMillis { 0 };
+        bool valid { false };
+        DocumentDetails details;
+    };
+
+    void setFile(const File& file)  { indexFile = file; }
+    const File& getFile() const     { return indexFile; }
+
+    bool load();
+    bool save();
+
+    /*
+     * Lists the directory, filling current with entries whose files are
+     * unchanged and stale with the ones that need their headers read. Files
+     * that are gone are dropped from the index.
+     */
+    void collect(const File& directory, const String& wildcard, Array<Entry>& current, Array<Entry>& stale);
+
+    // reads the header of each entry in place, spread over the pool when there is one
+    static void readHeaders(Array<Entry>& entries, int magicValue, RealtimeWorkerPool* pool);
+    static void readHeader(Entry& entry, int magicValue);
+
+    void update(const Entry& entry);
+
+    int size() const        { return (int) entries.size(); }
+    bool isDirty() const    { return dirty; }
+
+private:
+    static const int formatVersion = 1;
+
+    File indexFile;
+    std::map<String, Entry> entries;
+    bool dirty { false };
+};
@@ -1,27 +1,62 @@
+#include <algorithm>
+
 #include "DocumentLibrary.h"
 #include "AppConstants.h"
 #include "SingletonRepo.h"
 #include "Doc/Document.h"
 #include "../Definitions.h"
+#include "../Thread/RealtimeWorkerPool.h"
 #include "../Util/Util.h"
 
+namespace {
+    // small enough that the browser fills in steadily on a slow disk
+    const int scanBatchSize = 64;
+}
+
 DocumentLibrary::DocumentLibrary(SingletonRepo* repo) :
         SingletonAccessor   (repo, "DocumentLibrary")
-    ,   pendingPresetIndex  (NullPresetIndex)
     ,   currentPresetIndex  (NullPresetIndex)
-    ,   shouldOpenDefault   (formatSplit(false, true)) {
+    ,   shouldOpenDefault   (formatSplit(false, true))
+    ,   scanThread          (*this) {
+}
+
+DocumentLibrary::~DocumentLibrary() {
+    scanThread.stopThread(5000);
 }
 
 void DocumentLibrary::handleAsyncUpdate() {
-    load(pendingPresetIndex);
-    pendingPresetIndex = NullPresetIndex;
+    mergeScannedDocuments();
+
+    // the merge may have re-sorted allDocs, so the preset is found again by its path
+    if (pendingPresetPath.isNotEmpty()) {
+        load(indexOfPath(pendingPresetPath));
+        pendingPresetPath = {};
+    }
 }
 
 void DocumentLibrary::init() {
+    String settingsPath(getStrConstant(DocSettingsDir));
+
+    if (settingsPath.isNotEmpty()) {
+        indexCache.setFile(File(settingsPath).getSiblingFile("PresetIndex.bin"));
+        (void) indexCache.load();
+    }
+
     readDocuments(getStrConstant(DocumentsDir));
 }
 
+/*
+ * Unchanged files come straight from the index. The rest are read in the
+ * background and appended as they arrive, with listeners told of each batch.
+ */
 void DocumentLibrary::readDocuments(const String& dir) {
+    scanThread.stopThread(5000);
+
+    {
+        const ScopedLock sl(scannedLock);
+        scanned.clear();
+    }
+
     allDocs.clear();
 
     if (dir.isEmpty()) {
@@ -34,37 +69,149 @@ void DocumentLibrary::readDocuments(const String& dir) {
         return;
     }
 
-    Array<File> files;
-    directory.findChildFiles(files, File::findFiles, false, "*." + getStrConstant(DocumentExt),
-                             File::FollowSymlinks::no);
+    Array<PresetIndex::Entry> current, stale;
+    indexCache.collect(directory, "*." + getStrConstant(DocumentExt), current, stale);
+
+    for (auto& entry : current) {
+        if (entry.valid) {
+            addDocument(entry.details);
+        }
+    }
+
+    sortByPath();
+
+    if (!stale.isEmpty()) {
+        scanThread.start(stale, getConstant(DocMagicCode));
+    } else if (indexCache.isDirty()) {
+        (void) indexCache.save();
+    }
+}
+
+void DocumentLibrary::addDocument(const DocumentDetails& details) {
+    int code = details.getKey().hashCode();
 
-    for (auto& file : files) {
-        DocumentDetails details;
+    if (dismissedSet.find(code) != dismissedSet.end()) {
+        return;
+    }
 
-        int64 millis = file.getCreationTime().toMilliseconds();
+    allDocs.add(details);
 
-        details.setDateMillis   (millis);
-        details.setFilename     (file.getFullPathName());
-        details.setName         (file.getFileNameWithoutExtension());
-        details.setRevision     (-1);
-        details.setSizeBytes    ((int) file.getSize());
+    if (ratingsMap.contains(code)) {
+        allDocs.getReference(allDocs.size() - 1).setRating(ratingsMap[code]);
+    }
+}
 
-        std::unique_ptr<InputStream> stream(file.createInputStream());
+void DocumentLibrary::mergeScannedDocuments() {
+    Array<PresetIndex::Entry> entries;
+    bool finished = scanComplete.load();
 
-        if (Document::readHeader(stream.get(), details, getConstant(DocMagicCode))) {
-            int code = details.getKey().hashCode();
+    {
+        const ScopedLock sl(scannedLock);
+        entries.swapWith(scanned);
+    }
 
-            if (dismissedSet.find(code) != dismissedSet.end()) {
-                continue;
-            }
+    int firstIndex = allDocs.size();
 
-            if(ratingsMap.contains(code)) {
-                details.setRating(ratingsMap[code]);
-            }
+    for (auto& entry : entries) {
+        indexCache.update(entry);
 
-            allDocs.add(details);
+        if (entry.valid) {
+            addDocument(entry.details);
         }
     }
+
+    if (allDocs.size() > firstIndex) {
+        sortByPath();
+        listeners.call(&Listener::documentsAdded);
+    }
+
+    if (finished && scanComplete.exchange(false)) {
+        (void) indexCache.save();
+        listeners.call(&Listener::documentScanFinished);
+    }
+}
+
+/*
+ * Hosts address presets by program index, so the order must not depend on
+ * which files the index could vouch for or on when a scan batch landed.
+ */
+void DocumentLibrary::sortByPath() {
+    String currentPath;
+
+    if (isPositiveAndBelow(currentPresetIndex, allDocs.size())) {
+        currentPath = allDocs.getReference(currentPresetIndex).getFilename();
+    }
+
+    std::stable_sort(allDocs.begin(), allDocs.end(), [](const DocumentDetails& a, const DocumentDetails& b) {
+        return a.getFilename() < b.getFilename();
+    });
+
+    if (currentPath.isNotEmpty()) {
+        currentPresetIndex = indexOfPath(currentPath);
+    }
+}
+
+int DocumentLibrary::indexOfPath(const String& path) const {
+    for (int i = 0; i < allDocs.size(); ++i) {
+        if (allDocs.getReference(i).getFilename() == path) {
+            return i;
+        }
+    }
+
+    return NullPresetIndex;
+}
+
+bool DocumentLibrary::waitForScan(int timeoutMillis) {
+    if (!scanThread.waitForThreadToExit(timeoutMillis)) {
+        return false;
+    }
+
+    mergeScannedDocuments();
+
+    return true;
+}
+
+bool DocumentLibrary::isScanning() const {
+    const ScopedLock sl(scannedLock);
+    return scanThread.isThreadRunning() || !scanned.isEmpty();
+}
+
+DocumentLibrary::ScanThread::ScanThread(DocumentLibrary& library) :
+        Thread      ("PresetScan")
+    ,   library     (library)
+    ,   magicValue  (0) {
+}
+
+void DocumentLibrary::ScanThread::start(const Array<PresetIndex::Entry>& entries, int magic) {
+    toRead = entries;
+    magicValue = magic;
+    library.scanComplete = false;
+
+    startThread(Priority::low);
+}
+
+void DocumentLibrary::ScanThread::run() {
+    // reads mostly wait on the disk, so a few workers overlap them even on a small machine
+    RealtimeWorkerPool pool(jmin(3, RealtimeWorkerPool::defaultWorkerCount()), Priority::low);
+
+    for (int start = 0; start < toRead.size() && !threadShouldExit(); start += scanBatchSize) {
+        Array<PresetIndex::Entry> batch;
+        batch.addArray(toRead, start, scanBatchSize);
+
+        PresetIndex::readHeaders(batch, magicValue, &pool);
+
+        {
+            const ScopedLock sl(library.scannedLock);
+            library.scanned.addArray(batch);
+        }
+
+        library.triggerAsyncUpdate();
+    }
+
+    if (!threadShouldExit()) {
+        library.scanComplete = true;
+        library.triggerAsyncUpdate();
+    }
 }
 
 void DocumentLibrary::load(int index) {
@@ -78,8 +225,11 @@ void DocumentLibrary::load(int index) {
 }
 
 void DocumentLibrary::triggerAsyncLoad(int index) {
-    pendingPresetIndex = index;
-    triggerAsyncUpdate();
+    // the host's index refers to the list as it is now, not as it is once the next scan batch lands
+    if (isPositiveAndBelow(index, allDocs.size())) {
+        pendingPresetPath = allDocs.getReference(index).getFilename();
+        triggerAsyncUpdate();
+    }
 }
 
 String DocumentLibrary::getProgramName(int index) {
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <set>
 #include "Doc/DocumentDetails.h"
+#include "Doc/PresetIndex.h"
 #include "JuceHeader.h"
 #include "SingletonAccessor.h"
 
@@ -14,14 +16,29 @@ class DocumentLibrary :
 public:
     enum { NullPresetIndex = -1 };
 
+    class Listener {
+    public:
+        virtual ~Listener() = default;
+
+        // the background scan added documents, which may have moved others down the list
+        virtual void documentsAdded() = 0;
+        virtual void documentScanFinished() {}
+    };
+
     explicit DocumentLibrary(SingletonRepo*);
-    ~DocumentLibrary() override = default;
+    ~DocumentLibrary() override;
 
     void handleAsyncUpdate() override;
     void init() override;
     void load(int index);
     void readDocuments(const String& dir);
     void triggerAsyncLoad(int index);
+    void addListener(Listener* listener)    { listeners.add(listener);      }
+    void removeListener(Listener* listener) { listeners.remove(listener);   }
+
+    // blocks until the background scan is done and its documents are merged; message thread only
+    bool waitForScan(int timeoutMillis);
+    bool isScanning() const;
 
     void writeSettingsFile();
     bool readSettingsFile();
@@ -33,8 +50,38 @@ public:
     void setShouldOpenDefault(bool should)  { shouldOpenDefault = should;   }
 
 private:
+    /*
+     * Reads the headers the index could not vouch for, a batch at a time on a
+     * small worker pool, handing each batch to the message thread as it lands.
+     */
+    class ScanThread : public Thread {
+    public:
+        explicit ScanThread(DocumentLibrary& library);
+
+        void start(const Array<PresetIndex::Entry>& entries, int magicValue);
+        void run() override;
+
+    private:
+        DocumentLibrary& library;
+        Array<PresetIndex::Entry> toRead;
+        int magicValue;
+    };
+
+    void addDocument(const DocumentDetails& details);
+    void mergeScannedDocuments();
+    void sortByPath();
+    int indexOfPath(const String& path) const;
+
     bool settingsArePending, shouldOpenDefault;
-    int currentPresetIndex, pendingPresetIndex;
+    int currentPresetIndex;
+    String pendingPresetPath;
+
+    PresetIndex indexCache;
+    ScanThread scanThread;
+    CriticalSection scannedLock;
+    Array<PresetIndex::Entry> scanned;
+    std::atomic<bool> scanComplete { false };
+    ListenerList<Listener> listeners;
 
     Array<DocumentDetails> allDocs;
     HashMap<int, float> ratingsMap;
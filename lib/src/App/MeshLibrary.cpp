@@ -1,5 +1,7 @@
 #include "MeshLibrary.h"
 
+#include <algorithm>
+
 #include <Definitions.h>
 
 #include "Doc/PresetJson.h"
@@ -14,7 +16,9 @@ MeshLibrary::MeshLibrary(SingletonRepo* repo) :
         SingletonAccessor(repo, "MeshLibrary")
     ,   clipboardMesh()
     ,   dummyGroup(TypeMesh)
-    ,   dummyLayer() {
+    ,   dummyLayer()
+        // chained voices keep intercepts into the last copy for up to a cycle
+    ,   renderMeshes(std::make_shared<const RenderMeshes>(), std::chrono::seconds(1)) {
 }
 
 MeshLibrary::~MeshLibrary() {
@@ -83,6 +87,7 @@ void MeshLibrary::moveLayer(int groupId, int fromIndex, int toIndex) {
 
     LayerGroup& group = layerGroups[groupId];
     std::swap(group.layers[fromIndex], group.layers[toIndex]);
+    publishRenderMeshes();
 
     listeners.call(&Listener::layerChanged, groupId, toIndex);
     // todo does that work?
@@ -105,6 +110,7 @@ void MeshLibrary::addLayer(int groupId) {
     ScopedLock sl(arrayLock);
     group.layers.push_back(instantiateLayer(nullptr, group.meshType));
     effectiveMesh = group.previewMesh != nullptr ? group.previewMesh : group.getCurrentMesh();
+    publishRenderMeshes();
 
     int index = group.layers.size() - 1;
     listeners.call(&Listener::layerAdded, groupId, index);
@@ -124,6 +130,8 @@ void MeshLibrary::setCurrentMesh(int groupId, Mesh* mesh) {
         newEffectiveMesh = group.previewMesh != nullptr ? group.previewMesh : group.getCurrentMesh();
     }
 
+    publishRenderMeshes();
+
     if (oldEffectiveMesh != newEffectiveMesh) {
         notifyEffectiveMeshChanged(groupId, newEffectiveMesh);
     }
@@ -231,6 +239,7 @@ void MeshLibrary::pasteFromClipboardTo(Mesh* mesh, int type) {
 
     if (canPasteTo(type)) {
         mesh->deepCopy(sourceClipboardMesh);
+        publishRenderMeshes();
 
         // anything to change about guide curves here?
     } else {
@@ -249,10 +258,12 @@ bool MeshLibrary::removeLayerKeepingOne(int groupId, int layer) {
 
     if (group.layers.size() == 1) {
         group.layers.front() = instantiateLayer(nullptr, group.meshType);
+        publishRenderMeshes();
         return true;
     }
 
     group.layers.erase(group.layers.begin() + layer);
+    publishRenderMeshes();
 
     return false;
 }
@@ -349,6 +360,8 @@ bool MeshLibrary::readXML(const XmlElement* element) {
         }
     }
 
+    publishRenderMeshes();
+
     for (int i = 0; i < (int) layerGroups.size(); ++i) {
         listeners.call(&Listener::layerGroupAdded, i);
         notifyEffectiveMeshChanged(i, effectiveMeshes[i]);
@@ -436,6 +449,8 @@ bool MeshLibrary::readJSON(const var& object) {
         }
     }
 
+    publishRenderMeshes();
+
     for (int i = 0; i < (int) layerGroups.size(); ++i) {
         listeners.call(&Listener::layerGroupAdded, i);
         notifyEffectiveMeshChanged(i, effectiveMeshes[i]);
@@ -752,3 +767,114 @@ void MeshLibrary::updateAllSmoothedParamsToTarget(int voiceIndex) const {
         }
     }
 }
+
+void MeshLibrary::markAllMeshesEdited() {
+    for(auto& group : layerGroups) {
+        for(auto& layer : group.layers) {
+            if(layer.mesh) {
+                layer.mesh->markEdited();
+            }
+        }
+    }
+
+    publishRenderMeshes();
+}
+
+namespace {
+    std::shared_ptr<Mesh> copyForRendering(const Mesh& source) {
+        // a mesh doesn't free its elements on destruction
+        std::shared_ptr<Mesh> copy(new Mesh(source.getName()), [](Mesh* mesh) {
+            mesh->destroy();
+            delete mesh;
+        });
+
+        copy->deepCopy(&source);
+        return copy;
+    }
+
+    const MeshLibrary::RenderMeshes::Copy* findCopy(
+            const MeshLibrary::RenderMeshes& meshes,
+            int groupId,
+            uint64_t sourceRevision) {
+        if (! isPositiveAndBelow(groupId, (int) meshes.groups.size())) {
+            return nullptr;
+        }
+
+        for (const auto& copy : meshes.groups[groupId]) {
+            if (copy.mesh != nullptr && copy.sourceRevision == sourceRevision) {
+                return &copy;
+            }
+        }
+
+        return nullptr;
+    }
+}
+
+void MeshLibrary::publishRenderMeshes() {
+    std::shared_ptr<const RenderMeshes> previous = renderMeshes.latest();
+    auto next = std::make_shared<RenderMeshes>();
+    bool changed = previous->groups.size() != layerGroups.size();
+
+    {
+        ScopedLock sl(arrayLock);
+
+        next->groups.resize(layerGroups.size());
+
+        for (int groupId = 0; groupId < (int) layerGroups.size(); ++groupId) {
+            const LayerGroup& group = layerGroups[groupId];
+
+            if (group.meshType != TypeMesh) {
+                continue;
+            }
+
+            vector<RenderMeshes::Copy>& copies = next->groups[groupId];
+
+            for (const auto& layer : group.layers) {
+                RenderMeshes::Copy copy;
+
+                if (layer.mesh != nullptr) {
+                    // revisions are unique across meshes, so a match is this mesh, unedited
+                    copy.sourceRevision = layer.mesh->getRevision();
+
+                    if (const auto* existing = findCopy(*previous, groupId, copy.sourceRevision)) {
+                        copy.mesh = existing->mesh;
+                    } else {
+                        copy.mesh = copyForRendering(*layer.mesh);
+                    }
+                }
+
+                copies.push_back(copy);
+            }
+
+            if (! changed) {
+                const auto& before = previous->groups[groupId];
+
+                changed = before.size() != copies.size()
+                       || ! std::equal(before.begin(), before.end(), copies.begin(),
+                                       [](const RenderMeshes::Copy& a, const RenderMeshes::Copy& b) {
+                                           return a.mesh == b.mesh;
+                                       });
+            }
+        }
+    }
+
+    if (! changed) {
+        return;
+    }
+
+    listeners.call(&Listener::renderMeshesAboutToChange);
+    renderMeshes.publish(std::move(next));
+}
+
+Mesh* MeshLibrary::getRenderMesh(int group, int index) {
+    const RenderMeshes& meshes = renderMeshes.current();
+
+    if (isPositiveAndBelow(group, (int) meshes.groups.size())
+            && isPositiveAndBelow(index, (int) meshes.groups[group].size())) {
+        if (Mesh* mesh = meshes.groups[group][index].mesh.get()) {
+            return mesh;
+        }
+    }
+
+    return getMesh(group, index);
+}
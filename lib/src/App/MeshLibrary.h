@@ -1,10 +1,12 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <vector>
 #include "SingletonAccessor.h"
 #include "Doc/Savable.h"
 #include "../Obj/MorphPosition.h"
+#include "../Thread/SnapshotMailbox.h"
 #include "../Util/CommonEnums.h"
 
 using std::vector;
@@ -37,6 +39,9 @@ public:
         virtual void layerChanged(int layerGroup, int index) {}
         virtual void effectiveMeshChanged(int layerGroup, Mesh* mesh) {}
         virtual void instantiateLayer(XmlElement* layerElem, int meshType) {}
+
+        // called on the message thread before a changed set of render meshes goes out
+        virtual void renderMeshesAboutToChange() {}
     };
 
     /* ----------------------------------------------------------------------------- */
@@ -124,6 +129,21 @@ public:
         [[nodiscard]] bool isNotNull() const { return groupId != CommonEnums::Null && layerIdx != CommonEnums::Null; }
     };
 
+    /*
+     * Copies of the TypeMesh layers for the audio thread, republished after
+     * every edit and adopted once per block, so moving vertices never waits on
+     * the audio lock. A copy whose source revision hasn't moved is shared with
+     * the previous snapshot. Nothing edits a copy.
+     */
+    struct RenderMeshes {
+        struct Copy {
+            std::shared_ptr<Mesh> mesh;
+            uint64_t sourceRevision {};
+        };
+
+        vector<vector<Copy>> groups;
+    };
+
     struct GroupBindings {
         int scratch = CommonEnums::Null;
         int guideCurve = CommonEnums::Null;
@@ -199,6 +219,16 @@ public:
     void addListener(Listener* listener) { listeners.add(listener); }
     void updateSmoothedParameters(int voiceIndex, int numSamples44k) const;
     void updateAllSmoothedParamsToTarget(int voiceIndex) const;
+    void markAllMeshesEdited();
+
+    void publishRenderMeshes();
+    void adoptRenderMeshes() { renderMeshes.adopt(); }
+
+    // message thread; the copies stay valid for as long as the pointer is held
+    [[nodiscard]] std::shared_ptr<const RenderMeshes> latestRenderMeshes() const { return renderMeshes.latest(); }
+
+    // audio thread; falls back to the live mesh for a layer not yet published
+    [[nodiscard]] Mesh* getRenderMesh(int group, int index);
 
 protected:
     void notifyEffectiveMeshChanged(int groupId, Mesh* mesh);
@@ -211,4 +241,5 @@ protected:
     LayerGroup dummyGroup;
     vector<LayerGroup> layerGroups;
     ListenerList<Listener> listeners;
+    SnapshotMailbox<RenderMeshes> renderMeshes;
 };
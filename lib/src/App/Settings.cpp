@@ -45,6 +45,7 @@ void Settings::initialiseSettings() {
 
     addSetting(CurrentMorphAxis,        Vertex::Time);
     addSetting(CollisionDetection,      true);
+    addSetting(CompactPresets,          false);
     addSetting(DrawScales,              true);
     addSetting(FirstLaunch,             true);
     addSetting(IgnoringEditMessages,    false);
@@ -28,6 +28,7 @@ namespace AppSettings {
     ,   CollisionDetection
     ,   ProbeEditRefreshPolicy
     ,   PreviewVoiceLengthMilliseconds
+    ,   CompactPresets
 
     ,   numSettings
     };
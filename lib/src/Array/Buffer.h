@@ -15,7 +15,7 @@ using namespace juce;
     using Float64 = Ipp64f;
     using Complex32 = Ipp32fc;
     using Complex64 = Ipp64fc;
-  #elif defined(USE_ACCELERATE)
+  #elif defined(USE_ACCELERATE) || defined(USE_PORTABLE_SIMD)
     #define perfSplit(X, Y) Y
     #include <cstdint>
     #include <complex>
@@ -0,0 +1,534 @@
+#include "ScopedAlloc.h"
+#ifdef USE_PORTABLE_SIMD
+
+#include "Buffer.h"
+#include "ArrayDefs.h"
+#include "SimdKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <random>
+
+#define ERROR_COUNTER globalBufferPortableSizeErrorCount
+
+int globalBufferPortableSizeErrorCount = 0;
+
+// Float32 goes through the SIMD kernel table; the other types are plain loops,
+// which the compiler vectorizes well enough for how rarely they're used.
+#define KERNELS SimdKernels::get()
+
+#define declareForAll(T) \
+    T(Int8u)   \
+    T(Int8s)   \
+    T(Int16s)  \
+    T(Int32s)  \
+    T(Float32) \
+    T(Float64) \
+    T(Complex32)
+
+#define declareForReal(T) \
+    T(Float32) \
+    T(Float64)
+
+#define constructCopyTo(T)                       \
+    template<>                                   \
+    void Buffer<T>::copyTo(Buffer buff) const {  \
+        if(sz > 0 && buff.sz > 0)                \
+            std::memmove(buff.get(), ptr, jmin(sz, buff.sz) * sizeof(T)); \
+    }
+
+#define constructZero(T)                         \
+    template<>                                   \
+    Buffer<T>& Buffer<T>::zero() {               \
+        EMPTY_CHECK                              \
+        std::fill_n(ptr, sz, T());               \
+        return *this;                            \
+    }
+
+#define constructZeroSz(T)                       \
+    template<>                                   \
+    Buffer<T>& Buffer<T>::zero(int size) {       \
+        SIZE_CHECK                               \
+        jassert(size <= sz);                     \
+        std::fill_n(ptr, size, T());             \
+        return *this;                            \
+    }
+
+#define constructSet(T)                          \
+    template<>                                   \
+    Buffer<T>& Buffer<T>::set(T c) {             \
+        std::fill_n(ptr, sz, c);                 \
+        return *this;                            \
+    }
+
+#define constructWithPhase(T)                    \
+    template<>                                   \
+    Buffer<T>& Buffer<T>::withPhase(int phase, Buffer workBuffer) { \
+        jassert(phase >= 0);                     \
+        if(phase == 0 || sz == 0)                \
+            return *this;                        \
+        phase = phase % sz;                      \
+        section(phase, sz - phase).copyTo(workBuffer); \
+        copyTo(workBuffer.section(sz - phase, phase)); \
+        workBuffer.copyTo(*this);                \
+        return *this;                            \
+    }
+
+declareForAll(constructCopyTo)
+declareForAll(constructZero)
+declareForAll(constructZeroSz)
+declareForAll(constructSet)
+declareForAll(constructWithPhase)
+
+// ptr[i] = fn(ptr[i])
+#define defineLoop(name, type, expr)             \
+    template<> Buffer<type>& Buffer<type>::name() { \
+        for(int i = 0; i < sz; ++i) {            \
+            type x = ptr[i];                     \
+            ptr[i] = (expr);                     \
+        }                                        \
+        return *this;                            \
+    }
+
+#define defineLoop_Real(name, expr)              \
+    defineLoop(name, Float32, expr)              \
+    defineLoop(name, Float64, expr)
+
+defineLoop_Real(exp,  std::exp(x))
+defineLoop_Real(tanh, std::tanh(x))
+defineLoop_Real(sin,  std::sin(x))
+defineLoop_Real(ln,   std::log(x))
+defineLoop_Real(inv,  1 / x)
+defineLoop(abs,  Float64, std::abs(x))
+defineLoop(sqr,  Float64, x * x)
+defineLoop(sqrt, Float64, std::sqrt(x))
+
+template<> Buffer<Float32>& Buffer<Float32>::abs()  { KERNELS.abs(ptr, ptr, sz);  return *this; }
+template<> Buffer<Float32>& Buffer<Float32>::sqr()  { KERNELS.sqr(ptr, ptr, sz);  return *this; }
+template<> Buffer<Float32>& Buffer<Float32>::sqrt() { KERNELS.sqrt(ptr, ptr, sz); return *this; }
+
+template<> Buffer<Float32>& Buffer<Float32>::flip() { std::reverse(ptr, ptr + sz); return *this; }
+template<> Buffer<Float64>& Buffer<Float64>::flip() { std::reverse(ptr, ptr + sz); return *this; }
+
+template<> Buffer<Float32>& Buffer<Float32>::add(Float32 c) { NULL_ARG_CHECK KERNELS.addC(ptr, c, ptr, sz); return *this; }
+template<> Buffer<Float32>& Buffer<Float32>::mul(Float32 c) { UNO_ARG_CHECK  KERNELS.mulC(ptr, c, ptr, sz); return *this; }
+template<> Buffer<Float64>& Buffer<Float64>::add(Float64 c) { NULL_ARG_CHECK for(int i = 0; i < sz; ++i) ptr[i] += c; return *this; }
+template<> Buffer<Float64>& Buffer<Float64>::mul(Float64 c) { UNO_ARG_CHECK  for(int i = 0; i < sz; ++i) ptr[i] *= c; return *this; }
+template<> Buffer<Int16s>& Buffer<Int16s>::mul(Int16s c) {
+    if (ptr == nullptr || c == 1) {
+        return *this;
+    }
+
+    for (int i = 0; i < sz; ++i) {
+        ptr[i] = (Int16s) ((int) ptr[i] * (int) c);
+    }
+
+    return *this;
+}
+template<> Buffer<Float32>& Buffer<Float32>::sub(Float32 c) { return add(-c); }
+template<> Buffer<Float64>& Buffer<Float64>::sub(Float64 c) { return add(-c); }
+template<> Buffer<Float32>& Buffer<Float32>::div(Float32 c) { NULL_ARG_CHECK return mul(1.0f / c); }
+template<> Buffer<Float64>& Buffer<Float64>::div(Float64 c) { NULL_ARG_CHECK return mul(1.0 / c);  }
+template<> Buffer<Float32>& Buffer<Float32>::pow(Float32 c) { UNO_ARG_CHECK for(int i = 0; i < sz; ++i) ptr[i] = std::pow(ptr[i], c); return *this; }
+template<> Buffer<Float64>& Buffer<Float64>::pow(Float64 c) { UNO_ARG_CHECK for(int i = 0; i < sz; ++i) ptr[i] = std::pow(ptr[i], c); return *this; }
+
+// ptr[i] = ptr[i] op buff[i], over the shorter of the two
+#define defineKernelBuffOp(name)                 \
+    template<> Buffer<Float32>& Buffer<Float32>::name(Buffer<Float32> buff) { \
+        KERNELS.name(ptr, buff.get(), ptr, jmin(sz, buff.sz)); \
+        return *this;                            \
+    }
+
+#define defineLoopBuffOp(name, type, op)         \
+    template<> Buffer<type>& Buffer<type>::name(Buffer<type> buff) { \
+        const int size = jmin(sz, buff.sz);      \
+        for(int i = 0; i < size; ++i)            \
+            ptr[i] op buff.ptr[i];               \
+        return *this;                            \
+    }
+
+#define defineLoopConstOp(name, type, op)        \
+    template<> Buffer<type>& Buffer<type>::name(type c) { \
+        for(int i = 0; i < sz; ++i)              \
+            ptr[i] op c;                         \
+        return *this;                            \
+    }
+
+#define defineAddSubMulDivOps(T)                 \
+    T(add, +=)                                   \
+    T(sub, -=)                                   \
+    T(mul, *=)                                   \
+    T(div, /=)
+
+#define defineF64BuffOp(name, op)   defineLoopBuffOp(name, Float64, op)
+#define defineCplxBuffOp(name, op)  defineLoopBuffOp(name, Complex32, op)
+#define defineCplxConstOp(name, op) defineLoopConstOp(name, Complex32, op)
+
+defineKernelBuffOp(add)
+defineKernelBuffOp(sub)
+defineKernelBuffOp(mul)
+defineKernelBuffOp(div)
+defineAddSubMulDivOps(defineF64BuffOp)
+defineAddSubMulDivOps(defineCplxBuffOp)
+defineAddSubMulDivOps(defineCplxConstOp)
+
+// statistics
+
+template<> Float32 Buffer<Float32>::sum()  const { return KERNELS.sum(ptr, sz); }
+template<> Float32 Buffer<Float32>::mean() const { EMPTY_CHECK_ZERO return sum() / Float32(sz); }
+template<> Float32 Buffer<Float32>::min()  const { EMPTY_CHECK_ZERO return KERNELS.min(ptr, sz); }
+template<> Float32 Buffer<Float32>::max()  const { EMPTY_CHECK_ZERO return KERNELS.max(ptr, sz); }
+
+template<> Float64 Buffer<Float64>::sum()  const { return std::accumulate(ptr, ptr + sz, Float64()); }
+template<> Float64 Buffer<Float64>::mean() const { EMPTY_CHECK_ZERO return sum() / Float64(sz); }
+template<> Float64 Buffer<Float64>::min()  const { EMPTY_CHECK_ZERO return *std::min_element(ptr, ptr + sz); }
+template<> Float64 Buffer<Float64>::max()  const { EMPTY_CHECK_ZERO return *std::max_element(ptr, ptr + sz); }
+
+template<> Buffer<Float32>& Buffer<Float32>::sort() { std::sort(ptr, ptr + sz); return *this; }
+template<> Buffer<Float64>& Buffer<Float64>::sort() { std::sort(ptr, ptr + sz); return *this; }
+
+template<>
+void Buffer<Float32>::minmax(Float32& pMin, Float32& pMax) const {
+    if(sz == 0) {
+        pMin = 0;
+        pMax = 0;
+        return;
+    }
+
+    pMin = KERNELS.min(ptr, sz);
+    pMax = KERNELS.max(ptr, sz);
+}
+
+template<>
+void Buffer<Float32>::getMin(Float32& pMin, int& index) const {
+    index = sz == 0 ? 0 : int(std::min_element(ptr, ptr + sz) - ptr);
+    pMin  = sz == 0 ? 0 : ptr[index];
+}
+
+template<>
+void Buffer<Float32>::getMax(Float32& pMax, int& index) const {
+    index = sz == 0 ? 0 : int(std::max_element(ptr, ptr + sz) - ptr);
+    pMax  = sz == 0 ? 0 : ptr[index];
+}
+
+template<> Float32 Buffer<Float32>::dot(Buffer buff) const { return KERNELS.dot(ptr, buff.get(), jmin(sz, buff.sz)); }
+template<> Float64 Buffer<Float64>::dot(Buffer buff) const {
+    return std::inner_product(ptr, ptr + jmin(sz, buff.sz), buff.get(), Float64());
+}
+
+template<> Float32 Buffer<Float32>::normL1() const { return KERNELS.sumAbs(ptr, sz); }
+template<> Float64 Buffer<Float64>::normL1() const {
+    Float64 sum = 0;
+    for (int i = 0; i < sz; ++i) {
+        sum += std::abs(ptr[i]);
+    }
+    return sum;
+}
+template<> Float32 Buffer<Float32>::normL2() const { return std::sqrt(KERNELS.dot(ptr, ptr, sz)); }
+template<> Float64 Buffer<Float64>::normL2() const { return std::sqrt(dot(*this)); }
+
+template<> Float32 Buffer<Float32>::normDiffL2(Buffer buff) const {
+    return std::sqrt(KERNELS.distanceSq(ptr, buff.get(), jmin(sz, buff.sz)));
+}
+
+template<> Float64 Buffer<Float64>::normDiffL2(Buffer buff) const {
+    Float64 sum = 0;
+    for (int i = 0; i < jmin(sz, buff.sz); ++i) {
+        sum += (ptr[i] - buff.ptr[i]) * (ptr[i] - buff.ptr[i]);
+    }
+    return std::sqrt(sum);
+}
+
+#define constructStddev(T)                       \
+    template<> T Buffer<T>::stddev() const {     \
+        if(sz < 2) return 0;                     \
+        const T meanVal = mean();                \
+        T variance = 0;                          \
+        for(int i = 0; i < sz; ++i)              \
+            variance += (ptr[i] - meanVal) * (ptr[i] - meanVal); \
+        return std::sqrt(variance / T(sz - 1));  \
+    }
+
+declareForReal(constructStddev)
+
+template<>
+bool Buffer<Float32>::isProbablyEmpty() const {
+    if(sz == 0)
+        return true;
+
+    bool isEmpty = ptr[sz - 1] == 0;
+    int size      = sz / 2;
+
+    while (isEmpty && size > 0) {
+        isEmpty &= ptr[size] == 0;
+        size >>= 1;
+    }
+
+    return isEmpty;
+}
+
+// Add product
+
+template<>
+Buffer<Float32>& Buffer<Float32>::addProduct(Buffer src1, Buffer src2) {
+    KERNELS.addProduct(src1.get(), src2.get(), ptr, jmin(sz, src1.sz, src2.sz));
+    return *this;
+}
+
+template<>
+Buffer<Float32>& Buffer<Float32>::addProduct(Buffer src, Float32 k) {
+    if(sz == 0 || k == 0.f)
+        return *this;
+    KERNELS.addProductC(src.get(), k, ptr, jmin(sz, src.sz));
+    return *this;
+}
+
+#define constructAddProduct(T)                   \
+    template<>                                   \
+    Buffer<T>& Buffer<T>::addProduct(Buffer src1, Buffer src2) { \
+        const int size = jmin(sz, src1.sz, src2.sz); \
+        for(int i = 0; i < size; ++i)            \
+            ptr[i] += src1.ptr[i] * src2.ptr[i]; \
+        return *this;                            \
+    }                                            \
+                                                 \
+    template<>                                   \
+    Buffer<T>& Buffer<T>::addProduct(Buffer src, T k) { \
+        const int size = jmin(sz, src.sz);       \
+        for(int i = 0; i < size; ++i)            \
+            ptr[i] += src.ptr[i] * k;            \
+        return *this;                            \
+    }
+
+constructAddProduct(Float64)
+constructAddProduct(Complex32)
+
+// c - a[i]
+template<> Buffer<Float32>& Buffer<Float32>::subCRev(Float32 c) { KERNELS.mulC(ptr, -1.f, ptr, sz); return add(c); }
+template<> Buffer<Float64>& Buffer<Float64>::subCRev(Float64 c) { for(int i = 0; i < sz; ++i) ptr[i] = c - ptr[i]; return *this; }
+
+// c / a[i]
+#define constructDivCRev(T)                      \
+    template<> Buffer<T>& Buffer<T>::divCRev(T c) { \
+        EMPTY_CHECK                              \
+        if(c == 0) return zero();                \
+        for(int i = 0; i < sz; ++i)              \
+            ptr[i] = c / ptr[i];                 \
+        return *this;                            \
+    }
+
+// c ** a[i]
+#define constructPowCRev(T)                      \
+    template<> Buffer<T>& Buffer<T>::powCRev(T k) { \
+        EMPTY_CHECK                              \
+        if(k == 1) return *this;                 \
+        const T c = std::log(k);                 \
+        for(int i = 0; i < sz; ++i)              \
+            ptr[i] = std::exp(c * ptr[i]);       \
+        return *this;                            \
+    }
+
+declareForReal(constructDivCRev)
+declareForReal(constructPowCRev)
+
+// vector ramp
+
+#define constructRamp(T)                         \
+    template<> Buffer<T>& Buffer<T>::ramp(T offset, T delta) { \
+        for(int i = 0; i < sz; ++i)              \
+            ptr[i] = offset + T(i) * delta;      \
+        return *this;                            \
+    }                                            \
+                                                 \
+    template<> Buffer<T>& Buffer<T>::ramp() {    \
+        if(sz > 1)                               \
+            return ramp(T(0), T(1) / T(sz - 1)); \
+        return *this;                            \
+    }
+
+#define constructSinInit(T) \
+    template<> \
+    Buffer<T>& Buffer<T>::sin(float relFreq, float unitPhase) { \
+        if(sz == 0) return *this; \
+        return ramp( \
+            static_cast<T>(unitPhase * 2 * M_PI), \
+            static_cast<T>(relFreq * 2 * M_PI) \
+        ).sin(); \
+    }
+
+declareForReal(constructRamp)
+declareForReal(constructSinInit)
+
+// windows, with the end points of a symmetric window
+
+#define constructWindows(T)                      \
+    template<> Buffer<T>& Buffer<T>::hann() {    \
+        EMPTY_CHECK                              \
+        if(sz == 1) { ptr[0] = 1; return *this; } \
+        const double step = 2.0 * M_PI / double(sz - 1); \
+        for(int i = 0; i < sz; ++i)              \
+            ptr[i] = T(0.5 - 0.5 * std::cos(step * i)); \
+        return *this;                            \
+    }                                            \
+                                                 \
+    template<> Buffer<T>& Buffer<T>::blackman() { \
+        EMPTY_CHECK                              \
+        if(sz == 1) { ptr[0] = 1; return *this; } \
+        const double step = 2.0 * M_PI / double(sz - 1); \
+        for(int i = 0; i < sz; ++i)              \
+            ptr[i] = T(0.42 - 0.5 * std::cos(step * i) + 0.08 * std::cos(2 * step * i)); \
+        return *this;                            \
+    }
+
+declareForReal(constructWindows)
+
+// Threshold operations
+
+template<> Buffer<Float32>& Buffer<Float32>::clip(Float32 low, Float32 high) { KERNELS.clip(ptr, low, high, ptr, sz); return *this; }
+template<> Buffer<Float32>& Buffer<Float32>::threshLT(Float32 c) { KERNELS.clip(ptr, c, INFINITY, ptr, sz); return *this; }
+template<> Buffer<Float32>& Buffer<Float32>::threshGT(Float32 c) { KERNELS.clip(ptr, -INFINITY, c, ptr, sz); return *this; }
+
+template<> Buffer<Float64>& Buffer<Float64>::clip(Float64 low, Float64 high) {
+    for(int i = 0; i < sz; ++i) ptr[i] = jlimit(low, high, ptr[i]);
+    return *this;
+}
+template<> Buffer<Float64>& Buffer<Float64>::threshLT(Float64 c) { for(int i = 0; i < sz; ++i) ptr[i] = jmax(c, ptr[i]); return *this; }
+template<> Buffer<Float64>& Buffer<Float64>::threshGT(Float64 c) { for(int i = 0; i < sz; ++i) ptr[i] = jmin(c, ptr[i]); return *this; }
+
+template<> Buffer<Complex32>& Buffer<Complex32>::threshLT(Complex32 c) {
+    // same as IPP: entries whose magnitude is below the threshold take its real part as their magnitude
+    const float thresh = c.real();
+    for (int i = 0; i < sz; ++i) {
+        const float magnitude = std::abs(ptr[i]);
+        if (magnitude < thresh) {
+            ptr[i] = magnitude > 0 ? ptr[i] * (thresh / magnitude) : Complex32(thresh, 0);
+        }
+    }
+    return *this;
+}
+
+template<>
+Buffer<Float32>& Buffer<Float32>::rand(unsigned& seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<Float32> dist(0, 1);
+    for (int i = 0; i < sz; i++) {
+        ptr[i] = dist(gen);
+    }
+    seed = gen();
+    return *this;
+}
+
+template <>
+int Buffer<Float32>::upsampleFrom(Buffer<Float32> buff, int factor, int phase) {
+    if (sz == 0 || buff.empty())
+        return 0;
+    if (factor < 0)
+        factor = sz / buff.size();
+    if (factor == 1) {
+        buff.copyTo(*this);
+        return 0;
+    }
+
+    const int srcLen = buff.size();
+    const int dstLen = srcLen * factor;
+    if(dstLen > sz) {
+        ++ERROR_COUNTER;
+        return 0;
+    }
+
+    // pDst[factor * n + phase] = pSrc[n], as ippsSampleUp does
+    std::memset(ptr, 0, dstLen * sizeof(Float32));
+    for (int i = 0; i < srcLen; ++i) {
+        ptr[factor * i + phase] = buff[i];
+    }
+
+    return phase;
+}
+
+template <>
+int Buffer<Float32>::downsampleFrom(Buffer<Float32> buff, int factor, int phase) {
+    if (sz == 0 || buff.empty())
+        return 0;
+    if (factor < 0)
+        factor = buff.size() / sz;
+    if (factor == 1) {
+        buff.copyTo(*this);
+        return 0;
+    }
+
+    const int srcLen = buff.size();
+    phase = phase % factor;
+
+    if (phase < 0) {
+        phase += factor;
+    }
+
+    const int dstLen = phase < srcLen ? jmin(sz, (srcLen + factor - 1 - phase) / factor) : 0;
+
+    for (int i = 0; i < dstLen; ++i) {
+        ptr[i] = buff[phase + i * factor];
+    }
+
+    return (factor + phase - srcLen % factor) % factor;
+}
+
+#define implementOperators(T)                                  \
+template<>                                                     \
+void Buffer<T>::operator+=(const Buffer<T>& other) { \
+    add(other);                                                \
+}                                                              \
+                                                               \
+template<>                                                     \
+void Buffer<T>::operator+=(T val) {                  \
+    add(val);                                                  \
+}                                                              \
+                                                               \
+template<>                                                     \
+void Buffer<T>::operator-=(const Buffer<T>& other) { \
+    sub(other);                                                \
+}                                                              \
+                                                               \
+template<>                                                     \
+void Buffer<T>::operator-=(T val) {                  \
+    sub(val);                                                  \
+}                                                              \
+                                                               \
+template<>                                                     \
+void Buffer<T>::operator*=(const Buffer<T>& other) { \
+    mul(other);                                                \
+}                                                              \
+                                                               \
+template<>                                                     \
+void Buffer<T>::operator*=(T val) {                  \
+    mul(val);                                                  \
+}                                                              \
+                                                               \
+template<>                                                     \
+void Buffer<T>::operator/=(const Buffer<T>& other) { \
+    div(other);                                                \
+}                                                              \
+                                                               \
+template<>                                                     \
+void Buffer<T>::operator/=(T val) {                  \
+    div(val);                                                  \
+}                                                              \
+                                                               \
+template<>                                                     \
+void Buffer<T>::operator<<(const Buffer<T>& other) { \
+    other.copyTo(*this);                                       \
+}                                                              \
+                                                               \
+template<>                                                     \
+void Buffer<T>::operator>>(Buffer<T> other) const {  \
+    copyTo(other);                                             \
+}
+
+implementOperators(Float32)
+implementOperators(Float64)
+
+defineAudioBufferConstructor(Float32)
+defineAudioBufferConstructor(Float64)
+
+#endif // USE_PORTABLE_SIMD
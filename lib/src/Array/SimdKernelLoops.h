@@ -0,0 +1,417 @@
+#pragma once
+
+#include "SimdKernels.h"
+
+#include <math.h>
+#include <type_traits>
+
+/*
+ * The loop bodies shared by every SimdKernels table, written once against a
+ * small vector-ops traits type:
+ *
+ *   V, width, load, store, set1, add, sub, mul, div, min, max, abs, sqrt,
+ *   madd(a, b, c) = a * b + c, and horizontal hsum, hmin, hmax.
+ *
+ * Kernels that run independent channels side by side use Ops::Quad instead, a
+ * four-lane type with load, store, set1, add, sub, mul and madd, whatever the
+ * table's own width. Ops::DoubleQuad is the same in double precision, with load,
+ * store, sub, mul and madd, plus interleave and deinterleave, which move four
+ * samples of four channels in and out of four frames.
+ *
+ * Only include this from the SimdKernels units. Everything here has internal
+ * linkage on purpose: the AVX2 unit is compiled with different code generation
+ * flags, and sharing inline definitions with it would let the linker pick the
+ * AVX2 copy for callers that run on CPUs without it. For the same reason the
+ * loops call only intrinsics and C library functions, never a std:: inline
+ * like std::sqrt(float) or numeric_limits::infinity(): unoptimised builds emit
+ * those as weak symbols shared by every unit.
+ */
+namespace {
+namespace SimdLoops {
+    struct ScalarQuadOps {
+        struct V { float x[4]; };
+        static constexpr int width = 4;
+
+        template<class Fn> static V map(V a, V b, Fn fn) {
+            return { { fn(a.x[0], b.x[0]), fn(a.x[1], b.x[1]), fn(a.x[2], b.x[2]), fn(a.x[3], b.x[3]) } };
+        }
+
+        static V load(const float* p)           { return { { p[0], p[1], p[2], p[3] } }; }
+        static void store(float* p, V v)        { for (int i = 0; i < 4; ++i) { p[i] = v.x[i]; } }
+        static V set1(float c)                  { return { { c, c, c, c } }; }
+        static V add(V a, V b)                  { return map(a, b, [](float x, float y) { return x + y; }); }
+        static V sub(V a, V b)                  { return map(a, b, [](float x, float y) { return x - y; }); }
+        static V mul(V a, V b)                  { return map(a, b, [](float x, float y) { return x * y; }); }
+        static V madd(V a, V b, V c)            { return add(mul(a, b), c); }
+    };
+
+    struct ScalarDoubleQuadOps {
+        struct V { double x[4]; };
+
+        template<class Fn> static V map(V a, V b, Fn fn) {
+            return { { fn(a.x[0], b.x[0]), fn(a.x[1], b.x[1]), fn(a.x[2], b.x[2]), fn(a.x[3], b.x[3]) } };
+        }
+
+        static V load(const double* p)          { return { { p[0], p[1], p[2], p[3] } }; }
+        static void store(double* p, V v)       { for (int i = 0; i < 4; ++i) { p[i] = v.x[i]; } }
+        static V sub(V a, V b)                  { return map(a, b, [](double x, double y) { return x - y; }); }
+        static V mul(V a, V b)                  { return map(a, b, [](double x, double y) { return x * y; }); }
+        static V madd(V a, V b, V c)            { return map(mul(a, b), c, [](double x, double y) { return x + y; }); }
+
+        static void interleave(const float* const* lanes, int i, double* frames) {
+            for (int frame = 0; frame < 4; ++frame) {
+                for (int lane = 0; lane < 4; ++lane) {
+                    frames[4 * frame + lane] = lanes[lane][i + frame];
+                }
+            }
+        }
+
+        static void deinterleave(const double* frames, float* const* lanes, int i) {
+            for (int frame = 0; frame < 4; ++frame) {
+                for (int lane = 0; lane < 4; ++lane) {
+                    lanes[lane][i + frame] = (float) frames[4 * frame + lane];
+                }
+            }
+        }
+    };
+
+    struct ScalarOps {
+        using V = float;
+        using Quad = ScalarQuadOps;
+        using DoubleQuad = ScalarDoubleQuadOps;
+        static constexpr int width = 1;
+
+        static V load(const float* p)           { return *p; }
+        static void store(float* p, V v)        { *p = v; }
+        static V set1(float c)                  { return c; }
+        static V add(V a, V b)                  { return a + b; }
+        static V sub(V a, V b)                  { return a - b; }
+        static V mul(V a, V b)                  { return a * b; }
+        static V div(V a, V b)                  { return a / b; }
+        static V min(V a, V b)                  { return b < a ? b : a; }
+        static V max(V a, V b)                  { return a < b ? b : a; }
+        static V abs(V a)                       { return fabsf(a); }
+        static V sqrt(V a)                      { return sqrtf(a); }
+        static V madd(V a, V b, V c)            { return a * b + c; }
+        static float hsum(V a)                  { return a; }
+        static float hmin(V a)                  { return a; }
+        static float hmax(V a)                  { return a; }
+    };
+
+    // one vector op over the full-width part, the scalar op over the tail
+    template<class Ops, class VecFn, class ScalarFn>
+    void mapUnary(const float* src, float* dst, int n, VecFn vecFn, ScalarFn scalarFn) {
+        int i = 0;
+        for (; i + Ops::width <= n; i += Ops::width) {
+            Ops::store(dst + i, vecFn(Ops::load(src + i)));
+        }
+        for (; i < n; ++i) {
+            dst[i] = scalarFn(src[i]);
+        }
+    }
+
+    template<class Ops, class VecFn, class ScalarFn>
+    void mapBinary(const float* a, const float* b, float* dst, int n, VecFn vecFn, ScalarFn scalarFn) {
+        int i = 0;
+        for (; i + Ops::width <= n; i += Ops::width) {
+            Ops::store(dst + i, vecFn(Ops::load(a + i), Ops::load(b + i)));
+        }
+        for (; i < n; ++i) {
+            dst[i] = scalarFn(a[i], b[i]);
+        }
+    }
+
+    /*
+     * Reductions keep four independent accumulators so the loop isn't bound by
+     * the latency of a single add chain.
+     */
+    template<class Ops, class Accumulate, class Merge, class Horizontal, class ScalarAccumulate>
+    float reduce(const float* a, const float* b, int n, float identity, Accumulate accumulate,
+                 Merge merge, Horizontal horizontal, ScalarAccumulate scalarAccumulate) {
+        using V = typename Ops::V;
+        constexpr int w = Ops::width;
+
+        V acc0 = Ops::set1(identity), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+        int i = 0;
+
+        for (; i + 4 * w <= n; i += 4 * w) {
+            acc0 = accumulate(acc0, a + i,         b == nullptr ? nullptr : b + i);
+            acc1 = accumulate(acc1, a + i + w,     b == nullptr ? nullptr : b + i + w);
+            acc2 = accumulate(acc2, a + i + 2 * w, b == nullptr ? nullptr : b + i + 2 * w);
+            acc3 = accumulate(acc3, a + i + 3 * w, b == nullptr ? nullptr : b + i + 3 * w);
+        }
+        for (; i + w <= n; i += w) {
+            acc0 = accumulate(acc0, a + i, b == nullptr ? nullptr : b + i);
+        }
+
+        float result = horizontal(merge(merge(acc0, acc1), merge(acc2, acc3)));
+        for (; i < n; ++i) {
+            result = scalarAccumulate(result, a[i], b == nullptr ? 0.f : b[i]);
+        }
+
+        return result;
+    }
+
+    template<class Ops> void add(const float* a, const float* b, float* dst, int n) {
+        mapBinary<Ops>(a, b, dst, n, Ops::add, [](float x, float y) { return x + y; });
+    }
+
+    template<class Ops> void sub(const float* a, const float* b, float* dst, int n) {
+        mapBinary<Ops>(a, b, dst, n, Ops::sub, [](float x, float y) { return x - y; });
+    }
+
+    template<class Ops> void mul(const float* a, const float* b, float* dst, int n) {
+        mapBinary<Ops>(a, b, dst, n, Ops::mul, [](float x, float y) { return x * y; });
+    }
+
+    template<class Ops> void div(const float* a, const float* b, float* dst, int n) {
+        mapBinary<Ops>(a, b, dst, n, Ops::div, [](float x, float y) { return x / y; });
+    }
+
+    template<class Ops> void addC(const float* src, float c, float* dst, int n) {
+        const auto k = Ops::set1(c);
+        mapUnary<Ops>(src, dst, n, [k](auto x) { return Ops::add(x, k); }, [c](float x) { return x + c; });
+    }
+
+    template<class Ops> void mulC(const float* src, float c, float* dst, int n) {
+        const auto k = Ops::set1(c);
+        mapUnary<Ops>(src, dst, n, [k](auto x) { return Ops::mul(x, k); }, [c](float x) { return x * c; });
+    }
+
+    template<class Ops> void addProductC(const float* src, float c, float* dst, int n) {
+        const auto k = Ops::set1(c);
+        mapBinary<Ops>(src, dst, dst, n,
+                [k](auto x, auto d) { return Ops::madd(x, k, d); },
+                [c](float x, float d) { return x * c + d; });
+    }
+
+    template<class Ops> void addProduct(const float* a, const float* b, float* dst, int n) {
+        int i = 0;
+        for (; i + Ops::width <= n; i += Ops::width) {
+            Ops::store(dst + i, Ops::madd(Ops::load(a + i), Ops::load(b + i), Ops::load(dst + i)));
+        }
+        for (; i < n; ++i) {
+            dst[i] += a[i] * b[i];
+        }
+    }
+
+    template<class Ops> void clip(const float* src, float low, float high, float* dst, int n) {
+        const auto lo = Ops::set1(low);
+        const auto hi = Ops::set1(high);
+        mapUnary<Ops>(src, dst, n,
+                [lo, hi](auto x) { return Ops::min(hi, Ops::max(lo, x)); },
+                [low, high](float x) { return x < low ? low : (high < x ? high : x); });
+    }
+
+    template<class Ops> void abs(const float* src, float* dst, int n) {
+        mapUnary<Ops>(src, dst, n, Ops::abs, [](float x) { return fabsf(x); });
+    }
+
+    template<class Ops> void sqr(const float* src, float* dst, int n) {
+        mapUnary<Ops>(src, dst, n, [](auto x) { return Ops::mul(x, x); }, [](float x) { return x * x; });
+    }
+
+    template<class Ops> void sqrt(const float* src, float* dst, int n) {
+        mapUnary<Ops>(src, dst, n, Ops::sqrt, [](float x) { return sqrtf(x); });
+    }
+
+    template<class Ops>
+    void affine2D(const float* u, const float* v, const float* u2, const float* v2,
+                  float alpha, const float* m, float* dstX, float* dstY, int n) {
+        const auto x0 = Ops::set1(m[0]), mxu = Ops::set1(m[1]), mxv = Ops::set1(m[2]);
+        const auto y0 = Ops::set1(m[3]), myu = Ops::set1(m[4]), myv = Ops::set1(m[5]);
+        const auto wa = Ops::set1(alpha), wb = Ops::set1(1.f - alpha);
+        const bool blend = u2 != nullptr && v2 != nullptr;
+
+        auto map = [&](auto blendTag) {
+            constexpr bool blendRows = decltype(blendTag)::value;
+            int i = 0;
+            for (; i + Ops::width <= n; i += Ops::width) {
+                auto uu = Ops::load(u + i);
+                auto vv = Ops::load(v + i);
+
+                if (blendRows) {
+                    uu = Ops::madd(Ops::load(u2 + i), wb, Ops::mul(uu, wa));
+                    vv = Ops::madd(Ops::load(v2 + i), wb, Ops::mul(vv, wa));
+                }
+
+                Ops::store(dstX + i, Ops::madd(vv, mxv, Ops::madd(uu, mxu, x0)));
+                Ops::store(dstY + i, Ops::madd(vv, myv, Ops::madd(uu, myu, y0)));
+            }
+            for (; i < n; ++i) {
+                float uu = u[i];
+                float vv = v[i];
+
+                if (blendRows) {
+                    uu = u2[i] * (1.f - alpha) + uu * alpha;
+                    vv = v2[i] * (1.f - alpha) + vv * alpha;
+                }
+
+                dstX[i] = m[0] + m[1] * uu + m[2] * vv;
+                dstY[i] = m[3] + m[4] * uu + m[5] * vv;
+            }
+        };
+
+        // the branch is resolved at compile time in each instantiation, not per element
+        if (blend) {
+            map(std::true_type {});
+        } else {
+            map(std::false_type {});
+        }
+    }
+
+    template<class Ops>
+    void allpassLanes(float* frames, const float* coefficients, int numStages,
+                      float feedback, float mix, float* state, int n) {
+        using Q = typename Ops::Quad;
+        using V = typename Q::V;
+
+        numStages = numStages < SimdKernels::maxAllpassStages ? numStages : SimdKernels::maxAllpassStages;
+
+        V z[SimdKernels::maxAllpassStages];
+        for (int s = 0; s < numStages; ++s) {
+            z[s] = Q::load(state + 4 * s);
+        }
+
+        V y = Q::load(state + 4 * numStages);
+        const V fb = Q::set1(feedback);
+        const V wet = Q::set1(mix);
+
+        for (int i = 0; i < n; ++i) {
+            const V in = Q::load(frames + 4 * i);
+            const V a = Q::set1(coefficients[i]);
+            V x = Q::madd(y, fb, in);
+
+            for (int s = 0; s < numStages; ++s) {
+                const V out = Q::sub(z[s], Q::mul(a, x));
+                z[s] = Q::madd(a, out, x);
+                x = out;
+            }
+
+            y = x;
+            Q::store(frames + 4 * i, Q::madd(y, wet, in));
+        }
+
+        for (int s = 0; s < numStages; ++s) {
+            Q::store(state + 4 * s, z[s]);
+        }
+
+        Q::store(state + 4 * numStages, y);
+    }
+
+    // a section at a time, so one section's coefficients and state stay in registers across the frames
+    template<class Ops>
+    void biquadLanes(const float* const* in, float* const* out, int activeLanes,
+                     const double* coefficients, int numStages, double* state, double* frames, int n) {
+        using D = typename Ops::DoubleQuad;
+        using V = typename D::V;
+
+        int i = 0;
+        for (; i + 4 <= n; i += 4) {
+            D::interleave(in, i, frames + 4 * i);
+        }
+        for (; i < n; ++i) {
+            for (int lane = 0; lane < 4; ++lane) {
+                frames[4 * i + lane] = in[lane][i];
+            }
+        }
+
+        for (int stage = 0; stage < numStages; ++stage) {
+            const double* c = coefficients + stage * 5 * 4;
+            double* z = state + stage * 2 * 4;
+
+            const V b0 = D::load(c), b1 = D::load(c + 4), b2 = D::load(c + 8);
+            const V a1 = D::load(c + 12), a2 = D::load(c + 16);
+            V s1 = D::load(z), s2 = D::load(z + 4);
+
+            for (i = 0; i < n; ++i) {
+                const V x = D::load(frames + 4 * i);
+                const V y = D::madd(b0, x, s1);
+
+                s1 = D::sub(D::madd(b1, x, s2), D::mul(a1, y));
+                s2 = D::sub(D::mul(b2, x), D::mul(a2, y));
+                D::store(frames + 4 * i, y);
+            }
+
+            double next[8];
+            D::store(next, s1);
+            D::store(next + 4, s2);
+
+            for (int lane = 0; lane < 4; ++lane) {
+                if ((activeLanes >> lane) & 1) {
+                    z[lane] = next[lane];
+                    z[4 + lane] = next[4 + lane];
+                }
+            }
+        }
+
+        for (i = 0; i + 4 <= n; i += 4) {
+            D::deinterleave(frames + 4 * i, out, i);
+        }
+        for (; i < n; ++i) {
+            for (int lane = 0; lane < 4; ++lane) {
+                out[lane][i] = (float) frames[4 * i + lane];
+            }
+        }
+    }
+
+    template<class Ops> float sum(const float* src, int n) {
+        return reduce<Ops>(src, nullptr, n, 0.f,
+                [](auto acc, const float* a, const float*) { return Ops::add(acc, Ops::load(a)); },
+                Ops::add, Ops::hsum,
+                [](float acc, float a, float) { return acc + a; });
+    }
+
+    template<class Ops> float sumAbs(const float* src, int n) {
+        return reduce<Ops>(src, nullptr, n, 0.f,
+                [](auto acc, const float* a, const float*) { return Ops::add(acc, Ops::abs(Ops::load(a))); },
+                Ops::add, Ops::hsum,
+                [](float acc, float a, float) { return acc + fabsf(a); });
+    }
+
+    template<class Ops> float dot(const float* a, const float* b, int n) {
+        return reduce<Ops>(a, b, n, 0.f,
+                [](auto acc, const float* x, const float* y) { return Ops::madd(Ops::load(x), Ops::load(y), acc); },
+                Ops::add, Ops::hsum,
+                [](float acc, float x, float y) { return acc + x * y; });
+    }
+
+    template<class Ops> float distanceSq(const float* a, const float* b, int n) {
+        return reduce<Ops>(a, b, n, 0.f,
+                [](auto acc, const float* x, const float* y) {
+                    const auto d = Ops::sub(Ops::load(x), Ops::load(y));
+                    return Ops::madd(d, d, acc);
+                },
+                Ops::add, Ops::hsum,
+                [](float acc, float x, float y) { return acc + (x - y) * (x - y); });
+    }
+
+    template<class Ops> float min(const float* src, int n) {
+        return reduce<Ops>(src, nullptr, n, HUGE_VALF,
+                [](auto acc, const float* a, const float*) { return Ops::min(acc, Ops::load(a)); },
+                Ops::min, Ops::hmin,
+                [](float acc, float a, float) { return a < acc ? a : acc; });
+    }
+
+    template<class Ops> float max(const float* src, int n) {
+        return reduce<Ops>(src, nullptr, n, -HUGE_VALF,
+                [](auto acc, const float* a, const float*) { return Ops::max(acc, Ops::load(a)); },
+                Ops::max, Ops::hmax,
+                [](float acc, float a, float) { return acc < a ? a : acc; });
+    }
+
+    template<class Ops>
+    SimdKernels::Table makeTable(const char* name) {
+        return {
+            name,
+            add<Ops>, sub<Ops>, mul<Ops>, div<Ops>,
+            addC<Ops>, mulC<Ops>,
+            addProductC<Ops>, addProduct<Ops>,
+            clip<Ops>, abs<Ops>, sqr<Ops>, sqrt<Ops>,
+            affine2D<Ops>, allpassLanes<Ops>, biquadLanes<Ops>,
+            sum<Ops>, sumAbs<Ops>, dot<Ops>, distanceSq<Ops>,
+            min<Ops>, max<Ops>
+        };
+    }
+}
+}
@@ -0,0 +1,227 @@
+#include "SimdKernels.h"
+#include "SimdKernelLoops.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+  #define SIMD_KERNELS_X86 1
+  #include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+  #define SIMD_KERNELS_NEON 1
+  #include <arm_neon.h>
+#endif
+
+namespace {
+#ifdef SIMD_KERNELS_X86
+    struct Sse2DoubleQuadOps {
+        struct V { __m128d lo, hi; };
+
+        static V load(const double* p)          { return { _mm_loadu_pd(p), _mm_loadu_pd(p + 2) }; }
+        static void store(double* p, V v)       { _mm_storeu_pd(p, v.lo); _mm_storeu_pd(p + 2, v.hi); }
+        static V sub(V a, V b)                  { return { _mm_sub_pd(a.lo, b.lo), _mm_sub_pd(a.hi, b.hi) }; }
+        static V mul(V a, V b)                  { return { _mm_mul_pd(a.lo, b.lo), _mm_mul_pd(a.hi, b.hi) }; }
+        static V madd(V a, V b, V c)            { return { _mm_add_pd(_mm_mul_pd(a.lo, b.lo), c.lo),
+                                                           _mm_add_pd(_mm_mul_pd(a.hi, b.hi), c.hi) }; }
+
+        static void storeFrame(double* p, __m128 frame) {
+            _mm_storeu_pd(p, _mm_cvtps_pd(frame));
+            _mm_storeu_pd(p + 2, _mm_cvtps_pd(_mm_movehl_ps(frame, frame)));
+        }
+
+        static __m128 loadFrame(const double* p) {
+            return _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(p)), _mm_cvtpd_ps(_mm_loadu_pd(p + 2)));
+        }
+
+        // four samples of each lane become four frames: a transpose, then each widened
+        static void interleave(const float* const* lanes, int i, double* frames) {
+            __m128 f0 = _mm_loadu_ps(lanes[0] + i), f1 = _mm_loadu_ps(lanes[1] + i);
+            __m128 f2 = _mm_loadu_ps(lanes[2] + i), f3 = _mm_loadu_ps(lanes[3] + i);
+            _MM_TRANSPOSE4_PS(f0, f1, f2, f3);
+
+            storeFrame(frames, f0);
+            storeFrame(frames + 4, f1);
+            storeFrame(frames + 8, f2);
+            storeFrame(frames + 12, f3);
+        }
+
+        static void deinterleave(const double* frames, float* const* lanes, int i) {
+            __m128 f0 = loadFrame(frames), f1 = loadFrame(frames + 4);
+            __m128 f2 = loadFrame(frames + 8), f3 = loadFrame(frames + 12);
+            _MM_TRANSPOSE4_PS(f0, f1, f2, f3);
+
+            _mm_storeu_ps(lanes[0] + i, f0);
+            _mm_storeu_ps(lanes[1] + i, f1);
+            _mm_storeu_ps(lanes[2] + i, f2);
+            _mm_storeu_ps(lanes[3] + i, f3);
+        }
+    };
+
+    // SSE2 is part of the x86-64 baseline, so this needs no runtime check
+    struct Sse2Ops {
+        using V = __m128;
+        using Quad = Sse2Ops;
+        using DoubleQuad = Sse2DoubleQuadOps;
+        static constexpr int width = 4;
+
+        static V load(const float* p)           { return _mm_loadu_ps(p); }
+        static void store(float* p, V v)        { _mm_storeu_ps(p, v); }
+        static V set1(float c)                  { return _mm_set1_ps(c); }
+        static V add(V a, V b)                  { return _mm_add_ps(a, b); }
+        static V sub(V a, V b)                  { return _mm_sub_ps(a, b); }
+        static V mul(V a, V b)                  { return _mm_mul_ps(a, b); }
+        static V div(V a, V b)                  { return _mm_div_ps(a, b); }
+        static V min(V a, V b)                  { return _mm_min_ps(a, b); }
+        static V max(V a, V b)                  { return _mm_max_ps(a, b); }
+        static V abs(V a)                       { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+        static V sqrt(V a)                      { return _mm_sqrt_ps(a); }
+        static V madd(V a, V b, V c)            { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+
+        static float hsum(V a) {
+            V pairs = _mm_add_ps(a, _mm_movehl_ps(a, a));
+            return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+        }
+
+        static float hmin(V a) {
+            V pairs = _mm_min_ps(a, _mm_movehl_ps(a, a));
+            return _mm_cvtss_f32(_mm_min_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+        }
+
+        static float hmax(V a) {
+            V pairs = _mm_max_ps(a, _mm_movehl_ps(a, a));
+            return _mm_cvtss_f32(_mm_max_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+        }
+    };
+#endif
+
+#ifdef SIMD_KERNELS_NEON
+    struct NeonDoubleQuadOps {
+        struct V { float64x2_t lo, hi; };
+
+        static V load(const double* p)          { return { vld1q_f64(p), vld1q_f64(p + 2) }; }
+        static void store(double* p, V v)       { vst1q_f64(p, v.lo); vst1q_f64(p + 2, v.hi); }
+        static V sub(V a, V b)                  { return { vsubq_f64(a.lo, b.lo), vsubq_f64(a.hi, b.hi) }; }
+        static V mul(V a, V b)                  { return { vmulq_f64(a.lo, b.lo), vmulq_f64(a.hi, b.hi) }; }
+        static V madd(V a, V b, V c)            { return { vfmaq_f64(c.lo, a.lo, b.lo), vfmaq_f64(c.hi, a.hi, b.hi) }; }
+
+        static void transpose(float32x4_t& f0, float32x4_t& f1, float32x4_t& f2, float32x4_t& f3) {
+            const float32x4x2_t t01 = vtrnq_f32(f0, f1);
+            const float32x4x2_t t23 = vtrnq_f32(f2, f3);
+
+            f0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+            f1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+            f2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+            f3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+        }
+
+        static void storeFrame(double* p, float32x4_t frame) {
+            vst1q_f64(p, vcvt_f64_f32(vget_low_f32(frame)));
+            vst1q_f64(p + 2, vcvt_high_f64_f32(frame));
+        }
+
+        static float32x4_t loadFrame(const double* p) {
+            return vcvt_high_f32_f64(vcvt_f32_f64(vld1q_f64(p)), vld1q_f64(p + 2));
+        }
+
+        static void interleave(const float* const* lanes, int i, double* frames) {
+            float32x4_t f0 = vld1q_f32(lanes[0] + i), f1 = vld1q_f32(lanes[1] + i);
+            float32x4_t f2 = vld1q_f32(lanes[2] + i), f3 = vld1q_f32(lanes[3] + i);
+            transpose(f0, f1, f2, f3);
+
+            storeFrame(frames, f0);
+            storeFrame(frames + 4, f1);
+            storeFrame(frames + 8, f2);
+            storeFrame(frames + 12, f3);
+        }
+
+        static void deinterleave(const double* frames, float* const* lanes, int i) {
+            float32x4_t f0 = loadFrame(frames), f1 = loadFrame(frames + 4);
+            float32x4_t f2 = loadFrame(frames + 8), f3 = loadFrame(frames + 12);
+            transpose(f0, f1, f2, f3);
+
+            vst1q_f32(lanes[0] + i, f0);
+            vst1q_f32(lanes[1] + i, f1);
+            vst1q_f32(lanes[2] + i, f2);
+            vst1q_f32(lanes[3] + i, f3);
+        }
+    };
+
+    struct NeonOps {
+        using V = float32x4_t;
+        using Quad = NeonOps;
+        using DoubleQuad = NeonDoubleQuadOps;
+        static constexpr int width = 4;
+
+        static V load(const float* p)           { return vld1q_f32(p); }
+        static void store(float* p, V v)        { vst1q_f32(p, v); }
+        static V set1(float c)                  { return vdupq_n_f32(c); }
+        static V add(V a, V b)                  { return vaddq_f32(a, b); }
+        static V sub(V a, V b)                  { return vsubq_f32(a, b); }
+        static V mul(V a, V b)                  { return vmulq_f32(a, b); }
+        static V div(V a, V b)                  { return vdivq_f32(a, b); }
+        static V min(V a, V b)                  { return vminq_f32(a, b); }
+        static V max(V a, V b)                  { return vmaxq_f32(a, b); }
+        static V abs(V a)                       { return vabsq_f32(a); }
+        static V sqrt(V a)                      { return vsqrtq_f32(a); }
+        static V madd(V a, V b, V c)            { return vfmaq_f32(c, a, b); }
+        static float hsum(V a)                  { return vaddvq_f32(a); }
+        static float hmin(V a)                  { return vminvq_f32(a); }
+        static float hmax(V a)                  { return vmaxvq_f32(a); }
+    };
+#endif
+
+    struct Registry {
+        const SimdKernels::Table* tables[4] {};
+        int numTables {};
+        const SimdKernels::Table* best {};
+
+        Registry() {
+            static const SimdKernels::Table scalarTable = SimdLoops::makeTable<SimdLoops::ScalarOps>("scalar");
+            add(&scalarTable);
+
+          #ifdef SIMD_KERNELS_X86
+            static const SimdKernels::Table sse2Table = SimdLoops::makeTable<Sse2Ops>("sse2");
+            add(&sse2Table);
+
+          #if defined(__GNUC__) || defined(__clang__)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+                add(SimdKernels::avx2());
+            }
+          #endif
+          #endif
+
+          #ifdef SIMD_KERNELS_NEON
+            static const SimdKernels::Table neonTable = SimdLoops::makeTable<NeonOps>("neon");
+            add(&neonTable);
+          #endif
+        }
+
+        void add(const SimdKernels::Table* table) {
+            if (table != nullptr) {
+                tables[numTables++] = table;
+                best = table;
+            }
+        }
+    };
+
+    const Registry& registry() {
+        static const Registry instance;
+        return instance;
+    }
+}
+
+const SimdKernels::Table& SimdKernels::get() {
+    // resolved on first use; callers on the audio thread hit the cached pointer
+    static const Table& table = *registry().best;
+    return table;
+}
+
+int SimdKernels::getNumTables() {
+    return registry().numTables;
+}
+
+const SimdKernels::Table& SimdKernels::getTable(int index) {
+    return *registry().tables[index];
+}
+
+const SimdKernels::Table& SimdKernels::scalar() {
+    return *registry().tables[0];
+}
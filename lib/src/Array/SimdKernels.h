@@ -0,0 +1,106 @@
+#pragma once
+
+/*
+ * Hand-vectorized float kernels behind the portable Buffer/VecOps backend.
+ *
+ * Each instruction set gets its own table of function pointers. get() picks the
+ * widest one the running CPU supports, once, so a binary built for baseline
+ * x86-64 still uses AVX2 where it's available. The scalar table is always
+ * present and is the reference the others are tested against.
+ *
+ * All kernels accept unaligned pointers and any length, including 0. Binary
+ * kernels may be called in place (dst == a or dst == b).
+ */
+namespace SimdKernels {
+    // the most sections allpassLanes runs; its state stays in registers
+    constexpr int maxAllpassStages = 8;
+
+    struct Table {
+        const char* name;
+
+        // dst[i] = a[i] op b[i]
+        void (*add)(const float* a, const float* b, float* dst, int n);
+        void (*sub)(const float* a, const float* b, float* dst, int n);
+        void (*mul)(const float* a, const float* b, float* dst, int n);
+        void (*div)(const float* a, const float* b, float* dst, int n);
+
+        // dst[i] = src[i] op c
+        void (*addC)(const float* src, float c, float* dst, int n);
+        void (*mulC)(const float* src, float c, float* dst, int n);
+
+        // dst[i] += src[i] * c
+        void (*addProductC)(const float* src, float c, float* dst, int n);
+        // dst[i] += a[i] * b[i]
+        void (*addProduct)(const float* a, const float* b, float* dst, int n);
+
+        // dst[i] = min(high, max(low, src[i]))
+        void (*clip)(const float* src, float low, float high, float* dst, int n);
+        void (*abs)(const float* src, float* dst, int n);
+        void (*sqr)(const float* src, float* dst, int n);
+        void (*sqrt)(const float* src, float* dst, int n);
+
+        /*
+         * dstX[i] = m[0] + m[1] * u[i] + m[2] * v[i]
+         * dstY[i] = m[3] + m[4] * u[i] + m[5] * v[i]
+         *
+         * where u and v are first blended as u * alpha + u2 * (1 - alpha) when u2
+         * and v2 aren't null. dstX and dstY must not overlap the inputs.
+         */
+        void (*affine2D)(const float* u, const float* v, const float* u2, const float* v2,
+                         float alpha, const float* m, float* dstX, float* dstY, int n);
+
+        /*
+         * A phaser's chain of first-order allpass sections over n frames of four
+         * interleaved lanes, each lane with its own state. For frame i, with
+         * a = coefficients[i]:
+         *
+         *   x = frames[i] + feedback * y
+         *   for each section: s = z - a * x, z = x + a * s, x = s
+         *   y = x, frames[i] += mix * y
+         *
+         * state holds every section's z, then y, four lanes apiece, and carries
+         * over between calls. numStages is at most maxAllpassStages.
+         */
+        void (*allpassLanes)(float* frames, const float* coefficients, int numStages,
+                             float feedback, float mix, float* state, int n);
+
+        /*
+         * A cascade of biquads in transposed direct form II over n samples of four
+         * channels, one per lane, each lane with its own coefficients and state. Per
+         * section, for every frame:
+         *
+         *   y = b0 * x + s1, s1 = b1 * x - a1 * y + s2, s2 = b2 * x - a2 * y
+         *
+         * The sections run in double precision, as IPP's did: with a shelf near
+         * 20 Hz the poles sit so close to 1 that float state is off by tens of dB.
+         * coefficients holds b0, b1, b2, a1 and a2 per section, normalised by a0,
+         * four lanes apiece. state holds s1 and s2 per section, likewise, and
+         * carries over between calls for the lanes set in activeLanes, a bit per
+         * lane; the others keep theirs. in and out hold a channel per lane and may
+         * be the same. frames is scratch for 4 * n values.
+         */
+        void (*biquadLanes)(const float* const* in, float* const* out, int activeLanes,
+                            const double* coefficients, int numStages, double* state, double* frames, int n);
+
+        // reductions; the empty range gives 0 for sums, and +inf / -inf for min / max
+        float (*sum)(const float* src, int n);
+        float (*sumAbs)(const float* src, int n);
+        float (*dot)(const float* a, const float* b, int n);
+        float (*distanceSq)(const float* a, const float* b, int n);
+        float (*min)(const float* src, int n);
+        float (*max)(const float* src, int n);
+    };
+
+    // the fastest table the running CPU supports
+    const Table& get();
+
+    // every table compiled in and supported here, scalar first
+    int getNumTables();
+    const Table& getTable(int index);
+
+    const Table& scalar();
+
+    // defined in SimdKernelsAvx2.cpp, which is the only unit built with AVX2 enabled;
+    // null when that unit was compiled without it
+    const Table* avx2();
+}
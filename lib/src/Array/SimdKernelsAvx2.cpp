@@ -0,0 +1,116 @@
+#include "SimdKernels.h"
+
+/*
+ * Built with -mavx2 -mfma (see lib/CMakeLists.txt) and only reached after
+ * SimdKernels has checked the CPU, so nothing in this unit may be called
+ * without going through avx2().
+ */
+#if defined(__AVX2__) && defined(__FMA__)
+
+#include "SimdKernelLoops.h"
+#include <immintrin.h>
+
+namespace {
+    // the four-lane kernels, with the fused multiply-add this unit may use
+    struct Fma128Ops {
+        using V = __m128;
+        static constexpr int width = 4;
+
+        static V load(const float* p)           { return _mm_loadu_ps(p); }
+        static void store(float* p, V v)        { _mm_storeu_ps(p, v); }
+        static V set1(float c)                  { return _mm_set1_ps(c); }
+        static V add(V a, V b)                  { return _mm_add_ps(a, b); }
+        static V sub(V a, V b)                  { return _mm_sub_ps(a, b); }
+        static V mul(V a, V b)                  { return _mm_mul_ps(a, b); }
+        static V madd(V a, V b, V c)            { return _mm_fmadd_ps(a, b, c); }
+    };
+
+    struct Avx2DoubleQuadOps {
+        using V = __m256d;
+
+        static V load(const double* p)          { return _mm256_loadu_pd(p); }
+        static void store(double* p, V v)       { _mm256_storeu_pd(p, v); }
+        static V sub(V a, V b)                  { return _mm256_sub_pd(a, b); }
+        static V mul(V a, V b)                  { return _mm256_mul_pd(a, b); }
+        static V madd(V a, V b, V c)            { return _mm256_fmadd_pd(a, b, c); }
+
+        static void interleave(const float* const* lanes, int i, double* frames) {
+            __m128 f0 = _mm_loadu_ps(lanes[0] + i), f1 = _mm_loadu_ps(lanes[1] + i);
+            __m128 f2 = _mm_loadu_ps(lanes[2] + i), f3 = _mm_loadu_ps(lanes[3] + i);
+            _MM_TRANSPOSE4_PS(f0, f1, f2, f3);
+
+            _mm256_storeu_pd(frames, _mm256_cvtps_pd(f0));
+            _mm256_storeu_pd(frames + 4, _mm256_cvtps_pd(f1));
+            _mm256_storeu_pd(frames + 8, _mm256_cvtps_pd(f2));
+            _mm256_storeu_pd(frames + 12, _mm256_cvtps_pd(f3));
+        }
+
+        static void deinterleave(const double* frames, float* const* lanes, int i) {
+            __m128 f0 = _mm256_cvtpd_ps(_mm256_loadu_pd(frames));
+            __m128 f1 = _mm256_cvtpd_ps(_mm256_loadu_pd(frames + 4));
+            __m128 f2 = _mm256_cvtpd_ps(_mm256_loadu_pd(frames + 8));
+            __m128 f3 = _mm256_cvtpd_ps(_mm256_loadu_pd(frames + 12));
+            _MM_TRANSPOSE4_PS(f0, f1, f2, f3);
+
+            _mm_storeu_ps(lanes[0] + i, f0);
+            _mm_storeu_ps(lanes[1] + i, f1);
+            _mm_storeu_ps(lanes[2] + i, f2);
+            _mm_storeu_ps(lanes[3] + i, f3);
+        }
+    };
+
+    struct Avx2Ops {
+        using V = __m256;
+        using Quad = Fma128Ops;
+        using DoubleQuad = Avx2DoubleQuadOps;
+        static constexpr int width = 8;
+
+        static V load(const float* p)           { return _mm256_loadu_ps(p); }
+        static void store(float* p, V v)        { _mm256_storeu_ps(p, v); }
+        static V set1(float c)                  { return _mm256_set1_ps(c); }
+        static V add(V a, V b)                  { return _mm256_add_ps(a, b); }
+        static V sub(V a, V b)                  { return _mm256_sub_ps(a, b); }
+        static V mul(V a, V b)                  { return _mm256_mul_ps(a, b); }
+        static V div(V a, V b)                  { return _mm256_div_ps(a, b); }
+        static V min(V a, V b)                  { return _mm256_min_ps(a, b); }
+        static V max(V a, V b)                  { return _mm256_max_ps(a, b); }
+        static V abs(V a)                       { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+        static V sqrt(V a)                      { return _mm256_sqrt_ps(a); }
+        static V madd(V a, V b, V c)            { return _mm256_fmadd_ps(a, b, c); }
+
+        static __m128 halves(V a, __m128 (*op)(__m128, __m128)) {
+            return op(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+        }
+
+        static float hsum(V a) {
+            __m128 v = halves(a, [](__m128 x, __m128 y) { return _mm_add_ps(x, y); });
+            v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+            return _mm_cvtss_f32(_mm_add_ss(v, _mm_shuffle_ps(v, v, 1)));
+        }
+
+        static float hmin(V a) {
+            __m128 v = halves(a, [](__m128 x, __m128 y) { return _mm_min_ps(x, y); });
+            v = _mm_min_ps(v, _mm_movehl_ps(v, v));
+            return _mm_cvtss_f32(_mm_min_ss(v, _mm_shuffle_ps(v, v, 1)));
+        }
+
+        static float hmax(V a) {
+            __m128 v = halves(a, [](__m128 x, __m128 y) { return _mm_max_ps(x, y); });
+            v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+            return _mm_cvtss_f32(_mm_max_ss(v, _mm_shuffle_ps(v, v, 1)));
+        }
+    };
+}
+
+const SimdKernels::Table* SimdKernels::avx2() {
+    static const Table table = SimdLoops::makeTable<Avx2Ops>("avx2");
+    return &table;
+}
+
+#else
+
+const SimdKernels::Table* SimdKernels::avx2() {
+    return nullptr;
+}
+
+#endif
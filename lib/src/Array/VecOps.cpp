@@ -382,6 +382,166 @@ void VecOps::splitFrac(Buffer<Float64> src, Buffer<Float64> whole, Buffer<Float6
     frac.withSize(size).sub(whole.withSize(size));
 }
 
+#elif defined(USE_PORTABLE_SIMD)
+#include "SimdKernels.h"
+
+#include <cmath>
+#include <limits>
+#include <new>
+
+#define KERNELS SimdKernels::get()
+#define DST_SIZE jmin(src1.size(), src2.size(), dst.size())
+
+// 64-byte alignment keeps AVX loads within one cache line
+constexpr std::align_val_t allocAlignment { 64 };
+
+template<> void VecOps::zero(Float32* src, int size) { std::fill_n(src, size, 0.f); }
+template<> void VecOps::zero(Float64* src, int size) { std::fill_n(src, size, 0.0); }
+
+template<> void VecOps::add(SRCA_SRCB_DST(Float32)) { KERNELS.add(src1.get(), src2.get(), dst.get(), DST_SIZE); }
+template<> void VecOps::sub(SRCA_SRCB_DST(Float32)) { KERNELS.sub(src1.get(), src2.get(), dst.get(), DST_SIZE); }
+template<> void VecOps::mul(SRCA_SRCB_DST(Float32)) { KERNELS.mul(src1.get(), src2.get(), dst.get(), DST_SIZE); }
+template<> void VecOps::div(SRCA_SRCB_DST(Float32)) { KERNELS.div(src1.get(), src2.get(), dst.get(), DST_SIZE); }
+
+#define declareLoopForF64_Cplx(op, sym) \
+    template<> void VecOps::op(SRCA_SRCB_DST(Float64)) { \
+        for(int i = 0; i < DST_SIZE; ++i) dst[i] = src1[i] sym src2[i]; \
+    } \
+    template<> void VecOps::op(SRCA_SRCB_DST(Complex32)) { \
+        for(int i = 0; i < DST_SIZE; ++i) dst[i] = src1[i] sym src2[i]; \
+    }
+
+declareLoopForF64_Cplx(add, +)
+declareLoopForF64_Cplx(sub, -)
+declareLoopForF64_Cplx(mul, *)
+declareLoopForF64_Cplx(div, /)
+
+template<> void VecOps::move(Buffer<Float32> src, Buffer<Float32> dst) {
+    std::memmove(dst.get(), src.get(), jmin(src.size(), dst.size()) * sizeof(Float32));
+}
+
+template<> void VecOps::move(Buffer<Float64> src, Buffer<Float64> dst) {
+    std::memmove(dst.get(), src.get(), jmin(src.size(), dst.size()) * sizeof(Float64));
+}
+
+// truncates toward zero and saturates, as ippsConvert_*_Sfs does with ippRndZero
+#define defineRoundDown(T, S) \
+    template<> void VecOps::roundDown(Buffer<T> src, Buffer<S> dst) { \
+        const int size = jmin(src.size(), dst.size()); \
+        for(int i = 0; i < size; ++i) { \
+            const T v = jlimit((T) std::numeric_limits<S>::min(), (T) std::numeric_limits<S>::max(), src[i]); \
+            dst[i] = (S) v; \
+        } \
+    }
+
+defineRoundDown(Float32, Int8s)
+defineRoundDown(Float32, Int8u)
+defineRoundDown(Float32, Int16s)
+defineRoundDown(Float32, Int32s)
+defineRoundDown(Float64, Int16s)
+
+template<> void VecOps::mul(Buffer<Float32> src, Float32 k, Buffer<Float32> dst) {
+    BUFFS_EQ_CHECK
+    KERNELS.mulC(src.get(), k, dst.get(), src.size());
+}
+template<> void VecOps::mul(Buffer<Float64> src, Float64 k, Buffer<Float64> dst) {
+    BUFFS_EQ_CHECK
+    for(int i = 0; i < src.size(); ++i) dst[i] = src[i] * k;
+}
+template<> void VecOps::mul(Buffer<Complex32> src, Complex32 k, Buffer<Complex32> dst) {
+    BUFFS_EQ_CHECK
+    for(int i = 0; i < src.size(); ++i) dst[i] = src[i] * k;
+}
+template<> void VecOps::mul(Float32* src, Float32 k, Float32* dst, int len) {
+    KERNELS.mulC(src, k, dst, len);
+}
+template<> void VecOps::addProd(Float32* src, Float32 k, Float32* dst, int len) {
+    KERNELS.addProductC(src, k, dst, len);
+}
+
+template<> void VecOps::subCRev(Buffer<Float32> src, Float32 k, Buffer<Float32> dst) {
+    const int size = jmin(src.size(), dst.size());
+    KERNELS.mulC(src.get(), -1.f, dst.get(), size);
+    KERNELS.addC(dst.get(), k, dst.get(), size);
+}
+template<> void VecOps::subCRev(Buffer<Float64> src, Float64 k, Buffer<Float64> dst) {
+    for(int i = 0; i < jmin(src.size(), dst.size()); ++i) dst[i] = k - src[i];
+}
+
+template<> void VecOps::divCRev(Buffer<Float32> src, Float32 k, Buffer<Float32> dst) {
+    for(int i = 0; i < jmin(src.size(), dst.size()); ++i) dst[i] = k / src[i];
+}
+
+#define defineDiff(type) \
+    template<> void VecOps::diff(Buffer<type> src, Buffer<type> dst) { \
+        if(dst.size() < src.size() - 1 || dst.size() < 2) return; \
+        for(int i = 0; i < src.size() - 1; ++i) dst[i] = src[i + 1] - src[i]; \
+        dst[dst.size() - 1] = dst[dst.size() - 2]; \
+    }
+
+defineDiff(Float32)
+defineDiff(Float64)
+
+#define defineInterleave(type) \
+    template<> void VecOps::interleave(Buffer<type> x, Buffer<type> y, Buffer<type> dst) { \
+        if(x.empty()) return; \
+        jassert(dst.size() >= 2 * x.size()); \
+        for(int i = 0; i < x.size(); ++i) { \
+            dst[2 * i]     = x[i]; \
+            dst[2 * i + 1] = y[i]; \
+        } \
+    }
+
+defineInterleave(Float32)
+defineInterleave(Float64)
+
+#define defineAllocate(T) template<> T* VecOps::allocate<T>(int size) { \
+    return static_cast<T*>(::operator new(size * sizeof(T), allocAlignment, std::nothrow)); \
+}
+#define defineDeallocate(T) template<> void VecOps::deallocate<T>(T* ptr) { ::operator delete(ptr, allocAlignment); }
+defineForAllTypes(defineAllocate)
+defineForAllTypes(defineDeallocate)
+
+template<> void VecOps::convert(Buffer<Float64> src, Buffer<Float32> dst) {
+    for(int i = 0; i < jmin(src.size(), dst.size()); ++i) dst[i] = (Float32) src[i];
+}
+template<> void VecOps::convert(Buffer<Float32> src, Buffer<Float64> dst) {
+    for(int i = 0; i < jmin(src.size(), dst.size()); ++i) dst[i] = (Float64) src[i];
+}
+
+#define defineCopy(T) \
+template<> void VecOps::copy(const T* src, T* dst, int size) { \
+    if(size > 0) std::memcpy(dst, src, size * sizeof(T)); \
+}
+
+defineForAllTypes(defineCopy)
+
+// full linear convolution, as ippsConvolve: one scaled, shifted copy of the longer input per tap of the shorter
+template<> void VecOps::conv(Buffer<Float32> src1, Buffer<Float32> src2, Buffer<Float32> dst) {
+    if(src1.empty() || src2.empty()) return;
+    if(src1.size() < src2.size()) std::swap(src1, src2);
+
+    const int size = jmin(dst.size(), src1.size() + src2.size() - 1);
+    jassert(dst.size() >= src1.size() + src2.size() - 1);
+    dst.zero(size);
+
+    for(int j = 0; j < src2.size() && j < size; ++j) {
+        KERNELS.addProductC(src1.get(), src2[j], dst.get() + j, jmin(src1.size(), size - j));
+    }
+}
+
+#define defineSplitFrac(type) \
+    template<> void VecOps::splitFrac(Buffer<type> src, Buffer<type> whole, Buffer<type> frac) { \
+        const int size = jmin(src.size(), whole.size(), frac.size()); \
+        for(int i = 0; i < size; ++i) { \
+            whole[i] = std::floor(src[i]); \
+            frac[i]  = src[i] - whole[i]; \
+        } \
+    }
+
+defineSplitFrac(Float32)
+defineSplitFrac(Float64)
+
 #endif
 
 template<> void VecOps::flip(Buffer<Float32> src, Buffer<Float32> dst) { src.copyTo(dst); dst.flip();  }
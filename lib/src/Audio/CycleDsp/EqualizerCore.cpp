@@ -1,6 +1,5 @@
 #include "EqualizerCore.h"
 
-#include <Algo/IIR.h>
 #include <Audio/Filters/Butterworth.h>
 
 #include <algorithm>
@@ -10,7 +9,7 @@ namespace CycleDsp {
 
 class EqualizerCore::Band {
 public:
-    Band(int channelCount, int index) : iir(channelCount), index(index) {}
+    explicit Band(int index) : index(index) {}
 
     void configure(double sampleRate, float frequency, float gainDecibels) {
         if (index == 0) {
@@ -23,8 +22,6 @@ public:
             bandShelf.setup(1, sampleRate, frequency, frequency * 0.7f, gainDecibels);
             cascade = &bandShelf;
         }
-
-        iir.updateFromCascade(*cascade);
     }
 
     float responseMagnitude(double normalizedFrequency) const {
@@ -37,14 +34,16 @@ public:
     Dsp::SimpleFilter<Dsp::Butterworth::BandShelf<2>> bandShelf;
     Dsp::SimpleFilter<Dsp::Butterworth::HighShelf<2>> highShelf;
     Dsp::Cascade* cascade {};
-    IIR iir;
     int index;
 };
 
-EqualizerCore::EqualizerCore(int channels) : channelCount(std::max(1, channels)) {
+EqualizerCore::EqualizerCore(int channels) :
+        channelCount(std::clamp(channels, 1, BiquadLanes::numLanes)) {
+    jassert(channels <= BiquadLanes::numLanes);
+
     bands.reserve(bandCount);
     for (int index = 0; index < bandCount; ++index) {
-        bands.push_back(std::make_unique<Band>(channelCount, index));
+        bands.push_back(std::make_unique<Band>(index));
     }
 }
 
@@ -68,6 +67,30 @@ void EqualizerCore::configureBand(
             sampleRate,
             limitedFrequency,
             std::clamp(gainDecibels, -30.f, 30.f));
+
+    updateLanes();
+}
+
+void EqualizerCore::updateLanes() {
+    int numStages = 0;
+    for (const auto& band : bands) {
+        numStages += band->cascade != nullptr ? band->cascade->getNumStages() : 0;
+    }
+
+    // keeps the channels' histories unless the sections themselves changed
+    if (numStages != lanes.getNumStages()) {
+        lanes.setNumStages(numStages);
+    }
+
+    for (int channel = 0; channel < channelCount; ++channel) {
+        int stage = 0;
+
+        for (const auto& band : bands) {
+            if (band->cascade != nullptr) {
+                stage = lanes.setCascade(channel, stage, *band->cascade);
+            }
+        }
+    }
 }
 
 void EqualizerCore::process(int channel, Buffer<float> samples) {
@@ -75,15 +98,19 @@ void EqualizerCore::process(int channel, Buffer<float> samples) {
         return;
     }
 
-    for (const auto& band : bands) {
-        band->iir.process(channel, samples);
+    lanes.process(channel, samples);
+}
+
+void EqualizerCore::process(int firstChannel, const Buffer<float>* channels, int numChannels) {
+    if (firstChannel < 0 || numChannels <= 0 || firstChannel + numChannels > channelCount) {
+        return;
     }
+
+    lanes.process(firstChannel, channels, numChannels);
 }
 
 void EqualizerCore::clear() {
-    for (const auto& band : bands) {
-        band->iir.clear();
-    }
+    lanes.clear();
 }
 
 float EqualizerCore::responseDecibels(double frequency) const {
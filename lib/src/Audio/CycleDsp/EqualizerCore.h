@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Algo/BiquadLanes.h>
 #include <Array/Buffer.h>
 
 #include <memory>
@@ -16,15 +17,23 @@ public:
 
     void configureBand(int bandIndex, double sampleRate, float frequency, float gainDecibels);
     void process(int channel, Buffer<float> samples);
+
+    // channels firstChannel onwards together, each with its own history
+    void process(int firstChannel, const Buffer<float>* channels, int numChannels);
     void clear();
     float responseDecibels(double frequency) const;
 
 private:
     class Band;
 
+    void updateLanes();
+
     int channelCount;
     double sampleRate { 44100.0 };
     std::vector<std::unique_ptr<Band>> bands;
+
+    // every band's sections in a row, one lane per channel
+    BiquadLanes lanes;
 };
 
 }
@@ -9,6 +9,10 @@ int irImpulseLength(double normalizedValue) {
     return 1 << int(7. + normalizedValue * 7. + boundaryTolerance);
 }
 
+int irImpulseLengthAtRate(int length, double sampleRate) {
+    return (int) std::lround(length * sampleRate / irTunedSampleRate);
+}
+
 double irImpulseLengthValue(int length) {
     return (std::log(length) / std::log(2.0) - 7.) / 7.;
 }
@@ -21,8 +25,10 @@ float irPrefilterAmount(double normalizedValue) {
     return (float) (normalizedValue * normalizedValue * normalizedValue);
 }
 
-void buildIrPrefilterLevels(Buffer<float> levels, double normalizedValue) {
-    levels.set(1.f).zero((int) (irPrefilterAmount(normalizedValue) * levels.size()));
+void buildIrPrefilterLevels(Buffer<float> levels, double normalizedValue, double sampleRate) {
+    // the cutoff stays at the same frequency, so at higher rates it covers fewer bins
+    float bins = irPrefilterAmount(normalizedValue) * levels.size();
+    levels.set(1.f).zero((int) (bins * irTunedSampleRate / sampleRate));
 }
 
 void rasterizeIrImpulse(
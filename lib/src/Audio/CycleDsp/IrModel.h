@@ -7,12 +7,16 @@
 
 namespace CycleDsp {
 
+// impulse lengths and prefilter cutoffs were tuned in samples at this rate
+constexpr double irTunedSampleRate = 44100.0;
+
 int irImpulseLength(double normalizedValue);
+int irImpulseLengthAtRate(int length, double sampleRate);
 double irImpulseLengthValue(int length);
 float irPostGain(double normalizedValue);
 float irPrefilterAmount(double normalizedValue);
 
-void buildIrPrefilterLevels(Buffer<float> levels, double normalizedValue);
+void buildIrPrefilterLevels(Buffer<float> levels, double normalizedValue, double sampleRate = irTunedSampleRate);
 void rasterizeIrImpulse(
         Rasterization::SamplerView sampler,
         Buffer<float> impulse,
@@ -1,6 +1,7 @@
 #include "OscillatorLaneRasterizer.h"
 
 #include <algorithm>
+#include <cmath>
 
 namespace CycleDsp {
 
@@ -16,6 +17,13 @@ void configure(
     rasterizer.setWrapsEnds(true);
 }
 
+void advanceSpillover(Rasterization::VoiceCycleState& state, int sampleCount, double angleDelta) {
+    state.spillover += sampleCount * angleDelta;
+    while (state.spillover > 0.5) {
+        state.spillover -= 1.0;
+    }
+}
+
 void configure(
         Rasterization::VoiceRasterizer& rasterizer,
         const FixedFrameRasterizationRequest& request) {
@@ -47,11 +55,7 @@ void OscillatorLaneRasterizer::render(
         return;
     }
 
-    configure(rasterizer, request);
-    rasterizer.setInterceptPadding((float) std::max(
-            -request.state->spillover,
-            request.angleDelta));
-    rasterizer.renderChained(request.phaseCycles);
+    rasterize(rasterizer, request);
 
     const auto sampler = rasterizer.sampler();
     if (sampler.isSampleable()) {
@@ -63,10 +67,50 @@ void OscillatorLaneRasterizer::render(
     }
 
     output.zero();
-    request.state->spillover += output.size() * request.angleDelta;
-    if (request.state->spillover > 0.5) {
-        request.state->spillover -= 1.0;
+    advanceSpillover(*request.state, output.size(), request.angleDelta);
+}
+
+void OscillatorLaneRasterizer::rasterize(
+        Rasterization::VoiceRasterizer& rasterizer,
+        const ChainedRasterizationRequest& request) {
+    if (request.state == nullptr) {
+        return;
+    }
+    configure(rasterizer, request);
+    rasterizer.setInterceptPadding((float) std::max(
+            -request.state->spillover,
+            request.angleDelta));
+    rasterizer.renderChained(request.phaseCycles);
+}
+
+void OscillatorLaneRasterizer::sampleRotated(
+        const Rasterization::VoiceRasterizer& rasterizer,
+        Rasterization::VoiceCycleState& state,
+        float phaseCycles,
+        double angleDelta,
+        Buffer<float> output) {
+    const auto sampler = rasterizer.sampler();
+    if (angleDelta <= 0.0 || !sampler.isSampleable()) {
+        output.zero();
+        advanceSpillover(state, output.size(), angleDelta);
+        return;
+    }
+
+    // the rotated cycle at x is the zero-phase one at x - phase, so start that far back,
+    // within [0, 1), and finish past the wrap from the start of the cycle again
+    double start = state.spillover - (double) phaseCycles;
+    start -= std::floor(start);
+
+    const int size = output.size();
+    const int beforeWrap = jlimit(0, size, (int) std::ceil((1.0 - start) / angleDelta));
+    sampler.sampleWithInterval(output.withSize(beforeWrap), angleDelta, start);
+    if (beforeWrap < size) {
+        sampler.sampleWithInterval(
+                output.offset(beforeWrap),
+                angleDelta,
+                start + beforeWrap * angleDelta - 1.0);
     }
+    advanceSpillover(state, size, angleDelta);
 }
 
 bool OscillatorLaneRasterizer::renderFixedFrame(
@@ -32,6 +32,23 @@ public:
             Rasterization::VoiceRasterizer& rasterizer,
             const ChainedRasterizationRequest& request,
             Buffer<float> output);
+
+    // renders the request's next cycle without sampling it
+    static void rasterize(
+            Rasterization::VoiceRasterizer& rasterizer,
+            const ChainedRasterizationRequest& request);
+
+    /*
+     * Samples a cycle rendered at zero phase as though it had been rendered
+     * at phaseCycles, carrying the lane's spillover in state. Every lane
+     * slicing the mesh at the same morph can share that one cycle.
+     */
+    static void sampleRotated(
+            const Rasterization::VoiceRasterizer& rasterizer,
+            Rasterization::VoiceCycleState& state,
+            float phaseCycles,
+            double angleDelta,
+            Buffer<float> output);
     static bool renderFixedFrame(
             Rasterization::VoiceRasterizer& rasterizer,
             const FixedFrameRasterizationRequest& request,
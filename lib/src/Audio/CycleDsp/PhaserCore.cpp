@@ -0,0 +1,78 @@
+#include "PhaserCore.h"
+
+#include <Array/SimdKernels.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace CycleDsp {
+
+PhaserCore::PhaserCore() {
+    configure(configuration);
+}
+
+void PhaserCore::configure(const PhaserConfiguration& configurationToUse) {
+    configuration = configurationToUse;
+    configuration.sampleRate = std::max(1.0, configuration.sampleRate);
+
+    const auto nyquist = (float) (configuration.sampleRate * 0.5);
+
+    minDelay = configuration.minFrequency / nyquist;
+    maxDelay = configuration.maxFrequency / nyquist;
+    lfoIncrement = (float) (MathConstants<double>::twoPi * configuration.rate / configuration.sampleRate);
+}
+
+void PhaserCore::reset() {
+    lfoPhase = 0.0;
+    std::fill(std::begin(state), std::end(state), 0.f);
+}
+
+void PhaserCore::process(Buffer<float> left, Buffer<float> right) {
+    jassert(right.empty() || right.size() == left.size());
+
+    for (int offset = 0; offset < left.size(); offset += blockSize) {
+        const int numSamples = std::min(blockSize, left.size() - offset);
+
+        processBlock(
+                left.get() + offset,
+                right.empty() ? nullptr : right.get() + offset,
+                numSamples);
+    }
+}
+
+void PhaserCore::processBlock(float* left, float* right, int numSamples) {
+    // the allpass delay d sweeps between its limits, and each section's coefficient is (1 - d) / (1 + d)
+    const float halfRange = 0.5f * (maxDelay - minDelay);
+    Buffer<float> coefficient(coefficients, numSamples);
+    Buffer<float> denominator(denominators, numSamples);
+
+    coefficient.ramp((float) lfoPhase, lfoIncrement).sin().mul(halfRange).add(minDelay + halfRange);
+    coefficient.copyTo(denominator);
+    denominator.add(1.f);
+    coefficient.subCRev(1.f).div(denominator);
+
+    lfoPhase = std::fmod(lfoPhase + (double) lfoIncrement * numSamples, MathConstants<double>::twoPi);
+
+    for (int i = 0; i < numSamples; ++i) {
+        float* frame = frames + i * numLanes;
+        frame[0] = left[i];
+        frame[1] = right != nullptr ? right[i] : 0.f;
+        frame[2] = 0.f;
+        frame[3] = 0.f;
+    }
+
+    SimdKernels::get().allpassLanes(
+            frames, coefficients, numStages,
+            configuration.feedback, configuration.depth,
+            state, numSamples);
+
+    for (int i = 0; i < numSamples; ++i) {
+        left[i] = frames[i * numLanes];
+
+        if (right != nullptr) {
+            right[i] = frames[i * numLanes + 1];
+        }
+    }
+}
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Array/Buffer.h>
+
+namespace CycleDsp {
+
+struct PhaserConfiguration {
+    double sampleRate { 44100.0 };
+    float rate { 0.5f };
+    float feedback { 0.7f };
+    float depth { 1.f };
+    float minFrequency { 440.f };
+    float maxFrequency { 1600.f };
+};
+
+/*
+ * A six-section allpass phaser for up to two channels. Each block computes its
+ * sweep's coefficients in one pass, then runs the channels together as lanes
+ * of one vector, each with its own allpass and feedback state. Both channels
+ * follow the same sweep.
+ */
+class PhaserCore {
+public:
+    static constexpr int numStages = 6;
+    static constexpr int blockSize = 256;
+
+    PhaserCore();
+
+    void configure(const PhaserConfiguration& configuration);
+    void reset();
+    void process(Buffer<float> left, Buffer<float> right = {});
+
+private:
+    static constexpr int numLanes = 4;
+
+    void processBlock(float* left, float* right, int numSamples);
+
+    PhaserConfiguration configuration;
+
+    double lfoPhase {};
+    float lfoIncrement {};
+    float minDelay {}, maxDelay {};
+
+    float state[(numStages + 1) * numLanes] {};
+    float coefficients[blockSize] {};
+    float denominators[blockSize] {};
+    float frames[blockSize * numLanes] {};
+};
+
+}
@@ -1,6 +1,7 @@
 #include "ReverbKernel.h"
 
 #include <Algo/FFT.h>
+#include <Algo/Resampling.h>
 #include <Array/ScopedAlloc.h>
 #include <Util/NumberUtils.h>
 
@@ -45,9 +46,7 @@ void createVolumeRamp(
     }
 }
 
-}
-
-void buildReverbKernel(
+void buildAtTunedRate(
         const ReverbKernelConfiguration& configuration,
         Buffer<float> left,
         Buffer<float> right) {
@@ -121,3 +120,48 @@ void buildReverbKernel(
 }
 
 }
+
+int reverbKernelLength(float roomSize, double sampleRate) {
+    int length = NumberUtils::nextPower2((int) powf(2, 12 + 6 * roomSize));
+    return (int) std::lround(length * sampleRate / reverbTunedSampleRate);
+}
+
+void buildReverbKernel(
+        const ReverbKernelConfiguration& configuration,
+        Buffer<float> left,
+        Buffer<float> right) {
+    if (configuration.sampleRate == reverbTunedSampleRate) {
+        buildAtTunedRate(configuration, left, right);
+        return;
+    }
+
+    if (left.size() < 2 || (! right.empty() && right.size() != left.size())) {
+        return;
+    }
+
+    // shaped at the tuned rate and resampled, so the tail lasts as long and
+    // rolls off at the same frequencies whatever rate it convolves at
+    double ratio = configuration.sampleRate / reverbTunedSampleRate;
+    int tunedSize = (int) std::lround(left.size() / ratio);
+    tunedSize = std::max(kernelBlockSize, (tunedSize + kernelBlockSize - 1) / kernelBlockSize * kernelBlockSize);
+
+    ScopedAlloc<float> memory(tunedSize * 2);
+    Buffer<float> tunedLeft = memory.place(tunedSize);
+    Buffer<float> tunedRight = right.empty() ? Buffer<float>() : memory.place(tunedSize);
+
+    ReverbKernelConfiguration tuned = configuration;
+    tuned.sampleRate = reverbTunedSampleRate;
+    buildAtTunedRate(tuned, tunedLeft, tunedRight);
+
+    Buffer<float> channels[] = { left, right };
+    Buffer<float> tunedChannels[] = { tunedLeft, tunedRight };
+
+    for (int channel = 0; channel < (right.empty() ? 1 : 2); ++channel) {
+        Resampling::linResample(tunedChannels[channel], channels[channel]);
+
+        // more taps per second sum to more gain, so scale back to the tuned response
+        channels[channel].mul((float) (1. / ratio));
+    }
+}
+
+}
\ No newline at end of file
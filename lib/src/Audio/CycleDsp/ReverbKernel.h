@@ -4,12 +4,18 @@
 
 namespace CycleDsp {
 
+// the kernel's blocks, ramps and rolloffs were tuned in samples at this rate
+constexpr double reverbTunedSampleRate = 44100.0;
+
 struct ReverbKernelConfiguration {
     float roomSize { 0.2f };
     float damping { 0.35f };
     float highPass { 0.05f };
+    double sampleRate { reverbTunedSampleRate };
 };
 
+int reverbKernelLength(float roomSize, double sampleRate = reverbTunedSampleRate);
+
 void buildReverbKernel(
         const ReverbKernelConfiguration& configuration,
         Buffer<float> left,
@@ -507,10 +507,10 @@ void Multisample::performUpdate(UpdateType updateType) {
 void Multisample::updatePlaybackPosition() {
     float progress  = repo->getMorphPosition().getYellow();
     float seconds   = getGreatestLengthSeconds();
-    int newPosition = roundToInt(progress * seconds * 44100.f);
 
+    // positions index each sample's own audio
     for(auto sample : samples) {
-        sample->playbackPos = newPosition;
+        sample->playbackPos = roundToInt(progress * seconds * (float) sample->samplerate);
     }
 }
 
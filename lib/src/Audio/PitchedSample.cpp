@@ -362,6 +362,10 @@ MorphPosition PitchedSample::getBox() {
     return m;
 }
 
+double PitchedSample::periodForNote(int note) const {
+    return samplerate / NumberUtils::noteToFrequency(note, 0);
+}
+
 float PitchedSample::getAveragePeriod() {
     float average = 0;
 
@@ -56,6 +56,9 @@ public:
     [[nodiscard]] int size() const              { return audio.size(); }
     [[nodiscard]] float lengthSeconds() const   { return float(audio.size()) / float(samplerate); }
 
+    // in this sample's own samples, whatever rate it plays back at
+    [[nodiscard]] double periodForNote(int note) const;
+
     void addFrame(const PitchFrame& frame) { periods.push_back(frame); }
 
     float getAveragePeriod();
@@ -28,9 +28,13 @@ PluginProcessor::PluginProcessor() :
     repo->setPluginProcessor(this);
 
     audioHub = &getObj(AudioHub);
+
+    // the preset scan finishes after the host has first asked for the program list
+    getObj(DocumentLibrary).addListener(this);
 }
 
 PluginProcessor::~PluginProcessor() {
+    getObj(DocumentLibrary).removeListener(this);
     repo->setPluginProcessor(nullptr);
 }
 
@@ -177,6 +181,14 @@ void PluginProcessor::documentHasLoaded() {
     presetHasLoaded();
 }
 
+void PluginProcessor::documentsAdded() {
+    updateHostDisplay(ChangeDetails().withProgramChanged(true));
+}
+
+void PluginProcessor::documentScanFinished() {
+    updateHostDisplay(ChangeDetails().withProgramChanged(true));
+}
+
 const String PluginProcessor::getProgramName(int index) {
     return getObj(DocumentLibrary).getProgramName(index);
 }
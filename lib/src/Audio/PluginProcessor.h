@@ -11,6 +11,7 @@
 #include "../Obj/Ref.h"
 #include "JuceHeader.h"
 #include "../App/Doc/Document.h"
+#include "../App/DocumentLibrary.h"
 
 class AudioHub;
 using std::vector;
@@ -21,6 +22,7 @@ class SingletonRepo;
 class PluginProcessor :
         public AudioProcessor
     ,   public Document::Listener
+    ,   public DocumentLibrary::Listener
 {
 public:
     class Listener {
@@ -47,6 +49,8 @@ public:
     void processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages) override;
     void documentAboutToLoad() override {}
     void documentHasLoaded() override;
+    void documentsAdded() override;
+    void documentScanFinished() override;
     void presetHasLoaded();
     void updateLatency();
 
@@ -1,6 +1,8 @@
+#include <algorithm>
 #include <fstream>
 #include "Curve.h"
 
+#include <Array/SimdKernels.h>
 #include <Array/VecOps.h>
 
 #include "../Util/NumberUtils.h"
@@ -10,7 +12,7 @@ float*** Curve::table = nullptr;
 
 ostream& operator<<(ostream& stream, TransformParameters t) {
     stream.precision(3);
-    stream << "theta:\t" << t.theta * 180 / M_PI << "\n" << "scaleX:\t" << t.scaleX << "\n"
+    stream << "theta:\t" << std::atan2(-t.sinrot, t.cosrot) * 180 / M_PI << "\n" << "scaleX:\t" << t.scaleX << "\n"
             << "scaleY:\t" << t.scaleY << "\n" << "shear:\t" << t.shear << "\n" << "sinrot:\t"
             << t.sinrot << "\n" << "cosrot:\t" << t.cosrot << "\n" << "dpole:\t" << t.dpole << "\n"
             << "ypole:\t" << t.ypole << "\n" << "d:\t" << t.d.x << " " << t.d.y << "\n" << "\n";
@@ -173,9 +175,20 @@ void Curve::setResIndex(int index) {
 }
 
 void Curve::recalculateCurve() {
-    // the curve uses a time-guide, so no need for transform array
+    Transform transform;
+    solveTransform(transform);
+    applyTransform(transform);
+}
+
+void Curve::solveTransform(Transform& transform) {
+    transform.alpha   = 1.f;
+    transform.row     = table[resIndex][0];
+    transform.nextRow = nullptr;
+
+    // the curve uses a time-guide, so every point sits on b
     if (b.padAfter || b.padBefore) {
-        recalculatedPadded();
+        const float padded[] = { b.x, 0.f, 0.f, b.y, 0.f, 0.f };
+        std::copy(padded, padded + 6, transform.matrix);
         tp.scaleY = 1.f;
         return;
     }
@@ -188,20 +201,13 @@ void Curve::recalculateCurve() {
     dx   = (c.x - a.x);
     dyca = (c.y - a.y);
 
-    Complex32 cvec = { dx, dyca };
-    // ippsPhase_32fc(&cvec, &tp.theta, 1);
-    tp.theta = std::atan2(dyca, dx);
-
-    float ntheta = -tp.theta;
-    tp.sinrot = std::sin(ntheta);
-    tp.cosrot = std::cos(ntheta);
-
-    // ippsSin_32f_A21(&ntheta, &tp.sinrot, 1);
-    // ippsCos_32f_A24(&ntheta, &tp.cosrot, 1);
-
     float dist2 = dx * dx + dyca * dyca;
     dist2 = std::sqrt(dist2);
 
+    // rotation by -atan2(dyca, dx), without the trig
+    tp.sinrot = dist2 > 0 ? -dyca / dist2 : 0.f;
+    tp.cosrot = dist2 > 0 ? dx / dist2 : 1.f;
+
     // good luck understanding this
     tp.scaleX   = dist2;
     m           = dyca / dx;
@@ -225,48 +231,40 @@ void Curve::recalculateCurve() {
     distbi = std::sqrt(distbi);
     tp.scaleY = distbi;
 
-    int res  = resolution >> resIndex;
-    float ma = tp.scaleX * tp.cosrot;
-    float mc = tp.scaleX * tp.sinrot * -1;
-    float mb = tp.ypole * (tp.cosrot * tp.shear + tp.sinrot * tp.scaleY);
-    float md = tp.ypole * (-tp.sinrot * tp.shear + tp.cosrot * tp.scaleY);
+    float* matrix = transform.matrix;
+    matrix[0] = a.x;
+    matrix[1] = tp.scaleX * tp.cosrot;
+    matrix[2] = tp.ypole * (tp.cosrot * tp.shear + tp.sinrot * tp.scaleY);
+    matrix[3] = a.y;
+    matrix[4] = tp.scaleX * tp.sinrot * -1;
+    matrix[5] = tp.ypole * (-tp.sinrot * tp.shear + tp.cosrot * tp.scaleY);
 
-    // res  clk
-    // 0    900
-    // 1    836
-    // 2    833
     float alpha = interpolate ? 1 - (tableCurvePos - tableCurveIdx) : 1.f;
     bool actuallyShouldInterpolate = tableCurveIdx < numCurvelets - 1 && alpha < 1.f;
-    float* t  = table[resIndex][tableCurveIdx];
-    float* t2 = actuallyShouldInterpolate ? table[resIndex][tableCurveIdx + 1] : nullptr;
-    Buffer tx(transformX, res);
-    Buffer ty(transformY, res);
-
-    tx.set(a.x);
-    VecOps::addProd(t,       ma * alpha, transformX, res);
-    VecOps::addProd(t + res, mb * alpha, transformX, res);
-
-    if (actuallyShouldInterpolate) {
-        VecOps::addProd(t2,       ma * (1 - alpha), transformX, res);
-        VecOps::addProd(t2 + res, mb * (1 - alpha), transformX, res);
-    }
 
-    ty.set(a.y);
-    VecOps::addProd(t,       mc * alpha, transformY, res);
-    VecOps::addProd(t + res, md * alpha, transformY, res);
+    transform.row = table[resIndex][tableCurveIdx];
 
     if (actuallyShouldInterpolate) {
-        VecOps::addProd(t2,       mc * (1 - alpha), transformY, res);
-        VecOps::addProd(t2 + res, md * (1 - alpha), transformY, res);
+        transform.alpha = alpha;
+        transform.nextRow = table[resIndex][tableCurveIdx + 1];
     }
 }
 
-void Curve::recalculatedPadded() {
+void Curve::applyTransform(const Transform& transform) {
     int res = resolution >> resIndex;
-    Buffer tx(transformX, res);
-    Buffer ty(transformY, res);
-    tx.set(b.x);
-    ty.set(b.y);
+    const float* nextRow = transform.nextRow;
+
+    // each row holds the curvelet's x values, then its y values
+    SimdKernels::get().affine2D(
+            transform.row,
+            transform.row + res,
+            nextRow,
+            nextRow == nullptr ? nullptr : nextRow + res,
+            transform.alpha,
+            transform.matrix,
+            transformX,
+            transformY,
+            res);
 }
 
 float Curve::getCentreX() {
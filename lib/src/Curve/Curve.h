@@ -15,7 +15,6 @@ using std::ostream;
 
 class TransformParameters {
 public:
-    float theta;
     float scaleX;
     float scaleY;
     float shear;
@@ -36,6 +35,18 @@ public:
     static const int resolution     = 64u;
     static const int numCurvelets   = 128u;
 
+    /*
+     * The affine map from a curvelet table row to this curve's points, and the
+     * rows to blend: solveTransform() fills it (and tp), applyTransform() then
+     * writes transformX and transformY in one fused pass.
+     */
+    struct Transform {
+        float matrix[6];            // x0, x per u, x per v, y0, y per u, y per v
+        float alpha;
+        const float* row;
+        const float* nextRow;       // null when not interpolating between curvelets
+    };
+
     Float32 transformX[resolution];
     Float32 transformY[resolution];
 
@@ -67,7 +78,8 @@ public:
     void construct();
     void destruct();
     void recalculateCurve();
-    void recalculatedPadded();
+    void solveTransform(Transform& transform);
+    void applyTransform(const Transform& transform);
     void setResIndex(int index);
     void setShouldInterpolate(bool should)  { interpolate = should; }
     void update();
@@ -42,6 +42,8 @@ void Mesh::destroy() {
 
         verts.clear();
     }
+
+    markEdited();
 }
 
 void Mesh::print(bool printLines, bool printVerts) {
@@ -470,6 +472,8 @@ void Mesh::validate() {
 
         cube->validate();
     }
+
+    markEdited();
 }
 
 void Mesh::removeFreeVerts() {
@@ -495,6 +499,7 @@ void Mesh::updateToVersion(double newVersion) {
         }
 
         version = newVersion;
+        markEdited();
     }
 }
 
@@ -579,4 +584,5 @@ void Mesh::twin(float padLeft, float padRight) {
     }
 
     cubes.insert(cubes.end(), meshCopy->cubes.begin(), meshCopy->cubes.end());
+    markEdited();
 }
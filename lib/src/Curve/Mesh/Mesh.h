@@ -32,6 +32,15 @@ public:
     static void resetJsonReadCount() { jsonReadCount.store(0, std::memory_order_relaxed); }
     static uint64_t getJsonReadCount() { return jsonReadCount.load(std::memory_order_relaxed); }
 
+    /*
+     * Revisions are unique across all meshes, so a cache keyed on a mesh and its
+     * revision can't be fooled by another mesh allocated at the same address.
+     * Structural changes mark themselves; code that moves vertices in place must
+     * call markEdited() once it is done.
+     */
+    [[nodiscard]] uint64_t getRevision() const { return revision.load(std::memory_order_acquire); }
+    void markEdited() { revision.store(nextRevision(), std::memory_order_release); }
+
     vector<Vertex*>& getVerts()   { return verts; }
     vector<VertCube*>& getCubes() { return cubes; }
     const vector<Vertex*>& getVerts() const   { return verts; }
@@ -44,8 +53,8 @@ public:
 
     void setVersion(int newVersion) { version = newVersion; }
 
-    void addCube(VertCube* cube) { cubes.insert(cubes.end(), cube); }
-    void addVertex(Vertex* vert) { verts.insert(verts.end(), vert); }
+    void addCube(VertCube* cube) { cubes.insert(cubes.end(), cube); markEdited(); }
+    void addVertex(Vertex* vert) { verts.insert(verts.end(), vert); markEdited(); }
 
     bool removeCube(VertCube* cube) {
         return removeCube(std::find(cubes.begin(), cubes.end(), cube));
@@ -56,6 +65,7 @@ public:
             return false;
 
         cubes.erase(cube);
+        markEdited();
         return true;
     }
 
@@ -68,6 +78,7 @@ public:
             return false;
 
         verts.erase(vert);
+        markEdited();
         return true;
     }
 
@@ -80,7 +91,10 @@ public:
     }
 
 protected:
+    static uint64_t nextRevision() { return revisionCounter.fetch_add(1, std::memory_order_relaxed) + 1; }
+
     static inline std::atomic<uint64_t> jsonReadCount {};
+    static inline std::atomic<uint64_t> revisionCounter {};
 
     int version;
     String name;
@@ -88,5 +102,7 @@ protected:
     vector<Vertex*> verts;
     vector<VertCube*> cubes;
 
+    std::atomic<uint64_t> revision { nextRevision() };
+
     JUCE_LEAK_DETECTOR(Mesh)
 };
@@ -0,0 +1,200 @@
+#include "MeshSnapshot.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "Mesh.h"
+#include "../../Obj/MorphPosition.h"
+
+namespace {
+    const int sliceDims[] = { Vertex::Time, Vertex::Red, Vertex::Blue };
+
+    // matches VertCube::getFace, indexed by slot and pole
+    const int faceCornerTable[3][2][4] = {
+        { { VertCube::y0r0b0, VertCube::y0r0b1, VertCube::y0r1b0, VertCube::y0r1b1 },
+          { VertCube::y1r0b0, VertCube::y1r0b1, VertCube::y1r1b0, VertCube::y1r1b1 } },
+        { { VertCube::y0r0b0, VertCube::y0r0b1, VertCube::y1r0b0, VertCube::y1r0b1 },
+          { VertCube::y0r1b0, VertCube::y0r1b1, VertCube::y1r1b0, VertCube::y1r1b1 } },
+        { { VertCube::y0r0b0, VertCube::y0r1b0, VertCube::y1r0b0, VertCube::y1r1b0 },
+          { VertCube::y0r0b1, VertCube::y0r1b1, VertCube::y1r0b1, VertCube::y1r1b1 } },
+    };
+
+    void expandUnitUpperBoundary(float& value) {
+        if (value == 1.f) {
+            value += 0.000001f;
+        }
+    }
+}
+
+const int* MeshSnapshot::faceCorners(int dimension, bool pole) {
+    return faceCornerTable[slotOf(dimension)][pole ? 1 : 0];
+}
+
+void MeshSnapshot::reserve(int numCubes) {
+    cubes.reserve((size_t) numCubes);
+    corners.reserve((size_t) numCubes * valuesPerCube);
+
+    for (auto& axis : buckets) {
+        axis.cubes.reserve((size_t) numCubes * bucketsPerAxis);
+    }
+
+    for (auto& slot : bounds) {
+        for (auto& face : slot) {
+            for (auto* array : { &face.minX, &face.maxX, &face.minY, &face.maxY }) {
+                array->reserve((size_t) numCubes);
+            }
+        }
+    }
+}
+
+void MeshSnapshot::clear() {
+    source = nullptr;
+    revision = 0;
+    cubes.clear();
+    corners.clear();
+
+    for (auto& axis : buckets) {
+        std::fill(std::begin(axis.starts), std::end(axis.starts), 0);
+        axis.cubes.clear();
+    }
+
+    for (auto& slot : bounds) {
+        for (auto& face : slot) {
+            for (auto* array : { &face.minX, &face.maxX, &face.minY, &face.maxY }) {
+                array->clear();
+            }
+        }
+    }
+}
+
+bool MeshSnapshot::isCurrentFor(const Mesh& mesh) const {
+    return source == &mesh && revision == mesh.getRevision();
+}
+
+void MeshSnapshot::build(const Mesh& mesh) {
+    clear();
+
+    // read first: an edit landing mid-copy then leaves the snapshot stale rather than current
+    revision = mesh.getRevision();
+    source = &mesh;
+
+    for (auto* cube : mesh.getCubes()) {
+        bool complete = true;
+
+        for (auto* vertex : cube->lineVerts) {
+            complete &= vertex != nullptr;
+        }
+
+        if (!complete) {
+            jassertfalse;
+            continue;
+        }
+
+        cubes.push_back(cube);
+
+        for (auto* vertex : cube->lineVerts) {
+            corners.insert(corners.end(), vertex->values, vertex->values + Vertex::numElements);
+        }
+    }
+
+    const int numCubes = size();
+
+    for (int slot = 0; slot < numSliceDims; ++slot) {
+        int dimX = Vertex::Red;
+        int dimY = Vertex::Blue;
+        MorphPosition::getOtherDims(sliceDims[slot], dimX, dimY);
+
+        for (int pole = 0; pole < 2; ++pole) {
+            FaceBounds& face = bounds[slot][pole];
+            const int* faceCorner = faceCornerTable[slot][pole];
+
+            face.minX.resize((size_t) numCubes);
+            face.maxX.resize((size_t) numCubes);
+            face.minY.resize((size_t) numCubes);
+            face.maxY.resize((size_t) numCubes);
+
+            for (int i = 0; i < numCubes; ++i) {
+                const float* v00 = cornerValues(i, faceCorner[0]);
+                const float* v11 = cornerValues(i, faceCorner[3]);
+
+                face.minX[(size_t) i] = jmin(v00[dimX], v11[dimX]);
+                face.minY[(size_t) i] = jmin(v00[dimY], v11[dimY]);
+                face.maxX[(size_t) i] = jmax(v00[dimX], v11[dimX]);
+                face.maxY[(size_t) i] = jmax(v00[dimY], v11[dimY]);
+
+                expandUnitUpperBoundary(face.maxX[(size_t) i]);
+                expandUnitUpperBoundary(face.maxY[(size_t) i]);
+            }
+        }
+    }
+
+    buildBuckets();
+}
+
+void MeshSnapshot::buildBuckets() {
+    const int numCubes = size();
+
+    for (int slot = 0; slot < numSliceDims; ++slot) {
+        AxisBuckets& axis = buckets[slot];
+        const int dim = sliceDims[slot];
+
+        auto bucketRange = [this, dim](int cube, int& first, int& last) {
+            float low = cornerValues(cube, 0)[dim];
+            float high = low;
+
+            for (int corner = 1; corner < (int) VertCube::numVerts; ++corner) {
+                low  = jmin(low,  cornerValues(cube, corner)[dim]);
+                high = jmax(high, cornerValues(cube, corner)[dim]);
+            }
+
+            first = bucketOf(low);
+            last = bucketOf(high);
+        };
+
+        int first, last;
+
+        // counted first so every bucket's cubes sit contiguously, in mesh order
+        for (int i = 0; i < numCubes; ++i) {
+            bucketRange(i, first, last);
+
+            for (int bucket = first; bucket <= last; ++bucket) {
+                ++axis.starts[bucket + 1];
+            }
+        }
+
+        for (int bucket = 0; bucket < bucketsPerAxis; ++bucket) {
+            axis.starts[bucket + 1] += axis.starts[bucket];
+        }
+
+        int cursors[bucketsPerAxis];
+        std::copy(axis.starts, axis.starts + bucketsPerAxis, cursors);
+        axis.cubes.resize((size_t) axis.starts[bucketsPerAxis]);
+
+        for (int i = 0; i < numCubes; ++i) {
+            bucketRange(i, first, last);
+
+            for (int bucket = first; bucket <= last; ++bucket) {
+                axis.cubes[(size_t) cursors[bucket]++] = i;
+            }
+        }
+    }
+}
+
+MeshSnapshot::Candidates MeshSnapshot::candidatesAt(const MorphPosition& position) const {
+    Candidates best;
+    int bestSize = -1;
+
+    for (int slot = 0; slot < numSliceDims; ++slot) {
+        const AxisBuckets& axis = buckets[slot];
+        const int bucket = bucketOf(position[sliceDims[slot]].getCurrentValue());
+        const int count = axis.starts[bucket + 1] - axis.starts[bucket];
+
+        if (bestSize < 0 || count < bestSize) {
+            best.first = axis.cubes.data() + axis.starts[bucket];
+            best.last = best.first + count;
+            bestSize = count;
+        }
+    }
+
+    return best;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "VertCube.h"
+#include "Vertex.h"
+
+class Mesh;
+class MorphPosition;
+
+/*
+ * Flat copy of a mesh's cube corners, taken once per mesh revision, so slicing
+ * at audio rate walks contiguous arrays instead of chasing each cube's vertex
+ * pointers. The bounds of every face a slice tests are kept in their own
+ * arrays, one set per slicing dimension, so a cube that misses costs a few
+ * sequential loads; only cubes that are hit read their corners.
+ *
+ * Cubes are still referenced: intercepts, guide curves and depth projection
+ * work from them, and only for the cubes that are hit.
+ *
+ * Each morph axis is also split into buckets listing the cubes whose corners
+ * reach into them, so a slice only visits the cubes listed at the morph
+ * position on its most selective axis. Buckets list cubes in mesh order, so
+ * the visited cubes come in the same order as a full walk.
+ */
+class MeshSnapshot {
+public:
+    static constexpr int valuesPerCube = (int) VertCube::numVerts * Vertex::numElements;
+
+    static constexpr int bucketsPerAxis = 16;
+
+    struct FaceBounds {
+        std::vector<float> minX, maxX, minY, maxY;
+    };
+
+    struct Candidates {
+        const int* first {};
+        const int* last {};
+
+        [[nodiscard]] const int* begin() const { return first; }
+        [[nodiscard]] const int* end() const   { return last; }
+        [[nodiscard]] int size() const         { return (int) (last - first); }
+    };
+
+    void reserve(int numCubes);
+    void build(const Mesh& mesh);
+    void clear();
+
+    // whether this was built from the mesh at its current revision
+    [[nodiscard]] bool isCurrentFor(const Mesh& mesh) const;
+
+    [[nodiscard]] int size() const                      { return (int) cubes.size(); }
+    [[nodiscard]] uint64_t getRevision() const          { return revision; }
+    [[nodiscard]] VertCube* getCube(int index) const    { return cubes[(size_t) index]; }
+
+    [[nodiscard]] const float* cornerValues(int cube, int corner) const {
+        return corners.data() + (size_t) cube * valuesPerCube + (size_t) corner * Vertex::numElements;
+    }
+
+    /*
+     * Bounds of a face over the two dimensions other than the slicing one, in
+     * MorphPosition::getOtherDims order, with a unit upper bound nudged open so
+     * a position of exactly 1 is inside.
+     */
+    [[nodiscard]] const FaceBounds& getFaceBounds(int dimension, bool pole) const {
+        return bounds[slotOf(dimension)][pole ? 1 : 0];
+    }
+
+    [[nodiscard]] bool faceContains(int dimension, bool pole, int cube, float x, float y) const {
+        const FaceBounds& face = getFaceBounds(dimension, pole);
+
+        return ! (x < face.minX[(size_t) cube] || x >= face.maxX[(size_t) cube]
+               || y < face.minY[(size_t) cube] || y >= face.maxY[(size_t) cube]);
+    }
+
+    /*
+     * Indices of the cubes that can contain the position, ascending. A superset
+     * of those that slice at it: the cube still has to be sliced to tell.
+     */
+    [[nodiscard]] Candidates candidatesAt(const MorphPosition& position) const;
+
+    // corner indices of a face, in VertCube::Face order v00, v01, v10, v11
+    static const int* faceCorners(int dimension, bool pole);
+
+private:
+    static constexpr int numSliceDims = 3;
+
+    static int slotOf(int dimension) {
+        return dimension == Vertex::Time ? 0 : dimension == Vertex::Red ? 1 : 2;
+    }
+
+    static int bucketOf(float value) {
+        return (int) jlimit(0.f, (float) (bucketsPerAxis - 1), value * (float) bucketsPerAxis);
+    }
+
+    struct AxisBuckets {
+        int starts[bucketsPerAxis + 1] {};
+        std::vector<int> cubes;
+    };
+
+    void buildBuckets();
+
+    const Mesh* source {};
+    uint64_t revision {};
+
+    std::vector<VertCube*> cubes;
+    std::vector<float> corners;
+    FaceBounds bounds[numSliceDims][2];
+    AxisBuckets buckets[numSliceDims];
+};
@@ -10,6 +10,7 @@
 #include "../RasterizationRequest.h"
 #include "../RenderResult.h"
 #include <Curve/Mesh/Mesh.h>
+#include <Curve/Mesh/MeshSnapshot.h>
 #include <Curve/Mesh/VertCube.h>
 #include <Curve/Mesh/Vertex2.h>
 #include "../../../Obj/MorphPosition.h"
@@ -49,6 +50,42 @@ namespace Rasterization {
             return data.pointOverlaps;
         }
 
+        /*
+         * Same as slicing the cube at index in the snapshot, but a cube missing
+         * either face is rejected on the face bounds alone, and the reduction is
+         * only written for cubes whose faces both contain the position.
+         */
+        bool slice(
+                const MeshSnapshot& snapshot,
+                int index,
+                int dimension,
+                VertCube::ReductionData& data,
+                const MorphPosition& position) const {
+            data.pointOverlaps = false;
+            data.lineOverlaps = false;
+
+            int dimX = Vertex::Red;
+            int dimY = Vertex::Blue;
+
+            MorphPosition::getOtherDims(dimension, dimX, dimY);
+            Vertex2 point(position[dimX], position[dimY]);
+
+            if (!snapshot.faceContains(dimension, VertCube::LowPole, index, point.x, point.y)
+                    || !snapshot.faceContains(dimension, VertCube::HighPole, index, point.x, point.y)) {
+                return false;
+            }
+
+            sliceFace(snapshot, index, MeshSnapshot::faceCorners(dimension, VertCube::LowPole),
+                      dimX, dimY, point, data.v00, data.v10, data.v0);
+            sliceFace(snapshot, index, MeshSnapshot::faceCorners(dimension, VertCube::HighPole),
+                      dimX, dimY, point, data.v01, data.v11, data.v1);
+
+            data.lineOverlaps = true;
+            data.pointOverlaps = containsSlicePosition(data.v0.values[dimension], data.v1.values[dimension], position[dimension]);
+
+            return data.pointOverlaps;
+        }
+
         template<typename GuideApplier>
         const RenderResult& sliceMesh(
                 Mesh* mesh,
@@ -63,26 +100,75 @@ namespace Rasterization {
                 return output;
             }
 
-            int sliceDimension = request.overrideDimension
-                               ? request.overridingDimension
-                               : request.primaryViewDimension;
+            int sliceDimension = sliceDimensionOf(request);
             float independent = independentValue(sliceDimension, request.morph);
             PointScalingPolicy pointScaling(request.scalingMode);
 
             auto& cubes = mesh->getCubes();
             for (int i = 0; i < (int) cubes.size(); ++i) {
-                appendCubeIntercept(
-                        cubes[i],
-                        sliceDimension,
-                        independent,
-                        oscPhase,
-                        request,
-                        pointScaling,
-                        applyGuide,
-                        output,
-                        reductionData);
+                slice(*cubes[i], sliceDimension, reductionData, request.morph);
+
+                if (reductionData.pointOverlaps) {
+                    appendCubeIntercept(
+                            cubes[i],
+                            sliceDimension,
+                            independent,
+                            oscPhase,
+                            request,
+                            pointScaling,
+                            applyGuide,
+                            output,
+                            reductionData);
+                }
             }
 
+            return finishSlice(request, output);
+        }
+
+        template<typename GuideApplier>
+        const RenderResult& sliceMesh(
+                const MeshSnapshot& snapshot,
+                const RasterizationRequest& request,
+                float oscPhase,
+                GuideApplier&& applyGuide,
+                RenderResult& output,
+                VertCube::ReductionData& reductionData) const {
+            output.clear();
+
+            if (snapshot.size() == 0) {
+                return output;
+            }
+
+            int sliceDimension = sliceDimensionOf(request);
+            float independent = independentValue(sliceDimension, request.morph);
+            PointScalingPolicy pointScaling(request.scalingMode);
+
+            for (int i : snapshot.candidatesAt(request.morph)) {
+                if (slice(snapshot, i, sliceDimension, reductionData, request.morph)) {
+                    appendCubeIntercept(
+                            snapshot.getCube(i),
+                            sliceDimension,
+                            independent,
+                            oscPhase,
+                            request,
+                            pointScaling,
+                            applyGuide,
+                            output,
+                            reductionData);
+                }
+            }
+
+            return finishSlice(request, output);
+        }
+
+    private:
+        static int sliceDimensionOf(const RasterizationRequest& request) {
+            return request.overrideDimension
+                 ? request.overridingDimension
+                 : request.primaryViewDimension;
+        }
+
+        static const RenderResult& finishSlice(const RasterizationRequest& request, RenderResult& output) {
             std::sort(output.intercepts.begin(), output.intercepts.end());
             restrict(output.intercepts, request);
 
@@ -92,7 +178,6 @@ namespace Rasterization {
             return output;
         }
 
-    private:
         static float independentValue(int dimension, const MorphPosition& morph) {
             return dimension == Vertex::Time ? morph.time :
                    dimension == Vertex::Red  ? morph.red  :
@@ -110,11 +195,6 @@ namespace Rasterization {
                 GuideApplier&& applyGuide,
                 RenderResult& output,
                 VertCube::ReductionData& reductionData) const {
-            slice(*cube, sliceDimension, reductionData, request.morph);
-            if (!reductionData.pointOverlaps) {
-                return;
-            }
-
             Vertex* a = &reductionData.v0;
             Vertex* b = &reductionData.v1;
             Vertex* vertex = &reductionData.v;
@@ -271,6 +351,38 @@ namespace Rasterization {
             return true;
         }
 
+        static void sliceFace(
+                const MeshSnapshot& snapshot,
+                int index,
+                const int* corners,
+                int dimX,
+                int dimY,
+                const Vertex2& point,
+                Vertex& x0,
+                Vertex& x1,
+                Vertex& output) {
+            vertexAt(point.y, dimY, snapshot.cornerValues(index, corners[0]), snapshot.cornerValues(index, corners[1]), x0.values);
+            vertexAt(point.y, dimY, snapshot.cornerValues(index, corners[2]), snapshot.cornerValues(index, corners[3]), x1.values);
+            vertexAt(point.x, dimX, x0.values, x1.values, output.values);
+        }
+
+        // VertCube::vertexAt over bare value arrays
+        static void vertexAt(float x, int axis, const float* one, const float* two, float* output) {
+            float diff = two[axis] - one[axis];
+
+            if (diff == 0.f) {
+                std::copy(two, two + Vertex::numElements, output);
+                return;
+            }
+
+            float mult = (x - one[axis]) / diff;
+            NumberUtils::constrain(mult, 0.f, 1.f);
+
+            for (int i = 0; i < Vertex::numElements; ++i) {
+                output[i] = one[i] + mult * (two[i] - one[i]);
+            }
+        }
+
         static void expandUnitUpperBoundary(float& value) {
             if (value == 1.f) {
                 value += 0.000001f;
@@ -47,7 +47,15 @@ void GraphicRasterizer::restoreStateFrom(RenderState& state) {
     request.scalingMode = scalingModeFromRenderState(state.scalingType);
 }
 
-void GraphicRasterizer::saveStateTo(RenderState& state) {
+void GraphicRasterizer::copyBatchStateFrom(const GraphicRasterizer& other) {
+    copyRenderSettingsFrom(other);
+
+    RenderState state;
+    other.saveStateTo(state);
+    restoreStateFrom(state);
+}
+
+void GraphicRasterizer::saveStateTo(RenderState& state) const {
     const auto& request = getRequest();
     state.lowResCurves = request.lowResCurves;
     state.calcDepthDims = request.calcDepthDimensions;
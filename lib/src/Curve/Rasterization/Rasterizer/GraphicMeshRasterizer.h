@@ -43,9 +43,12 @@ public:
     GraphicRasterizer(bool cyclic, float margin);
 
     void restoreStateFrom(RenderState& state);
-    void saveStateTo(RenderState& state);
+    void saveStateTo(RenderState& state) const;
     ScopedRenderState preserveState(RenderState& state) { return ScopedRenderState(this, &state); }
 
+    // takes everything other renders with, including a batch state restored onto it
+    void copyBatchStateFrom(const GraphicRasterizer& other);
+
     int getNoiseSeed() const { return getRequest().noiseSeed; }
 
     void updateGeometry() override;
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <limits>
+
+#include "TimeColumnCache.h"
+
+namespace Rasterization {
+
+namespace {
+    const int morphDims[] = { Vertex::Time, Vertex::Red, Vertex::Blue };
+}
+
+bool TimeColumnCache::Region::contains(const float* point) const {
+    for (int d = 0; d < 3; ++d) {
+        if (point[d] < low[d] || point[d] > high[d]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TimeColumnCache::findMovedRegions(
+        const MeshSnapshot& before,
+        const MeshSnapshot& after,
+        std::vector<Region>& regions) {
+    regions.clear();
+
+    if (before.size() != after.size()) {
+        return false;
+    }
+
+    for (int i = 0; i < after.size(); ++i) {
+        if (before.getCube(i) != after.getCube(i)) {
+            return false;
+        }
+
+        // a cube's corners are contiguous
+        const float* was = before.cornerValues(i, 0);
+        const float* now = after.cornerValues(i, 0);
+
+        if (std::equal(was, was + MeshSnapshot::valuesPerCube, now)) {
+            continue;
+        }
+
+        Region region;
+        std::fill(region.low, region.low + 3, std::numeric_limits<float>::max());
+        std::fill(region.high, region.high + 3, std::numeric_limits<float>::lowest());
+
+        // where it was stops being sliced and where it is starts, so both count
+        for (const MeshSnapshot* snapshot : { &before, &after }) {
+            for (int corner = 0; corner < (int) VertCube::numVerts; ++corner) {
+                const float* values = snapshot->cornerValues(i, corner);
+
+                for (int d = 0; d < 3; ++d) {
+                    region.low[d]  = jmin(region.low[d],  values[morphDims[d]]);
+                    region.high[d] = jmax(region.high[d], values[morphDims[d]]);
+                }
+            }
+        }
+
+        regions.push_back(region);
+    }
+
+    return true;
+}
+
+bool TimeColumnCache::sameInputs(const TimeColumnRasterizer::Context& context) const {
+    if (!valid
+            || numColumns != context.numColumns
+            || columnSize != context.sumBuffer.size()
+            || primeDimension != context.primeDimension
+            || numActiveLayers != context.numActiveLayers
+            || panelPan != context.panelPan
+            || layers.size() != context.layers->size()
+            || (int) columnSizes.size() != context.numColumns) {
+        return false;
+    }
+
+    for (int i = 0; i < context.numColumns; ++i) {
+        const Column& column = (*context.columns)[(size_t) i];
+
+        if (columnSizes[(size_t) i] != column.size() || columnData[(size_t) i] != column.get()) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < layers.size(); ++i) {
+        const auto& layer = (*context.layers)[i];
+
+        if (layers[i].mesh != layer.mesh || layers[i].active != layer.active || layers[i].pan != layer.pan) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TimeColumnCache::findChangedColumns(
+        const TimeColumnRasterizer::Context& context,
+        std::vector<int>& changedColumns) {
+    jassert(context.layers != nullptr);
+    jassert(context.columns != nullptr);
+
+    const int numLayers = (int) context.layers->size();
+
+    nextPositions.resize((size_t) (context.numColumns * numLayers * 3));
+
+    for (int col = 0; col < context.numColumns; ++col) {
+        for (int layer = 0; layer < numLayers; ++layer) {
+            MorphPosition position = TimeColumnRasterizer::columnPosition(context, col, layer);
+            float* point = &nextPositions[(size_t) ((col * numLayers + layer) * 3)];
+
+            for (int d = 0; d < 3; ++d) {
+                point[d] = position[morphDims[d]].getCurrentValue();
+            }
+        }
+    }
+
+    nextSnapshots.resize((size_t) numLayers);
+
+    for (int layer = 0; layer < numLayers; ++layer) {
+        Mesh* mesh = (*context.layers)[(size_t) layer].mesh;
+
+        if (mesh != nullptr) {
+            nextSnapshots[(size_t) layer].build(*mesh);
+        } else {
+            nextSnapshots[(size_t) layer].clear();
+        }
+    }
+
+    bool onlyMoved = sameInputs(context) && positions == nextPositions;
+    int numMoved = 0;
+
+    if (onlyMoved) {
+        movedRegions.resize((size_t) numLayers);
+
+        for (int layer = 0; layer < numLayers && onlyMoved; ++layer) {
+            onlyMoved = findMovedRegions(snapshots[(size_t) layer], nextSnapshots[(size_t) layer], movedRegions[(size_t) layer]);
+            numMoved += (int) movedRegions[(size_t) layer].size();
+        }
+
+        onlyMoved &= numMoved > 0;
+    }
+
+    changedColumns.clear();
+
+    if (onlyMoved) {
+        for (int col = 0; col < context.numColumns; ++col) {
+            bool changed = false;
+
+            for (int layer = 0; layer < numLayers && !changed; ++layer) {
+                // inactive layers aren't rendered, so their edits don't show
+                if (!(*context.layers)[(size_t) layer].active) {
+                    continue;
+                }
+
+                const float* point = &nextPositions[(size_t) ((col * numLayers + layer) * 3)];
+
+                for (const auto& region : movedRegions[(size_t) layer]) {
+                    if (region.contains(point)) {
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+
+            if (changed) {
+                changedColumns.push_back(col);
+            }
+        }
+    }
+
+    snapshots.swap(nextSnapshots);
+    positions.swap(nextPositions);
+    layers = *context.layers;
+
+    columnSizes.resize((size_t) context.numColumns);
+    columnData.resize((size_t) context.numColumns);
+
+    for (int i = 0; i < context.numColumns; ++i) {
+        columnSizes[(size_t) i] = (*context.columns)[(size_t) i].size();
+        columnData[(size_t) i] = (*context.columns)[(size_t) i].get();
+    }
+
+    numColumns      = context.numColumns;
+    columnSize      = context.sumBuffer.size();
+    primeDimension  = context.primeDimension;
+    numActiveLayers = context.numActiveLayers;
+    panelPan        = context.panelPan;
+    valid           = true;
+
+    return onlyMoved;
+}
+
+}
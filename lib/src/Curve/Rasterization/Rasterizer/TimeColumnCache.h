@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+
+#include <Curve/Mesh/MeshSnapshot.h>
+#include <Curve/Rasterization/Rasterizer/TimeColumnRenderer.h>
+
+namespace Rasterization {
+
+/*
+ * Remembers what the time columns were last rendered from, so a render that
+ * follows a vertex edit only redoes the columns whose slices pass through a
+ * cube that moved.
+ *
+ * Anything else renders every column: different slice positions, layers or
+ * column sizes, cubes added or removed, or an update that changed no vertex
+ * at all, since that was sent for something this can't see, like a guide
+ * curve.
+ */
+class TimeColumnCache {
+public:
+    /*
+     * Compares the context's inputs with the last call's and remembers them.
+     * Returns true when only the columns left in changedColumns need
+     * rendering, which may be none, and false when all of them do.
+     */
+    bool findChangedColumns(const TimeColumnRasterizer::Context& context, std::vector<int>& changedColumns);
+
+    // for when the columns' contents are lost, like when their memory is freed
+    void invalidate() { valid = false; }
+
+private:
+    struct Region {
+        float low[3], high[3];
+
+        [[nodiscard]] bool contains(const float* point) const;
+    };
+
+    // the regions moved cubes covered before or after; false if the cubes themselves changed
+    static bool findMovedRegions(const MeshSnapshot& before, const MeshSnapshot& after, std::vector<Region>& regions);
+
+    bool sameInputs(const TimeColumnRasterizer::Context& context) const;
+
+    bool valid {};
+    int numColumns {};
+    int columnSize {};
+    int primeDimension {};
+    int numActiveLayers {};
+    float panelPan {};
+
+    std::vector<int> columnSizes;
+    std::vector<const float*> columnData;
+    std::vector<TimeColumnRasterizer::Layer> layers;
+    std::vector<MeshSnapshot> snapshots, nextSnapshots;
+    std::vector<float> positions, nextPositions;  // time, red and blue, by column then layer
+    std::vector<std::vector<Region>> movedRegions;
+};
+
+}
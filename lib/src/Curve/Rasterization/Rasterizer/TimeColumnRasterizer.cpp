@@ -1,77 +1,134 @@
+#include <atomic>
+
+#include <Thread/RealtimeWorkerPool.h>
 #include <Util/Arithmetic.h>
 
 #include "TimeColumnRenderer.h"
 
 namespace Rasterization {
 
+MorphPosition TimeColumnRasterizer::columnPosition(const Context& context, int colIdx, int layerIdx) {
+    int timeColIdx = jmin(context.zoomProgress.size() - 1, colIdx * context.timeIncrement);
+    float progress = context.zoomProgress[timeColIdx];
+
+    MorphPosition position = context.rasterizer->getMorphPosition();
+    position[context.primeDimension].setValueDirect(progress);
+
+    float scratchTime = context.primeDimension != Vertex::Time ? context.panelTime : progress;
+
+    if (context.primeDimension == Vertex::Time
+            && context.useScratchTime
+            && context.resolveScratchTime) {
+        context.resolveScratchTime(layerIdx, timeColIdx, progress, scratchTime);
+    }
+
+    position.time.setValueDirect(scratchTime);
+    return position;
+}
+
 void TimeColumnRasterizer::render(Context context) const {
     jassert(context.layers != nullptr);
     jassert(context.rasterizer != nullptr);
     jassert(context.columns != nullptr);
 
-    int nextPow2 = context.sumBuffer.size();
+    const std::vector<int>* subset = context.columnsToRender;
+    const int numToRender = subset != nullptr ? (int) subset->size() : context.numColumns;
+    const int numTiles = (numToRender + columnsPerTile - 1) / columnsPerTile;
+
+    auto columnAt = [subset](int index) {
+        return subset != nullptr ? (*subset)[(size_t) index] : index;
+    };
+
+    auto isCancelled = [&context] {
+        return context.cancelled != nullptr && context.cancelled->load(std::memory_order_relaxed);
+    };
+
+    auto renderTile = [&](const Lane& lane, int tile) {
+        int first = tile * columnsPerTile;
+        int end = jmin(numToRender, first + columnsPerTile);
+
+        for (int i = first; i < end; ++i) {
+            renderColumn(context, lane, columnAt(i));
+        }
+
+        if (context.tileRendered) {
+            context.tileRendered(first, end);
+        }
+    };
+
+    if (context.pool == nullptr || context.lanes == nullptr || context.lanes->empty() || numTiles < 2) {
+        Lane lane { context.rasterizer, context.layerBuffer, context.sumBuffer };
+
+        for (int tile = 0; tile < numTiles && !isCancelled(); ++tile) {
+            renderTile(lane, tile);
+        }
+
+        return;
+    }
+
+    // lanes pull tiles until none are left, so a lane whose columns are cheap takes more of them
+    std::atomic<int> nextTile { 0 };
+
+    auto job = [&](int laneIndex) {
+        const Lane& lane = (*context.lanes)[(size_t) laneIndex];
+
+        for (int tile = nextTile++; tile < numTiles && !isCancelled(); tile = nextTile++) {
+            renderTile(lane, tile);
+        }
+    };
+
+    context.pool->parallelFor(jmin((int) context.lanes->size(), numTiles), job);
+}
+
+void TimeColumnRasterizer::renderColumn(const Context& context, const Lane& lane, int colIdx) const {
+    GraphicRasterizer* rasterizer = lane.rasterizer;
+    Column& column = (*context.columns)[colIdx];
+
+    int nextPow2 = lane.sumBuffer.size();
+
+    if (context.primeDimension == Vertex::Red) {
+        nextPow2 = column.size();
+    }
+
     double delta = nextPow2 > 0 ? 1.0 / double(nextPow2) : 0.0;
 
-    for (int colIdx = 0; colIdx < context.numColumns; ++colIdx) {
-        int timeColIdx = jmin(context.zoomProgress.size() - 1, colIdx * context.timeIncrement);
-        Column& column = (*context.columns)[colIdx];
+    lane.sumBuffer.zero();
 
-        if (context.primeDimension == Vertex::Red) {
-            nextPow2 = column.size();
-            delta = 1.0 / double(nextPow2);
+    for (int layerIdx = 0; layerIdx < (int) context.layers->size(); ++layerIdx) {
+        Buffer<float> localBuffer = context.numActiveLayers == 1
+                                        ? lane.sumBuffer.withSize(nextPow2)
+                                        : Buffer<float>(
+                                                  lane.layerBuffer + layerIdx * nextPow2,
+                                                  nextPow2);
+
+        const Layer& layer = (*context.layers)[layerIdx];
+        if (!layer.active || layer.mesh == nullptr || !layer.mesh->hasEnoughCubesForCrossSection()) {
+            continue;
         }
 
-        context.rasterizer->getMorphPosition()[context.primeDimension].setValueDirect(
-                context.zoomProgress[timeColIdx]);
-
-        context.sumBuffer.zero();
-
-        for (int layerIdx = 0; layerIdx < (int) context.layers->size(); ++layerIdx) {
-            Buffer<float> localBuffer = context.numActiveLayers == 1
-                                            ? context.sumBuffer.withSize(nextPow2)
-                                            : Buffer<float>(
-                                                      context.layerBuffer + layerIdx * nextPow2,
-                                                      nextPow2);
-
-            const Layer& layer = (*context.layers)[layerIdx];
-            if (!layer.active || layer.mesh == nullptr || !layer.mesh->hasEnoughCubesForCrossSection()) {
-                continue;
-            }
-
-            float scratchTime = context.primeDimension != Vertex::Time
-                                    ? context.panelTime
-                                    : context.zoomProgress[timeColIdx];
-
-            if (context.primeDimension == Vertex::Time
-                    && context.useScratchTime
-                    && context.resolveScratchTime) {
-                context.resolveScratchTime(
-                        layerIdx,
-                        timeColIdx,
-                        context.zoomProgress[timeColIdx],
-                        scratchTime);
-            }
-
-            context.rasterizer->setNoiseSeed(noiseSeedForColumnLayer(colIdx, layerIdx));
-            context.rasterizer->setYellow(scratchTime);
-            context.rasterizer->renderWaveformOnly(layer.mesh, 0.f);
-
-            auto sampler = context.rasterizer->sampler();
-            if (!sampler.isSampleable()) {
-                localBuffer.zero();
-                continue;
-            }
-
-            sampler.sampleWithInterval(localBuffer, delta, 0.0);
-            localBuffer.mul(Arithmetic::getRelativePan(layer.pan, context.panelPan));
-
-            if (context.numActiveLayers > 1) {
-                context.sumBuffer.add(localBuffer);
-            }
+        MorphPosition position = columnPosition(context, colIdx, layerIdx);
+
+        rasterizer->getMorphPosition()[context.primeDimension].setValueDirect(
+                position[context.primeDimension].getCurrentValue());
+        rasterizer->setNoiseSeed(noiseSeedForColumnLayer(colIdx, layerIdx));
+        rasterizer->setYellow(position.time.getCurrentValue());
+        rasterizer->renderWaveformOnly(layer.mesh, 0.f);
+
+        auto sampler = rasterizer->sampler();
+        if (!sampler.isSampleable()) {
+            localBuffer.zero();
+            continue;
         }
 
-        context.sumBuffer.copyTo(column);
+        sampler.sampleWithInterval(localBuffer, delta, 0.0);
+        localBuffer.mul(Arithmetic::getRelativePan(layer.pan, context.panelPan));
+
+        if (context.numActiveLayers > 1) {
+            lane.sumBuffer.add(localBuffer);
+        }
     }
+
+    lane.sumBuffer.copyTo(column);
 }
 
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <vector>
 
@@ -8,6 +9,8 @@
 #include <Curve/Mesh/Mesh.h>
 #include <Curve/Rasterization/Rasterizer/GraphicMeshRasterizer.h>
 
+class RealtimeWorkerPool;
+
 namespace Rasterization {
 
 class TimeColumnRasterizer {
@@ -20,6 +23,13 @@ public:
 
     using ScratchTimeResolver = std::function<bool(int, int, float, float&)>;
 
+    // a rasterizer and scratch buffers of the same sizes as the context's, one per job on the pool
+    struct Lane {
+        GraphicRasterizer* rasterizer {};
+        Buffer<float> layerBuffer;
+        Buffer<float> sumBuffer;
+    };
+
     struct Context {
         const std::vector<Layer>* layers {};
         GraphicRasterizer* rasterizer {};
@@ -37,8 +47,27 @@ public:
         float panelTime {};
         float panelPan { 0.5f };
         bool useScratchTime {};
+
+        // only these columns are rendered when set; the rest are left as they are
+        const std::vector<int>* columnsToRender {};
+
+        // called by the lane that finished a tile, with the tile's span of the render order
+        std::function<void(int, int)> tileRendered;
+
+        // checked before each tile; once set, the tiles not yet started are left as they are
+        const std::atomic<bool>* cancelled {};
+
+        /*
+         * Tiles of columns are spread over the lanes when both are set. The lanes'
+         * rasterizers must carry the same render settings as rasterizer, and the
+         * scratch time resolver must be safe to call from the pool's threads.
+         */
+        RealtimeWorkerPool* pool {};
+        std::vector<Lane>* lanes {};
     };
 
+    static constexpr int columnsPerTile = 16;
+
     static int noiseSeedForLayer(int layerIndex) {
         return layerIndex * 104729;
     }
@@ -47,7 +76,13 @@ public:
         return columnIndex * 6197 + noiseSeedForLayer(layerIndex);
     }
 
+    // the position column colIdx of layer layerIdx is sliced at
+    static MorphPosition columnPosition(const Context& context, int colIdx, int layerIdx);
+
     void render(Context context) const;
+
+private:
+    void renderColumn(const Context& context, const Lane& lane, int colIdx) const;
 };
 
 }
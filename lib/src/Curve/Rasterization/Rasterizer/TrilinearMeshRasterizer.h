@@ -3,6 +3,7 @@
 #include <vector>
 
 #include <Curve/Mesh/Mesh.h>
+#include <Curve/Mesh/MeshSnapshot.h>
 #include <Curve/Rasterization/Builders/CurveWaveformBuilder.h>
 #include <Curve/Rasterization/GuideCurveOffsetSeeds.h>
 #include <Curve/Rasterization/Interpolation/TrilinearMeshSlicer.h>
@@ -228,6 +229,14 @@ namespace Rasterization {
             guideCurveOffsetSeeds.derive(layerSize, tableSize, seed);
         }
 
+        // so another rasterizer renders the same as this one, e.g. on a worker thread
+        void copyRenderSettingsFrom(const TrilinearMeshRasterizer& other) {
+            mesh = other.mesh;
+            request = other.request;
+            guideCurveProvider = other.guideCurveProvider;
+            guideCurveOffsetSeeds = other.guideCurveOffsetSeeds;
+        }
+
     protected:
         void reserveTrilinearStorage(
                 size_t interceptCapacity,
@@ -241,6 +250,7 @@ namespace Rasterization {
             output.colorPoints.reserve(interceptCapacity);
             output.waveformMemory.ensureSize(waveformCapacity * 5);
             output.fixedWaveformCapacity = true;
+            meshSnapshot.reserve((int) interceptCapacity);
         }
 
         RasterizationRequest& compatibilityRequest() {
@@ -256,16 +266,27 @@ namespace Rasterization {
             publishSnapshot(createSnapshotSource());
         }
 
+        // panel updates follow edits made in place, so they always recapture the mesh
         void updateTrilinearGeometry(float oscPhase) {
+            meshSnapshot.clear();
             renderTrilinearGeometry(oscPhase);
             publishTrilinearSnapshot();
         }
 
         void updateTrilinearWaveform(float oscPhase) {
+            meshSnapshot.clear();
             renderTrilinearWaveform(oscPhase);
             publishTrilinearSnapshot();
         }
 
+        const MeshSnapshot& snapshotOf(const Mesh& renderMesh) {
+            if (!meshSnapshot.isCurrentFor(renderMesh)) {
+                meshSnapshot.build(renderMesh);
+            }
+
+            return meshSnapshot;
+        }
+
         Mesh* mesh {};
 
         void clearTrilinearOutput() {
@@ -297,7 +318,7 @@ namespace Rasterization {
                     &needsResorting,
                     renderRequest);
             meshSlicer.sliceMesh(
-                    &renderMesh,
+                    snapshotOf(renderMesh),
                     renderRequest,
                     oscPhase,
                     guideApplier,
@@ -337,6 +358,7 @@ namespace Rasterization {
         RasterizationRequest request;
         GuideCurveOffsetSeeds guideCurveOffsetSeeds;
         TrilinearMeshSlicer meshSlicer;
+        MeshSnapshot meshSnapshot;
         CurveWaveformBuilder waveformBuilder;
         RenderResult output;
         VertCube::ReductionData reduction;
@@ -202,9 +202,13 @@ const RenderResult& VoiceRasterizer::renderVoiceSlice(float oscPhase) {
             &chainResult.needsResorting,
             getRequest());
 
-    auto& cubes = mesh->getCubes();
-    for (int i = 0; i < (int) cubes.size(); ++i) {
-        appendVoiceCubeIntercept(cubes[i], voiceTime, oscPhase, guideApplier, sliceResult.intercepts);
+    const MeshSnapshot& snapshot = snapshotOf(*mesh);
+    const MorphPosition voiceMorph = getRequest().morph.withTime(voiceTime);
+
+    for (int i : snapshot.candidatesAt(voiceMorph)) {
+        if (voiceSlicer.slice(snapshot, i, Vertex::Time, chainReduction, voiceMorph)) {
+            appendVoiceCubeIntercept(snapshot.getCube(i), voiceTime, oscPhase, guideApplier, sliceResult.intercepts);
+        }
     }
 
     std::sort(sliceResult.intercepts.begin(), sliceResult.intercepts.end());
@@ -221,12 +225,6 @@ void VoiceRasterizer::appendVoiceCubeIntercept(
         float oscPhase,
         GuideCurveApplier& applyGuide,
         std::vector<Intercept>& intercepts) {
-    voiceSlicer.slice(
-            *cube,
-            Vertex::Time,
-            chainReduction,
-            getRequest().morph.withTime(voiceTime));
-
     Vertex* a = &chainReduction.v0;
     Vertex* b = &chainReduction.v1;
     Vertex* vertex = &chainReduction.v;
@@ -1,7 +1,13 @@
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "Updater.h"
 #include "../../App/Settings.h"
 #include "../../App/SingletonRepo.h"
 #include "../../Definitions.h"
+#include "../../Thread/RealtimeWorkerPool.h"
 
 namespace {
 
@@ -26,6 +32,19 @@ Updater::Updater(SingletonRepo* repo) :
     ,   throttleUpdates     (true) {
 }
 
+Updater::~Updater() = default;
+
+void Updater::setUpdateWorkers(int numWorkers) {
+    graph.setWorkerPool(nullptr);
+    updatePool = nullptr;
+
+    if (numWorkers > 0) {
+        // these share cores with the audio thread, so they must not outrank it
+        updatePool = std::make_unique<RealtimeWorkerPool>(numWorkers, Thread::Priority::normal);
+        graph.setWorkerPool(updatePool.get());
+    }
+}
+
 void Updater::update(int code, UpdateType type) {
     Node* node = startingNodes[code];
 
@@ -46,9 +65,12 @@ void Updater::update(int code, UpdateType type) {
         lastUpdateMillis = Time::currentTimeMillis();
 
         graph.setUpdateType(type);
-        graph.setUpdateContext(String(getUpdateTypeName(type)) + " from " +
-                               (node != nullptr && node->getDebugName().isNotEmpty() ? node->getDebugName()
-                                                                                     : "unnamed"));
+
+        if (graph.isPrintingPath()) {
+            graph.setUpdateContext(String(getUpdateTypeName(type)) + " from " +
+                                   (node->getDebugName().isNotEmpty() ? node->getDebugName() : "unnamed"));
+        }
+
         graph.update(node);
 
         sendChangeMessage();
@@ -118,46 +140,228 @@ void Updater::handleAsyncUpdate() {
 
 Updater::Graph::Graph(SingletonRepo* repo) :
         SingletonAccessor(repo, "UpdateGraph")
+    ,   printsPath(false)
+    ,   passInFlight(false)
+    ,   numPasses(0)
     ,   updateType(Update)
-    ,   printsPath(false) {
+    ,   workerPool(nullptr) {
 }
 
 void Updater::Graph::update(Node* startingNode) {
-    reset();
-    startingNode->markPath();
+    // an update that asks for another pass waits for this one to finish
+    if (passInFlight) {
+        std::pair<Node*, UpdateType> request(startingNode, updateType);
+
+        if (std::find(deferredUpdates.begin(), deferredUpdates.end(), request) == deferredUpdates.end()) {
+            deferredUpdates.push_back(request);
+        }
+
+        return;
+    }
+
+    passInFlight = true;
+    runPass(scheduleFor(startingNode), updateType);
+
+    while (! deferredUpdates.empty()) {
+        vector<std::pair<Node*, UpdateType>> requests;
+        requests.swap(deferredUpdates);
+
+        // requests of one type share a pass, so their common downstream updates once
+        for (size_t i = 0; i < requests.size();) {
+            UpdateType type = requests[i].second;
+            Array<Node*> nodes;
+
+            for (; i < requests.size() && requests[i].second == type; ++i) {
+                nodes.add(requests[i].first);
+            }
+
+            if (nodes.size() == 1) {
+                runPass(scheduleFor(nodes.getFirst()), type);
+            } else {
+                runPass(buildSchedule(nodes), type);
+            }
+        }
+    }
+
+    passInFlight = false;
+}
+
+const Updater::Graph::Schedule& Updater::Graph::scheduleFor(Node* startingNode) {
+    Schedule& schedule = schedules[startingNode];
 
-    String path = String();
+    if (schedule.revision != Node::topologyRevision) {
+        schedule = buildSchedule(Array<Node*>(startingNode));
+    }
+
+    return schedule;
+}
+
+/*
+ * The nodes reached are the same as a depth-first walk from the marked head
+ * nodes would update: every child of a reached node, and every marked parent
+ * of one. A node's level is one past its deepest reached parent.
+ */
+Updater::Graph::Schedule Updater::Graph::buildSchedule(const Array<Node*>& startingNodes) const {
+    std::unordered_set<Node*> marked;
+
+    for (auto startingNode : startingNodes) {
+        for (auto node : startingNode->nodesToMark) {
+            marked.insert(node);
+        }
+    }
+
+    vector<Node*> reached;
+    std::unordered_set<Node*> reachedSet;
+
+    auto reach = [&](Node* node) {
+        if (reachedSet.insert(node).second) {
+            reached.push_back(node);
+        }
+    };
 
     for (auto headNode : headNodes) {
-        if(headNode->isDirty()) {
-            headNode->performUpdate(path, updateType, printsPath);
+        if (marked.count(headNode) > 0) {
+            reach(headNode);
+        }
+    }
+
+    for (size_t i = 0; i < reached.size(); ++i) {
+        Node* node = reached[i];
+
+        for (auto child : node->children) {
+            reach(child);
+        }
+
+        for (auto parent : node->parents) {
+            if (marked.count(parent) > 0) {
+                reach(parent);
+            }
         }
     }
 
-    if(printsPath) {
-        String action = updateContext;
+    std::unordered_map<Node*, int> levels;
 
-        if (String extra = getUpdateString(); extra.isNotEmpty()) {
-            action << " " << extra;
+    std::function<int(Node*)> levelOf = [&](Node* node) {
+        if (auto it = levels.find(node); it != levels.end()) {
+            jassert(it->second >= 0); // a cycle in the update graph
+            return jmax(0, it->second);
+        }
+
+        levels[node] = -1;
+        int level = 0;
+
+        for (auto parent : node->parents) {
+            if (reachedSet.count(parent) > 0) {
+                level = jmax(level, levelOf(parent) + 1);
+            }
         }
 
-        path = "Update: " + action + "\t" + path;
-        DBG(path);
+        levels[node] = level;
+        return level;
+    };
 
-        lastPath = path;
+    Schedule schedule;
+    schedule.revision = Node::topologyRevision;
+
+    for (auto node : reached) {
+        auto level = (size_t) levelOf(node);
+
+        if (schedule.levels.size() <= level) {
+            schedule.levels.resize(level + 1);
+        }
+
+        schedule.levels[level].push_back(node);
     }
+
+    return schedule;
+}
+
+void Updater::Graph::runPass(const Schedule& schedule, UpdateType type) {
+    ++numPasses;
+
+    for (auto& level : schedule.levels) {
+        for (auto node : level) {
+            node->updated = false;
+            node->dirty = true;
+        }
+    }
+
+    for (auto& level : schedule.levels) {
+        runLevel(level, type);
+    }
+
+    if (printsPath) {
+        tracePass(schedule);
+    }
+}
+
+void Updater::Graph::runLevel(const vector<Node*>& level, UpdateType type) {
+    concurrentScratch.clear();
+
+    if (workerPool != nullptr) {
+        for (auto node : level) {
+            if (node->isConcurrent()) {
+                concurrentScratch.push_back(node);
+            }
+        }
+    }
+
+    if (concurrentScratch.size() > 1) {
+        auto job = [this, type](int index) {
+            concurrentScratch[(size_t) index]->executeUpdate(type);
+        };
+
+        workerPool->parallelFor((int) concurrentScratch.size(), job);
+    } else {
+        concurrentScratch.clear();
+    }
+
+    for (auto node : level) {
+        if (std::find(concurrentScratch.begin(), concurrentScratch.end(), node) == concurrentScratch.end()) {
+            node->executeUpdate(type);
+        }
+
+        node->updated = true;
+        node->dirty = false;
+    }
+}
+
+void Updater::Graph::tracePass(const Schedule& schedule) {
+    String path;
+
+    for (auto& level : schedule.levels) {
+        for (auto node : level) {
+            if (node->toUpdate != nullptr) {
+                path << (node->debugName.isNotEmpty() ? node->debugName : node->toUpdate->getUpdateName()) << " ";
+            }
+        }
+    }
+
+    String action = updateContext;
+
+    if (String extra = getUpdateString(); extra.isNotEmpty()) {
+        action << " " << extra;
+    }
+
+    path = "Update: " + action + "\t" + path;
+    DBG(path);
+
+    lastPath = path;
 }
 
 void Updater::Graph::addHeadNode(Node* node) {
     headNodes.addIfNotAlreadyThere(node);
+    Node::topologyChanged();
 }
 
 void Updater::Graph::addHeadNodes(Array<Node*> nodes) {
     headNodes.addArray(nodes);
+    Node::topologyChanged();
 }
 
 void Updater::Graph::removeHeadNode(Node* node) {
     headNodes.removeFirstMatchingValue(node);
+    Node::topologyChanged();
 }
 
 void Updater::Graph::reset() {
@@ -171,11 +375,13 @@ void Updater::Graph::reset() {
 Updater::Node::Node() :
         updated(false)
     ,   dirty(false)
+    ,   concurrent(false)
     ,   toUpdate(nullptr) {}
 
 Updater::Node::Node(Updateable* objectToUpdate) :
         updated(false)
     ,   dirty(false)
+    ,   concurrent(false)
     ,   toUpdate(objectToUpdate) {
     if (toUpdate != nullptr) {
         debugName = toUpdate->getUpdateName();
@@ -185,16 +391,20 @@ Updater::Node::Node(Updateable* objectToUpdate) :
 void Updater::Node::updatesAfter(Node* parent) {
     parent->children.addIfNotAlreadyThere(this);
     parents.addIfNotAlreadyThere(parent);
+    topologyChanged();
 }
 
 void Updater::Node::marks(Array<Node*> nodes) {
     for (int i = 0; i < nodes.size(); ++i) {
         nodesToMark.addIfNotAlreadyThere(nodes.getUnchecked(i));
     }
+
+    topologyChanged();
 }
 
 void Updater::Node::marks(Node* headNode) {
     nodesToMark.addIfNotAlreadyThere(headNode);
+    topologyChanged();
 }
 
 void Updater::Node::marksAndUpdatesAfter(Node* parent) {
@@ -205,43 +415,12 @@ void Updater::Node::marksAndUpdatesAfter(Node* parent) {
 void Updater::Node::doesntUpdateAfter(Node* parent) {
     parents.removeFirstMatchingValue(parent);
     parent->children.removeFirstMatchingValue(this);
+    topologyChanged();
 }
 
 void Updater::Node::doesntMark(Node* node) {
     nodesToMark.removeFirstMatchingValue(node);
-}
-
-void Updater::Node::performUpdate(String& updatePath, UpdateType updateType, bool shouldPrintPath) {
-    if(updated || ! dirty) {
-        return;
-    }
-
-    for(auto i : children) {
-        i->markDirty();
-    }
-
-    for(auto parent : parents) {
-        if(parent->isDirty()) {
-            parent->performUpdate(updatePath, updateType, shouldPrintPath);
-        }
-    }
-
-    // we can get here by a parent updating this
-    if (!updated) {
-        if(shouldPrintPath && toUpdate != nullptr) {
-            String name = debugName.isNotEmpty() ? debugName : toUpdate->getUpdateName();
-            updatePath << name << " ";
-        }
-
-        executeUpdate(updateType);
-
-        updated = true;
-        dirty = false;
-
-        for(auto node : children) {
-            node->performUpdate(updatePath, updateType, shouldPrintPath);
-        }
-    }
+    topologyChanged();
 }
 
 void Updater::Node::executeUpdate(UpdateType updateType) {
@@ -267,6 +446,7 @@ void Updater::Node::markPath() {
 
 void Updater::Node::marksAll(const Array<Node*>& nodes) {
     nodesToMark.addArray(nodes);
+    topologyChanged();
 }
 
 void Updater::Node::updatesAfterAll(const Array<Node*>& nodes) {
@@ -274,6 +454,8 @@ void Updater::Node::updatesAfterAll(const Array<Node*>& nodes) {
         nodes[i]->children.addIfNotAlreadyThere(this);
         parents.addIfNotAlreadyThere(nodes[i]);
     }
+
+    topologyChanged();
 }
 
 void Updater::setStartingNode(int code, Node* node) {
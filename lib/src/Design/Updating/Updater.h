@@ -2,6 +2,9 @@
 
 #include <map>
 #include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
 #include "Updateable.h"
 #include "../../App/SingletonAccessor.h"
 #include "../../Obj/Ref.h"
@@ -9,6 +12,9 @@
 
 using std::map;
 using std::deque;
+using std::vector;
+
+class RealtimeWorkerPool;
 
 class Updater :
         public SingletonAccessor
@@ -35,10 +41,13 @@ public:
 
         void reset();
         void markPath();
-        void performUpdate(String& path, UpdateType updateType, bool shouldPrintPath = false);
+
+        // the target may update on a worker alongside other concurrent nodes of its level
+        void setConcurrent(bool is)          { concurrent = is; }
 
         [[nodiscard]] bool isDirty() const   { return dirty;    }
         [[nodiscard]] bool isUpdated() const { return updated;  }
+        [[nodiscard]] bool isConcurrent() const { return concurrent; }
         [[nodiscard]] const Array<Node*>& getParents() const     { return parents;     }
         [[nodiscard]] const Array<Node*>& getChildren() const    { return children;    }
         [[nodiscard]] const Array<Node*>& getMarkedNodes() const { return nodesToMark; }
@@ -50,8 +59,13 @@ public:
         virtual void executeUpdate(UpdateType updateType);
 
     private:
+        // bumped by every edge or head change, so cached schedules know to rebuild
+        static void topologyChanged() { ++topologyRevision; }
+        inline static int topologyRevision = 0;
+
         bool updated;
         bool dirty;
+        bool concurrent;
 
         String debugName;
         Array<Node*> parents;
@@ -75,20 +89,51 @@ public:
         void removeHeadNode (Node* node);
         void update         (Node* node);
         void setUpdateContext(const String& context) { updateContext = context; }
+        void setWorkerPool  (RealtimeWorkerPool* pool) { workerPool = pool; }
 
         [[nodiscard]] const Array<Node*>& getHeadNodes() const { return headNodes; }
         void setUpdateType(UpdateType type)     { updateType = type; }
         void setPrintsPath(bool does)   { printsPath = does; }
 
+        [[nodiscard]] bool isPrintingPath() const       { return printsPath; }
+        [[nodiscard]] bool isUpdating() const           { return passInFlight; }
+        [[nodiscard]] const String& getLastPath() const { return lastPath; }
+        [[nodiscard]] int getNumPasses() const          { return numPasses; }
+
         virtual String getUpdateString() { return {}; }
 
     private:
+        /*
+         * The nodes a pass over one starting node reaches, grouped into
+         * topological levels: nothing in a level depends on another node of
+         * the same level, so a level's concurrent nodes can run side by side.
+         */
+        struct Schedule {
+            int revision { -1 };
+            vector<vector<Node*>> levels;
+        };
+
+        Schedule buildSchedule(const Array<Node*>& startingNodes) const;
+        const Schedule& scheduleFor(Node* startingNode);
+        void runPass(const Schedule& schedule, UpdateType type);
+        void runLevel(const vector<Node*>& level, UpdateType type);
+        void tracePass(const Schedule& schedule);
+
         bool printsPath;
+        bool passInFlight;
+        int numPasses;
         UpdateType updateType;
         String lastPath;
         String updateContext;
         Array<Node*> headNodes;
 
+        RealtimeWorkerPool* workerPool;
+        map<Node*, Schedule> schedules;
+        vector<Node*> concurrentScratch;
+
+        // requests made while a pass runs, each kept once, in order of arrival
+        vector<std::pair<Node*, UpdateType>> deferredUpdates;
+
         void reset() override;
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Graph);
@@ -106,9 +151,10 @@ public:
     /* ----------------------------------------------------------------------------- */
 
     explicit Updater(SingletonRepo* repo);
-    ~Updater() override = default;
+    ~Updater() override;
 
     void setThrottling(bool doThrottle, int threshMillis);
+    void setUpdateWorkers(int numWorkers);
     void update(int code, UpdateType type = Update);
     void clearPendingUpdates();
     void handleAsyncUpdate() override;
@@ -124,6 +170,7 @@ protected:
     int64 lastUpdateMillis;
 
     Graph graph;
+    std::unique_ptr<RealtimeWorkerPool> updatePool;
     map<int, Node*> startingNodes;
     Array<ChangeListener*> listeners;
     deque<PendingUpdate> pendingUpdates;
@@ -13,6 +13,7 @@
 #include "../App/MeshLibrary.h"
 #include "../App/Settings.h"
 #include "../App/SingletonRepo.h"
+#include "../Curve/Mesh/Mesh.h"
 #include "../Curve/Rasterization/Rasterizer/Rasterizer.h"
 #include "../Curve/Rasterization/Rasterizer/RasterizerData.h"
 #include "../Curve/Mesh/Vertex.h"
@@ -1400,6 +1401,7 @@ void Interactor::selectConnectedVerts(set<Vertex*>& alreadySeen, Vertex* current
 
 void Interactor::performUpdate(UpdateType updateType) {
     if (updateType == Update) {
+        markMeshEdited();
         updateDepthVerts();
         requestPanelRepaint();
     }
@@ -1422,9 +1424,20 @@ void Interactor::doGlobalUIUpdate(bool force) {
 }
 
 void Interactor::updateDspSync() {
+    markMeshEdited();
     performRasterizerUpdate(Update);
 }
 
+void Interactor::markMeshEdited() {
+    // vertices are dragged in place, so the mesh can't tell it changed
+    if (Mesh* mesh = getMesh()) {
+        mesh->markEdited();
+    }
+
+    // the audio thread renders from copies, which only a publish refreshes
+    getObj(MeshLibrary).publishRenderMeshes();
+}
+
 void Interactor::postUpdateMessage() {
     updateDspSync();
     performUpdate(Update);
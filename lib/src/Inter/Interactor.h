@@ -156,6 +156,7 @@ public:
     void performUpdate(UpdateType updateType) override;
     virtual void updateDepthVerts();
     virtual void updateDspSync();
+    void markMeshEdited();
     virtual bool doesMeshChangeWarrantGlobalUpdate();
     virtual bool shouldDoDimensionCheck();
     bool shouldValidateCollisions() const;
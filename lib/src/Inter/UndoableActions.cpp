@@ -55,6 +55,8 @@ void ResponsiveUndoableAction::performExtra() {
 }
 
 void ResponsiveUndoableAction::handleAsyncUpdate() {
+    // actions don't know which mesh they touched, and the rasterizers update before the interactors do
+    getObj(MeshLibrary).markAllMeshesEdited();
     doPreUpdateCheck();
     getObj(Updater).update(updateCode, Update);
     doPostUpdateCheck();
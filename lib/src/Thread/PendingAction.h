@@ -1,4 +1,13 @@
 #pragma once
+
+#include <atomic>
+#include <type_traits>
+
+/*
+ * A coalescing, lock-free mailbox from the message thread to the audio thread:
+ * any thread may trigger, the audio thread takes. Triggering again before the
+ * audio thread gets to it just replaces the value.
+ */
 class PendingAction {
 public:
     virtual ~PendingAction() = default;
@@ -12,45 +21,77 @@ public:
     }
 
     bool isPending() const {
-        return pending;
+        return pending.load(std::memory_order_acquire);
     }
 
     void trigger() {
-        pending = true;
+        pending.store(true, std::memory_order_release);
+    }
+
+    /**
+     * Clears and returns the pending flag in one step, so a trigger that
+     * arrives while the action is being handled is not lost.
+     */
+    bool takePending() {
+        return pending.exchange(false, std::memory_order_acq_rel);
     }
 
     virtual void dismiss() {
-        pending = false;
+        pending.store(false, std::memory_order_release);
     }
 
 protected:
     int id;
-    bool pending;
+    std::atomic<bool> pending;
 };
 
+namespace PendingActionDetail {
+    // small trivially copyable values are published atomically; anything bigger
+    // is left to the owner's own synchronisation, as before
+    template<class T, bool = std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(long long)>
+    class Storage {
+    public:
+        T load() const              { return value; }
+        void store(const T& v)      { value = v; }
+
+    private:
+        T value {};
+    };
+
+    template<class T>
+    class Storage<T, true> {
+    public:
+        T load() const              { return value.load(std::memory_order_acquire); }
+        void store(const T& v)      { value.store(v, std::memory_order_release); }
+
+    private:
+        std::atomic<T> value { T() };
+    };
+}
+
 template<class T>
 class PendingActionValue : public PendingAction {
 public:
     PendingActionValue(int type) : PendingAction(type) {}
 
     const T getValue() const {
-        return value;
+        return value.load();
     }
 
     T getValueAndDismiss() {
-        T ret = value;
+        T ret = value.load();
         dismiss();
         return ret;
     }
 
     void setValueAndTrigger(const T& value) {
-        this->value = value;
+        this->value.store(value);
 
         trigger();
     }
 
     void setValue(const T& value) {
-        this->value = value;
+        this->value.store(value);
     }
 
 //  void dismiss()
@@ -60,5 +101,5 @@ public:
 //  }
 
 private:
-    T value;
-};
\ No newline at end of file
+    PendingActionDetail::Storage<T> value;
+};
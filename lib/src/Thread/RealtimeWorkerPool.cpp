@@ -0,0 +1,116 @@
+#include <thread>
+
+#include "RealtimeWorkerPool.h"
+
+namespace {
+    constexpr uint64 indexMask = 0xffff;
+
+    uint64 packJobState(uint64 generation, int count) {
+        return (generation << 32) | ((uint64) count << 16);
+    }
+}
+
+class RealtimeWorkerPool::Worker : public Thread {
+public:
+    Worker(RealtimeWorkerPool& pool, int index) :
+            Thread("RealtimeWorker" + String(index))
+        ,   pool(pool) {
+    }
+
+    void run() override {
+        while (! threadShouldExit()) {
+            wake.wait(-1);
+
+            while (! threadShouldExit() && pool.claimAndRun()) {
+            }
+        }
+    }
+
+    void stop() {
+        signalThreadShouldExit();
+        wake.signal();
+        stopThread(1000);
+    }
+
+    WaitableEvent wake;
+
+private:
+    RealtimeWorkerPool& pool;
+};
+
+/* ----------------------------------------------------------------------------- */
+
+RealtimeWorkerPool::RealtimeWorkerPool(int numWorkers, Thread::Priority priority) {
+    for (int i = 0; i < numWorkers; ++i) {
+        workers.emplace_back(std::make_unique<Worker>(*this, i));
+        workers.back()->startThread(priority);
+    }
+}
+
+RealtimeWorkerPool::~RealtimeWorkerPool() {
+    for (auto& worker : workers) {
+        worker->stop();
+    }
+}
+
+int RealtimeWorkerPool::defaultWorkerCount() {
+    return jmax(0, SystemStats::getNumPhysicalCpus() - 1);
+}
+
+void RealtimeWorkerPool::dispatch(int count, void* context, JobFunction function) {
+    jassert(count <= maxJobCount);
+
+    if (count <= 0) {
+        return;
+    }
+
+    if (workers.empty() || count == 1) {
+        for (int i = 0; i < count; ++i) {
+            function(context, i);
+        }
+
+        return;
+    }
+
+    const uint64 generation = (jobState.load(std::memory_order_relaxed) >> 32) + 1;
+
+    jobContext = context;
+    jobFunction = function;
+    remaining.store(count, std::memory_order_relaxed);
+    jobState.store(packJobState(generation, count), std::memory_order_release);
+
+    const int wakeCount = jmin(count - 1, (int) workers.size());
+
+    for (int i = 0; i < wakeCount; ++i) {
+        workers[(size_t) i]->wake.signal();
+    }
+
+    while (claimAndRun()) {
+    }
+
+    // only in-flight indices remain, so this wait is bounded by one job's duration
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+    }
+}
+
+bool RealtimeWorkerPool::claimAndRun() {
+    uint64 state = jobState.load(std::memory_order_acquire);
+
+    for (;;) {
+        const int count = (int) ((state >> 16) & indexMask);
+        const int index = (int) (state & indexMask);
+
+        if (index >= count) {
+            return false;
+        }
+
+        if (jobState.compare_exchange_weak(state, state + 1, std::memory_order_acq_rel)) {
+            // the descriptor cannot change until this index is counted off below
+            jobFunction(jobContext, index);
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+
+            return true;
+        }
+    }
+}
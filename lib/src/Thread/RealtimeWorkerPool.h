@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "JuceHeader.h"
+
+using namespace juce;
+
+/*
+ * Pre-spawned workers that fan an indexed job out across cores from the audio
+ * thread. Dispatch neither allocates nor takes a lock other than the event used
+ * to wake idle workers; the calling thread claims indices alongside the workers
+ * and returns once every index in [0, count) has run exactly once.
+ *
+ * Results that need a deterministic order should be written to per-index
+ * storage by the job and combined by the caller after dispatch returns.
+ */
+class RealtimeWorkerPool {
+public:
+    using JobFunction = void (*)(void* context, int index);
+
+    static constexpr int maxJobCount = 0xffff;
+
+    // work off the audio thread (UI updates, imports) should pass a lower priority
+    explicit RealtimeWorkerPool(int numWorkers, Thread::Priority priority = Thread::Priority::highest);
+    ~RealtimeWorkerPool();
+
+    template<class Fn>
+    void parallelFor(int count, Fn& fn) {
+        dispatch(count, &fn, [](void* context, int index) {
+            (*static_cast<Fn*>(context))(index);
+        });
+    }
+
+    void dispatch(int count, void* context, JobFunction function);
+
+    int getNumWorkers() const { return (int) workers.size(); }
+    static int defaultWorkerCount();
+
+private:
+    class Worker;
+
+    bool claimAndRun();
+
+    // generation:32 | count:16 | next index:16, so a late worker can never
+    // claim an index against a job descriptor from a different dispatch
+    std::atomic<uint64> jobState { 0 };
+    std::atomic<int> remaining { 0 };
+
+    void* jobContext { nullptr };
+    JobFunction jobFunction { nullptr };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    JUCE_DECLARE_NON_COPYABLE(RealtimeWorkerPool)
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+/*
+ * Hands immutable snapshots from the message thread to the audio thread, the
+ * same way ConvReverb hands over its generations. The audio thread adopts the
+ * newest snapshot once per block and reads it until the next adopt, so an edit
+ * in progress never holds up or tears a block.
+ *
+ * Only raw pointers cross threads: adopting is a pair of atomic loads and a
+ * store, with no reference counting and no lock. The publisher owns every
+ * snapshot it handed out and frees, on a later publish, those that are neither
+ * published nor marked in use by the audio thread. A grace period covers state
+ * rendered from a snapshot that outlives the block it was adopted in, such as
+ * intercepts chained into the next cycle.
+ */
+template<class T>
+class SnapshotMailbox {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit SnapshotMailbox(
+            std::shared_ptr<const T> initial = std::make_shared<const T>()
+        ,   Clock::duration gracePeriod = Clock::duration::zero()) :
+            gracePeriod(gracePeriod)
+        ,   published(initial.get())
+        ,   inUse(initial.get())
+        ,   adopted(initial.get()) {
+        handedOut.push_back({ std::move(initial), {} });
+    }
+
+    SnapshotMailbox(const SnapshotMailbox&) = delete;
+    SnapshotMailbox& operator=(const SnapshotMailbox&) = delete;
+
+    // publishing thread
+
+    void publish(std::shared_ptr<const T> next) {
+        published.store(next.get(), std::memory_order_seq_cst);
+        handedOut.push_back({ std::move(next), {} });
+
+        freeReleased();
+    }
+
+    [[nodiscard]] std::shared_ptr<const T> latest() const { return handedOut.back().snapshot; }
+
+    [[nodiscard]] int numHeld() const { return (int) handedOut.size(); }
+
+    // audio thread
+
+    const T& adopt() {
+        const T* next = published.load(std::memory_order_seq_cst);
+
+        // mark it in use, then check it was not replaced in between: once the mark
+        // is visible with the pointer still published, the publisher sees the mark
+        // on every later publish and will not free it
+        for (;;) {
+            inUse.store(next, std::memory_order_seq_cst);
+            const T* check = published.load(std::memory_order_seq_cst);
+
+            if (check == next) {
+                break;
+            }
+
+            next = check;
+        }
+
+        adopted = next;
+        return *adopted;
+    }
+
+    [[nodiscard]] const T& current() const { return *adopted; }
+
+private:
+    struct HandedOut {
+        std::shared_ptr<const T> snapshot;
+        Clock::time_point releasedAt;
+    };
+
+    void freeReleased() {
+        const auto now = Clock::now();
+        const T* reading = inUse.load(std::memory_order_seq_cst);
+
+        // the newest is still published, so only older ones can have been let go of
+        auto first = handedOut.begin();
+        auto last = handedOut.end() - 1;
+
+        for (auto it = first; it != last; ++it) {
+            if (it->snapshot.get() == reading) {
+                it->releasedAt = {};
+            } else if (it->releasedAt == Clock::time_point {}) {
+                it->releasedAt = now;
+            }
+        }
+
+        handedOut.erase(std::remove_if(first, last, [this, now](const HandedOut& entry) {
+            return entry.releasedAt != Clock::time_point {} && now - entry.releasedAt >= gracePeriod;
+        }), last);
+    }
+
+    Clock::duration gracePeriod;
+
+    std::atomic<const T*> published;
+    std::atomic<const T*> inUse;
+    const T* adopted;
+    std::vector<HandedOut> handedOut;
+};
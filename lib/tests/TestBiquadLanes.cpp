@@ -0,0 +1,165 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <Algo/BiquadLanes.h>
+#include <Audio/Filters/Butterworth.h>
+#include <Audio/Filters/Filter.h>
+
+namespace {
+    constexpr double sampleRate = 44100.0;
+
+    std::vector<float> createSignal(int size, int seed) {
+        std::vector<float> signal((size_t) size);
+        Random random(seed);
+
+        for (int i = 0; i < size; ++i) {
+            signal[(size_t) i] = 0.4f * std::sin(0.03f * (float) (i * seed)) + 0.5f * (random.nextFloat() - 0.5f);
+        }
+
+        return signal;
+    }
+
+    void requireClose(const std::vector<float>& actual, const std::vector<float>& expected) {
+        REQUIRE(actual.size() == expected.size());
+
+        for (size_t i = 0; i < actual.size(); ++i) {
+            INFO("sample " << i);
+            REQUIRE(actual[i] == Catch::Approx(expected[i]).margin(1e-4));
+        }
+    }
+}
+
+TEST_CASE("BiquadLanes matches the per-sample cascade on each lane", "[filters][biquad-lanes]") {
+    constexpr int length = 3000;
+
+    Dsp::SimpleFilter<Dsp::Butterworth::LowPass<6>, 1> lowPass;
+    Dsp::SimpleFilter<Dsp::Butterworth::HighPass<6>, 1> highPass;
+    lowPass.setup(6, sampleRate, 2000.0);
+    highPass.setup(5, sampleRate, 300.0);
+
+    std::vector<float> expectedLow = createSignal(length, 1);
+    std::vector<float> expectedHigh = createSignal(length, 2);
+    float* lowChannel[] = { expectedLow.data() };
+    float* highChannel[] = { expectedHigh.data() };
+    lowPass.process(length, lowChannel);
+    highPass.process(length, highChannel);
+
+    // the high pass is of odd order, so its last section is first order
+    BiquadLanes lanes(lowPass.getNumStages());
+    REQUIRE(lanes.setCascade(0, 0, lowPass) == 3);
+    REQUIRE(lanes.setCascade(1, 0, highPass) == 3);
+
+    for (int blockSize : { 1, 13, 256, 1000, length }) {
+        INFO("block size " << blockSize);
+
+        std::vector<float> low = createSignal(length, 1);
+        std::vector<float> high = createSignal(length, 2);
+        lanes.clear();
+
+        for (int offset = 0; offset < length; offset += blockSize) {
+            const int size = jmin(blockSize, length - offset);
+            Buffer<float> channels[] = { { low.data() + offset, size }, { high.data() + offset, size } };
+            lanes.process(0, channels, 2);
+        }
+
+        requireClose(low, expectedLow);
+        requireClose(high, expectedHigh);
+    }
+}
+
+TEST_CASE("BiquadLanes keeps a low shelf near 20 Hz as precise as the cascade", "[filters][biquad-lanes]") {
+    constexpr double highSampleRate = 192000.0;
+    constexpr int length = 192000;
+
+    // poles this close to 1 are where float state strays from the double cascade by tens of dB
+    Dsp::SimpleFilter<Dsp::Butterworth::LowShelf<2>, 1> lowShelf;
+    lowShelf.setup(2, highSampleRate, 20.0, 12.0);
+
+    std::vector<float> expected = createSignal(length, 7);
+    for (int i = 0; i < length; ++i) {
+        expected[(size_t) i] += 0.3f * (float) std::sin(MathConstants<double>::twoPi * 30.0 * i / highSampleRate);
+    }
+    std::vector<float> actual = expected;
+
+    float* channel[] = { expected.data() };
+    lowShelf.process(length, channel);
+
+    BiquadLanes lanes(lowShelf.getNumStages());
+    lanes.setCascade(0, 0, lowShelf);
+
+    for (int offset = 0; offset < length; offset += 512) {
+        lanes.process(0, { actual.data() + offset, jmin(512, length - offset) });
+    }
+
+    requireClose(actual, expected);
+}
+
+TEST_CASE("BiquadLanes leaves other lanes' histories alone", "[filters][biquad-lanes]") {
+    constexpr int length = 500;
+
+    Dsp::SimpleFilter<Dsp::Butterworth::LowPass<4>> lowPass;
+    lowPass.setup(4, sampleRate, 1000.0);
+
+    BiquadLanes together(lowPass.getNumStages()), apart(lowPass.getNumStages());
+    for (int lane = 0; lane < BiquadLanes::numLanes; ++lane) {
+        together.setCascade(lane, 0, lowPass);
+        apart.setCascade(lane, 0, lowPass);
+    }
+
+    std::vector<float> left = createSignal(length, 3), right = createSignal(length, 4);
+    std::vector<float> apartLeft = left, apartRight = right;
+
+    // halves, so each lane's history must carry over while the other lane runs
+    for (int offset : { 0, length / 2 }) {
+        Buffer<float> channels[] = { { left.data() + offset, length / 2 }, { right.data() + offset, length / 2 } };
+        together.process(2, channels, 2);
+
+        apart.process(2, { apartLeft.data() + offset, length / 2 });
+        apart.process(3, { apartRight.data() + offset, length / 2 });
+    }
+
+    REQUIRE(apartLeft == left);
+    REQUIRE(apartRight == right);
+}
+
+TEST_CASE("BiquadLanes throughput against the per-sample cascade", "[filters][biquad-lanes][benchmark][.]") {
+    constexpr int samplesPerRun = 1 << 20;
+
+    // five sections, like the equalizer's bands
+    Dsp::SimpleFilter<Dsp::Butterworth::LowPass<10>, 2> cascade;
+    cascade.setup(10, sampleRate, 4000.0);
+
+    BiquadLanes lanes(cascade.getNumStages());
+    lanes.setCascade(0, 0, cascade);
+    lanes.setCascade(1, 0, cascade);
+
+    for (int blockSize : { 64, 256, 1024 }) {
+        std::vector<float> left = createSignal(blockSize, 5), right = createSignal(blockSize, 6);
+        float* channels[] = { left.data(), right.data() };
+        Buffer<float> buffers[] = { { left.data(), blockSize }, { right.data(), blockSize } };
+        const int blocks = samplesPerRun / blockSize;
+
+        double start = Time::getMillisecondCounterHiRes();
+        for (int block = 0; block < blocks; ++block) {
+            cascade.process(blockSize, channels);
+        }
+        double perSample = Time::getMillisecondCounterHiRes() - start;
+
+        start = Time::getMillisecondCounterHiRes();
+        for (int block = 0; block < blocks; ++block) {
+            lanes.process(0, buffers, 2);
+        }
+        double laned = Time::getMillisecondCounterHiRes() - start;
+
+        const double frames = (double) blocks * blockSize * 1e-3;
+        std::cout << "block " << blockSize << ", " << cascade.getNumStages() << " sections: per-sample "
+                  << frames / perSample << " M stereo frames/s, lanes " << frames / laned << " M stereo frames/s"
+                  << " (" << perSample / laned << "x)" << std::endl;
+
+        REQUIRE(std::isfinite(left[0] + right[0]));
+    }
+}
@@ -1,7 +1,10 @@
 #include <App/MemoryPool.h>
+#include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include "JuceHeader.h"
 using namespace juce;
+#include <iostream>
+#include <thread>
 #include "../src/Algo/ConvReverb.h"
 #include "../src/Array/ScopedAlloc.h"
 #include "../src/Audio/CycleDsp/ReverbKernel.h"
@@ -175,6 +178,7 @@ TEST_CASE("ConvReverb Convolution Accuracy", "[ConvReverb]") {
         ConvReverb::basicConvolve(input, ir, reference);
 
         // Initialize two-stage convolution
+        reverb.setWaitsForLateJobs(true);
         reverb.init(headSize, tailSize, ir);
 
         int processedIn = 0, processedOut = 0;
@@ -199,6 +203,124 @@ TEST_CASE("ConvReverb Convolution Accuracy", "[ConvReverb]") {
     }
 }
 
+TEST_CASE("ConvReverb stages grow from the head block to the tail block", "[ConvReverb]") {
+    const int kernelSize = 16384;
+    ScopedAlloc<float> kernelAlloc(kernelSize);
+    Buffer<float> kernel(kernelAlloc.get(), kernelSize);
+    TestConvReverb::generateTestIR(kernel);
+
+    ConvReverb reverb;
+    reverb.init(64, 1024, kernel);
+
+    // 64, 128, 256, 512 and a 1024 stage for the remainder; above 128 is the worker's
+    CHECK(reverb.getNumStages() == 5);
+    CHECK(reverb.getNumBackgroundStages() == 3);
+
+    reverb.setBackgroundProcessing(false);
+    reverb.init(64, 1024, kernel);
+    CHECK(reverb.getNumStages() == 5);
+    CHECK(reverb.getNumBackgroundStages() == 0);
+
+    reverb.init(64, 1024, kernel.withSize(100));
+    CHECK(reverb.getNumStages() == 0);
+}
+
+TEST_CASE("ConvReverb non-uniform stages match direct convolution", "[ConvReverb]") {
+    const int inputSize = 6000;
+    const int irSize = 8192 + 77;
+    const int outputSize = inputSize + irSize - 1;
+
+    ScopedAlloc<float> memory(inputSize + irSize + outputSize * 2 + 512);
+    Buffer<float> input = memory.place(inputSize);
+    Buffer<float> ir = memory.place(irSize);
+    Buffer<float> reference = memory.place(outputSize);
+    Buffer<float> output = memory.place(outputSize);
+    Buffer<float> buffer = memory.place(512);
+
+    TestConvReverb::generateTestSignal(input);
+    TestConvReverb::generateTestIR(ir);
+    ConvReverb::basicConvolve(input, ir, reference);
+    const float tolerance = 1e-3f * jmax(reference.max(), -reference.min());
+
+    for (bool background : { false, true }) {
+        INFO("background " << background);
+
+        ConvReverb reverb;
+        reverb.setBackgroundProcessing(background);
+        // callbacks come far faster than realtime here, so late blocks are waited for
+        reverb.setWaitsForLateJobs(true);
+        reverb.init(32, 2048, ir);
+
+        // ragged callbacks so stage boundaries land mid-call
+        int processed = 0, seed = 7;
+        while (processed < outputSize) {
+            int toProcess = jmin(outputSize - processed, 1 + seed % 300);
+            seed = seed * 37 + 331;
+
+            Buffer<float> subBuffer = buffer.withSize(toProcess);
+            subBuffer.zero();
+            if (processed < inputSize) {
+                input.section(processed, jmin(toProcess, inputSize - processed)).copyTo(subBuffer);
+            }
+
+            reverb.process(subBuffer, output.section(processed, toProcess));
+            processed += toProcess;
+        }
+
+        float maxError = 0;
+        for (int i = 0; i < outputSize; ++i) {
+            maxError = jmax(maxError, fabsf(output[i] - reference[i]));
+        }
+
+        CHECK(maxError <= tolerance);
+    }
+}
+
+TEST_CASE("ConvReverb can be re-initialised while another thread processes", "[ConvReverb]") {
+    const int kernelSize = 32768;
+    ScopedAlloc<float> kernelAlloc(kernelSize);
+    Buffer<float> kernel(kernelAlloc.get(), kernelSize);
+    TestConvReverb::generateTestIR(kernel);
+
+    ConvReverb reverb;
+    reverb.init(64, 4096, kernel);
+
+    std::atomic<bool> finished { false };
+    std::atomic<bool> allFinite { true };
+
+    std::thread audio([&] {
+        ScopedAlloc<float> ioMemory(256);
+        Buffer<float> input = ioMemory.place(128);
+        Buffer<float> output = ioMemory.place(128);
+        Random random(3);
+
+        while (! finished.load()) {
+            for (int j = 0; j < input.size(); ++j) {
+                input[j] = random.nextFloat() - 0.5f;
+            }
+
+            reverb.process(input, output);
+
+            for (int j = 0; j < output.size(); ++j) {
+                if (! std::isfinite(output[j])) {
+                    allFinite = false;
+                }
+            }
+        }
+    });
+
+    // alternate kernel lengths so stage counts and storage change underneath process()
+    for (int i = 0; i < 200; ++i) {
+        reverb.init(64, 4096, kernel.withSize(i % 2 == 0 ? kernelSize / 4 : kernelSize));
+    }
+
+    finished = true;
+    audio.join();
+
+    CHECK(allFinite.load());
+    CHECK(reverb.getNumStages() > 0);
+}
+
 TEST_CASE("ConvReverb Edge Cases", "[ConvReverb]") {
     ConvReverb reverb;
 
@@ -302,3 +424,107 @@ TEST_CASE("Cycle reverb high pass attenuates low bins independently of damping",
     REQUIRE(lowRetention < 0.9f);
     REQUIRE(highRetention > 0.9f);
 }
+
+TEST_CASE("Cycle reverb kernel keeps its duration and response at other rates",
+        "[ConvReverb][ReverbKernel]") {
+    constexpr float roomSize = 0.35f;
+    const int tunedSize = CycleDsp::reverbKernelLength(roomSize);
+    const int doubledSize = CycleDsp::reverbKernelLength(roomSize, 2 * CycleDsp::reverbTunedSampleRate);
+    REQUIRE(tunedSize == 32768);
+    REQUIRE(doubledSize == 2 * tunedSize);
+    REQUIRE(CycleDsp::reverbKernelLength(roomSize, 48000.0) == 35666);
+
+    ScopedAlloc<float> memory(tunedSize * 2 + doubledSize * 2);
+    Buffer<float> tuned = memory.place(tunedSize);
+    Buffer<float> tunedMagnitudes = memory.place(tunedSize);
+    Buffer<float> doubled = memory.place(doubledSize);
+    Buffer<float> doubledRight = memory.place(doubledSize);
+
+    CycleDsp::ReverbKernelConfiguration configuration;
+    configuration.roomSize = roomSize;
+    configuration.damping = 0.f;
+    CycleDsp::buildReverbKernel(configuration, tuned);
+    configuration.sampleRate = 2 * CycleDsp::reverbTunedSampleRate;
+    CycleDsp::buildReverbKernel(configuration, doubled, doubledRight);
+
+    REQUIRE_FALSE(doubled.isProbablyEmpty());
+    REQUIRE_FALSE(doubled == doubledRight);
+
+    // the energy decays over the same share of the kernel, so over the same time
+    constexpr int numSections = 8;
+    float tunedTotal = tuned.normL2();
+    float doubledTotal = doubled.normL2();
+
+    for (int i = 0; i < numSections; ++i) {
+        float tunedShare = tuned.section(i * tunedSize / numSections, tunedSize / numSections).normL2() / tunedTotal;
+        float doubledShare = doubled.section(i * doubledSize / numSections, doubledSize / numSections).normL2() / doubledTotal;
+
+        CAPTURE(i, tunedShare, doubledShare);
+        REQUIRE(doubledShare == Catch::Approx(tunedShare).margin(0.03f));
+    }
+
+    // bins of the same frequency carry the same gain, once the forward scaling by N is undone
+    constexpr int lowBin = 24;
+    constexpr int highBin = 512;
+    Transform transform;
+    transform.allocate(tunedSize, Transform::DivFwdByN, true);
+    transform.forward(tuned);
+    transform.getMagnitudes().copyTo(tunedMagnitudes);
+
+    Transform doubledTransform;
+    doubledTransform.allocate(doubledSize, Transform::DivFwdByN, true);
+    doubledTransform.forward(doubled);
+
+    const float gain = 2.f * doubledTransform.getMagnitudes().section(lowBin, highBin - lowBin).sum()
+            / tunedMagnitudes.section(lowBin, highBin - lowBin).sum();
+    INFO("gain relative to the tuned kernel: " << gain);
+    REQUIRE(gain > 0.85f);
+    REQUIRE(gain < 1.1f);
+}
+
+TEST_CASE("ConvReverb worst-case callback time by IR length", "[ConvReverb][benchmark][.]") {
+    const int callbackSize = 256;
+    const int numCallbacks = 4000;
+
+    ScopedAlloc<float> ioMemory(callbackSize * 2);
+    Buffer<float> input = ioMemory.place(callbackSize);
+    Buffer<float> output = ioMemory.place(callbackSize);
+
+    std::cout << "ConvReverb callback " << callbackSize << ", head " << callbackSize
+              << ", tail " << 16 * callbackSize << std::endl;
+
+    for (int irSize : { 16384, 65536, 262144, 1048576 }) {
+        ScopedAlloc<float> kernelAlloc(irSize);
+        Buffer<float> kernel(kernelAlloc.get(), irSize);
+        TestConvReverb::generateTestIR(kernel);
+
+        for (bool background : { false, true }) {
+            ConvReverb reverb;
+            reverb.setBackgroundProcessing(background);
+            reverb.init(callbackSize, 16 * callbackSize, kernel);
+
+            Random random(irSize);
+            double worstMicros = 0, totalMicros = 0;
+
+            for (int i = 0; i < numCallbacks; ++i) {
+                for (int j = 0; j < callbackSize; ++j) {
+                    input[j] = random.nextFloat() - 0.5f;
+                }
+
+                int64 start = Time::getHighResolutionTicks();
+                reverb.process(input, output);
+                double micros = 1e6 * Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+
+                worstMicros = jmax(worstMicros, micros);
+                totalMicros += micros;
+            }
+
+            std::cout << "  IR " << irSize << (background ? " worker " : " inline ")
+                      << "stages " << reverb.getNumStages()
+                      << " (" << reverb.getNumBackgroundStages() << " background)"
+                      << ", mean " << totalMicros / numCallbacks << "us"
+                      << ", worst " << worstMicros << "us"
+                      << ", deadline misses " << reverb.getDeadlineMisses() << std::endl;
+        }
+    }
+}
@@ -0,0 +1,166 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "../src/Array/VecOps.h"
+#include "../src/Curve/Curve.h"
+
+namespace {
+    using Catch::Approx;
+
+    struct CurveTableScope {
+        CurveTableScope() {
+            if (refCount++ == 0) {
+                Curve::calcTable();
+            }
+        }
+
+        ~CurveTableScope() {
+            if (--refCount == 0) {
+                Curve::deleteTable();
+            }
+        }
+
+        inline static int refCount = 0;
+    };
+
+    // the per-curve path as it was: trig for the rotation, then up to five passes per axis
+    void recalculateLegacy(Curve& curve, bool interpolate, float* transformX, float* transformY) {
+        const Intercept& a = curve.a;
+        const Intercept& b = curve.b;
+        const Intercept& c = curve.c;
+        int res = Curve::resolution >> curve.resIndex;
+
+        if (b.padAfter || b.padBefore) {
+            Buffer<float>(transformX, res).set(b.x);
+            Buffer<float>(transformY, res).set(b.y);
+            return;
+        }
+
+        float dx = c.x - a.x;
+        float dyca = c.y - a.y;
+        float ntheta = -std::atan2(dyca, dx);
+        float sinrot = std::sin(ntheta);
+        float cosrot = std::cos(ntheta);
+        float scaleX = std::sqrt(dx * dx + dyca * dyca);
+
+        float m = dyca / dx;
+        float icptX = (m * m * a.x + b.y * m - a.y * m + b.x) / (1.f + m * m);
+        float icptY = m * (icptX - a.x) + a.y;
+        float dX = 0.5f * (a.x + c.x);
+        float dY = 0.5f * (a.y + c.y);
+        int ypole = a.y + m * (b.x - a.x) < b.y ? 1 : -1;
+        int dpole = dX < icptX ? 1 : -1;
+        float distbi = (b.x - icptX) * (b.x - icptX) + (b.y - icptY) * (b.y - icptY);
+        float distbd = (b.x - dX) * (b.x - dX) + (b.y - dY) * (b.y - dY);
+        float shear = std::sqrt(jmax(0.f, distbd - distbi)) * (float) (dpole * ypole);
+        float scaleY = std::sqrt(distbi);
+
+        float ma = scaleX * cosrot;
+        float mc = scaleX * sinrot * -1;
+        float mb = (float) ypole * (cosrot * shear + sinrot * scaleY);
+        float md = (float) ypole * (-sinrot * shear + cosrot * scaleY);
+
+        float tableCurvePos = (Curve::numCurvelets - 1) * jlimit(0.f, 1.f, b.shp);
+        int tableCurveIdx = int(tableCurvePos);
+        float alpha = interpolate ? 1 - (tableCurvePos - tableCurveIdx) : 1.f;
+        bool blend = tableCurveIdx < Curve::numCurvelets - 1 && alpha < 1.f;
+        float* t  = Curve::table[curve.resIndex][tableCurveIdx];
+        float* t2 = blend ? Curve::table[curve.resIndex][tableCurveIdx + 1] : nullptr;
+
+        Buffer<float>(transformX, res).set(a.x);
+        VecOps::addProd(t,       ma * alpha, transformX, res);
+        VecOps::addProd(t + res, mb * alpha, transformX, res);
+
+        Buffer<float>(transformY, res).set(a.y);
+        VecOps::addProd(t,       mc * alpha, transformY, res);
+        VecOps::addProd(t + res, md * alpha, transformY, res);
+
+        if (blend) {
+            VecOps::addProd(t2,       ma * (1 - alpha), transformX, res);
+            VecOps::addProd(t2 + res, mb * (1 - alpha), transformX, res);
+            VecOps::addProd(t2,       mc * (1 - alpha), transformY, res);
+            VecOps::addProd(t2 + res, md * (1 - alpha), transformY, res);
+        }
+    }
+
+    std::vector<Curve> createCurves(int count, bool interpolate, int seed) {
+        std::vector<Curve> curves;
+        curves.reserve((size_t) count);
+        Random random(seed);
+        float x = 0.f;
+
+        for (int i = 0; i < count; ++i) {
+            float step = 0.01f + 0.05f * random.nextFloat();
+            Intercept a(x, random.nextFloat());
+            Intercept b(x + step * (0.2f + 0.6f * random.nextFloat()), random.nextFloat(), nullptr, random.nextFloat());
+            Intercept c(x + step, random.nextFloat());
+            b.padBefore = i % 17 == 5;
+            x += step;
+
+            curves.emplace_back(a, b, c);
+            curves.back().setResIndex(i % Curve::resolutions);
+            curves.back().setShouldInterpolate(interpolate);
+        }
+
+        return curves;
+    }
+}
+
+TEST_CASE("Fused curve transforms match the previous per-curve algorithm", "[curve][transform]") {
+    CurveTableScope curveTableScope;
+    float expectedX[Curve::resolution], expectedY[Curve::resolution];
+
+    for (bool interpolate : { false, true }) {
+        auto curves = createCurves(100, interpolate, interpolate ? 7 : 8);
+
+        for (int i = 0; i < (int) curves.size(); ++i) {
+            Curve& curve = curves[(size_t) i];
+            curve.recalculateCurve();
+            recalculateLegacy(curve, interpolate, expectedX, expectedY);
+
+            INFO("curve " << i << ", interpolate " << interpolate);
+            for (int j = 0; j < Curve::resolution >> curve.resIndex; ++j) {
+                REQUIRE(curve.transformX[j] == Approx(expectedX[j]).margin(1e-5));
+                REQUIRE(curve.transformY[j] == Approx(expectedY[j]).margin(1e-5));
+            }
+        }
+    }
+}
+
+TEST_CASE("Curve transform throughput, fused kernel against the previous algorithm", "[curve][transform][benchmark][.]") {
+    CurveTableScope curveTableScope;
+    constexpr int curvesPerRun = 1 << 20;
+    float scratchX[Curve::resolution], scratchY[Curve::resolution];
+
+    for (int count : { 16, 128, 1024 }) {
+        auto curves = createCurves(count, true, count);
+        const int passes = jmax(1, curvesPerRun / count);
+
+        double start = Time::getMillisecondCounterHiRes();
+        for (int pass = 0; pass < passes; ++pass) {
+            for (auto& curve : curves) {
+                recalculateLegacy(curve, true, scratchX, scratchY);
+            }
+        }
+        double legacy = Time::getMillisecondCounterHiRes() - start;
+
+        start = Time::getMillisecondCounterHiRes();
+        for (int pass = 0; pass < passes; ++pass) {
+            for (auto& curve : curves) {
+                curve.recalculateCurve();
+            }
+        }
+        double fused = Time::getMillisecondCounterHiRes() - start;
+
+        const double curveCount = (double) passes * count * 1e-3;
+        std::cout << count << " curves: previous " << curveCount / legacy << " M curves/s"
+                  << ", fused " << curveCount / fused << " M curves/s"
+                  << " (" << legacy / fused << "x)" << std::endl;
+
+        REQUIRE(std::isfinite(curves.back().transformX[0] + scratchX[0]));
+    }
+}
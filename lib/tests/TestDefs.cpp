@@ -1,6 +1,6 @@
 #include "TestDefs.h"
 
-#ifdef USE_ACCELERATE
+#if defined(USE_ACCELERATE) || defined(USE_PORTABLE_SIMD)
   float real(const Complex32& c) { return c.real(); }
   float imag(const Complex32& c) { return c.imag(); }
   float mag(const Complex32& c) { return std::abs(c); }
@@ -27,3 +27,28 @@ TEST_CASE("Equalizer core keeps channel histories independent", "[CycleDsp][equa
     REQUIRE(leftSamples[0] != 0.f);
     REQUIRE(rightSamples[0] == 0.f);
 }
+
+TEST_CASE("Equalizer core processes channels together as it does one at a time", "[CycleDsp][equalizer]") {
+    CycleDsp::EqualizerCore together(3), apart(3);
+    for (int band = 0; band < CycleDsp::EqualizerCore::bandCount; ++band) {
+        const float frequency = 100.f * (float) (band + 1) * (float) (band + 1);
+        together.configureBand(band, 48000.0, frequency, 6.f * (float) (band - 2));
+        apart.configureBand(band, 48000.0, frequency, 6.f * (float) (band - 2));
+    }
+
+    float left[64], right[64], apartLeft[64], apartRight[64];
+    for (int i = 0; i < 64; ++i) {
+        left[i] = apartLeft[i] = (i % 7 == 0) ? 1.f : -0.25f;
+        right[i] = apartRight[i] = (i % 5 == 0) ? -1.f : 0.1f;
+    }
+
+    Buffer<float> channels[] = { { left, 64 }, { right, 64 } };
+    together.process(0, channels, 2);
+    apart.process(0, { apartLeft, 64 });
+    apart.process(1, { apartRight, 64 });
+
+    for (int i = 0; i < 64; ++i) {
+        REQUIRE(left[i] == apartLeft[i]);
+        REQUIRE(right[i] == apartRight[i]);
+    }
+}
@@ -119,3 +119,26 @@ TEST_CASE("IR curve-to-kernel path preserves Cycle 1 golden samples", "[cycle-ds
         REQUIRE(filtered[(size_t) indices[i]] == Catch::Approx(expected[i]).margin(1.0e-5f));
     }
 }
+
+TEST_CASE("IR lengths and prefilter cutoffs keep their durations and frequencies at other rates",
+        "[cycle-dsp][ir]") {
+    REQUIRE(CycleDsp::irImpulseLengthAtRate(1024, CycleDsp::irTunedSampleRate) == 1024);
+    REQUIRE(CycleDsp::irImpulseLengthAtRate(1024, 88200.) == 2048);
+    REQUIRE(CycleDsp::irImpulseLengthAtRate(1024, 48000.) == 1115);
+
+    constexpr int length = 256;
+    std::array<float, length / 2> tunedLevels {};
+    std::array<float, length> doubledLevels {};
+
+    // the same bin width in Hz, over twice the bins
+    CycleDsp::buildIrPrefilterLevels({ tunedLevels.data(), (int) tunedLevels.size() }, 0.5);
+    CycleDsp::buildIrPrefilterLevels({ doubledLevels.data(), (int) doubledLevels.size() }, 0.5, 88200.);
+
+    for (int i = 0; i < (int) tunedLevels.size(); ++i) {
+        CAPTURE(i);
+        REQUIRE(doubledLevels[(size_t) i] == tunedLevels[(size_t) i]);
+    }
+
+    REQUIRE(tunedLevels[15] == 0.f);
+    REQUIRE(tunedLevels[16] == 1.f);
+}
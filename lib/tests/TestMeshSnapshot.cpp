@@ -0,0 +1,294 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+
+#include "../src/Curve/Mesh/Mesh.h"
+#include "../src/Curve/Mesh/MeshSnapshot.h"
+#include "../src/Curve/Mesh/VertCube.h"
+#include "../src/Curve/Rasterization/Interpolation/TrilinearMeshSlicer.h"
+#include "../src/Curve/Rasterization/Rasterizer/TrilinearMeshRasterizer.h"
+
+namespace {
+    using Catch::Approx;
+
+    struct MeshDeleter {
+        void operator()(Mesh* mesh) const {
+            if (mesh != nullptr) {
+                mesh->destroy();
+                delete mesh;
+            }
+        }
+    };
+
+    // cubes over random sub-ranges of time, red and blue; every fourth spans all of them
+    std::unique_ptr<Mesh, MeshDeleter> createScatteredMesh(int numCubes, int seed) {
+        std::unique_ptr<Mesh, MeshDeleter> mesh(new Mesh("ScatteredMesh"));
+        Random random(seed);
+
+        for (int c = 0; c < numCubes; ++c) {
+            auto* cube = new VertCube(mesh.get());
+
+            float low[3], high[3];
+            for (int d = 0; d < 3; ++d) {
+                float a = random.nextFloat();
+                float b = random.nextFloat();
+                low[d]  = c % 4 == 0 ? 0.f : jmin(a, b);
+                high[d] = c % 4 == 0 ? 1.f : jmax(a, b);
+            }
+
+            for (int i = 0; i < (int) VertCube::numVerts; ++i) {
+                bool time, red, blue;
+                VertCube::getPoles(i, time, red, blue);
+
+                Vertex* vertex = cube->getVertex(i);
+                vertex->values[Vertex::Time]  = time ? high[0] : low[0];
+                vertex->values[Vertex::Red]   = red  ? high[1] : low[1];
+                vertex->values[Vertex::Blue]  = blue ? high[2] : low[2];
+                vertex->values[Vertex::Phase] = random.nextFloat() * 1.2f;
+                vertex->values[Vertex::Amp]   = random.nextFloat();
+                vertex->values[Vertex::Curve] = random.nextFloat();
+            }
+
+            mesh->addCube(cube);
+        }
+
+        return mesh;
+    }
+
+    // cubes laid end to end along time, each spanning all of red and blue
+    std::unique_ptr<Mesh, MeshDeleter> createTiledMesh(int numCubes, int seed) {
+        std::unique_ptr<Mesh, MeshDeleter> mesh(new Mesh("TiledMesh"));
+        Random random(seed);
+
+        for (int c = 0; c < numCubes; ++c) {
+            auto* cube = new VertCube(mesh.get());
+
+            for (int i = 0; i < (int) VertCube::numVerts; ++i) {
+                bool time, red, blue;
+                VertCube::getPoles(i, time, red, blue);
+
+                Vertex* vertex = cube->getVertex(i);
+                vertex->values[Vertex::Time]  = (float) (c + (time ? 1 : 0)) / (float) numCubes;
+                vertex->values[Vertex::Red]   = red  ? 1.f : 0.f;
+                vertex->values[Vertex::Blue]  = blue ? 1.f : 0.f;
+                vertex->values[Vertex::Phase] = random.nextFloat();
+                vertex->values[Vertex::Amp]   = random.nextFloat();
+                vertex->values[Vertex::Curve] = random.nextFloat();
+            }
+
+            mesh->addCube(cube);
+        }
+
+        return mesh;
+    }
+
+    Rasterization::RasterizationRequest sliceRequest(int dimension, const MorphPosition& morph, bool depth) {
+        Rasterization::RasterizationRequest request;
+        request.dims = Dimensions(Vertex::Phase, Vertex::Amp, Vertex::Time, Vertex::Red, Vertex::Blue);
+        request.morph = morph;
+        request.primaryViewDimension = dimension;
+        request.calcDepthDimensions = depth;
+
+        return request;
+    }
+
+    const auto noGuides = [](Intercept&, const MorphPosition&, bool) {};
+}
+
+TEST_CASE("MeshSnapshot slicing matches slicing the cubes", "[meshsnapshot][slice]") {
+    auto mesh = createScatteredMesh(200, 17);
+
+    MeshSnapshot snapshot;
+    snapshot.build(*mesh);
+    REQUIRE(snapshot.size() == mesh->getNumCubes());
+
+    Rasterization::TrilinearMeshSlicer slicer;
+    Rasterization::RenderResult expected, actual;
+    VertCube::ReductionData reduction;
+    Random random(3);
+
+    for (int dimension : { (int) Vertex::Time, (int) Vertex::Red, (int) Vertex::Blue }) {
+        for (int trial = 0; trial < 40; ++trial) {
+            // the unit edges are special-cased in slicing, so hit them on purpose
+            MorphPosition morph(trial == 0 ? 0.f : trial == 1 ? 1.f : random.nextFloat(),
+                                trial == 2 ? 1.f : random.nextFloat(),
+                                trial == 3 ? 0.f : random.nextFloat());
+            auto request = sliceRequest(dimension, morph, trial % 2 == 0);
+
+            slicer.sliceMesh(mesh.get(), request, 0.1f, noGuides, expected, reduction);
+            slicer.sliceMesh(snapshot, request, 0.1f, noGuides, actual, reduction);
+
+            INFO("dimension=" << dimension << " trial=" << trial);
+            REQUIRE(actual.sampleable == expected.sampleable);
+            REQUIRE(actual.intercepts.size() == expected.intercepts.size());
+            REQUIRE(actual.colorPoints.size() == expected.colorPoints.size());
+
+            for (int i = 0; i < (int) expected.intercepts.size(); ++i) {
+                REQUIRE(actual.intercepts[i].cube == expected.intercepts[i].cube);
+                REQUIRE(actual.intercepts[i].x == Approx(expected.intercepts[i].x).margin(1e-6));
+                REQUIRE(actual.intercepts[i].y == Approx(expected.intercepts[i].y).margin(1e-6));
+                REQUIRE(actual.intercepts[i].shp == Approx(expected.intercepts[i].shp).margin(1e-6));
+            }
+        }
+    }
+}
+
+TEST_CASE("MeshSnapshot is rebuilt when the mesh is edited", "[meshsnapshot][revision]") {
+    auto mesh = createScatteredMesh(8, 5);
+    auto other = createScatteredMesh(8, 5);
+
+    MeshSnapshot snapshot;
+    snapshot.build(*mesh);
+    REQUIRE(snapshot.isCurrentFor(*mesh));
+    REQUIRE_FALSE(snapshot.isCurrentFor(*other));
+    REQUIRE(snapshot.getRevision() != other->getRevision());
+
+    mesh->markEdited();
+    REQUIRE_FALSE(snapshot.isCurrentFor(*mesh));
+
+    snapshot.build(*mesh);
+    REQUIRE(snapshot.isCurrentFor(*mesh));
+    std::unique_ptr<VertCube> removed(mesh->getCubes().back());
+    REQUIRE(mesh->removeCube(removed.get()));
+    REQUIRE_FALSE(snapshot.isCurrentFor(*mesh));
+
+    // a rasterizer renders from its snapshot until the edit is marked
+    Rasterization::TrilinearMeshRasterizer rasterizer;
+    auto request = sliceRequest(Vertex::Time, MorphPosition(0.5f, 0.5f, 0.5f), false);
+
+    const auto firstSize = rasterizer.renderGeometry({ *mesh, request, 0.f }).intercepts.size();
+    REQUIRE(firstSize > 0);
+
+    for (auto* vertex : mesh->getVerts()) {
+        vertex->values[Vertex::Red] = 2.f;
+    }
+
+    REQUIRE(rasterizer.renderGeometry({ *mesh, request, 0.f }).intercepts.size() == firstSize);
+
+    mesh->markEdited();
+    REQUIRE(rasterizer.renderGeometry({ *mesh, request, 0.f }).intercepts.empty());
+}
+
+TEST_CASE("MeshSnapshot candidates cover every cube that slices", "[meshsnapshot][index]") {
+    auto mesh = createTiledMesh(64, 9);
+
+    MeshSnapshot snapshot;
+    snapshot.build(*mesh);
+
+    Rasterization::TrilinearMeshSlicer slicer;
+    VertCube::ReductionData reduction;
+    Random random(11);
+
+    for (int trial = 0; trial < 200; ++trial) {
+        // unit edges and tile seams are where bucket and slice boundaries disagree
+        float time = trial == 0 ? 0.f : trial == 1 ? 1.f : trial < 20 ? (float) trial / 16.f : random.nextFloat();
+        MorphPosition morph(time, trial == 2 ? 1.f : random.nextFloat(), random.nextFloat());
+
+        auto candidates = snapshot.candidatesAt(morph);
+        REQUIRE(candidates.size() <= 2 * 64 / MeshSnapshot::bucketsPerAxis);
+        REQUIRE(std::is_sorted(candidates.begin(), candidates.end()));
+
+        for (int i = 0; i < snapshot.size(); ++i) {
+            if (slicer.slice(snapshot, i, Vertex::Time, reduction, morph)) {
+                INFO("trial=" << trial << " cube=" << i);
+                REQUIRE(std::find(candidates.begin(), candidates.end(), i) != candidates.end());
+            }
+        }
+    }
+
+    snapshot.clear();
+    REQUIRE(snapshot.candidatesAt(MorphPosition(0.5f, 0.5f, 0.5f)).size() == 0);
+}
+
+TEST_CASE("MeshSnapshot indexed slicing by cube count", "[meshsnapshot][index][benchmark][.]") {
+    constexpr int slicesPerSize = 1 << 20;
+
+    Rasterization::TrilinearMeshSlicer slicer;
+    VertCube::ReductionData reduction;
+
+    for (int numCubes : { 10, 100, 1000 }) {
+        auto mesh = createTiledMesh(numCubes, numCubes);
+        MeshSnapshot snapshot;
+        snapshot.build(*mesh);
+
+        const int passes = jmax(1, slicesPerSize / numCubes);
+        int hits[2] {};
+        double millis[2] {};
+
+        for (int path = 0; path < 2; ++path) {
+            Random random(numCubes);
+            double start = Time::getMillisecondCounterHiRes();
+
+            for (int pass = 0; pass < passes; ++pass) {
+                MorphPosition morph(random.nextFloat(), 0.5f, 0.5f);
+
+                if (path == 0) {
+                    for (int i = 0; i < snapshot.size(); ++i) {
+                        hits[path] += slicer.slice(snapshot, i, Vertex::Time, reduction, morph) ? 1 : 0;
+                    }
+                } else {
+                    for (int i : snapshot.candidatesAt(morph)) {
+                        hits[path] += slicer.slice(snapshot, i, Vertex::Time, reduction, morph) ? 1 : 0;
+                    }
+                }
+            }
+
+            millis[path] = Time::getMillisecondCounterHiRes() - start;
+        }
+
+        std::cout << numCubes << " cubes: full walk " << millis[0] * 1e3 / passes << " us/slice"
+                  << ", indexed " << millis[1] * 1e3 / passes << " us/slice"
+                  << " (" << millis[0] / millis[1] << "x)" << std::endl;
+
+        REQUIRE(hits[0] == hits[1]);
+    }
+}
+
+TEST_CASE("MeshSnapshot slice throughput by cube count", "[meshsnapshot][benchmark][.]") {
+    constexpr int slicesPerSize = 1 << 21;
+
+    Rasterization::TrilinearMeshSlicer slicer;
+    Rasterization::RenderResult output;
+    VertCube::ReductionData reduction;
+
+    for (int numCubes : { 16, 64, 256, 1024, 4096 }) {
+        auto mesh = createScatteredMesh(numCubes, numCubes);
+        MeshSnapshot snapshot;
+        snapshot.build(*mesh);
+
+        const int passes = jmax(1, slicesPerSize / numCubes);
+        auto request = sliceRequest(Vertex::Time, MorphPosition(0.5f, 0.5f, 0.5f), false);
+        request.overrideDimension = true;
+        size_t intercepts[2] {};
+        double millis[2] {};
+
+        for (int path = 0; path < 2; ++path) {
+            Random random(numCubes);
+            double start = Time::getMillisecondCounterHiRes();
+
+            for (int pass = 0; pass < passes; ++pass) {
+                request.morph.time.setValueDirect(random.nextFloat());
+
+                if (path == 0) {
+                    slicer.sliceMesh(mesh.get(), request, 0.f, noGuides, output, reduction);
+                } else {
+                    slicer.sliceMesh(snapshot, request, 0.f, noGuides, output, reduction);
+                }
+
+                intercepts[path] += output.intercepts.size();
+            }
+
+            millis[path] = Time::getMillisecondCounterHiRes() - start;
+        }
+
+        const double cubeSlices = (double) passes * numCubes * 1e-3;
+        std::cout << numCubes << " cubes: pointers " << cubeSlices / millis[0] << " M cube slices/s"
+                  << ", snapshot " << cubeSlices / millis[1] << " M cube slices/s"
+                  << " (" << millis[0] / millis[1] << "x)" << std::endl;
+
+        REQUIRE(intercepts[0] > 0);
+    }
+}
@@ -11,6 +11,8 @@
 #include <JuceHeader.h>
 #include <Util/Arithmetic.h>
 
+#include <cmath>
+
 using namespace juce;
 
 namespace {
@@ -43,6 +45,14 @@ namespace {
             position.timeDepth = 1.f;
         }
 
+        void setYellow(float yellow) {
+            position.time.setValueDirect(yellow);
+        }
+
+        float getYellow() override {
+            return position.time.getCurrentValue();
+        }
+
         MorphPosition getMorphPosition() override {
             return position;
         }
@@ -96,11 +106,10 @@ namespace {
         meshLib.addLayer(GroupWavePitch);
     }
 
-    File writeTestWaveFile() {
+    File writeTestWaveFile(int sampleRate = 44100) {
         File file = File::getSpecialLocation(File::tempDirectory)
                 .getNonexistentChildFile("amaranth-multisample", ".wav");
 
-        constexpr int sampleRate = 44100;
         constexpr int sampleCount = 4096;
 
         AudioBuffer<float> buffer(1, sampleCount);
@@ -165,3 +174,48 @@ TEST_CASE("Multisample keeps sample mesh layers distinct when replacing overlaps
 
     waveFile.deleteFile();
 }
+
+TEST_CASE("Multisample positions and periods count in each sample's own rate", "[Multisample]") {
+    ScopedJuceGui juceGui;
+    SingletonRepo repo;
+    TestMorphPositioner positioner;
+
+    repo.add(new AppConstants(&repo));
+    repo.add(new Document(&repo));
+    repo.add(new EditWatcher(&repo));
+    repo.add(new MeshLibrary(&repo));
+    repo.setMorphPositioner(&positioner);
+    seedDefaultMeshLibrary(repo);
+
+    Multisample multisample(&repo, nullptr);
+    File fullRateFile = writeTestWaveFile(44100);
+    File halfRateFile = writeTestWaveFile(22050);
+
+    positioner.setMidiRange(40, 50);
+    PitchedSample* fullRate = multisample.addSample(fullRateFile, 60);
+    REQUIRE(fullRate != nullptr);
+    fullRate->midiRange = Range<int>(40, 50);
+
+    positioner.setMidiRange(70, 80);
+    PitchedSample* halfRate = multisample.addSample(halfRateFile, 72);
+    REQUIRE(halfRate != nullptr);
+    halfRate->midiRange = Range<int>(70, 80);
+
+    REQUIRE(fullRate->samplerate == 44100);
+    REQUIRE(halfRate->samplerate == 22050);
+
+    // halfway through the longest sample is the same moment in both
+    positioner.setYellow(0.5f);
+    multisample.updatePlaybackPosition();
+
+    REQUIRE(multisample.getGreatestLengthSeconds() == halfRate->lengthSeconds());
+    REQUIRE(fullRate->playbackPos == 4096);
+    REQUIRE(halfRate->playbackPos == 2048);
+
+    // note 81 is A440 in NumberUtils
+    REQUIRE(std::abs(fullRate->periodForNote(81) - 44100. / 440.) < 1e-9);
+    REQUIRE(std::abs(halfRate->periodForNote(81) - 22050. / 440.) < 1e-9);
+
+    fullRateFile.deleteFile();
+    halfRateFile.deleteFile();
+}
@@ -1,6 +1,10 @@
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <cmath>
+#include <iostream>
+#include <vector>
+
 #include <Algo/Oversampler.h>
 #include <App/MemoryPool.h>
 #include <App/SingletonRepo.h>
@@ -16,6 +20,34 @@ namespace {
 
         return peak;
     }
+
+    // amplitude of the component at relFreq cycles per sample
+    float toneMagnitude(Buffer<float> buffer, double relFreq) {
+        double re = 0, im = 0;
+
+        for (int i = 0; i < buffer.size(); ++i) {
+            re += buffer[i] * std::cos(2 * M_PI * relFreq * i);
+            im += buffer[i] * std::sin(2 * M_PI * relFreq * i);
+        }
+
+        return float(2 * std::sqrt(re * re + im * im) / buffer.size());
+    }
+
+    const char* engineName(Oversampler::Engine engine) {
+        switch (engine) {
+            case Oversampler::Engine::FullRate: return "full rate";
+            case Oversampler::Engine::Polyphase: return "polyphase";
+            case Oversampler::Engine::HalfBandIir: return "half-band IIR";
+        }
+
+        return "";
+    }
+
+    constexpr Oversampler::Engine allEngines[] = {
+        Oversampler::Engine::FullRate,
+        Oversampler::Engine::Polyphase,
+        Oversampler::Engine::HalfBandIir
+    };
 }
 
 TEST_CASE("Oversampler preserves low frequency amplitude", "[oversampler]") {
@@ -39,3 +71,166 @@ TEST_CASE("Oversampler preserves low frequency amplitude", "[oversampler]") {
         REQUIRE(peakAbs(buffer) == Catch::Approx(before).margin(0.1f));
     }
 }
+
+TEST_CASE("Oversampler engines preserve low frequency amplitude", "[oversampler]") {
+    SingletonRepo repo;
+    repo.add(new MemoryPool(&repo));
+
+    constexpr int size = 256;
+    ScopedAlloc<float> memory(size);
+
+    for (auto engine : allEngines) {
+        for (int factor : { 2, 3, 4, 8 }) {
+            INFO(engineName(engine) << ", factor " << factor);
+            Buffer<float> buffer(memory.get(), size);
+
+            buffer.sin(1.f / 32.f);
+            float before = peakAbs(buffer);
+
+            Oversampler oversampler(&repo, 16);
+            oversampler.setOversampleFactor(factor);
+            oversampler.setEngine(engine);
+            oversampler.startOversamplingBlock(buffer);
+            oversampler.stopOversamplingBlock();
+
+            REQUIRE(buffer.size() == size);
+            REQUIRE(peakAbs(buffer) == Catch::Approx(before).margin(0.1f));
+        }
+    }
+}
+
+TEST_CASE("Polyphase oversampling matches the full rate filter", "[oversampler]") {
+    SingletonRepo repo;
+    repo.add(new MemoryPool(&repo));
+
+    constexpr int size = 1500; // so each block spans several filter partitions once oversampled
+    ScopedAlloc<float> memory(3 * size);
+    Buffer<float> source = memory.place(size);
+    Buffer<float> expected = memory.place(size);
+    Buffer<float> actual = memory.place(size);
+
+    Random random(5);
+    for (float& value : source) {
+        value = random.nextFloat() * 2.f - 1.f;
+    }
+
+    for (int factor : { 2, 4, 8 }) {
+        INFO("factor " << factor);
+        std::vector<float> upsampled;
+
+        for (auto engine : { Oversampler::Engine::FullRate, Oversampler::Engine::Polyphase }) {
+            Buffer<float> output = engine == Oversampler::Engine::FullRate ? expected : actual;
+            Buffer<float> buffer = output;
+            source.copyTo(output);
+
+            Oversampler oversampler(&repo, 16);
+            oversampler.setOversampleFactor(factor);
+            oversampler.setEngine(engine);
+
+            // two blocks, so the filter history carries between calls
+            for (int start : { 0, size / 2 }) {
+                buffer = output.section(start, size / 2);
+                oversampler.startOversamplingBlock(buffer);
+
+                if (engine == Oversampler::Engine::FullRate) {
+                    upsampled.assign(buffer.begin(), buffer.end());
+                } else {
+                    for (int i = 0; i < buffer.size(); ++i) {
+                        REQUIRE(buffer[i] == Catch::Approx(upsampled[(size_t) i]).margin(1e-5f));
+                    }
+                }
+
+                oversampler.stopOversamplingBlock();
+            }
+
+            REQUIRE(oversampler.getLatencySamples() == 32 / factor);
+        }
+
+        for (int i = 0; i < size; ++i) {
+            REQUIRE(actual[i] == Catch::Approx(expected[i]).margin(1e-5f));
+        }
+    }
+}
+
+TEST_CASE("Oversampler engines reject the images of upsampling", "[oversampler]") {
+    SingletonRepo repo;
+    repo.add(new MemoryPool(&repo));
+
+    constexpr int size = 256;
+    ScopedAlloc<float> memory(size);
+
+    for (auto engine : allEngines) {
+        for (int factor : { 2, 4, 8 }) {
+            INFO(engineName(engine) << ", factor " << factor);
+            Buffer<float> buffer(memory.get(), size);
+            buffer.sin(1.f / 16.f);
+
+            Oversampler oversampler(&repo, 32);
+            oversampler.setOversampleFactor(factor);
+            oversampler.setEngine(engine);
+            oversampler.startOversamplingBlock(buffer);
+
+            // the settled half, a whole number of periods of both the tone and its first image
+            Buffer<float> settled = buffer.section(buffer.size() / 2, buffer.size() / 2);
+            float tone = toneMagnitude(settled, 1.0 / (16.0 * factor));
+            float image = toneMagnitude(settled, 15.0 / (16.0 * factor));
+
+            REQUIRE(tone == Catch::Approx(0.97f).margin(0.02f));
+            REQUIRE(image < tone * 1e-3f);
+
+            oversampler.stopOversamplingBlock();
+        }
+    }
+}
+
+TEST_CASE("Half-band oversampling adds no latency", "[oversampler]") {
+    Oversampler oversampler(16);
+    oversampler.setOversampleFactor(4);
+
+    REQUIRE(oversampler.getEngine() == Oversampler::Engine::Polyphase);
+    REQUIRE(oversampler.getLatencySamples() == 8);
+
+    oversampler.setEngine(Oversampler::Engine::HalfBandIir);
+    REQUIRE(oversampler.getLatencySamples() == 0);
+    REQUIRE(oversampler.getTail().empty());
+
+    // only powers of two can be halved down to, so other factors keep the FIR
+    oversampler.setOversampleFactor(3);
+    REQUIRE(oversampler.getLatencySamples() == 32 / 3);
+    REQUIRE(!oversampler.getTail().empty());
+}
+
+TEST_CASE("Oversampler engine throughput", "[oversampler][benchmark][.]") {
+    SingletonRepo repo;
+    repo.add(new MemoryPool(&repo));
+
+    constexpr int size = 512;
+    constexpr int blocks = 2000;
+    ScopedAlloc<float> memory(2 * size);
+    Buffer<float> source = memory.place(size);
+    Buffer<float> block = memory.place(size);
+    source.sin(0.01f);
+
+    for (int factor : { 4, 8 }) {
+        for (auto engine : allEngines) {
+            Oversampler oversampler(&repo);
+            oversampler.setOversampleFactor(factor);
+            oversampler.setEngine(engine);
+
+            double start = Time::getMillisecondCounterHiRes();
+            for (int i = 0; i < blocks; ++i) {
+                Buffer<float> buffer = block;
+                source.copyTo(buffer);
+
+                oversampler.startOversamplingBlock(buffer);
+                oversampler.stopOversamplingBlock();
+            }
+            double elapsed = Time::getMillisecondCounterHiRes() - start;
+
+            std::cout << factor << "x " << engineName(engine) << ": "
+                      << 1000.0 * elapsed / blocks << " us per " << size << " samples" << std::endl;
+
+            REQUIRE(std::isfinite(block[0]));
+        }
+    }
+}
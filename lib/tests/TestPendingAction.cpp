@@ -0,0 +1,49 @@
+#include <Thread/PendingAction.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <thread>
+
+TEST_CASE("PendingAction coalesces triggers and takes them once", "[PendingAction]") {
+    PendingActionValue<int> action(7);
+
+    REQUIRE(action.getId() == 7);
+    REQUIRE_FALSE(action.takePending());
+
+    action.setValueAndTrigger(1);
+    action.setValueAndTrigger(2);
+
+    REQUIRE(action.isPending());
+    REQUIRE(action.takePending());
+    REQUIRE(action.getValue() == 2);
+    REQUIRE_FALSE(action.takePending());
+}
+
+TEST_CASE("PendingAction does not lose triggers raised from another thread", "[PendingAction]") {
+    PendingActionValue<int> action(0);
+    std::atomic<bool> done { false };
+    constexpr int numTriggers = 20000;
+
+    std::thread producer([&] {
+        for (int i = 1; i <= numTriggers; ++i) {
+            action.setValueAndTrigger(i);
+        }
+
+        done = true;
+    });
+
+    int lastSeen = 0;
+
+    while (! done.load() || action.isPending()) {
+        if (action.takePending()) {
+            int value = action.getValue();
+            REQUIRE(value >= lastSeen);
+            lastSeen = value;
+        }
+    }
+
+    producer.join();
+
+    REQUIRE(lastSeen == numTriggers);
+}
@@ -0,0 +1,179 @@
+#include <Audio/CycleDsp/PhaserCore.h>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using CycleDsp::PhaserConfiguration;
+using CycleDsp::PhaserCore;
+
+namespace {
+
+// the per-sample phaser the block path replaced, with one of these per channel
+class ReferencePhaser {
+public:
+    explicit ReferencePhaser(const PhaserConfiguration& configuration) :
+            feedback(configuration.feedback)
+        ,   depth(configuration.depth) {
+        const auto nyquist = (float) (configuration.sampleRate * 0.5);
+        dmin = configuration.minFrequency / nyquist;
+        dmax = configuration.maxFrequency / nyquist;
+        lfoInc = (float) (MathConstants<double>::twoPi * configuration.rate / configuration.sampleRate);
+    }
+
+    void process(float& inSamp) {
+        float d = dmin + (dmax - dmin) * ((std::sin(lfoPhase) + 1.f) / 2.f);
+        float a1 = (1.f - d) / (1.f + d);
+
+        lfoPhase += lfoInc;
+        if (lfoPhase >= MathConstants<float>::twoPi) {
+            lfoPhase -= MathConstants<float>::twoPi;
+        }
+
+        float y = inSamp + zm1 * feedback;
+        for (float& z : allpassZm1) {
+            float out = y * -a1 + z;
+            z = out * a1 + y;
+            y = out;
+        }
+
+        zm1 = y;
+        inSamp += y * depth;
+    }
+
+private:
+    float allpassZm1[PhaserCore::numStages] {};
+    float dmin, dmax, feedback, depth;
+    float lfoPhase {}, lfoInc, zm1 {};
+};
+
+PhaserConfiguration testConfiguration() {
+    PhaserConfiguration configuration;
+    configuration.rate = 3.f;
+    configuration.feedback = 0.6f;
+    configuration.depth = 0.8f;
+    configuration.minFrequency = 300.f;
+    configuration.maxFrequency = 2500.f;
+    return configuration;
+}
+
+std::vector<float> createSignal(int size, float frequency) {
+    std::vector<float> signal((size_t) size);
+    Random random(size);
+
+    for (int i = 0; i < size; ++i) {
+        signal[(size_t) i] = 0.5f * std::sin(frequency * (float) i) + 0.2f * (random.nextFloat() - 0.5f);
+    }
+
+    return signal;
+}
+
+void processInBlocks(PhaserCore& phaser, std::vector<float>& left, std::vector<float>& right, int blockSize) {
+    for (int offset = 0; offset < (int) left.size(); offset += blockSize) {
+        const int size = jmin(blockSize, (int) left.size() - offset);
+        phaser.process({ left.data() + offset, size }, { right.data() + offset, size });
+    }
+}
+
+}
+
+TEST_CASE("PhaserCore matches the per-sample phaser on each channel", "[PhaserCore]") {
+    constexpr int length = 5000;
+    const auto configuration = testConfiguration();
+
+    std::vector<float> expectedLeft = createSignal(length, 0.05f);
+    std::vector<float> expectedRight = createSignal(length, 0.11f);
+    ReferencePhaser leftReference(configuration), rightReference(configuration);
+
+    for (int i = 0; i < length; ++i) {
+        leftReference.process(expectedLeft[(size_t) i]);
+        rightReference.process(expectedRight[(size_t) i]);
+    }
+
+    for (int blockSize : { 1, 7, 64, 256, 300, 1024 }) {
+        INFO("block size " << blockSize);
+
+        std::vector<float> left = createSignal(length, 0.05f);
+        std::vector<float> right = createSignal(length, 0.11f);
+        PhaserCore phaser;
+        phaser.configure(configuration);
+        processInBlocks(phaser, left, right, blockSize);
+
+        for (int i = 0; i < length; ++i) {
+            REQUIRE(left[(size_t) i] == Catch::Approx(expectedLeft[(size_t) i]).margin(1e-3));
+            REQUIRE(right[(size_t) i] == Catch::Approx(expectedRight[(size_t) i]).margin(1e-3));
+        }
+    }
+}
+
+TEST_CASE("PhaserCore keeps each channel's state to itself", "[PhaserCore]") {
+    constexpr int length = 1000;
+    const auto configuration = testConfiguration();
+
+    std::vector<float> stereoLeft = createSignal(length, 0.05f);
+    std::vector<float> stereoRight = createSignal(length, 0.3f);
+    std::vector<float> monoLeft = stereoLeft;
+
+    PhaserCore stereo, mono;
+    stereo.configure(configuration);
+    mono.configure(configuration);
+
+    stereo.process({ stereoLeft.data(), length }, { stereoRight.data(), length });
+    mono.process({ monoLeft.data(), length });
+
+    REQUIRE(stereoLeft == monoLeft);
+
+    // a reset starts the sweep and the allpass chain over
+    std::vector<float> again = createSignal(length, 0.05f);
+    mono.reset();
+    mono.process({ again.data(), length });
+
+    REQUIRE(again == monoLeft);
+}
+
+TEST_CASE("PhaserCore throughput against the per-sample phaser", "[PhaserCore][benchmark][.]") {
+    constexpr int samplesPerRun = 1 << 20;
+    const auto configuration = testConfiguration();
+
+    for (int blockSize : { 64, 256, 1024 }) {
+        const std::vector<float> sourceLeft = createSignal(blockSize, 0.05f);
+        const std::vector<float> sourceRight = createSignal(blockSize, 0.11f);
+        std::vector<float> left, right;
+        const int blocks = samplesPerRun / blockSize;
+
+        // as before: one shared state, stepped once per sample per channel
+        ReferencePhaser shared(configuration);
+        double start = Time::getMillisecondCounterHiRes();
+        for (int block = 0; block < blocks; ++block) {
+            left = sourceLeft;
+            right = sourceRight;
+
+            for (auto* channel : { &left, &right }) {
+                for (float& sample : *channel) {
+                    shared.process(sample);
+                }
+            }
+        }
+        double perSample = Time::getMillisecondCounterHiRes() - start;
+
+        PhaserCore phaser;
+        phaser.configure(configuration);
+        start = Time::getMillisecondCounterHiRes();
+        for (int block = 0; block < blocks; ++block) {
+            left = sourceLeft;
+            right = sourceRight;
+            phaser.process({ left.data(), blockSize }, { right.data(), blockSize });
+        }
+        double blockwise = Time::getMillisecondCounterHiRes() - start;
+
+        const double frames = (double) blocks * blockSize * 1e-3;
+        std::cout << "block " << blockSize << ": per-sample " << frames / perSample << " M stereo frames/s"
+                  << ", block " << frames / blockwise << " M stereo frames/s"
+                  << " (" << perSample / blockwise << "x)" << std::endl;
+
+        REQUIRE(std::isfinite(left[0] + right[0]));
+    }
+}
@@ -0,0 +1,159 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "../src/App/Doc/PresetBinary.h"
+#include "../src/App/Doc/PresetJson.h"
+
+using namespace juce;
+
+namespace {
+    var meshJson(int numVerts) {
+        auto mesh = PresetJson::object();
+        Array<var> vertices, cubes;
+
+        for (int i = 0; i < numVerts; ++i) {
+            auto vertex = PresetJson::object();
+            vertex->setProperty("time",   (double) (float) (i * 0.013));
+            vertex->setProperty("phase",  (double) (float) (i * 0.29));
+            vertex->setProperty("amp",    0.1 * i + 1e-9);
+            vertex->setProperty("key",    0.5);
+            vertex->setProperty("mod",    0.25);
+            vertex->setProperty("weight", 1.0);
+            vertex->setProperty("id", i);
+            vertices.add(PresetJson::toVar(vertex));
+        }
+
+        for (int i = 0; i + 8 <= numVerts; i += 8) {
+            auto cube = PresetJson::object();
+            auto guides = PresetJson::object();
+            Array<var> vertexIds;
+
+            for (int v = 0; v < 8; ++v) {
+                vertexIds.add(i + v);
+            }
+
+            guides->setProperty("time", -1);
+            guides->setProperty("amp", i % 3);
+            cube->setProperty("vertexIds", var(vertexIds));
+            cube->setProperty("guides", PresetJson::toVar(guides));
+            cube->setProperty("enabled", i % 16 == 0);
+            cubes.add(PresetJson::toVar(cube));
+        }
+
+        mesh->setProperty("name", "test mesh");
+        mesh->setProperty("version", 3);
+        mesh->setProperty("vertices", var(vertices));
+        mesh->setProperty("cubes", var(cubes));
+
+        return PresetJson::toVar(mesh);
+    }
+
+    var roundTrip(const var& value) {
+        MemoryBlock block = PresetBinary::encode(value);
+        return PresetBinary::decode(block.getData(), block.getSize());
+    }
+}
+
+TEST_CASE("PresetBinary round trips JSON values exactly", "[preset][binary]") {
+    auto root = PresetJson::object();
+    Array<var> ragged;
+
+    ragged.add(1);
+    ragged.add("two");
+    ragged.add(3.5);
+
+    // same keys, but one row's value changes type, so this cannot be a table
+    Array<var> mixedRows;
+    for (int i = 0; i < 3; ++i) {
+        auto row = PresetJson::object();
+        row->setProperty("value", i == 1 ? var(1.5) : var(i));
+        mixedRows.add(PresetJson::toVar(row));
+    }
+
+    root->setProperty("mesh", meshJson(64));
+    root->setProperty("ragged", var(ragged));
+    root->setProperty("mixed", var(mixedRows));
+    root->setProperty("empty", PresetJson::array());
+    root->setProperty("flag", true);
+    root->setProperty("large", (int64) 1 << 40);
+    root->setProperty("text", String(L"été"));
+
+    var original = PresetJson::toVar(root);
+    var decoded = roundTrip(original);
+
+    REQUIRE(JSON::toString(decoded, true) == JSON::toString(original, true));
+    REQUIRE(PresetJson::property(decoded, "large").isInt64());
+    REQUIRE(PresetJson::property(decoded, "flag").isBool());
+
+    auto* vertices = PresetJson::getArray(PresetJson::property(PresetJson::property(decoded, "mesh"), "vertices"));
+    REQUIRE(vertices != nullptr);
+    REQUIRE(PresetJson::property(vertices->getReference(5), "id").isInt());
+    REQUIRE(PresetJson::property(vertices->getReference(5), "amp").isDouble());
+}
+
+TEST_CASE("PresetBinary stores mesh arrays as columns", "[preset][binary]") {
+    var mesh = meshJson(4000);
+
+    MemoryBlock binary = PresetBinary::encode(mesh);
+    String json = JSON::toString(mesh, true);
+
+    // seven numeric columns of at most eight bytes each, plus a little framing
+    REQUIRE(binary.getSize() < (size_t) 4000 * 7 * 8 + 4096);
+    REQUIRE(binary.getSize() * 3 < (size_t) json.getNumBytesAsUTF8());
+}
+
+TEST_CASE("PresetBinary reads only the sections asked for", "[preset][binary]") {
+    PresetBinary::Writer writer;
+    writer.addSection("details", "a preset");
+    writer.addSection("meshLibrary", meshJson(256));
+    writer.addSection("settings", 42);
+
+    MemoryOutputStream out;
+    out.writeString("host data before the preset");
+    const int64 start = out.getPosition();
+    REQUIRE(writer.write(out));
+
+    MemoryInputStream in(out.getData(), out.getDataSize(), false);
+    in.setPosition(start);
+    REQUIRE(PresetBinary::isBinary(in));
+    REQUIRE(in.getPosition() == start);
+
+    PresetBinary::Reader reader;
+    REQUIRE(reader.open(in));
+    REQUIRE(reader.getVersion() == PresetBinary::formatVersion);
+    REQUIRE(reader.getSectionKeys().size() == 3);
+    REQUIRE_FALSE(reader.hasSection("modMatrix"));
+    REQUIRE(reader.readSection("modMatrix").isVoid());
+
+    // out of order, so each read seeks to its own payload
+    REQUIRE(int(reader.readSection("settings")) == 42);
+    REQUIRE(reader.readSection("details").toString() == "a preset");
+    REQUIRE(JSON::toString(reader.readSection("meshLibrary")) == JSON::toString(meshJson(256)));
+}
+
+TEST_CASE("PresetBinary rejects other formats and damaged data", "[preset][binary]") {
+    MemoryOutputStream gzipped;
+    {
+        GZIPCompressorOutputStream gzip(gzipped, 5);
+        gzip.writeText("{ \"format\": \"amaranth-preset\" }", false, false, nullptr);
+    }
+
+    MemoryInputStream gzipInput(gzipped.getData(), gzipped.getDataSize(), false);
+    REQUIRE_FALSE(PresetBinary::isBinary(gzipInput));
+
+    PresetBinary::Reader reader;
+    REQUIRE_FALSE(reader.open(gzipInput));
+
+    MemoryBlock block = PresetBinary::encode(meshJson(128));
+
+    // every truncation decodes to void or a value, never reads past the end
+    for (size_t size = 0; size < block.getSize(); size += 7) {
+        var decoded = PresetBinary::decode(block.getData(), size);
+        REQUIRE((decoded.isVoid() || decoded.getDynamicObject() != nullptr));
+    }
+
+    for (size_t i = 0; i < block.getSize(); i += 13) {
+        MemoryBlock damaged(block);
+        damaged[i] = (char) ~damaged[i];
+        (void) PresetBinary::decode(damaged.getData(), damaged.getSize());
+    }
+}
@@ -0,0 +1,161 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <iostream>
+
+#include "../src/App/Doc/Document.h"
+#include "../src/App/Doc/PresetIndex.h"
+#include "../src/Thread/RealtimeWorkerPool.h"
+
+using namespace juce;
+
+namespace {
+    const int magicValue = (int) 0xc0dedbad;
+
+    void writePreset(const File& file, const String& author, int payloadBytes) {
+        DocumentDetails details;
+        details.setFilename(file.getFullPathName());
+        details.setName(file.getFileNameWithoutExtension());
+        details.setAuthor(author);
+
+        (void) file.deleteFile();
+        std::unique_ptr<FileOutputStream> stream(file.createOutputStream());
+        REQUIRE(stream != nullptr);
+        REQUIRE(Document::saveHeader(stream.get(), details, magicValue));
+        stream->writeRepeatedByte(0x5a, (size_t) payloadBytes);
+    }
+
+    void writePresets(const File& dir, int count) {
+        REQUIRE(dir.createDirectory().wasOk());
+
+        for (int i = 0; i < count; ++i) {
+            writePreset(dir.getChildFile("preset" + String(i) + ".cyc"), "author" + String(i), 256 + i % 97);
+        }
+    }
+
+    // reads whatever is stale and folds it back into the index, returning how many were read
+    int scan(PresetIndex& index, const File& dir, Array<PresetIndex::Entry>& current, RealtimeWorkerPool* pool = nullptr) {
+        Array<PresetIndex::Entry> stale;
+        current.clear();
+        index.collect(dir, "*.cyc", current, stale);
+        PresetIndex::readHeaders(stale, magicValue, pool);
+
+        for (auto& entry : stale) {
+            index.update(entry);
+            current.add(entry);
+        }
+
+        return stale.size();
+    }
+}
+
+TEST_CASE("PresetIndex only rereads changed presets", "[preset][index]") {
+    TemporaryFile tempDir;
+    File dir = tempDir.getFile();
+    File indexFile = dir.getSiblingFile(dir.getFileName() + ".index");
+    writePresets(dir, 20);
+    dir.getChildFile("notes.txt").replaceWithText("not a preset");
+    dir.getChildFile("broken.cyc").replaceWithText("no header here");
+
+    Array<PresetIndex::Entry> current;
+    {
+        PresetIndex index;
+        index.setFile(indexFile);
+        REQUIRE_FALSE(index.load());
+        REQUIRE(scan(index, dir, current) == 21);
+        REQUIRE(index.save());
+    }
+
+    PresetIndex index;
+    index.setFile(indexFile);
+    REQUIRE(index.load());
+    REQUIRE(index.size() == 21);
+    REQUIRE(scan(index, dir, current) == 0);
+    REQUIRE_FALSE(index.isDirty());
+
+    int valid = 0;
+    for (auto& entry : current) {
+        if (entry.valid) {
+            ++valid;
+            String number = File(entry.path).getFileNameWithoutExtension().fromFirstOccurrenceOf("preset", false, false);
+            REQUIRE(entry.details.getAuthor() == "author" + number);
+            REQUIRE(entry.details.getFilename() == entry.path);
+        }
+    }
+    REQUIRE(valid == 20);
+
+    // one rewritten, one removed
+    writePreset(dir.getChildFile("preset3.cyc"), "someone else", 5000);
+    REQUIRE(dir.getChildFile("preset4.cyc").deleteFile());
+
+    REQUIRE(scan(index, dir, current) == 1);
+    REQUIRE(index.isDirty());
+    REQUIRE(index.size() == 20);
+
+    for (auto& entry : current) {
+        if (entry.path.endsWith("preset3.cyc")) {
+            REQUIRE(entry.details.getAuthor() == "someone else");
+        }
+    }
+
+    (void) indexFile.deleteFile();
+    (void) dir.deleteRecursively();
+}
+
+TEST_CASE("PresetIndex reads headers the same on a worker pool", "[preset][index]") {
+    TemporaryFile tempDir;
+    File dir = tempDir.getFile();
+    writePresets(dir, 150);
+
+    PresetIndex serialIndex, pooledIndex;
+    Array<PresetIndex::Entry> serial, pooled;
+    RealtimeWorkerPool pool(3, Thread::Priority::normal);
+
+    REQUIRE(scan(serialIndex, dir, serial) == 150);
+    REQUIRE(scan(pooledIndex, dir, pooled, &pool) == 150);
+
+    for (int i = 0; i < serial.size(); ++i) {
+        REQUIRE(serial[i].path == pooled[i].path);
+        REQUIRE(serial[i].valid == pooled[i].valid);
+        REQUIRE(serial[i].details.getAuthor() == pooled[i].details.getAuthor());
+    }
+
+    (void) dir.deleteRecursively();
+}
+
+TEST_CASE("PresetIndex cold and warm library scan of 5k presets", "[preset][index][benchmark][.]") {
+    constexpr int numPresets = 5000;
+
+    TemporaryFile tempDir;
+    File dir = tempDir.getFile();
+    File indexFile = dir.getSiblingFile(dir.getFileName() + ".index");
+    writePresets(dir, numPresets);
+
+    RealtimeWorkerPool pool(jmin(3, RealtimeWorkerPool::defaultWorkerCount()), Thread::Priority::normal);
+    Array<PresetIndex::Entry> current;
+
+    for (bool pooled : { false, true }) {
+        PresetIndex index;
+        index.setFile(indexFile);
+
+        double start = Time::getMillisecondCounterHiRes();
+        (void) index.load();
+        REQUIRE(scan(index, dir, current, pooled ? &pool : nullptr) == numPresets);
+        REQUIRE(index.save());
+        double cold = Time::getMillisecondCounterHiRes() - start;
+
+        PresetIndex warmIndex;
+        warmIndex.setFile(indexFile);
+
+        start = Time::getMillisecondCounterHiRes();
+        REQUIRE(warmIndex.load());
+        REQUIRE(scan(warmIndex, dir, current) == 0);
+        double warm = Time::getMillisecondCounterHiRes() - start;
+
+        std::cout << numPresets << " presets, " << (pooled ? "pooled" : "serial")
+                  << ": cold " << cold << " ms, warm " << warm << " ms" << std::endl;
+
+        REQUIRE(indexFile.deleteFile());
+    }
+
+    (void) dir.deleteRecursively();
+}
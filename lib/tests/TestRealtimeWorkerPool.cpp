@@ -0,0 +1,39 @@
+#include <Thread/RealtimeWorkerPool.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <vector>
+
+TEST_CASE("RealtimeWorkerPool runs every index exactly once", "[RealtimeWorkerPool]") {
+    RealtimeWorkerPool pool(3);
+    REQUIRE(pool.getNumWorkers() == 3);
+
+    std::vector<std::atomic<int>> hits(64);
+
+    for (int round = 0; round < 200; ++round) {
+        const int count = 1 + round % (int) hits.size();
+
+        for (auto& hit : hits) {
+            hit.store(0);
+        }
+
+        auto job = [&hits](int index) { hits[(size_t) index].fetch_add(1); };
+        pool.parallelFor(count, job);
+
+        for (int i = 0; i < (int) hits.size(); ++i) {
+            REQUIRE(hits[(size_t) i].load() == (i < count ? 1 : 0));
+        }
+    }
+}
+
+TEST_CASE("RealtimeWorkerPool without workers runs serially in index order", "[RealtimeWorkerPool]") {
+    RealtimeWorkerPool pool(0);
+    std::vector<int> order;
+    order.reserve(8);
+
+    auto job = [&order](int index) { order.push_back(index); };
+    pool.parallelFor(8, job);
+
+    REQUIRE(order == std::vector<int>({ 0, 1, 2, 3, 4, 5, 6, 7 }));
+}
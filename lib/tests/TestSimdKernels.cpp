@@ -0,0 +1,288 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <Array/ScopedAlloc.h>
+#include <Array/SimdKernels.h>
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef USE_ACCELERATE
+  #include <Accelerate/Accelerate.h>
+#endif
+
+using Catch::Approx;
+
+namespace {
+    std::vector<float> signal(int size, float frequency, float offset) {
+        std::vector<float> values((size_t) size);
+        for (int i = 0; i < size; ++i) {
+            values[(size_t) i] = offset + std::sin(frequency * (float) i);
+        }
+        return values;
+    }
+
+    float maxError(const std::vector<float>& a, const std::vector<float>& b) {
+        float error = 0.f;
+        for (size_t i = 0; i < a.size(); ++i) {
+            error = jmax(error, std::abs(a[i] - b[i]));
+        }
+        return error;
+    }
+}
+
+TEST_CASE("SimdKernels dispatch to the widest supported table", "[simd]") {
+    REQUIRE(SimdKernels::getNumTables() >= 1);
+    REQUIRE(std::string(SimdKernels::scalar().name) == "scalar");
+    REQUIRE(&SimdKernels::get() == &SimdKernels::getTable(SimdKernels::getNumTables() - 1));
+}
+
+TEST_CASE("SimdKernels tables agree with the scalar reference", "[simd]") {
+    const auto& reference = SimdKernels::scalar();
+
+    // lengths around the vector widths, so every head/tail split gets exercised
+    for (int size : { 0, 1, 3, 4, 7, 8, 15, 17, 31, 33, 64, 1001 }) {
+        const auto a = signal(size, 0.31f, 0.1f);
+        const auto b = signal(size, 0.17f, 2.f);
+
+        for (int t = 0; t < SimdKernels::getNumTables(); ++t) {
+            const auto& table = SimdKernels::getTable(t);
+            INFO(table.name << ", size " << size);
+
+            std::vector<float> expected = a, actual = a;
+
+            auto checkBinary = [&](auto scalarKernel, auto kernel) {
+                expected = a;
+                actual = a;
+                scalarKernel(a.data(), b.data(), expected.data(), size);
+                kernel(a.data(), b.data(), actual.data(), size);
+                REQUIRE(maxError(expected, actual) <= 1.0e-6f);
+            };
+
+            checkBinary(reference.add, table.add);
+            checkBinary(reference.sub, table.sub);
+            checkBinary(reference.mul, table.mul);
+            checkBinary(reference.div, table.div);
+            checkBinary(reference.addProduct, table.addProduct);
+
+            auto checkUnary = [&](auto scalarKernel, auto kernel) {
+                expected = a;
+                actual = a;
+                scalarKernel(a.data(), expected.data(), size);
+                kernel(a.data(), actual.data(), size);
+                REQUIRE(maxError(expected, actual) <= 1.0e-6f);
+            };
+
+            checkUnary(reference.abs, table.abs);
+            checkUnary(reference.sqr, table.sqr);
+
+            expected = b;
+            actual = b;
+            reference.sqrt(b.data(), expected.data(), size);
+            table.sqrt(b.data(), actual.data(), size);
+            REQUIRE(maxError(expected, actual) <= 1.0e-6f);
+
+            expected = b;
+            actual = b;
+            reference.addProductC(a.data(), 0.75f, expected.data(), size);
+            table.addProductC(a.data(), 0.75f, actual.data(), size);
+            REQUIRE(maxError(expected, actual) <= 1.0e-6f);
+
+            reference.clip(a.data(), -0.5f, 0.5f, expected.data(), size);
+            table.clip(a.data(), -0.5f, 0.5f, actual.data(), size);
+            REQUIRE(maxError(expected, actual) == 0.f);
+
+            const float matrix[] = { 0.25f, 1.5f, -0.75f, -0.5f, 0.3f, 2.f };
+            std::vector<float> expectedY(a.size()), actualY(a.size());
+
+            for (bool blend : { false, true }) {
+                const float* u2 = blend ? b.data() : nullptr;
+                const float* v2 = blend ? a.data() : nullptr;
+
+                reference.affine2D(a.data(), b.data(), u2, v2, 0.4f, matrix, expected.data(), expectedY.data(), size);
+                table.affine2D(a.data(), b.data(), u2, v2, 0.4f, matrix, actual.data(), actualY.data(), size);
+                REQUIRE(maxError(expected, actual) <= 1.0e-5f);
+                REQUIRE(maxError(expectedY, actualY) <= 1.0e-5f);
+            }
+
+            // four lanes per frame, so a quarter of the frames, carried over two calls
+            const int frames = size / 4;
+            const int split = frames / 3;
+            std::vector<float> expectedState(4 * 7, 0.f), actualState(4 * 7, 0.f);
+            std::vector<float> coefficients((size_t) frames);
+            for (int i = 0; i < frames; ++i) {
+                coefficients[(size_t) i] = 0.5f + 0.4f * b[(size_t) i] - 0.8f;
+            }
+
+            expected = a;
+            actual = a;
+            for (auto* kernel : { &reference, &table }) {
+                float* dst = kernel == &reference ? expected.data() : actual.data();
+                float* state = kernel == &reference ? expectedState.data() : actualState.data();
+
+                kernel->allpassLanes(dst, coefficients.data(), 6, 0.7f, 0.9f, state, split);
+                kernel->allpassLanes(dst + 4 * split, coefficients.data() + split, 6, 0.7f, 0.9f, state, frames - split);
+            }
+            REQUIRE(maxError(expected, actual) <= 1.0e-5f);
+            REQUIRE(maxError(expectedState, actualState) <= 1.0e-5f);
+
+            // two sections with different coefficients per lane, the second a one-pole; lane 3 sits out
+            const double sections[] = {
+                0.02, 0.03, 0.04, 0.05,  0.04, 0.05, 0.06, 0.07,  0.02, 0.01, 0.02, 0.03,
+                -1.5, -1.4, -1.3, -1.2,  0.6, 0.55, 0.5, 0.45,
+                0.5, 0.6, 0.7, 0.8,  0.5, 0.4, 0.3, 0.2,  0.0, 0.0, 0.0, 0.0,
+                -0.5, -0.6, -0.7, -0.8,  0.0, 0.0, 0.0, 0.0
+            };
+            std::vector<double> expectedSections(4 * 4, 0.0), actualSections(4 * 4, 0.0);
+            std::vector<double> frameScratch(4 * (size_t) size);
+            std::vector<float> expectedLanes[4], actualLanes[4];
+
+            for (int lane = 0; lane < 4; ++lane) {
+                expectedLanes[lane] = actualLanes[lane] = signal(size, 0.05f * (float) (lane + 1), 0.f);
+            }
+
+            for (auto* kernel : { &reference, &table }) {
+                auto& lanes = kernel == &reference ? expectedLanes : actualLanes;
+                double* state = kernel == &reference ? expectedSections.data() : actualSections.data();
+                float* channels[] = { lanes[0].data(), lanes[1].data(), lanes[2].data(), lanes[3].data() };
+
+                kernel->biquadLanes(channels, channels, 0x7, sections, 2, state, frameScratch.data(), size / 3);
+
+                for (float*& channel : channels) {
+                    channel += size / 3;
+                }
+                kernel->biquadLanes(channels, channels, 0x7, sections, 2, state,
+                                    frameScratch.data(), size - size / 3);
+            }
+            for (int lane = 0; lane < 4; ++lane) {
+                REQUIRE(maxError(expectedLanes[lane], actualLanes[lane]) <= 1.0e-6f);
+            }
+            for (size_t i = 0; i < expectedSections.size(); ++i) {
+                REQUIRE(actualSections[i] == Approx(expectedSections[i]).margin(1.0e-9));
+            }
+            for (int i : { 3, 7, 11, 15 }) {
+                REQUIRE(actualSections[(size_t) i] == 0.0);
+            }
+
+            // in place
+            actual = a;
+            table.mulC(actual.data(), 3.f, actual.data(), size);
+            table.addC(actual.data(), 1.f, actual.data(), size);
+            for (int i = 0; i < size; ++i) {
+                REQUIRE(actual[(size_t) i] == Approx(a[(size_t) i] * 3.f + 1.f));
+            }
+
+            // reductions differ from the scalar order only by rounding
+            const float tolerance = 1.0e-5f * (float) (size + 1);
+            REQUIRE(table.sum(a.data(), size) == Approx(reference.sum(a.data(), size)).margin(tolerance));
+            REQUIRE(table.sumAbs(a.data(), size) == Approx(reference.sumAbs(a.data(), size)).margin(tolerance));
+            REQUIRE(table.dot(a.data(), b.data(), size) == Approx(reference.dot(a.data(), b.data(), size)).margin(tolerance));
+            REQUIRE(table.distanceSq(a.data(), b.data(), size)
+                    == Approx(reference.distanceSq(a.data(), b.data(), size)).margin(tolerance));
+            REQUIRE(table.min(a.data(), size) == reference.min(a.data(), size));
+            REQUIRE(table.max(a.data(), size) == reference.max(a.data(), size));
+        }
+    }
+}
+
+TEST_CASE("SimdKernels throughput against the Buffer backend", "[simd][benchmark][.]") {
+    constexpr int size = 4096;
+
+    ScopedAlloc<float> memory(3 * size);
+    Buffer<float> a = memory.place(size);
+    Buffer<float> b = memory.place(size);
+    Buffer<float> dst = memory.place(size);
+
+    for (int i = 0; i < size; ++i) {
+        a[i] = std::sin(0.01f * (float) i);
+        b[i] = 1.5f + std::cos(0.02f * (float) i);
+    }
+
+    std::cout << "SimdKernels best=" << SimdKernels::get().name << std::endl;
+
+    for (int t = 0; t < SimdKernels::getNumTables(); ++t) {
+        const auto& table = SimdKernels::getTable(t);
+        const std::string name = table.name;
+
+        BENCHMARK(name + " mul 4096")            { table.mul(a, b, dst, size); return dst[0]; };
+        BENCHMARK(name + " addProductC 4096")    { table.addProductC(a, 0.5f, dst, size); return dst[0]; };
+        BENCHMARK(name + " clip 4096")           { table.clip(a, -0.5f, 0.5f, dst, size); return dst[0]; };
+        BENCHMARK(name + " sum 4096")            { return table.sum(a, size); };
+        BENCHMARK(name + " dot 4096")            { return table.dot(a, b, size); };
+        BENCHMARK(name + " max 4096")            { return table.max(a, size); };
+    }
+
+    // whatever the build uses for Buffer: IPP, Accelerate or the kernels above
+    BENCHMARK("Buffer mul 4096")         { VecOps::mul(a, b, dst); return dst[0]; };
+    BENCHMARK("Buffer addProduct 4096")  { dst.addProduct(a, 0.5f); return dst[0]; };
+    BENCHMARK("Buffer clip 4096")        { a.copyTo(dst); dst.clip(-0.5f, 0.5f); return dst[0]; };
+    BENCHMARK("Buffer sum 4096")         { return a.sum(); };
+    BENCHMARK("Buffer dot 4096")         { return a.dot(b); };
+    BENCHMARK("Buffer max 4096")         { return a.max(); };
+}
+
+#if defined(USE_IPP) || defined(USE_ACCELERATE)
+TEST_CASE("SimdKernels throughput against IPP / Accelerate", "[simd][benchmark][.]") {
+    constexpr int size = 4096;
+
+    ScopedAlloc<float> memory(3 * size);
+    Buffer<float> a = memory.place(size);
+    Buffer<float> b = memory.place(size);
+    Buffer<float> dst = memory.place(size);
+
+    for (int i = 0; i < size; ++i) {
+        a[i] = std::sin(0.01f * (float) i);
+        b[i] = 1.5f + std::cos(0.02f * (float) i);
+    }
+
+    // the library called directly, next to the kernel table the CPU would dispatch to
+    const auto& kernels = SimdKernels::get();
+    const std::string simd = kernels.name;
+    const std::string native = perfSplit("ipp", "vDSP");
+    const float low = -0.5f, high = 0.5f, scale = 0.5f;
+    const auto n = perfSplit(size, vDSP_Length(size));
+
+    BENCHMARK(simd + " mul 4096")   { kernels.mul(a, b, dst, size); return dst[0]; };
+    BENCHMARK(native + " mul 4096") {
+        perfSplit(ippsMul_32f(a, b, dst, n), vDSP_vmul(a, 1, b, 1, dst, 1, n));
+        return dst[0];
+    };
+
+    BENCHMARK(simd + " addProductC 4096")   { kernels.addProductC(a, scale, dst, size); return dst[0]; };
+    BENCHMARK(native + " addProductC 4096") {
+        perfSplit(ippsAddProductC_32f(a, scale, dst, n), vDSP_vsma(a, 1, &scale, dst, 1, dst, 1, n));
+        return dst[0];
+    };
+
+    BENCHMARK(simd + " clip 4096")   { kernels.clip(a, low, high, dst, size); return dst[0]; };
+    BENCHMARK(native + " clip 4096") {
+        perfSplit(ippsThreshold_LTValGTVal_32f(a, dst, n, low, low, high, high),
+                  vDSP_vclip(a, 1, &low, &high, dst, 1, n));
+        return dst[0];
+    };
+
+    BENCHMARK(simd + " sum 4096")   { return kernels.sum(a, size); };
+    BENCHMARK(native + " sum 4096") {
+        float result = 0.f;
+        perfSplit(ippsSum_32f(a, n, &result, ippAlgHintFast), vDSP_sve(a, 1, &result, n));
+        return result;
+    };
+
+    BENCHMARK(simd + " dot 4096")   { return kernels.dot(a, b, size); };
+    BENCHMARK(native + " dot 4096") {
+        float result = 0.f;
+        perfSplit(ippsDotProd_32f(a, b, n, &result), vDSP_dotpr(a, 1, b, 1, &result, n));
+        return result;
+    };
+
+    BENCHMARK(simd + " max 4096")   { return kernels.max(a, size); };
+    BENCHMARK(native + " max 4096") {
+        float result = 0.f;
+        perfSplit(ippsMax_32f(a, n, &result), vDSP_maxv(a, 1, &result, n));
+        return result;
+    };
+}
+#endif
@@ -0,0 +1,118 @@
+#include <Thread/SnapshotMailbox.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <thread>
+
+namespace {
+    struct Counted {
+        Counted() = default;
+        explicit Counted(int value, std::atomic<int>* freed = nullptr) : value(value), freed(freed) {}
+
+        ~Counted() {
+            if (freed != nullptr) {
+                freed->fetch_add(1);
+            }
+        }
+
+        int value {};
+        std::atomic<int>* freed {};
+    };
+}
+
+TEST_CASE("SnapshotMailbox keeps the adopted snapshot until the next adopt", "[SnapshotMailbox]") {
+    SnapshotMailbox<Counted> mailbox(std::make_shared<const Counted>(1));
+
+    REQUIRE(mailbox.adopt().value == 1);
+
+    mailbox.publish(std::make_shared<const Counted>(2));
+    mailbox.publish(std::make_shared<const Counted>(3));
+
+    REQUIRE(mailbox.current().value == 1);
+    REQUIRE(mailbox.latest()->value == 3);
+    REQUIRE(mailbox.adopt().value == 3);
+    REQUIRE(mailbox.current().value == 3);
+}
+
+TEST_CASE("SnapshotMailbox frees released snapshots on the publishing thread", "[SnapshotMailbox]") {
+    std::atomic<int> freed { 0 };
+    SnapshotMailbox<Counted> mailbox(std::make_shared<const Counted>(0, &freed));
+
+    mailbox.adopt();
+    mailbox.publish(std::make_shared<const Counted>(1, &freed));
+
+    // the audio thread still reads the first one
+    REQUIRE(freed == 0);
+
+    mailbox.adopt();
+
+    // adopting lets go of the first one but does not free it
+    REQUIRE(freed == 0);
+    REQUIRE(mailbox.numHeld() == 2);
+
+    mailbox.publish(std::make_shared<const Counted>(2, &freed));
+
+    REQUIRE(freed == 1);
+    REQUIRE(mailbox.numHeld() == 2);
+}
+
+TEST_CASE("SnapshotMailbox holds released snapshots for the grace period", "[SnapshotMailbox]") {
+    std::atomic<int> freed { 0 };
+    SnapshotMailbox<Counted> mailbox(std::make_shared<const Counted>(0, &freed), std::chrono::hours(1));
+
+    for (int i = 1; i < 10; ++i) {
+        mailbox.publish(std::make_shared<const Counted>(i, &freed));
+        mailbox.adopt();
+    }
+
+    REQUIRE(freed == 0);
+    REQUIRE(mailbox.current().value == 9);
+}
+
+TEST_CASE("SnapshotMailbox never tears a snapshot read on another thread", "[SnapshotMailbox]") {
+    struct Pair {
+        int a {}, b {};
+    };
+
+    SnapshotMailbox<Pair> mailbox;
+    std::atomic<bool> done { false };
+    std::atomic<bool> torn { false };
+
+    std::thread reader([&] {
+        int lastSeen = 0;
+
+        while (! done.load()) {
+            const Pair& pair = mailbox.adopt();
+
+            if (pair.a != pair.b || pair.a < lastSeen) {
+                torn = true;
+            }
+
+            lastSeen = pair.a;
+        }
+    });
+
+    for (int i = 1; i <= 20000; ++i) {
+        mailbox.publish(std::make_shared<const Pair>(Pair { i, i }));
+    }
+
+    done = true;
+    reader.join();
+
+    REQUIRE_FALSE(torn);
+    REQUIRE(mailbox.latest()->a == 20000);
+}
+
+TEST_CASE("SnapshotMailbox adopts without taking a reference", "[SnapshotMailbox]") {
+    SnapshotMailbox<Counted> mailbox(std::make_shared<const Counted>(0));
+    mailbox.publish(std::make_shared<const Counted>(1));
+
+    // the mailbox's own reference plus the one returned here
+    REQUIRE(mailbox.latest().use_count() == 2);
+
+    mailbox.adopt();
+
+    REQUIRE(mailbox.current().value == 1);
+    REQUIRE(mailbox.latest().use_count() == 2);
+}
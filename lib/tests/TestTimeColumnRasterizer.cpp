@@ -1,7 +1,15 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <atomic>
+#include <iostream>
+#include <memory>
+
 #include <Array/ScopedAlloc.h>
+#include <Curve/Curve.h>
+#include <Curve/Mesh/VertCube.h>
+#include <Curve/Rasterization/Rasterizer/TimeColumnCache.h>
 #include <Curve/Rasterization/Rasterizer/TimeColumnRenderer.h>
+#include <Thread/RealtimeWorkerPool.h>
 
 TEST_CASE("Shared time column rasterizer varies guide seeds by column and layer", "[rasterization][time-column]") {
     using Rasterization::TimeColumnRasterizer;
@@ -42,3 +50,309 @@ TEST_CASE("Shared time column rasterizer clears columns without active meshes",
 
     REQUIRE(columns.front().sum() == 0.f);
 }
+
+namespace {
+    using Rasterization::TimeColumnRasterizer;
+
+    struct MeshDeleter {
+        void operator()(Mesh* mesh) const {
+            if (mesh != nullptr) {
+                mesh->destroy();
+                delete mesh;
+            }
+        }
+    };
+
+    struct CurveTableScope {
+        CurveTableScope() {
+            if (refCount++ == 0) {
+                Curve::calcTable();
+            }
+        }
+
+        ~CurveTableScope() {
+            if (--refCount == 0) {
+                Curve::deleteTable();
+            }
+        }
+
+        inline static int refCount = 0;
+    };
+
+    // a waveform of phasePoints points that changes shape across timeSegments spans of time
+    std::unique_ptr<Mesh, MeshDeleter> createGridMesh(int timeSegments, int phasePoints, int seed) {
+        std::unique_ptr<Mesh, MeshDeleter> mesh(new Mesh("TimeColumnMesh"));
+        Random random(seed);
+
+        for (int t = 0; t < timeSegments; ++t) {
+            for (int p = 0; p < phasePoints; ++p) {
+                auto* cube = new VertCube(mesh.get());
+                float phase = ((float) p + 0.2f + 0.6f * random.nextFloat()) / (float) phasePoints;
+
+                for (int i = 0; i < (int) VertCube::numVerts; ++i) {
+                    bool time, red, blue;
+                    VertCube::getPoles(i, time, red, blue);
+
+                    Vertex* vertex = cube->getVertex(i);
+                    vertex->values[Vertex::Time]  = (float) (t + (time ? 1 : 0)) / (float) timeSegments;
+                    vertex->values[Vertex::Red]   = red  ? 1.f : 0.f;
+                    vertex->values[Vertex::Blue]  = blue ? 1.f : 0.f;
+                    vertex->values[Vertex::Phase] = phase;
+                    vertex->values[Vertex::Amp]   = random.nextFloat();
+                    vertex->values[Vertex::Curve] = random.nextFloat();
+                }
+
+                mesh->addCube(cube);
+            }
+        }
+
+        return mesh;
+    }
+
+    void configure(Rasterization::GraphicRasterizer& rasterizer) {
+        auto state = Rasterization::GraphicRasterizer::createAnalysisRenderState(
+                Rasterization::GraphicRasterizer::Scaling::HalfBipolar,
+                MorphPosition(0.f, 0.4f, 0.6f));
+        rasterizer.restoreStateFrom(state);
+        rasterizer.setDims(Dimensions(Vertex::Phase, Vertex::Amp, Vertex::Time, Vertex::Red, Vertex::Blue));
+    }
+
+    struct ColumnGrid {
+        ColumnGrid(int numColumns, int columnSize) :
+                memory(numColumns * columnSize + 3 * columnSize + numColumns) {
+            for (int i = 0; i < numColumns; ++i) {
+                columns.emplace_back(memory.place(columnSize));
+                columns.back().zero();
+            }
+
+            layerBuffer = memory.place(columnSize);
+            sumBuffer = memory.place(columnSize);
+            zoomProgress = memory.place(numColumns);
+            zoomProgress.ramp(0.f, 1.f / (float) (numColumns - 1));
+        }
+
+        TimeColumnRasterizer::Context context(
+                const std::vector<TimeColumnRasterizer::Layer>& layers,
+                Rasterization::GraphicRasterizer& rasterizer) {
+            TimeColumnRasterizer::Context context;
+            context.layers = &layers;
+            context.rasterizer = &rasterizer;
+            context.columns = &columns;
+            context.zoomProgress = zoomProgress;
+            context.layerBuffer = layerBuffer;
+            context.sumBuffer = sumBuffer;
+            context.numColumns = (int) columns.size();
+            context.numActiveLayers = 1;
+            return context;
+        }
+
+        ScopedAlloc<Float32> memory;
+        std::vector<Column> columns;
+        Buffer<float> layerBuffer, sumBuffer, zoomProgress;
+    };
+
+    void requireSameColumns(const std::vector<Column>& actual, const std::vector<Column>& expected) {
+        REQUIRE(actual.size() == expected.size());
+
+        for (size_t c = 0; c < actual.size(); ++c) {
+            for (int i = 0; i < actual[c].size(); ++i) {
+                INFO("column " << c << ", row " << i);
+                REQUIRE(actual[c][i] == expected[c][i]);
+            }
+        }
+    }
+}
+
+TEST_CASE("Time columns render the same in tiles across a pool", "[rasterization][time-column]") {
+    CurveTableScope curveTableScope;
+    auto mesh = createGridMesh(8, 6, 3);
+    std::vector<TimeColumnRasterizer::Layer> layers { { mesh.get(), true, 0.5f } };
+
+    Rasterization::GraphicRasterizer rasterizer(true, 0.f);
+    configure(rasterizer);
+
+    ColumnGrid serial(100, 64), tiled(100, 64);
+    TimeColumnRasterizer().render(serial.context(layers, rasterizer));
+    REQUIRE(serial.columns[50].sumAbs() > 0.f);
+
+    RealtimeWorkerPool pool(3, Thread::Priority::normal);
+    ScopedAlloc<Float32> laneMemory(4 * 2 * 64);
+    std::vector<std::unique_ptr<Rasterization::GraphicRasterizer>> laneRasterizers;
+    std::vector<TimeColumnRasterizer::Lane> lanes;
+
+    for (int i = 0; i < 4; ++i) {
+        laneRasterizers.push_back(std::make_unique<Rasterization::GraphicRasterizer>(true, 0.f));
+        laneRasterizers.back()->copyBatchStateFrom(rasterizer);
+        lanes.push_back({ laneRasterizers.back().get(), laneMemory.place(64), laneMemory.place(64) });
+    }
+
+    auto context = tiled.context(layers, rasterizer);
+    context.pool = &pool;
+    context.lanes = &lanes;
+    TimeColumnRasterizer().render(context);
+
+    requireSameColumns(tiled.columns, serial.columns);
+}
+
+TEST_CASE("Time column tiles report as they finish and stop once cancelled", "[rasterization][time-column]") {
+    CurveTableScope curveTableScope;
+    auto mesh = createGridMesh(8, 6, 4);
+    std::vector<TimeColumnRasterizer::Layer> layers { { mesh.get(), true, 0.5f } };
+
+    Rasterization::GraphicRasterizer rasterizer(true, 0.f);
+    configure(rasterizer);
+
+    ColumnGrid grid(100, 64);
+    std::vector<int> reported;
+    std::atomic<bool> cancelled { false };
+
+    auto context = grid.context(layers, rasterizer);
+    context.cancelled = &cancelled;
+    context.tileRendered = [&](int first, int end) {
+        for (int i = first; i < end; ++i) {
+            reported.push_back(i);
+        }
+
+        // the second tile is the last one started
+        cancelled = end >= 2 * TimeColumnRasterizer::columnsPerTile;
+    };
+
+    TimeColumnRasterizer().render(context);
+
+    REQUIRE((int) reported.size() == 2 * TimeColumnRasterizer::columnsPerTile);
+
+    for (int i = 0; i < (int) reported.size(); ++i) {
+        REQUIRE(reported[(size_t) i] == i);
+    }
+
+    REQUIRE(grid.columns[TimeColumnRasterizer::columnsPerTile].sumAbs() > 0.f);
+    REQUIRE(grid.columns[2 * TimeColumnRasterizer::columnsPerTile].sumAbs() == 0.f);
+}
+
+TEST_CASE("TimeColumnCache redoes only the columns a moved cube passes through", "[rasterization][time-column]") {
+    CurveTableScope curveTableScope;
+    auto mesh = createGridMesh(8, 6, 5);
+    std::vector<TimeColumnRasterizer::Layer> layers { { mesh.get(), true, 0.5f } };
+
+    Rasterization::GraphicRasterizer rasterizer(true, 0.f);
+    configure(rasterizer);
+
+    ColumnGrid incremental(120, 64);
+    Rasterization::TimeColumnCache cache;
+    std::vector<int> changed;
+
+    auto context = incremental.context(layers, rasterizer);
+    REQUIRE_FALSE(cache.findChangedColumns(context, changed));
+    TimeColumnRasterizer().render(context);
+
+    // an update that moved nothing was sent for something else, so everything is redone
+    REQUIRE_FALSE(cache.findChangedColumns(context, changed));
+
+    // the third time segment's first point moves up; it spans time 2/8 to 3/8
+    VertCube* cube = mesh->getCubes()[2 * 6];
+    for (int i = 0; i < (int) VertCube::numVerts; ++i) {
+        cube->getVertex(i)->values[Vertex::Amp] += 0.1f;
+    }
+    mesh->markEdited();
+
+    REQUIRE(cache.findChangedColumns(context, changed));
+    REQUIRE_FALSE(changed.empty());
+    REQUIRE((int) changed.size() < 120 / 4);
+
+    for (int col : changed) {
+        float time = incremental.zoomProgress[col];
+        REQUIRE(time >= 2.f / 8.f);
+        REQUIRE(time <= 3.f / 8.f);
+    }
+
+    context.columnsToRender = &changed;
+    TimeColumnRasterizer().render(context);
+
+    ColumnGrid full(120, 64);
+    TimeColumnRasterizer().render(full.context(layers, rasterizer));
+    requireSameColumns(incremental.columns, full.columns);
+
+    // moving the cube to other times redoes where it was and where it is
+    for (int i = 0; i < (int) VertCube::numVerts; ++i) {
+        cube->getVertex(i)->values[Vertex::Time] += 0.25f;
+    }
+    mesh->markEdited();
+
+    REQUIRE(cache.findChangedColumns(context, changed));
+    REQUIRE(incremental.zoomProgress[changed.front()] <= 2.f / 8.f + 0.01f);
+    REQUIRE(incremental.zoomProgress[changed.back()] >= 5.f / 8.f - 0.01f);
+
+    // added cubes and different columns aren't a vertex edit
+    mesh->addCube(new VertCube(mesh.get()));
+    REQUIRE_FALSE(cache.findChangedColumns(context, changed));
+
+    context.numColumns = 60;
+    REQUIRE_FALSE(cache.findChangedColumns(context, changed));
+}
+
+TEST_CASE("Time column render time, full against a single-vertex edit", "[rasterization][time-column][benchmark][.]") {
+    constexpr int numColumns = 512;
+    constexpr int runs = 20;
+
+    CurveTableScope curveTableScope;
+    auto mesh = createGridMesh(32, 24, 7);
+    std::vector<TimeColumnRasterizer::Layer> layers { { mesh.get(), true, 0.5f } };
+
+    Rasterization::GraphicRasterizer rasterizer(true, 0.f);
+    configure(rasterizer);
+
+    const int numWorkers = jmin(3, RealtimeWorkerPool::defaultWorkerCount());
+    RealtimeWorkerPool pool(jmax(1, numWorkers), Thread::Priority::normal);
+    ScopedAlloc<Float32> laneMemory((pool.getNumWorkers() + 1) * 2 * 256);
+    std::vector<std::unique_ptr<Rasterization::GraphicRasterizer>> laneRasterizers;
+    std::vector<TimeColumnRasterizer::Lane> lanes;
+
+    for (int i = 0; i < pool.getNumWorkers() + 1; ++i) {
+        laneRasterizers.push_back(std::make_unique<Rasterization::GraphicRasterizer>(true, 0.f));
+        laneRasterizers.back()->copyBatchStateFrom(rasterizer);
+        lanes.push_back({ laneRasterizers.back().get(), laneMemory.place(256), laneMemory.place(256) });
+    }
+
+    ColumnGrid grid(numColumns, 256);
+    Rasterization::TimeColumnCache cache;
+    std::vector<int> changed;
+    Vertex* vertex = mesh->getCubes()[100]->getVertex(0);
+
+    for (int mode = 0; mode < 3; ++mode) {
+        auto context = grid.context(layers, rasterizer);
+        const bool pooled = mode > 0;
+        const bool incremental = mode == 2;
+
+        if (pooled) {
+            context.pool = &pool;
+            context.lanes = &lanes;
+        }
+
+        cache.invalidate();
+        (void) cache.findChangedColumns(context, changed);
+        TimeColumnRasterizer().render(context);
+
+        double start = Time::getMillisecondCounterHiRes();
+        size_t rendered = 0;
+
+        for (int run = 0; run < runs; ++run) {
+            vertex->values[Vertex::Amp] = run % 2 == 0 ? 0.8f : 0.2f;
+            mesh->markEdited();
+
+            if (incremental && cache.findChangedColumns(context, changed)) {
+                context.columnsToRender = &changed;
+                rendered += changed.size();
+            } else {
+                context.columnsToRender = nullptr;
+                rendered += numColumns;
+            }
+
+            TimeColumnRasterizer().render(context);
+        }
+
+        double millis = (Time::getMillisecondCounterHiRes() - start) / runs;
+        std::cout << numColumns << " columns, " << mesh->getNumCubes() << " cubes, "
+                  << (incremental ? "single-vertex edit, pooled" : pooled ? "full, pooled" : "full, serial")
+                  << ": " << millis << " ms, " << rendered / runs << " columns per render" << std::endl;
+    }
+}
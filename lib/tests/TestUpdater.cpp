@@ -1,6 +1,14 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "../src/Design/Updating/Updater.h"
+#include "../src/Thread/RealtimeWorkerPool.h"
 
 namespace {
     class TestableUpdater :
@@ -23,6 +31,40 @@ namespace {
         }
     };
 
+    class RecordingNode :
+            public Updater::Node {
+    public:
+        RecordingNode(const String& name, std::vector<String>& log, std::mutex& logLock) :
+                log(log)
+            ,   logLock(logLock) {
+            setDebugName(name);
+        }
+
+        void executeUpdate(UpdateType) override {
+            if (onUpdate) {
+                onUpdate();
+            }
+
+            const std::lock_guard<std::mutex> lock(logLock);
+            log.push_back(getDebugName());
+        }
+
+        std::function<void()> onUpdate;
+
+    private:
+        std::vector<String>& log;
+        std::mutex& logLock;
+    };
+
+    int positionOf(const std::vector<String>& log, const String& name) {
+        for (size_t i = 0; i < log.size(); ++i) {
+            if (log[i] == name) {
+                return (int) i;
+            }
+        }
+        return -1;
+    }
+
     void requirePendingUpdate(const Updater::PendingUpdate& update, int source, UpdateType type) {
         REQUIRE(update.source == source);
         REQUIRE(update.type == type);
@@ -74,3 +116,140 @@ TEST_CASE("Updater optimizes redundant pending updates", "[updating]") {
         requirePendingUpdate(pending[2], 4, RestoreDetail);
     }
 }
+
+TEST_CASE("Update graph runs each reached node once after its parents", "[updating]") {
+    std::vector<String> log;
+    std::mutex logLock;
+
+    // a -> b, a -> c, b + c -> d; e is a head nobody marks
+    RecordingNode a("a", log, logLock), b("b", log, logLock), c("c", log, logLock);
+    RecordingNode d("d", log, logLock), e("e", log, logLock);
+    Updater::Node start;
+
+    b.updatesAfter(&a);
+    c.updatesAfter(&a);
+    d.updatesAfter(&b);
+    d.updatesAfter(&c);
+    start.marks(&a);
+
+    Updater::Graph graph(nullptr);
+    graph.addHeadNode(&a);
+    graph.addHeadNode(&e);
+
+    for (int pass = 0; pass < 2; ++pass) {
+        log.clear();
+        graph.update(&start);
+
+        REQUIRE(log.size() == 4);
+        REQUIRE(positionOf(log, "e") < 0);
+        REQUIRE(positionOf(log, "a") < positionOf(log, "b"));
+        REQUIRE(positionOf(log, "a") < positionOf(log, "c"));
+        REQUIRE(positionOf(log, "b") < positionOf(log, "d"));
+        REQUIRE(positionOf(log, "c") < positionOf(log, "d"));
+        REQUIRE(d.isUpdated());
+    }
+
+    // edges changed after the schedule was cached
+    d.doesntUpdateAfter(&c);
+    d.doesntUpdateAfter(&b);
+    log.clear();
+    graph.update(&start);
+    REQUIRE(log.size() == 3);
+    REQUIRE(positionOf(log, "d") < 0);
+}
+
+TEST_CASE("Update graph runs concurrent siblings on the worker pool", "[updating]") {
+    std::vector<String> log;
+    std::mutex logLock;
+
+    RecordingNode root("root", log, logLock), sink("sink", log, logLock);
+    std::vector<std::unique_ptr<RecordingNode>> siblings;
+    Updater::Node start;
+    start.marks(&root);
+
+    std::atomic<int> running { 0 }, maxRunning { 0 };
+    std::atomic<int> finishedBeforeSink { 0 };
+
+    for (int i = 0; i < 6; ++i) {
+        siblings.push_back(std::make_unique<RecordingNode>("s" + String(i), log, logLock));
+        auto& sibling = *siblings.back();
+        sibling.updatesAfter(&root);
+        sibling.setConcurrent(true);
+        sink.updatesAfter(&sibling);
+
+        sibling.onUpdate = [&] {
+            int now = ++running;
+            int seen = maxRunning.load();
+            while (now > seen && ! maxRunning.compare_exchange_weak(seen, now)) {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            --running;
+            ++finishedBeforeSink;
+        };
+    }
+
+    int siblingsDoneAtSink = -1;
+    sink.onUpdate = [&] { siblingsDoneAtSink = finishedBeforeSink.load(); };
+
+    RealtimeWorkerPool pool(3, Thread::Priority::normal);
+    Updater::Graph graph(nullptr);
+    graph.addHeadNode(&root);
+    graph.setWorkerPool(&pool);
+    graph.update(&start);
+
+    REQUIRE(log.size() == 8);
+    REQUIRE(siblingsDoneAtSink == 6);
+    REQUIRE(maxRunning.load() > 1);
+    for (auto& sibling : siblings) {
+        REQUIRE(sibling->isUpdated());
+    }
+}
+
+TEST_CASE("Update graph coalesces requests made during a pass", "[updating]") {
+    std::vector<String> log;
+    std::mutex logLock;
+
+    RecordingNode first("first", log, logLock), second("second", log, logLock), shared("shared", log, logLock);
+    Updater::Node startFirst, startSecond;
+    shared.updatesAfter(&second);
+    startFirst.marks(&first);
+    startSecond.marks(&second);
+
+    Updater::Graph graph(nullptr);
+    graph.addHeadNode(&first);
+    graph.addHeadNode(&second);
+
+    // the first node asks for the second pass three times while it is still updating
+    first.onUpdate = [&] {
+        REQUIRE(graph.isUpdating());
+        graph.update(&startSecond);
+        graph.update(&startSecond);
+        graph.update(&startSecond);
+    };
+
+    graph.update(&startFirst);
+
+    REQUIRE(graph.getNumPasses() == 2);
+    REQUIRE(log == std::vector<String>({ "first", "second", "shared" }));
+    REQUIRE_FALSE(graph.isUpdating());
+}
+
+TEST_CASE("Update graph builds the path only while tracing", "[updating]") {
+    struct NamedUpdateable : Updateable {
+        void performUpdate(UpdateType) override {}
+    } target;
+    target.setUpdateName("target");
+
+    Updater::Node node(&target), start;
+    start.marks(&node);
+
+    Updater::Graph graph(nullptr);
+    graph.addHeadNode(&node);
+
+    graph.update(&start);
+    REQUIRE(graph.getLastPath().isEmpty());
+
+    graph.setPrintsPath(true);
+    graph.update(&start);
+    REQUIRE(graph.getLastPath().contains("target"));
+}